@@ -18,6 +18,9 @@ special_handling = {
     'unistd.h': '#if !defined(_WIN32) && __has_include(<unistd.h>)\n    #include <unistd.h>\n#endif',
     'sys/ioctl.h': '#if !defined(_WIN32) && __has_include(<sys/ioctl.h>)\n    #include <sys/ioctl.h>\n#endif',
     'termios.h': '#if !defined(_WIN32) && __has_include(<termios.h>)\n    #include <termios.h>\n#endif',
+    'sys/mman.h': '#if !defined(_WIN32) && __has_include(<sys/mman.h>)\n    #include <sys/mman.h>\n#endif',
+    'sys/stat.h': '#if !defined(_WIN32) && __has_include(<sys/stat.h>)\n    #include <sys/stat.h>\n#endif',
+    'fcntl.h': '#if !defined(_WIN32) && __has_include(<fcntl.h>)\n    #include <fcntl.h>\n#endif',
     'io.h': '#ifdef _WIN32\n    #include <io.h>\n#endif',
     'Windows.h': 
 '''#ifdef _WIN32
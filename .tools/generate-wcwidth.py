@@ -0,0 +1,211 @@
+#  Copyright 2022 Eugene Gershnik
+#
+#  Use of this source code is governed by a BSD-style
+#  license that can be found in the LICENSE file or at
+#  https://github.com/gershnik/argum/blob/master/LICENSE
+#
+# Generates inc/argum/wcwidth-tables.h - the two-level lookup tables used by
+# Argum::Wcwidth::mk_wcwidth
+#
+# Usage:
+#   generate-wcwidth.py [--ucd DIR | --builtin] [output]
+#
+# By default the latest UnicodeData.txt and EastAsianWidth.txt are downloaded from
+# unicode.org. Use --ucd to point to a directory with these files already present
+# or --builtin to use Python's own unicodedata module (no network access needed).
+#
+import re
+import urllib.request
+from pathlib import Path
+from typing import List, Tuple
+
+MYPATH = Path(__file__).parent
+ROOT = MYPATH.parent
+
+UCD_URL = 'https://www.unicode.org/Public/UCD/latest/ucd/'
+
+MAX_CODEPOINT = 0x10FFFF
+PAGE_BITS = 8
+PAGE_SIZE = 1 << PAGE_BITS
+WORD_BITS = 32
+WORDS_PER_PAGE = PAGE_SIZE // WORD_BITS
+
+# Same rules as the original Markus Kuhn's implementation:
+# zero width: "uniset +cat=Me +cat=Mn +cat=Cf -00AD +1160-11FF +200B"
+# wide: East Asian Wide (W) and Full-width (F) plus the rest of planes 2 and 3
+ZERO_WIDTH_CATEGORIES = {'Me', 'Mn', 'Cf'}
+ZERO_WIDTH_EXTRA = [(0x1160, 0x11FF), (0x200B, 0x200B)]
+ZERO_WIDTH_EXCLUDED = {0x00AD}
+WIDE_EXTRA = [(0x20000, 0x2FFFD), (0x30000, 0x3FFFD)]
+# default East Asian Width of unassigned code points per UAX #11
+# (EastAsianWidth.txt lists these explicitly but Python's unicodedata does not)
+UNASSIGNED_WIDE = [(0x3400, 0x4DBF), (0x4E00, 0x9FFF), (0xF900, 0xFAFF)]
+
+
+def parseRanges(text: str):
+    line_re = re.compile(r'^([0-9A-F]+)(?:\.\.([0-9A-F]+))?\s*;\s*([^\s#]+)')
+    for line in text.splitlines():
+        m = line_re.match(line)
+        if not m:
+            continue
+        first = int(m.group(1), 16)
+        last = int(m.group(2), 16) if m.group(2) else first
+        yield first, last, m.group(3)
+
+
+def loadUcd(ucd: str | None) -> Tuple[str, List[str], List[str]]:
+    def read(name):
+        if ucd is not None:
+            return (Path(ucd) / name).read_text(encoding='utf-8')
+        with urllib.request.urlopen(UCD_URL + name) as resp:
+            return resp.read().decode('utf-8')
+
+    categories = ['Cn'] * (MAX_CODEPOINT + 1)
+    rangeStart = None
+    for line in read('UnicodeData.txt').splitlines():
+        fields = line.split(';')
+        if len(fields) < 3:
+            continue
+        cp = int(fields[0], 16)
+        if fields[1].endswith(', First>'):
+            rangeStart = cp
+            continue
+        if fields[1].endswith(', Last>'):
+            for c in range(rangeStart, cp + 1):
+                categories[c] = fields[2]
+            continue
+        categories[cp] = fields[2]
+
+    widths = ['N'] * (MAX_CODEPOINT + 1)
+    eaw = read('EastAsianWidth.txt')
+    for first, last, width in parseRanges(eaw):
+        for c in range(first, last + 1):
+            widths[c] = width
+
+    version = 'latest'
+    if m := re.search(r'EastAsianWidth-([0-9.]+)\.txt', eaw):
+        version = m.group(1)
+    return version, categories, widths
+
+
+def loadBuiltin() -> Tuple[str, List[str], List[str]]:
+    import unicodedata
+    categories = [unicodedata.category(chr(c)) for c in range(MAX_CODEPOINT + 1)]
+    widths = [unicodedata.east_asian_width(chr(c)) if categories[c] != 'Cn' else 'N' 
+              for c in range(MAX_CODEPOINT + 1)]
+    for first, last in UNASSIGNED_WIDE:
+        for c in range(first, last + 1):
+            if categories[c] == 'Cn':
+                widths[c] = 'W'
+    return unicodedata.unidata_version, categories, widths
+
+
+def classify(categories: List[str], widths: List[str]) -> Tuple[List[bool], List[bool]]:
+    zero = [cat in ZERO_WIDTH_CATEGORIES for cat in categories]
+    for c in ZERO_WIDTH_EXCLUDED:
+        zero[c] = False
+    for first, last in ZERO_WIDTH_EXTRA:
+        for c in range(first, last + 1):
+            zero[c] = True
+
+    wide = [w in ('W', 'F') for w in widths]
+    for first, last in WIDE_EXTRA:
+        for c in range(first, last + 1):
+            wide[c] = True
+    # zero width wins, as in the original
+    wide = [w and not z for w, z in zip(wide, zero)]
+    return zero, wide
+
+
+def pageWords(bits: List[bool], page: int) -> Tuple[int, ...]:
+    ret = []
+    start = page * PAGE_SIZE
+    for w in range(WORDS_PER_PAGE):
+        word = 0
+        for b in range(WORD_BITS):
+            c = start + w * WORD_BITS + b
+            if c <= MAX_CODEPOINT and bits[c]:
+                word |= 1 << b
+        ret.append(word)
+    return tuple(ret)
+
+
+def buildTables(zero: List[bool], wide: List[bool]):
+    pageCount = (MAX_CODEPOINT + 1) // PAGE_SIZE
+    uniquePages = {}
+    pages = []
+    index = []
+    for page in range(pageCount):
+        key = (pageWords(zero, page), pageWords(wide, page))
+        idx = uniquePages.get(key)
+        if idx is None:
+            idx = len(pages)
+            uniquePages[key] = idx
+            pages.append(key)
+        index.append(idx)
+    if len(pages) > 256:
+        raise RuntimeError(f'too many unique pages ({len(pages)}) for 8-bit page index')
+    return index, pages
+
+
+def render(version: str, index: List[int], pages) -> str:
+    out = []
+    out.append('//\n')
+    out.append('// Copyright 2022 Eugene Gershnik\n')
+    out.append('//\n')
+    out.append('// Use of this source code is governed by a BSD-style\n')
+    out.append('// license that can be found in the LICENSE file or at\n')
+    out.append('// https://github.com/gershnik/argum/blob/master/LICENSE\n')
+    out.append('//\n')
+    out.append('// THIS FILE IS GENERATED by .tools/generate-wcwidth.py. DO NOT EDIT.\n')
+    out.append(f'// Unicode version: {version}\n')
+    out.append('//\n')
+    out.append('#ifndef HEADER_ARGUM_WCWIDTH_TABLES_H_INCLUDED\n')
+    out.append('#define HEADER_ARGUM_WCWIDTH_TABLES_H_INCLUDED\n\n')
+    out.append('#include <stdint.h>\n\n')
+    out.append('namespace Argum::Wcwidth {\n\n')
+    out.append(f'constexpr unsigned widthPageBits = {PAGE_BITS};\n\n')
+    out.append('struct WidthPage {\n')
+    out.append(f'    uint32_t zero[{WORDS_PER_PAGE}];\n')
+    out.append(f'    uint32_t wide[{WORDS_PER_PAGE}];\n')
+    out.append('};\n\n')
+    out.append('/* index of WidthPage for each 256 code points page */\n')
+    out.append(f'inline constexpr uint8_t widthPageIndex[{len(index)}] = {{\n')
+    for i in range(0, len(index), 16):
+        out.append('    ' + ', '.join(f'{v:3}' for v in index[i:i + 16]) + ',\n')
+    out.append('};\n\n')
+    out.append('/* bitmaps of zero-width and wide code points for each distinct page */\n')
+    out.append(f'inline constexpr WidthPage widthPages[{len(pages)}] = {{\n')
+    for zero, wide in pages:
+        out.append('    {\n')
+        out.append('        {' + ', '.join(f'0x{w:08X}' for w in zero) + '},\n')
+        out.append('        {' + ', '.join(f'0x{w:08X}' for w in wide) + '}\n')
+        out.append('    },\n')
+    out.append('};\n\n')
+    out.append('}\n\n')
+    out.append('#endif\n')
+    return ''.join(out)
+
+
+def main():
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    source = parser.add_mutually_exclusive_group()
+    source.add_argument('--ucd', help='directory containing UnicodeData.txt and EastAsianWidth.txt')
+    source.add_argument('--builtin', action='store_true', help="use Python's unicodedata module")
+    parser.add_argument('output', nargs='?', default=str(ROOT / 'inc/argum/wcwidth-tables.h'))
+    args = parser.parse_args()
+
+    if args.builtin:
+        version, categories, widths = loadBuiltin()
+    else:
+        version, categories, widths = loadUcd(args.ucd)
+
+    zero, wide = classify(categories, widths)
+    index, pages = buildTables(zero, wide)
+    Path(args.output).write_text(render(version, index, pages), encoding='utf-8')
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,101 @@
+#include "allocation-counter.h"
+
+#include <new>
+#include <algorithm>
+
+#include <stdlib.h>
+
+using std::max;
+
+namespace {
+    //counting is meant for single threaded programs
+    Bench::AllocationCounters counters;
+
+    auto countedAllocate(size_t size) -> void * {
+        ++counters.allocations;
+        counters.bytes += size;
+        //malloc(0) may return nullptr
+        return malloc(size ? size : 1);
+    }
+
+    auto countedAllocate(size_t size, std::align_val_t alignment) -> void * {
+        ++counters.allocations;
+        counters.bytes += size;
+        auto align = size_t(alignment);
+        #ifdef _WIN32
+            return _aligned_malloc(size ? size : 1, align);
+        #else
+            return aligned_alloc(align, (max(size, size_t(1)) + align - 1) / align * align);
+        #endif
+    }
+
+    auto countedFree(void * ptr, std::align_val_t) noexcept {
+        #ifdef _WIN32
+            _aligned_free(ptr);
+        #else
+            free(ptr);
+        #endif
+    }
+}
+
+auto Bench::allocationCounters() -> AllocationCounters {
+    return counters;
+}
+
+//GCC pairs the inlined replacement operators with the builtin ones and reports a mismatch
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+auto operator new(size_t size) -> void * {
+    if (auto ret = countedAllocate(size))
+        return ret;
+    throw std::bad_alloc();
+}
+auto operator new[](size_t size) -> void * {
+    return operator new(size);
+}
+auto operator new(size_t size, const std::nothrow_t &) noexcept -> void * {
+    return countedAllocate(size);
+}
+auto operator new[](size_t size, const std::nothrow_t &) noexcept -> void * {
+    return countedAllocate(size);
+}
+auto operator new(size_t size, std::align_val_t alignment) -> void * {
+    if (auto ret = countedAllocate(size, alignment))
+        return ret;
+    throw std::bad_alloc();
+}
+auto operator new[](size_t size, std::align_val_t alignment) -> void * {
+    return operator new(size, alignment);
+}
+auto operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept -> void * {
+    return countedAllocate(size, alignment);
+}
+auto operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept -> void * {
+    return countedAllocate(size, alignment);
+}
+void operator delete(void * ptr) noexcept {
+    free(ptr);
+}
+void operator delete[](void * ptr) noexcept {
+    free(ptr);
+}
+void operator delete(void * ptr, size_t) noexcept {
+    free(ptr);
+}
+void operator delete[](void * ptr, size_t) noexcept {
+    free(ptr);
+}
+void operator delete(void * ptr, std::align_val_t alignment) noexcept {
+    countedFree(ptr, alignment);
+}
+void operator delete[](void * ptr, std::align_val_t alignment) noexcept {
+    countedFree(ptr, alignment);
+}
+void operator delete(void * ptr, size_t, std::align_val_t alignment) noexcept {
+    countedFree(ptr, alignment);
+}
+void operator delete[](void * ptr, size_t, std::align_val_t alignment) noexcept {
+    countedFree(ptr, alignment);
+}
@@ -0,0 +1,24 @@
+#ifndef HEADER_ALLOCATION_COUNTER_H_INCLUDED
+#define HEADER_ALLOCATION_COUNTER_H_INCLUDED
+
+//Counters of heap allocations made through the global operator new.
+//Linking allocation-counter.cpp into an executable replaces the global operators with counting ones.
+
+#include <stddef.h>
+
+namespace Bench {
+
+    struct AllocationCounters {
+        size_t allocations = 0;
+        size_t bytes = 0;
+
+        friend auto operator-(const AllocationCounters & lhs, const AllocationCounters & rhs) -> AllocationCounters {
+            return {lhs.allocations - rhs.allocations, lhs.bytes - rhs.bytes};
+        }
+    };
+
+    //Totals since the program start. Not thread safe.
+    auto allocationCounters() -> AllocationCounters;
+}
+
+#endif
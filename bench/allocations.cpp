@@ -0,0 +1,337 @@
+//Counts heap allocations made by common operations and checks them against budgets.
+//
+//Usage: bench-allocations [--budgets=FILE] [--update]
+//
+//Without --budgets the counts are only reported. With it the program fails if any operation
+//exceeds its budget or has none. Allocation counts must not exceed the budget at all. Byte
+//counts may exceed it by bytesTolerancePercent since they depend on the path of the temporary
+//response file. With --update the budgets file is rewritten with the current counts instead.
+//
+//Counts depend on the standard library. The checked-in budgets are for libstdc++.
+
+#include "allocation-counter.h"
+
+#include <argum/parser.h>
+#include <argum/command-line.h>
+#include <argum/type-parsers.h>
+
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+
+    //A small but realistic program's command line interface
+    struct Program {
+        vector<string> sources;
+        string destination;
+        size_t encoding = 0;
+        string compression;
+        int level = 9;
+        unsigned verbosity = 0;
+        vector<string> definitions;
+        string outputDir;
+
+        ChoiceParser encodingChoices;
+        Parser parser;
+
+        //clears the parsed values keeping the capacity so that repeated parsing does not allocate for them
+        void reset() {
+            sources.clear();
+            destination.clear();
+            compression.clear();
+            verbosity = 0;
+            definitions.clear();
+            outputDir.clear();
+        }
+
+        Program() {
+            encodingChoices.addChoice("default");
+            encodingChoices.addChoice("base64");
+            encodingChoices.addChoice("hex");
+
+            parser.add(
+                Positional("source").
+                help("source file").
+                occurs(zeroOrMoreTimes).
+                handler([this](string_view value) {
+                    sources.emplace_back(value);
+                }));
+            parser.add(
+                Positional("destination").
+                help("destination file").
+                occurs(once).
+                handler([this](string_view value) {
+                    destination = value;
+                }));
+            parser.add(
+                Option("--help", "-h").
+                help("show this help message and exit").
+                handler([]() {}));
+            parser.add(
+                Option("--verbose", "-v").
+                help("increase verbosity, can be repeated").
+                occurs(zeroOrMoreTimes).
+                handler([this]() { ++verbosity; }));
+            parser.add(
+                Option("--format", "-f", "--encoding", "-e").
+                help("output file format").
+                argName(encodingChoices.description()).
+                handler([this](string_view value) {
+                    encoding = encodingChoices.parse(value);
+                }));
+            parser.add(
+                Option("--compress", "-c").
+                argName("ALGORITHM").
+                requireAttachedArgument(true).
+                help("compress output with a given algorithm (default gzip)").
+                handler([this](optional<string_view> value) {
+                    compression = value.value_or("gzip");
+                }));
+            parser.add(
+                Option("--level", "-l").
+                argName("LEVEL").
+                help("compression level, requires --compress").
+                handler([this](string_view value) {
+                    level = parseIntegral<int>(value);
+                }));
+            parser.add(
+                Option("--define", "-D").
+                argName("NAME=VALUE").
+                help("define a variable").
+                occurs(zeroOrMoreTimes).
+                handler([this](string_view value) {
+                    definitions.emplace_back(value);
+                }));
+            parser.add(
+                Option("--output-dir", "-o").
+                argName("DIR").
+                help("directory to put the outputs in").
+                handler([this](string_view value) {
+                    outputDir = value;
+                }));
+
+            parser.addValidator(
+                oneOrNoneOf(
+                    optionPresent("--format"),
+                    anyOf(optionPresent("--compress"), optionPresent("--level"))
+                ),
+                "options --format and --compress/--level are mutually exclusive"
+            );
+            parser.addValidator(
+                !optionPresent("--level") || optionPresent("--compress"),
+                "if --level is specified then --compress must be specified also"
+            );
+        }
+    };
+
+    const vector<string> typicalArgs = {
+        "-vv", "--compress=bzip2", "--level", "5", "-DNAME=1", "--define", "OTHER=2", "-o", "out",
+        "first.txt", "second.txt", "dest.txt"
+    };
+
+    auto failingParse(Program & program, const vector<string> & args) -> size_t {
+        program.reset();
+        try {
+            program.parser.parse(args);
+        } catch (ParsingException & ex) {
+            return ex.message().size();
+        }
+        fprintf(stderr, "parsing was expected to fail\n");
+        abort();
+    }
+
+    struct Operation {
+        const char * name;
+        function<void ()> setup;
+        function<void ()> run;
+    };
+
+    auto responseFile() -> filesystem::path {
+        static auto ret = filesystem::temp_directory_path() / ("argum-allocations-" + to_string(rand()) + ".txt");
+        return ret;
+    }
+
+    auto operations() -> vector<Operation> {
+        static Program program;
+        static string responseArg;
+
+        return {
+            {"construct", {}, []() {
+                Program local;
+            }},
+            {"parse", {}, []() {
+                program.reset();
+                program.parser.parse(typicalArgs);
+            }},
+            {"parse-until-unknown", {}, []() {
+                program.reset();
+                auto rest = program.parser.parseUntilUnknown(vector<string>{"-v", "--compress", "dest.txt", "--unknown", "-x"});
+            }},
+            {"parse-collecting-errors", {}, []() {
+                program.reset();
+                auto errors = program.parser.parseCollectingErrors(vector<string>{"--bogus", "-v", "--level", "x", "--format=xml", "dest.txt"});
+                for (auto & error: errors)
+                    (void)error->message();
+            }},
+            {"format-help", {}, []() {
+                auto help = program.parser.formatHelp("prog", 80);
+            }},
+            {"format-usage", {}, []() {
+                auto usage = program.parser.formatUsage("prog", 80);
+            }},
+            {"error-unknown-option", {}, []() {
+                failingParse(program, {"-v", "--bogus", "dest.txt"});
+            }},
+            {"error-missing-argument", {}, []() {
+                failingParse(program, {"dest.txt", "--level"});
+            }},
+            {"error-missing-positional", {}, []() {
+                failingParse(program, {"-v"});
+            }},
+            {"error-invalid-choice", {}, []() {
+                failingParse(program, {"--format=xml", "dest.txt"});
+            }},
+            {"error-validation", {}, []() {
+                failingParse(program, {"--format=hex", "--compress", "dest.txt"});
+            }},
+            {"response-file-expand", []() {
+                ofstream str(responseFile());
+                for (int i = 0; i < 100; ++i)
+                    str << "--define\nNAME" << i << "=VALUE" << i << '\n';
+                responseArg = "@" + responseFile().string();
+            }, []() {
+                ResponseFileReader reader('@');
+                auto expanded = reader.expand(vector<string>{"-v", responseArg, "dest.txt"});
+            }},
+            {"response-file-expand-mapped", {}, []() {
+                ResponseFileReader reader('@');
+                auto expanded = reader.expandMapped(vector<string>{"-v", responseArg, "dest.txt"});
+            }},
+            {"response-file-parse", {}, []() {
+                ResponseFileReader reader('@');
+                auto expanded = reader.expandMapped(vector<string>{"-v", responseArg, "dest.txt"});
+                program.reset();
+                program.parser.parse(expanded);
+            }}
+        };
+    }
+
+    struct Budget {
+        size_t allocations;
+        size_t bytes;
+    };
+
+    constexpr size_t bytesTolerancePercent = 5;
+
+    auto exceeds(const Bench::AllocationCounters & counts, const Budget & budget) -> bool {
+        return counts.allocations > budget.allocations || 
+               counts.bytes * 100 > budget.bytes * (100 + bytesTolerancePercent);
+    }
+
+    auto readBudgets(const filesystem::path & path, map<string, Budget> & budgets) -> bool {
+        ifstream str(path);
+        if (!str) {
+            fprintf(stderr, "cannot read %s\n", path.string().c_str());
+            return false;
+        }
+        string line;
+        for (unsigned lineNo = 1; getline(str, line); ++lineNo) {
+            if (line.empty() || line[0] == '#')
+                continue;
+            istringstream lineStr(line);
+            string name;
+            Budget budget{};
+            if (!(lineStr >> name >> budget.allocations >> budget.bytes)) {
+                fprintf(stderr, "%s:%u: expected: name allocations bytes\n", path.string().c_str(), lineNo);
+                return false;
+            }
+            budgets[name] = budget;
+        }
+        return true;
+    }
+
+    auto writeBudgets(const filesystem::path & path, const vector<pair<string, Bench::AllocationCounters>> & results) -> bool {
+        ofstream str(path);
+        str << "# Allocation budgets checked by the check-allocations target. Counts are for libstdc++.\n"
+               "# Regenerate with the update-allocation-budgets target after an intentional change.\n"
+               "# operation allocations bytes\n";
+        for (auto & [name, counts]: results)
+            str << name << ' ' << counts.allocations << ' ' << counts.bytes << '\n';
+        str.close();
+        if (!str) {
+            fprintf(stderr, "cannot write %s\n", path.string().c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char * argv[]) {
+
+    optional<filesystem::path> budgetsPath;
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        string_view arg = argv[i];
+        if (arg.substr(0, 10) == "--budgets=") {
+            budgetsPath = arg.substr(10);
+        } else if (arg == "--update") {
+            update = true;
+        } else {
+            fprintf(stderr, "usage: %s [--budgets=FILE] [--update]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (update && !budgetsPath) {
+        fprintf(stderr, "--update requires --budgets\n");
+        return EXIT_FAILURE;
+    }
+
+    map<string, Budget> budgets;
+    if (budgetsPath && !update && !readBudgets(*budgetsPath, budgets))
+        return EXIT_FAILURE;
+
+    vector<pair<string, Bench::AllocationCounters>> results;
+    bool failed = false;
+    printf("%-32s %12s %12s %12s %12s\n", "operation", "allocations", "budget", "bytes", "budget");
+    for (auto & operation: operations()) {
+        if (operation.setup)
+            operation.setup();
+        //the first run pays for one-time initialization such as locale and static data
+        operation.run();
+        auto before = Bench::allocationCounters();
+        operation.run();
+        auto counts = Bench::allocationCounters() - before;
+        results.emplace_back(operation.name, counts);
+
+        auto it = budgets.find(operation.name);
+        if (it == budgets.end()) {
+            printf("%-32s %12zu %12s %12zu %12s\n", operation.name, counts.allocations, "-", counts.bytes, "-");
+            if (budgetsPath && !update) {
+                fprintf(stderr, "error: no budget for %s\n", operation.name);
+                failed = true;
+            }
+            continue;
+        }
+        auto & budget = it->second;
+        printf("%-32s %12zu %12zu %12zu %12zu\n", operation.name, counts.allocations, budget.allocations, counts.bytes, budget.bytes);
+        if (exceeds(counts, budget)) {
+            fprintf(stderr, "error: %s exceeds its allocation budget\n", operation.name);
+            failed = true;
+        }
+    }
+    error_code ec;
+    filesystem::remove(responseFile(), ec);
+
+    if (update)
+        return writeBudgets(*budgetsPath, results) ? EXIT_SUCCESS : EXIT_FAILURE;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,304 @@
+//End-to-end benchmarks of generated command line interfaces.
+//
+//This file is built twice: against inc/argum and, with ARGUM_BENCH_SINGLE_FILE defined,
+//against the amalgamated single-file/argum.h
+
+#include "bench.h"
+
+#ifdef ARGUM_BENCH_SINGLE_FILE
+    #include <argum.h>
+#else
+    #include <argum/parser.h>
+#endif
+
+#include <memory>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+
+    //Generated definition of a command line interface. It only holds data so that
+    //generating names and help texts is not measured as part of parser construction.
+
+    enum class OptionKind {
+        flag,
+        requiredArgument,
+        optionalArgument
+    };
+
+    struct OptionSpec {
+        vector<string> names;
+        OptionKind kind;
+        string help;
+    };
+
+    struct CommandSpec {
+        string name;
+        vector<OptionSpec> options;
+    };
+
+    struct CliSpec {
+        vector<OptionSpec> options;
+        vector<CommandSpec> commands;
+    };
+
+    constexpr size_t subCommandCount = 8;
+    constexpr char shortNames[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    constexpr size_t shortNameCount = sizeof(shortNames) - 1;
+
+    //Every 10th option has an alias. With short names the first 52 options also have
+    //a single letter one.
+    auto generateOptions(size_t count, const string & prefix, bool withShortNames) -> vector<OptionSpec> {
+        static const char * const helpWords[] = {
+            "controls", "how", "input", "files", "are", "processed", "when", "multiple",
+            "configuration", "sources", "specify", "conflicting", "values"
+        };
+        constexpr size_t helpWordCount = sizeof(helpWords) / sizeof(helpWords[0]);
+
+        vector<OptionSpec> ret;
+        ret.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            OptionSpec spec{{"--" + prefix + "-" + to_string(i) + "-name"}, OptionKind(i % 3), prefix + ' ' + to_string(i)};
+            if (withShortNames && i < shortNameCount)
+                spec.names.push_back(string{'-', shortNames[i]});
+            if (i % 10 == 0)
+                spec.names.push_back("--" + prefix.substr(0, 3) + to_string(i));
+            for (size_t j = 0; j < 5 + i % 20; ++j)
+                (spec.help += ' ') += helpWords[(i + j * 7) % helpWordCount];
+            ret.push_back(std::move(spec));
+        }
+        return ret;
+    }
+
+    //Without sub-commands all options are global. With them half of the options are
+    //global and the rest is spread over the sub-commands. Sub-command options have distinct
+    //names and no short names so that the global parser stops at them.
+    auto generateCli(size_t optionCount, bool withSubCommands) -> CliSpec {
+        CliSpec ret;
+        if (!withSubCommands) {
+            ret.options = generateOptions(optionCount, "option", true);
+            return ret;
+        }
+        ret.options = generateOptions(max(optionCount / 2, size_t(1)), "option", true);
+        for (size_t i = 0; i < subCommandCount; ++i) {
+            ret.commands.push_back({"command-" + to_string(i),
+                                    generateOptions(max(optionCount / 2 / subCommandCount, size_t(1)), "sub", false)});
+        }
+        return ret;
+    }
+
+    //Arguments exercising option i: exact, abbreviated, aliased and short names,
+    //attached and separate values
+    auto appendOptionArgs(const vector<OptionSpec> & options, size_t i, size_t variant, vector<string> & dest) {
+        auto & spec = options[i];
+        auto & name = spec.names.front();
+        bool hasShort = (spec.names.size() > 1 && spec.names[1].size() == 2);
+        switch(spec.kind) {
+            case OptionKind::flag:
+                switch (variant % 3) {
+                    case 0: dest.push_back(name); break;
+                    case 1: dest.push_back(name.substr(0, name.size() - 2)); break;
+                    case 2: dest.push_back(spec.names[hasShort ? 1 : 0]); break;
+                }
+                break;
+            case OptionKind::requiredArgument:
+                switch (variant % 3) {
+                    case 0: dest.push_back(name + "=value"); break;
+                    case 1: dest.push_back(name); dest.push_back("value"); break;
+                    //letters of an attached value would be taken for other short options
+                    case 2: dest.push_back(hasShort ? spec.names[1] + "42" : name + "=value"); break;
+                }
+                break;
+            case OptionKind::optionalArgument:
+                switch (variant % 3) {
+                    case 0: dest.push_back(name); break;
+                    case 1: dest.push_back(name + "=value"); break;
+                    case 2: dest.push_back(spec.names.back()); break;
+                }
+                break;
+        }
+    }
+
+    //A representative command line: 24 options and a few positionals
+    auto generateArgs(const CliSpec & cli) -> vector<string> {
+        vector<string> ret;
+        for (size_t i = 0; i < 16; ++i)
+            appendOptionArgs(cli.options, (i * 7919) % cli.options.size(), i, ret);
+        if (!cli.commands.empty()) {
+            auto & command = cli.commands[cli.commands.size() / 2];
+            ret.push_back(command.name);
+            for (size_t i = 0; i < 8; ++i)
+                appendOptionArgs(command.options, (i * 7919) % command.options.size(), i, ret);
+        } else {
+            for (size_t i = 16; i < 24; ++i)
+                appendOptionArgs(cli.options, (i * 7919) % cli.options.size(), i, ret);
+        }
+        for (size_t i = 0; i < 4; ++i)
+            ret.push_back("file-" + to_string(i));
+        return ret;
+    }
+
+    //Values received by the handlers
+    struct Results {
+        size_t flags = 0;
+        size_t valuesSize = 0;
+        size_t files = 0;
+        size_t command = 0;
+    };
+
+    //generated options have at most 3 names
+    auto makeNames(const vector<string> & names) -> OptionNames {
+        switch (names.size()) {
+            case 1:  return OptionNames(names[0]);
+            case 2:  return OptionNames(names[0], names[1]);
+            default: return OptionNames(names[0], names[1], names[2]);
+        }
+    }
+
+    auto addOptions(Parser & parser, const vector<OptionSpec> & options, Results & results) {
+        for (auto & spec: options) {
+            Option option(makeNames(spec.names));
+            option.help(spec.help).occurs(zeroOrMoreTimes);
+            switch(spec.kind) {
+                case OptionKind::flag:
+                    option.handler([&results]() { ++results.flags; });
+                    break;
+                case OptionKind::requiredArgument:
+                    option.argName("VALUE").handler([&results](string_view value) { results.valuesSize += value.size(); });
+                    break;
+                case OptionKind::optionalArgument:
+                    //otherwise the next positional would be taken as the argument
+                    option.argName("VALUE").requireAttachedArgument(true).handler([&results](optional<string_view> value) {
+                        results.valuesSize += value ? value->size() : 0;
+                    });
+                    break;
+            }
+            parser.add(std::move(option));
+        }
+    }
+
+    auto addFiles(Parser & parser, Results & results) {
+        parser.add(Positional("file").
+                   help("files to process").
+                   occurs(zeroOrMoreTimes).
+                   handler([&results](string_view) { ++results.files; }));
+    }
+
+    //Parsers built from a specification, as a program would do on startup
+    struct Cli {
+        Cli(const CliSpec & spec) {
+            addOptions(parser, spec.options, results);
+            if (spec.commands.empty()) {
+                addFiles(parser, results);
+                return;
+            }
+            parser.addSubCommand(Positional("command").
+                                 help("command to run").
+                                 handler([this, &spec](string_view value) {
+                for (size_t i = 0; i < spec.commands.size(); ++i) {
+                    if (spec.commands[i].name == value) {
+                        results.command = i;
+                        return;
+                    }
+                }
+                throw Parser::ValidationError("unknown command");
+            }));
+            commands.reserve(spec.commands.size());
+            for (auto & commandSpec: spec.commands) {
+                auto & command = commands.emplace_back(make_unique<Parser>());
+                addOptions(*command, commandSpec.options, results);
+                addFiles(*command, results);
+            }
+        }
+
+        auto parse(const vector<string> & args) -> void {
+            if (commands.empty()) {
+                parser.parse(args);
+                return;
+            }
+            auto rest = parser.parseUntilUnknown(args);
+            commands[results.command]->parse(rest);
+        }
+
+        Parser parser;
+        vector<unique_ptr<Parser>> commands;
+        Results results;
+    };
+
+    //Parsing failure handled the way a program reports it: message followed by usage
+    auto reportError(Cli & cli, const vector<string> & args) -> size_t {
+        try {
+            cli.parse(args);
+        } catch (ParsingException & ex) {
+            return ex.message().size() + cli.parser.formatUsage("prog").size();
+        }
+        fprintf(stderr, "error case did not fail\n");
+        abort();
+    }
+
+    const vector<size_t> cliSizes = {10, 100, 1000, 10000};
+
+    template<class Func>
+    auto forBothShapes(const char * name, Func func) -> void {
+        Bench::registry().push_back({string("cli/") + name, cliSizes, [func](Bench::Runner & runner, size_t size) {
+            return func(runner, generateCli(size, false));
+        }});
+        Bench::registry().push_back({string("cli-subcommands/") + name, cliSizes, [func](Bench::Runner & runner, size_t size) {
+            return func(runner, generateCli(size, true));
+        }});
+    }
+
+    [[maybe_unused]] const bool registered = []() {
+
+        forBothShapes("construct", [](Bench::Runner & runner, const CliSpec & spec) {
+            return runner.run([&]() {
+                Cli cli(spec);
+                return cli.commands.size();
+            });
+        });
+
+        forBothShapes("parse", [](Bench::Runner & runner, const CliSpec & spec) {
+            Cli cli(spec);
+            auto args = generateArgs(spec);
+            return runner.run([&]() {
+                cli.parse(args);
+                return cli.results.flags;
+            });
+        });
+
+        //construction followed by parsing: what a program does on every start
+        forBothShapes("startup", [](Bench::Runner & runner, const CliSpec & spec) {
+            auto args = generateArgs(spec);
+            return runner.run([&]() {
+                Cli cli(spec);
+                cli.parse(args);
+                return cli.results.flags;
+            });
+        });
+
+        forBothShapes("help", [](Bench::Runner & runner, const CliSpec & spec) {
+            Cli cli(spec);
+            return runner.run([&]() {
+                return cli.parser.formatHelp("prog").size();
+            });
+        });
+
+        forBothShapes("error-unknown-option", [](Bench::Runner & runner, const CliSpec & spec) {
+            Cli cli(spec);
+            auto args = generateArgs(spec);
+            args.insert(args.begin() + 8, "--no-such-option");
+            return runner.run([&]() { return reportError(cli, args); });
+        });
+
+        //"--option-" is a prefix of the names of all options
+        forBothShapes("error-ambiguous-option", [](Bench::Runner & runner, const CliSpec & spec) {
+            Cli cli(spec);
+            auto args = generateArgs(spec);
+            args.insert(args.begin() + 8, "--option-");
+            return runner.run([&]() { return reportError(cli, args); });
+        });
+
+        return true;
+    }();
+}
@@ -0,0 +1,79 @@
+#include "bench.h"
+
+#include <argum/flat-map.h>
+#include <argum/partitioner.h>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+
+    auto keyName(size_t i) -> string {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "option-%06zu", i);
+        return buf;
+    }
+
+    auto makeMap(size_t size) -> FlatMap<string, unsigned> {
+        FlatMap<string, unsigned> map;
+        for (size_t i = 0; i < size; ++i)
+            map.add(keyName(i), unsigned(i));
+        return map;
+    }
+
+    //hits in pseudo-random order interleaved with misses
+    auto makeQueries(size_t size) -> vector<string> {
+        vector<string> ret;
+        for (size_t i = 0; i < 256; ++i)
+            ret.push_back(i % 4 == 3 ? keyName(i) + "-missing" : keyName((i * 7919) % size));
+        return ret;
+    }
+}
+
+BENCHMARK("FlatMap::find", {10, 100, 10000}, [](Bench::Runner & runner, size_t size) {
+    auto map = makeMap(size);
+    auto queries = makeQueries(size);
+    size_t current = 0;
+    return runner.run([&]() {
+        auto & query = queries[current++ % queries.size()];
+        return map.find(string_view(query)) != map.end();
+    });
+});
+
+BENCHMARK("findMatchOrMatchingPrefixRange", {10, 100, 10000}, [](Bench::Runner & runner, size_t size) {
+    auto map = makeMap(size);
+    //exact matches, prefixes of runs of different lengths and misses
+    vector<string> queries;
+    for (size_t i = 0; i < 256; ++i) {
+        auto key = keyName((i * 7919) % size);
+        switch (i % 4) {
+            case 0: queries.push_back(key); break;
+            case 1: queries.push_back(key.substr(0, key.size() - 1)); break;
+            case 2: queries.push_back(key.substr(0, key.size() - 2)); break;
+            case 3: queries.push_back(key + "-missing"); break;
+        }
+    }
+    size_t current = 0;
+    return runner.run([&]() {
+        auto & query = queries[current++ % queries.size()];
+        auto [first, last] = findMatchOrMatchingPrefixRange(map, string_view(query));
+        return last - first;
+    });
+});
+
+BENCHMARK("Partitioner::partition", {4, 32, 256}, [](Bench::Runner & runner, size_t size) {
+    Partitioner<unsigned> partitioner;
+    for (size_t i = 0; i < size; ++i) {
+        switch (i % 4) {
+            case 0: partitioner.addRange(1, 1); break;
+            case 1: partitioner.addRange(0, 1); break;
+            case 2: partitioner.addRange(0, Partitioner<unsigned>::infinity); break;
+            case 3: partitioner.addRange(2, 5); break;
+        }
+    }
+    auto n = unsigned(partitioner.minimumSequenceSize() + size);
+    return runner.run([&]() {
+        auto res = partitioner.partition(n);
+        return res->size();
+    });
+});
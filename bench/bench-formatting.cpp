@@ -0,0 +1,51 @@
+#include "bench.h"
+
+#include <argum/formatting.h>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+    //help-like text of size words
+    auto makeText(size_t size) -> string {
+        static const char * const words[] = {
+            "the", "option", "controls", "how", "input", "files", "are", "processed", "when", 
+            "multiple", "configuration", "sources", "specify", "conflicting", "values,", "see", "also"
+        };
+        string ret;
+        for (size_t i = 0; i < size; ++i) {
+            if (i)
+                ret += ' ';
+            ret += words[(i * 7) % size_t(std::size(words))];
+        }
+        return ret;
+    }
+}
+
+//size is the number of characters
+BENCHMARK("stringWidth/ascii", {16, 256, 4096}, [](Bench::Runner & runner, size_t size) {
+    auto text = makeText(size).substr(0, size);
+    text.resize(size, 'x');
+    return runner.run([&]() {
+        Bench::doNotOptimize(text);
+        return stringWidth(string_view(text));
+    });
+});
+
+BENCHMARK("stringWidth/wide-mixed", {16, 256, 4096}, [](Bench::Runner & runner, size_t size) {
+    wstring text;
+    static const wchar_t sample[] = L"option オプション café é \U0001F600 ";
+    while (text.size() < size)
+        text += sample;
+    text.resize(size);
+    return runner.run([&]() {
+        Bench::doNotOptimize(text);
+        return stringWidth(wstring_view(text));
+    });
+});
+
+//size is the number of words, wrapped at 80 columns with indent
+BENCHMARK("wordWrap", {10, 100, 1000}, [](Bench::Runner & runner, size_t size) {
+    auto text = makeText(size);
+    return runner.run([&]() { return wordWrap(text, 80, 24, 4).size(); });
+});
@@ -0,0 +1,279 @@
+//Compares BasicParser with getopt_long and a hand-written parser on the same option set.
+//
+//Each parser records the same results, which are checked to be equal before measuring.
+//The reported ratios are the time of BasicParser relative to the other two.
+
+#include "bench.h"
+
+#include <argum/parser.h>
+
+#include <getopt.h>
+#include <locale.h>
+#include <string.h>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+
+    //What every parser extracts from the command line
+    struct Results {
+        unsigned verbose = 0;
+        unsigned quiet = 0;
+        unsigned extract = 0;
+        unsigned noColor = 0;
+        unsigned compress = 0;
+        size_t valuesSize = 0;
+        size_t files = 0;
+
+        friend auto operator==(const Results &, const Results &) -> bool = default;
+    };
+
+    //Short clusters, long options with '=' and separate arguments, abbreviations,
+    //optional arguments and positionals
+    auto makeCommandLine(size_t size) -> vector<string> {
+        static const vector<vector<string>> groups = {
+            {"-vqx"},
+            {"--output=out.txt"},
+            {"--lev", "5"},
+            {"-DNAME=1"},
+            {"--compress"},
+            {"file.txt"},
+            {"--compress=gzip"},
+            {"--no-color"},
+            {"-o", "other.txt"},
+            {"--thr=4"},
+            {"-cbzip2"},
+            {"--define", "OTHER=2"},
+            {"--verb"}
+        };
+        vector<string> ret = {"prog"};
+        for (size_t i = 0; ret.size() - 1 < size; ++i) {
+            auto & group = groups[i % groups.size()];
+            ret.insert(ret.end(), group.begin(), group.end());
+        }
+        return ret;
+    }
+
+    auto makeArgv(vector<string> & args) -> vector<char *> {
+        vector<char *> ret;
+        for (auto & arg: args)
+            ret.push_back(arg.data());
+        ret.push_back(nullptr);
+        return ret;
+    }
+
+    //getopt_long
+
+    constexpr const char * getoptShortOptions = "vqxo:l:c::D:";
+    enum { noColorOption = 256, threadsOption };
+    const struct option getoptLongOptions[] = {
+        {"verbose",  no_argument,       nullptr, 'v'},
+        {"quiet",    no_argument,       nullptr, 'q'},
+        {"extract",  no_argument,       nullptr, 'x'},
+        {"output",   required_argument, nullptr, 'o'},
+        {"level",    required_argument, nullptr, 'l'},
+        {"compress", optional_argument, nullptr, 'c'},
+        {"define",   required_argument, nullptr, 'D'},
+        {"no-color", no_argument,       nullptr, noColorOption},
+        {"threads",  required_argument, nullptr, threadsOption},
+        {nullptr,    0,                 nullptr, 0}
+    };
+
+    //argv is permuted by getopt_long so it is restored from source on each call
+    auto parseWithGetopt(const vector<char *> & source, vector<char *> & argv) -> Results {
+        Results ret;
+        copy(source.begin(), source.end(), argv.begin());
+        int argc = int(source.size() - 1);
+        //0 rather than 1 makes glibc reinitialize its internal state
+        optind = 0;
+        opterr = 0;
+        for (int c; (c = getopt_long(argc, argv.data(), getoptShortOptions, getoptLongOptions, nullptr)) != -1; ) {
+            switch(c) {
+                case 'v': ++ret.verbose; break;
+                case 'q': ++ret.quiet; break;
+                case 'x': ++ret.extract; break;
+                case noColorOption: ++ret.noColor; break;
+                case 'c':
+                    ++ret.compress;
+                    ret.valuesSize += optarg ? strlen(optarg) : 0;
+                    break;
+                case 'o': case 'l': case 'D': case threadsOption:
+                    ret.valuesSize += strlen(optarg);
+                    break;
+                default:
+                    fprintf(stderr, "getopt_long failed\n");
+                    abort();
+            }
+        }
+        ret.files = size_t(argc - optind);
+        return ret;
+    }
+
+    //BasicParser
+
+    struct ArgumCli {
+        Results results;
+        Parser parser;
+
+        ArgumCli() {
+            auto flag = [&](unsigned Results::*member, auto && ...names) {
+                parser.add(Option(names...).occurs(zeroOrMoreTimes).handler([this, member]() {
+                    ++(results.*member);
+                }));
+            };
+            auto value = [&](auto && ...names) {
+                parser.add(Option(names...).occurs(zeroOrMoreTimes).handler([this](string_view val) {
+                    results.valuesSize += val.size();
+                }));
+            };
+            flag(&Results::verbose, "-v", "--verbose");
+            flag(&Results::quiet, "-q", "--quiet");
+            flag(&Results::extract, "-x", "--extract");
+            flag(&Results::noColor, "--no-color");
+            value("-o", "--output");
+            value("-l", "--level");
+            value("-D", "--define");
+            value("--threads");
+            parser.add(Option("-c", "--compress").
+                       occurs(zeroOrMoreTimes).
+                       requireAttachedArgument(true).
+                       handler([this](optional<string_view> val) {
+                ++results.compress;
+                results.valuesSize += val ? val->size() : 0;
+            }));
+            parser.add(Positional("file").occurs(zeroOrMoreTimes).handler([this](string_view) {
+                ++results.files;
+            }));
+        }
+
+        auto parse(const vector<char *> & argv) -> Results {
+            results = {};
+            parser.parse(int(argv.size() - 1), const_cast<char **>(argv.data()));
+            return results;
+        }
+    };
+
+    //Hand-written parser for this option set only. It is a lower bound of what any
+    //general purpose parser can achieve.
+
+    auto parseByHand(const vector<char *> & argv) -> Results {
+        Results ret;
+        auto requireValue = [&](size_t & idx, const char * attached) -> const char * {
+            if (attached)
+                return attached;
+            if (++idx == argv.size() - 1) {
+                fprintf(stderr, "missing argument\n");
+                abort();
+            }
+            return argv[idx];
+        };
+
+        for (size_t i = 1; i < argv.size() - 1; ++i) {
+            const char * arg = argv[i];
+            if (arg[0] != '-' || arg[1] == 0) {
+                ++ret.files;
+                continue;
+            }
+            if (arg[1] == '-') {
+                const char * name = arg + 2;
+                const char * eq = strchr(name, '=');
+                size_t nameLen = eq ? size_t(eq - name) : strlen(name);
+                const struct option * match = nullptr;
+                for (auto opt = getoptLongOptions; opt->name; ++opt) {
+                    if (strncmp(opt->name, name, nameLen) != 0)
+                        continue;
+                    if (opt->name[nameLen] == 0) {
+                        match = opt;
+                        break;
+                    }
+                    if (match) {
+                        fprintf(stderr, "ambiguous option\n");
+                        abort();
+                    }
+                    match = opt;
+                }
+                if (!match) {
+                    fprintf(stderr, "unknown option\n");
+                    abort();
+                }
+                const char * attached = eq ? eq + 1 : nullptr;
+                switch(match->val) {
+                    case 'v': ++ret.verbose; break;
+                    case 'q': ++ret.quiet; break;
+                    case 'x': ++ret.extract; break;
+                    case noColorOption: ++ret.noColor; break;
+                    case 'c':
+                        ++ret.compress;
+                        ret.valuesSize += attached ? strlen(attached) : 0;
+                        break;
+                    default:
+                        ret.valuesSize += strlen(requireValue(i, attached));
+                }
+                continue;
+            }
+            for (const char * current = arg + 1; *current; ++current) {
+                switch(*current) {
+                    case 'v': ++ret.verbose; continue;
+                    case 'q': ++ret.quiet; continue;
+                    case 'x': ++ret.extract; continue;
+                    case 'c':
+                        ++ret.compress;
+                        ret.valuesSize += strlen(current + 1);
+                        break;
+                    case 'o': case 'l': case 'D':
+                        ret.valuesSize += strlen(requireValue(i, current[1] ? current + 1 : nullptr));
+                        break;
+                    default:
+                        fprintf(stderr, "unknown option\n");
+                        abort();
+                }
+                break;
+            }
+        }
+        return ret;
+    }
+
+    auto printRow(const char * name, size_t size, const Bench::Statistics & stats, double baseline) {
+        printf("%-16s %8zu %12.1f %8.2f%% %12.2fx\n", name, size, stats.median,
+               stats.mean > 0 ? stats.stddev * 100 / stats.mean : 0, stats.median / baseline);
+    }
+}
+
+int main(int argc, char * argv[]) {
+    Bench::Settings settings;
+    settings.sizes = {8, 64, 512};
+    if (!Bench::parseCommandLine(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    setlocale(LC_ALL, "en_US.UTF-8");
+
+    Bench::warnIfUnoptimized();
+    Bench::Runner runner(settings);
+    ArgumCli argum;
+
+    printf("%-16s %8s %12s %9s %13s\n", "parser", "args", "median ns", "stddev", "vs getopt");
+    for (auto size: settings.sizes) {
+        auto args = makeCommandLine(size);
+        auto source = makeArgv(args);
+        auto scratch = source;
+
+        auto expected = parseWithGetopt(source, scratch);
+        if (argum.parse(source) != expected || parseByHand(source) != expected) {
+            fprintf(stderr, "parsers disagree on the results\n");
+            return EXIT_FAILURE;
+        }
+
+        auto getoptStats = runner.run([&]() { return parseWithGetopt(source, scratch).files; });
+        auto argumStats = runner.run([&]() { return argum.parse(source).files; });
+        auto handStats = runner.run([&]() { return parseByHand(source).files; });
+
+        printRow("getopt_long", size, getoptStats, getoptStats.median);
+        printRow("BasicParser", size, argumStats, getoptStats.median);
+        printRow("hand-written", size, handStats, getoptStats.median);
+        printf("%-16s %8zu BasicParser is %.2fx getopt_long and %.2fx hand-written\n\n", "ratio", size,
+               argumStats.median / getoptStats.median, argumStats.median / handStats.median);
+        fflush(stdout);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+#include "bench.h"
+
+#include <argum/command-line.h>
+#include <argum/quoting-splitter.h>
+
+#include <filesystem>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+    //one argument per line
+    auto makeLines(size_t size) -> string {
+        string ret;
+        ret.reserve(size + 32);
+        for (size_t i = 0; ret.size() < size; ++i)
+            ret += "--argument-" + to_string(i) + "\n";
+        return ret;
+    }
+
+    //several arguments per line, some of them quoted or escaped
+    auto makeQuoted(size_t size) -> string {
+        string ret;
+        ret.reserve(size + 64);
+        for (size_t i = 0; ret.size() < size; ++i)
+            ret += "-DNAME" + to_string(i) + "=\"value with spaces\" 'single quoted' plain escaped\\ space\n";
+        return ret;
+    }
+
+    //the minimal quote and escape handling a user would write without the quoting splitter
+    void handWrittenSplit(string && line, auto dest) {
+        string current;
+        bool inArgument = false;
+        char quote = 0;
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (quote) {
+                if (c == quote)
+                    quote = 0;
+                else
+                    current += c;
+            } else if (c == '\'' || c == '"') {
+                quote = c;
+                inArgument = true;
+            } else if (c == '\\' && i + 1 < line.size()) {
+                current += line[++i];
+                inArgument = true;
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                if (inArgument)
+                    *dest = std::move(current);
+                current.clear();
+                inArgument = false;
+            } else {
+                current += c;
+                inArgument = true;
+            }
+        }
+        if (inArgument)
+            *dest = std::move(current);
+    }
+
+    //writes the content to a temporary file and measures the operation on a response file argument for it
+    template<class Op>
+    auto runOnFile(Bench::Runner & runner, const string & content, Op op) -> Bench::Statistics {
+        auto path = filesystem::temp_directory_path() / "argum-bench-response.txt";
+        FILE * fp = fopen(path.string().c_str(), "wb");
+        if (!fp) {
+            fprintf(stderr, "unable to create %s\n", path.string().c_str());
+            exit(EXIT_FAILURE);
+        }
+        fwrite(content.data(), 1, content.size(), fp);
+        fclose(fp);
+        auto arg = "@" + path.string();
+        const char * argv[] = {arg.c_str()};
+        auto ret = runner.run([&]() { return op(std::span(argv)); });
+        filesystem::remove(path);
+        return ret;
+    }
+
+    const vector<size_t> fileSizes = {10 * 1024 * 1024};
+    ResponseFileReader reader('@');
+    const QuotingSplitter shellSplitter;
+    const QuotingSplitter gccSplitter(QuotingSplitter::Syntax::gcc);
+}
+
+//size is the response file size in bytes
+BENCHMARK("responseFile/expand/lines/default", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeLines(size), [](auto args) {
+        return reader.expand(args).size();
+    });
+});
+
+BENCHMARK("responseFile/expand/lines/shell", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeLines(size), [](auto args) {
+        return reader.expand(args, shellSplitter).size();
+    });
+});
+
+BENCHMARK("responseFile/expand/quoted/hand-written", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeQuoted(size), [](auto args) {
+        return reader.expand(args, [](string && line, auto dest) {
+            handWrittenSplit(std::move(line), dest);
+        }).size();
+    });
+});
+
+BENCHMARK("responseFile/expand/quoted/shell", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeQuoted(size), [](auto args) {
+        return reader.expand(args, shellSplitter).size();
+    });
+});
+
+BENCHMARK("responseFile/expand/quoted/gcc", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeQuoted(size), [](auto args) {
+        return reader.expand(args, gccSplitter).size();
+    });
+});
+
+BENCHMARK("responseFile/expandMapped/lines/default", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeLines(size), [](auto args) {
+        return reader.expandMapped(args).size();
+    });
+});
+
+BENCHMARK("responseFile/expandMapped/lines/shell", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeLines(size), [](auto args) {
+        return reader.expandMapped(args, shellSplitter).size();
+    });
+});
+
+BENCHMARK("responseFile/expandMapped/quoted/shell", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeQuoted(size), [](auto args) {
+        return reader.expandMapped(args, shellSplitter).size();
+    });
+});
+
+BENCHMARK("responseFile/expandMapped/quoted/gcc", fileSizes, [](Bench::Runner & runner, size_t size) {
+    return runOnFile(runner, makeQuoted(size), [](auto args) {
+        return reader.expandMapped(args, gccSplitter).size();
+    });
+});
@@ -0,0 +1,76 @@
+#include "bench.h"
+
+#include <argum/tokenizer.h>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+
+    //size long options, the first 26 also have single letter short names
+    auto makeTokenizer(size_t size) -> Tokenizer {
+        Tokenizer tokenizer;
+        for (size_t i = 0; i < size; ++i) {
+            auto longName = "--option-" + to_string(i) + "-name";
+            if (i < 26)
+                tokenizer.add(OptionNames(string{'-', char('a' + i)}, longName));
+            else
+                tokenizer.add(OptionNames(longName));
+        }
+        return tokenizer;
+    }
+
+    //a mix of exact, uniquely abbreviated, valued long options, short option clusters and positionals
+    auto makeArgs(size_t optionCount, size_t argCount) -> vector<string> {
+        vector<string> ret;
+        ret.reserve(argCount);
+        for (size_t i = 0; ret.size() < argCount; ++i) {
+            auto idx = to_string((i * 7919) % optionCount);
+            switch (i % 5) {
+                case 0: ret.push_back("--option-" + idx + "-name"); break;
+                case 1: ret.push_back("--option-" + idx + "-name=value"); break;
+                case 2: ret.push_back(optionCount >= 3 ? "-abc" : "-a"); break;
+                case 3: ret.push_back("positional-" + idx); break;
+                case 4: ret.push_back("--option-" + idx + "-na"); break;
+            }
+        }
+        return ret;
+    }
+
+    auto tokenizeAll(const Tokenizer & tokenizer, const vector<string> & args) {
+        unsigned count = 0;
+        auto rest = tokenizer.tokenize(args.begin(), args.end(), [&](auto && token) {
+            Bench::doNotOptimize(token);
+            ++count;
+            return Tokenizer::Continue;
+        });
+        return count + unsigned(rest.size());
+    }
+}
+
+BENCHMARK("tokenize/mixed-options", {10, 100, 1000}, [](Bench::Runner & runner, size_t size) {
+    auto tokenizer = makeTokenizer(size);
+    auto args = makeArgs(size, size);
+    return runner.run([&]() { return tokenizeAll(tokenizer, args); });
+});
+
+BENCHMARK("tokenize/long-exact-64-args", {10, 100, 1000}, [](Bench::Runner & runner, size_t size) {
+    auto tokenizer = makeTokenizer(size);
+    vector<string> args;
+    for (size_t i = 0; i < 64; ++i)
+        args.push_back("--option-" + to_string((i * 7919) % size) + "-name");
+    return runner.run([&]() { return tokenizeAll(tokenizer, args); });
+});
+
+//findLongestPrefix is private so it is measured via plain arguments that do not start
+//with any prefix: each one is a single prefix lookup followed by an argument token
+BENCHMARK("tokenize/findLongestPrefix-64-plain-args", {2, 8, 32}, [](Bench::Runner & runner, size_t size) {
+    Tokenizer::Settings settings;
+    settings.addShortPrefix("-").addLongPrefix("--");
+    for (size_t i = 2; i < size; ++i)
+        settings.addLongPrefix("+" + to_string(i) + "+");
+    Tokenizer tokenizer(settings);
+    tokenizer.add(OptionNames("--option"));
+    vector<string> args(64, "plain-argument");
+    return runner.run([&]() { return tokenizeAll(tokenizer, args); });
+});
@@ -0,0 +1,36 @@
+#include "bench.h"
+
+#include <argum/type-parsers.h>
+
+using namespace Argum;
+using namespace std;
+
+//size is the number of digits
+BENCHMARK("parseIntegral<long long>", {1, 9, 18}, [](Bench::Runner & runner, size_t size) {
+    string value;
+    for (size_t i = 0; i < size; ++i)
+        value += char('1' + i % 9);
+    return runner.run([&]() {
+        Bench::doNotOptimize(value);
+        return parseIntegral<long long>(value);
+    });
+});
+
+BENCHMARK("parseIntegral<unsigned>/hex", {1, 4, 8}, [](Bench::Runner & runner, size_t size) {
+    string value = "0x";
+    for (size_t i = 0; i < size; ++i)
+        value += "1a2b3c4d"[i % 8];
+    return runner.run([&]() {
+        Bench::doNotOptimize(value);
+        return parseIntegral<unsigned>(value);
+    });
+});
+
+//size is the number of choices, the value matches the middle one
+BENCHMARK("ChoiceParser::parse", {2, 10, 50}, [](Bench::Runner & runner, size_t size) {
+    ChoiceParser parser;
+    for (size_t i = 0; i < size; ++i)
+        parser.addChoice("choice-" + to_string(i), "alias-" + to_string(i));
+    auto value = "CHOICE-" + to_string(size / 2);
+    return runner.run([&]() { return parser.parse(value); });
+});
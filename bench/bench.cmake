@@ -0,0 +1,185 @@
+#
+#  Copyright 2022 Eugene Gershnik
+#
+#  Use of this source code is governed by a BSD-style
+#  license that can be found in the LICENSE file or at
+#  https://github.com/gershnik/argum/blob/master/LICENSE
+#
+
+find_package(Threads REQUIRED)
+
+get_property(ARGUM_IS_MULTI_CONFIG GLOBAL PROPERTY GENERATOR_IS_MULTI_CONFIG)
+
+function(configure_bench name)
+
+    if (NOT DEFINED CMAKE_CXX_STANDARD)
+        set_property(TARGET ${name} PROPERTY CXX_STANDARD 20)
+        set_property(TARGET ${name} PROPERTY CXX_STANDARD_REQUIRED ON)
+    endif()
+
+    target_link_libraries(${name}
+        PRIVATE
+            Threads::Threads
+
+            $<$<PLATFORM_ID:Android>:log>
+    )
+
+    #benchmarks are meaningless without optimizations so enable them when no build type is given
+    if (NOT ARGUM_IS_MULTI_CONFIG AND NOT CMAKE_BUILD_TYPE)
+        target_compile_definitions(${name} PRIVATE NDEBUG)
+        target_compile_options(${name}
+            PRIVATE
+                $<$<CXX_COMPILER_ID:AppleClang,Clang,GNU>:-O2>
+                $<$<CXX_COMPILER_ID:MSVC>:/O2>
+        )
+    endif()
+
+    target_compile_options(${name}
+        PRIVATE
+            $<$<CXX_COMPILER_ID:AppleClang>:-Wall -Wextra -Wpedantic 
+                -Wno-gnu-zero-variadic-macro-arguments #Clang bug - this is not an issue in C++20
+            > 
+            $<$<CXX_COMPILER_ID:GNU>:-Wall -Wextra -Wpedantic
+                -Wno-unknown-pragmas
+            >
+            $<$<CXX_COMPILER_ID:MSVC>:/utf-8 /W4 /EHsc>
+    )
+
+    if ("${CMAKE_CXX_COMPILER_FRONTEND_VARIANT}" STREQUAL "MSVC")
+        target_compile_options(${name} PRIVATE $<$<CXX_COMPILER_ID:Clang>:/W4>)
+    else()
+        target_compile_options(${name} PRIVATE $<$<CXX_COMPILER_ID:Clang>:-Wall;-Wextra;-pedantic>)
+    endif()
+
+endfunction(configure_bench name)
+
+
+add_executable(bench EXCLUDE_FROM_ALL)
+configure_bench(bench)
+
+target_link_libraries(bench PRIVATE argum)
+
+target_sources(bench 
+    PRIVATE
+        bench/bench.h
+        bench/bench.cpp
+        bench/bench-tokenizer.cpp
+        bench/bench-containers.cpp
+        bench/bench-type-parsers.cpp
+        bench/bench-formatting.cpp
+        bench/bench-response-files.cpp
+)
+
+#end-to-end benchmarks of generated command lines against the headers in inc
+add_executable(bench-cli EXCLUDE_FROM_ALL)
+configure_bench(bench-cli)
+
+target_link_libraries(bench-cli PRIVATE argum)
+
+target_sources(bench-cli 
+    PRIVATE
+        bench/bench.h
+        bench/bench.cpp
+        bench/bench-cli.cpp
+)
+
+#and the same against the amalgamated header
+add_executable(bench-cli-single-file EXCLUDE_FROM_ALL)
+configure_bench(bench-cli-single-file)
+
+target_include_directories(bench-cli-single-file
+    PRIVATE
+        single-file
+)
+
+target_compile_definitions(bench-cli-single-file
+    PRIVATE
+        ARGUM_BENCH_SINGLE_FILE
+)
+
+target_sources(bench-cli-single-file 
+    PRIVATE
+        bench/bench.h
+        bench/bench.cpp
+        bench/bench-cli.cpp
+)
+
+if (TARGET amalgamate)
+    add_dependencies(bench-cli-single-file amalgamate)
+endif()
+
+#comparison with getopt_long where it is available
+include(CheckIncludeFileCXX)
+check_include_file_cxx(getopt.h ARGUM_HAS_GETOPT_H)
+if (ARGUM_HAS_GETOPT_H)
+    add_executable(bench-getopt EXCLUDE_FROM_ALL)
+    configure_bench(bench-getopt)
+
+    target_link_libraries(bench-getopt PRIVATE argum)
+
+    target_sources(bench-getopt 
+        PRIVATE
+            bench/bench.h
+            bench/bench-getopt.cpp
+    )
+endif()
+
+#offline search for inputs that are slow to parse relative to their size
+add_executable(bench-fuzz EXCLUDE_FROM_ALL)
+configure_bench(bench-fuzz)
+
+target_link_libraries(bench-fuzz PRIVATE argum)
+
+target_sources(bench-fuzz 
+    PRIVATE
+        bench/bench.h
+        bench/allocation-counter.h
+        bench/allocation-counter.cpp
+        bench/fuzz-parse.cpp
+)
+
+#the slowest inputs found so far measured as regression benchmarks
+add_custom_target(bench-fuzz-regressions
+    DEPENDS bench-fuzz
+    COMMAND bench-fuzz --replay ${CMAKE_CURRENT_LIST_DIR}/fuzz-cases
+)
+
+#the same as a libFuzzer target
+if (CMAKE_CXX_COMPILER_ID STREQUAL "Clang" AND NOT "${CMAKE_CXX_COMPILER_FRONTEND_VARIANT}" STREQUAL "MSVC")
+    add_executable(fuzz-parse EXCLUDE_FROM_ALL)
+    configure_bench(fuzz-parse)
+
+    target_link_libraries(fuzz-parse PRIVATE argum)
+    target_compile_definitions(fuzz-parse PRIVATE ARGUM_FUZZ_LIBFUZZER)
+    target_compile_options(fuzz-parse PRIVATE -fsanitize=fuzzer)
+    target_link_options(fuzz-parse PRIVATE -fsanitize=fuzzer)
+
+    target_sources(fuzz-parse 
+        PRIVATE
+            bench/fuzz-parse.cpp
+    )
+endif()
+
+#heap allocations of common operations checked against budgets
+add_executable(bench-allocations EXCLUDE_FROM_ALL)
+configure_bench(bench-allocations)
+
+target_link_libraries(bench-allocations PRIVATE argum)
+
+target_sources(bench-allocations 
+    PRIVATE
+        bench/allocation-counter.h
+        bench/allocation-counter.cpp
+        bench/allocations.cpp
+        bench/allocation-budgets.txt
+)
+
+add_custom_target(check-allocations
+    DEPENDS bench-allocations
+    COMMAND bench-allocations --budgets=${CMAKE_CURRENT_LIST_DIR}/allocation-budgets.txt
+)
+
+add_custom_target(update-allocation-budgets
+    DEPENDS bench-allocations
+    COMMAND bench-allocations --budgets=${CMAKE_CURRENT_LIST_DIR}/allocation-budgets.txt --update
+)
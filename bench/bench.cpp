@@ -0,0 +1,19 @@
+#include "bench.h"
+
+#include <locale.h>
+
+int main(int argc, char * argv[]) {
+    Bench::Settings settings;
+    if (!Bench::parseCommandLine(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    //same as the tests so that wide character width is measured for real
+    setlocale(LC_ALL, "en_US.UTF-8");
+
+    Bench::warnIfUnoptimized();
+    if (Bench::runAll(settings) == 0) {
+        fprintf(stderr, "no benchmarks match\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
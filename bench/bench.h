@@ -0,0 +1,225 @@
+#ifndef HEADER_BENCH_H_INCLUDED
+#define HEADER_BENCH_H_INCLUDED
+
+//Minimal self-contained benchmarking harness.
+//It deliberately does not include any Argum headers so that it can be used with both
+//inc/argum and the amalgamated single-file/argum.h
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace Bench {
+
+    //Prevents the compiler from optimizing away computation of the value
+    template<class T>
+    inline void doNotOptimize(const T & value) {
+    #if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+    #else
+        static const void * volatile sink;
+        sink = &value;
+    #endif
+    }
+
+    struct Statistics {
+        double median = 0;
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+    };
+
+    inline auto statisticsOf(std::vector<double> samples) -> Statistics {
+        Statistics ret;
+        if (samples.empty())
+            return ret;
+        std::sort(samples.begin(), samples.end());
+        auto count = samples.size();
+        ret.median = (count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2);
+        ret.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / double(count);
+        double variance = 0;
+        for (auto sample: samples)
+            variance += (sample - ret.mean) * (sample - ret.mean);
+        ret.stddev = (count > 1 ? sqrt(variance / double(count - 1)) : 0);
+        ret.min = samples.front();
+        return ret;
+    }
+
+    struct Settings {
+        std::string filter;
+        std::vector<size_t> sizes;
+        unsigned samples = 10;
+        std::chrono::nanoseconds minSampleTime = std::chrono::milliseconds(10);
+    };
+
+    /**
+     Measures a single operation.
+
+     The operation is repeated enough times for each sample to take at least
+     Settings::minSampleTime and the time per operation is reported for each sample.
+     */
+    class Runner {
+    public:
+        Runner(const Settings & settings): m_settings(settings) {
+        }
+
+        template<class Op>
+        auto run(Op && op) -> Statistics {
+            size_t iterations = 1;
+            for ( ; ; ) {
+                auto elapsed = time(op, iterations);
+                if (elapsed >= m_settings.minSampleTime || iterations >= (size_t(1) << 40))
+                    break;
+                //aim slightly above the minimum to avoid re-running on noise
+                auto factor = elapsed.count() > 0 ? double(m_settings.minSampleTime.count()) * 1.2 / double(elapsed.count()) : 10.0;
+                iterations = size_t(double(iterations) * std::clamp(factor, 1.5, 10.0));
+            }
+            std::vector<double> samples;
+            samples.reserve(m_settings.samples);
+            for (unsigned i = 0; i < m_settings.samples; ++i)
+                samples.push_back(double(time(op, iterations).count()) / double(iterations));
+            return statisticsOf(std::move(samples));
+        }
+
+    private:
+        template<class Op>
+        static auto time(Op & op, size_t iterations) -> std::chrono::nanoseconds {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                if constexpr (std::is_void_v<decltype(op())>)
+                    op();
+                else
+                    doNotOptimize(op());
+            }
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        }
+    private:
+        const Settings & m_settings;
+    };
+
+    //A benchmark builds its input for the given size and measures it using the runner
+    using BenchmarkFunc = std::function<Statistics (Runner & runner, size_t size)>;
+
+    struct Benchmark {
+        std::string name;
+        std::vector<size_t> sizes;
+        BenchmarkFunc func;
+    };
+
+    inline auto registry() -> std::vector<Benchmark> & {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    struct Registration {
+        Registration(std::string name, std::vector<size_t> sizes, BenchmarkFunc func) {
+            registry().push_back({std::move(name), std::move(sizes), std::move(func)});
+        }
+    };
+
+    inline auto printHeader() -> void {
+        printf("%-48s %8s %12s %12s %9s %12s\n", "benchmark", "size", "median ns/op", "mean ns/op", "stddev", "min ns/op");
+    }
+
+    inline auto printResult(std::string_view name, size_t size, const Statistics & stats) -> void {
+        double relative = stats.mean > 0 ? stats.stddev * 100 / stats.mean : 0;
+        printf("%-48.*s %8zu %12.1f %12.1f %8.2f%% %12.1f\n", int(name.size()), name.data(), size,
+               stats.median, stats.mean, relative, stats.min);
+        fflush(stdout);
+    }
+
+    //Runs all registered benchmarks matching the settings. Returns the number of benchmarks run.
+    inline auto runAll(const Settings & settings) -> unsigned {
+        Runner runner(settings);
+        unsigned count = 0;
+        printHeader();
+        for (auto & benchmark: registry()) {
+            if (!settings.filter.empty() && benchmark.name.find(settings.filter) == std::string::npos)
+                continue;
+            auto & sizes = settings.sizes.empty() ? benchmark.sizes : settings.sizes;
+            for (auto size: sizes) {
+                printResult(benchmark.name, size, benchmark.func(runner, size));
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    //Parses the common command line options. Returns false and prints usage on error.
+    inline auto parseCommandLine(int argc, char * argv[], Settings & settings) -> bool {
+        using namespace std::literals;
+
+        auto usage = [&]() {
+            fprintf(stderr, "usage: %s [--filter=TEXT] [--sizes=N,N,...] [--samples=N] [--min-time-ms=N]\n", argv[0]);
+            return false;
+        };
+        auto valueOf = [](std::string_view arg, std::string_view name, std::string_view & value) {
+            if (arg.substr(0, name.size()) != name)
+                return false;
+            value = arg.substr(name.size());
+            return true;
+        };
+        auto toNumber = [](std::string_view str, unsigned long long & value) {
+            if (str.empty())
+                return false;
+            value = 0;
+            for (char c: str) {
+                if (c < '0' || c > '9')
+                    return false;
+                value = value * 10 + unsigned(c - '0');
+            }
+            return true;
+        };
+
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i], value;
+            unsigned long long number;
+            if (valueOf(arg, "--filter="sv, value)) {
+                settings.filter = value;
+            } else if (valueOf(arg, "--sizes="sv, value)) {
+                settings.sizes.clear();
+                for (size_t pos = 0; pos <= value.size(); ) {
+                    auto end = std::min(value.find(',', pos), value.size());
+                    if (!toNumber(value.substr(pos, end - pos), number))
+                        return usage();
+                    settings.sizes.push_back(size_t(number));
+                    pos = end + 1;
+                }
+            } else if (valueOf(arg, "--samples="sv, value)) {
+                if (!toNumber(value, number) || number == 0)
+                    return usage();
+                settings.samples = unsigned(number);
+            } else if (valueOf(arg, "--min-time-ms="sv, value)) {
+                if (!toNumber(value, number))
+                    return usage();
+                settings.minSampleTime = std::chrono::milliseconds(number);
+            } else {
+                return usage();
+            }
+        }
+        return true;
+    }
+
+    inline auto warnIfUnoptimized() -> void {
+    #ifndef NDEBUG
+        fprintf(stderr, "warning: assertions are enabled, results are not representative\n");
+    #endif
+    }
+}
+
+#define BENCH_CONCAT1(a, b) a ## b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT1(a, b)
+#define BENCHMARK(name, ...) \
+    static ::Bench::Registration BENCH_CONCAT(benchRegistration, __LINE__)(name, __VA_ARGS__)
+
+#endif
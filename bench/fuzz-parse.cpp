@@ -0,0 +1,463 @@
+//Search for inputs that make parsing slow relative to their size.
+//
+//The input format is:
+//  byte 0      - line width for wrapping, 10 to 137
+//  byte 1      - bit 0 set: parse collecting all errors
+//  the rest    - command line arguments separated by '\n'
+//The parser below is set up to reach the paths that can be super-linear: positional counting
+//with several positionals, long short option clusters, several value delimiters, prefix
+//ambiguity among many long names and word wrapping of long unbreakable text.
+//
+//With ARGUM_FUZZ_LIBFUZZER defined this file only provides LLVMFuzzerTestOneInput. Use
+//libFuzzer's -report_slow_units and -timeout to find slow inputs.
+//
+//Otherwise it builds a standalone program that runs offline:
+//  bench-fuzz [--iterations=N] [--min-len=N] [--max-len=N] [--objective=time|allocations] [--save=N] [--out=DIR] [--seed=N] [CORPUS...]
+//      searches for inputs with the highest cost per byte, starting from built-in seeds and the
+//      files in CORPUS, and saves the slowest ones to DIR. Shorter inputs are grown to the minimum
+//      length by repeating their content since per byte cost of tiny inputs is all fixed overhead.
+//  bench-fuzz --replay [FILE|DIR...]
+//      measures saved inputs as regression benchmarks
+
+#include <argum/parser.h>
+#include <argum/formatting.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+#include <stddef.h>
+
+using namespace Argum;
+using namespace std;
+
+namespace {
+
+    auto makeFuzzParser(size_t & counter) -> Parser {
+        Parser::Settings settings;
+        settings.addLongPrefix("--")
+                .addShortPrefix("-")
+                .addOptionTerminator("--")
+                .addValueDelimiter('=')
+                .addValueDelimiter(':')
+                .addValueDelimiter(',');
+        Parser parser(settings);
+
+        //single letter flags for long clusters, a few with arguments
+        for (char c = 'a'; c <= 'z'; ++c) {
+            string shortName{'-', c};
+            string longName = string("--flag-") + c;
+            if (c == 'o' || c == 'p') {
+                parser.add(Option(shortName, longName).occurs(zeroOrMoreTimes).handler([&](string_view value) { counter += value.size(); }));
+            } else if (c >= 'x') {
+                parser.add(Option(shortName, longName).occurs(zeroOrMoreTimes).handler([&](optional<string_view>) { ++counter; }));
+            } else {
+                parser.add(Option(shortName, longName).occurs(zeroOrMoreTimes).handler([&]() { ++counter; }));
+            }
+        }
+        //multi letter short names sharing prefixes
+        for (auto name: {"-fo", "-foo", "-foobar", "-ba", "-bar"})
+            parser.add(Option(name).occurs(zeroOrMoreTimes).handler([&](optional<string_view>) { ++counter; }));
+        //many long names sharing prefixes
+        for (int i = 0; i < 128; ++i) {
+            parser.add(Option("--option-" + to_string(i)).
+                       occurs(zeroOrMoreTimes).
+                       handler([&](optional<string_view>) { ++counter; }));
+        }
+        parser.add(Positional("first").occurs(Quantifier(0, 3)).handler([&](string_view) { ++counter; }));
+        parser.add(Positional("second").occurs(Quantifier(1, 2)).handler([&](string_view) { ++counter; }));
+        parser.add(Positional("rest").occurs(zeroOrMoreTimes).handler([&](string_view) { ++counter; }));
+        return parser;
+    }
+
+    auto runOne(const uint8_t * data, size_t size) -> size_t {
+        static size_t counter = 0;
+        static const Parser parser = makeFuzzParser(counter);
+
+        if (size < 2)
+            return 0;
+        unsigned width = 10 + data[0] % 128;
+        bool collectErrors = (data[1] & 1);
+        string_view text(reinterpret_cast<const char *>(data + 2), size - 2);
+
+        vector<string_view> args;
+        for (size_t start = 0; start <= text.size(); ) {
+            auto end = min(text.find('\n', start), text.size());
+            args.push_back(text.substr(start, end - start));
+            start = end + 1;
+        }
+
+        size_t ret = 0;
+        if (collectErrors) {
+            for (auto & error: parser.parseCollectingErrors(args))
+                ret += error->message().size();
+        } else {
+        #ifdef ARGUM_USE_EXPECTED
+            if (auto res = parser.parse(args); !res)
+                ret += res.error()->message().size();
+        #else
+            try {
+                parser.parse(args);
+            } catch (ParsingException & ex) {
+                ret += ex.message().size();
+            }
+        #endif
+        }
+        ret += wordWrap(text, width, width / 4, width / 2).size();
+        return ret + counter;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size) {
+    (void)runOne(data, size);
+    return 0;
+}
+
+#ifndef ARGUM_FUZZ_LIBFUZZER
+
+#include "bench.h"
+#include "allocation-counter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <algorithm>
+
+#include <locale.h>
+
+namespace {
+
+    enum class Objective {
+        time,
+        allocations
+    };
+
+    struct Candidate {
+        string input;
+        double cost = 0;
+        double nsPerByte = 0;
+        double allocationsPerByte = 0;
+    };
+
+    auto inputOf(const string & input) -> pair<const uint8_t *, size_t> {
+        return {reinterpret_cast<const uint8_t *>(input.data()), input.size()};
+    }
+
+    //Time is the minimum of a few runs, each repeated until it is long enough to measure
+    auto measure(const string & input, Objective objective) -> Candidate {
+        auto [data, size] = inputOf(input);
+        auto before = Bench::allocationCounters();
+        Bench::doNotOptimize(runOne(data, size));
+        auto allocations = (Bench::allocationCounters() - before).allocations;
+
+        double bestNs = 0;
+        if (objective == Objective::time) {
+            size_t repeats = 1;
+            for (int attempt = 0; attempt < 3; ++attempt) {
+                for ( ; ; ) {
+                    auto start = chrono::steady_clock::now();
+                    for (size_t i = 0; i < repeats; ++i)
+                        Bench::doNotOptimize(runOne(data, size));
+                    auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+                    if (elapsed < 20'000 && repeats < 1'000'000) {
+                        repeats *= 4;
+                        continue;
+                    }
+                    auto ns = elapsed / double(repeats);
+                    bestNs = (attempt == 0 ? ns : min(bestNs, ns));
+                    break;
+                }
+            }
+        }
+
+        Candidate ret;
+        ret.input = input;
+        ret.nsPerByte = bestNs / double(size);
+        ret.allocationsPerByte = double(allocations) / double(size);
+        ret.cost = (objective == Objective::time ? ret.nsPerByte : ret.allocationsPerByte);
+        return ret;
+    }
+
+    auto builtInSeeds() -> vector<string> {
+        return {
+            string("\x50\x00", 2) + "-abc\n--option-1=x\nfile\nfile",
+            string("\x20\x01", 2) + "-abcdefghijklmnopqrstuvw\n--opt\n-foob\n--flag-x:1,2",
+            string("\x10\x00", 2) + "a b c d e f\nverylongwordwithoutspaces\n-o\nvalue\n--\n-x",
+            string("\x40\x00", 2) + "--option-\n-bar=1\n-xyz\none\ntwo\nthree\nfour\nfive"
+        };
+    }
+
+    //Mutations favour structure that stresses the parser: option prefixes, delimiters,
+    //repeated arguments and long runs of characters
+    class Mutator {
+    public:
+        Mutator(unsigned seed, size_t minLength, size_t maxLength): 
+            m_random(seed), 
+            m_minLength(minLength),
+            m_maxLength(maxLength) {
+        }
+
+        auto mutate(string input) -> string {
+            auto count = this->uniform(1, 4);
+            for (size_t i = 0; i < count; ++i)
+                this->mutateOnce(input);
+            return this->fit(std::move(input));
+        }
+
+        auto fit(string input) const -> string {
+            if (input.size() < 2)
+                input.resize(2, '\0');
+            const string content = input.substr(2);
+            while (input.size() < this->m_minLength)
+                (input += '\n') += content;
+            if (input.size() > this->m_maxLength)
+                input.resize(this->m_maxLength);
+            return input;
+        }
+
+    private:
+        auto uniform(size_t min, size_t max) -> size_t {
+            return uniform_int_distribution<size_t>(min, max)(this->m_random);
+        }
+
+        void mutateOnce(string & input) {
+            static const char * const tokens[] = {
+                "-", "--", "=", ":", ",", "\n", "\n--\n", "--option-", "--opt", "--flag-", "-fo", "-foo",
+                "-abcdefghijklmnopqrstuvwxyz", "-xyz", "-o", "\nfile\n", " ", "\x1b[1m"
+            };
+            //the header bytes are mutated separately
+            size_t pos = 2 + this->uniform(0, input.size() - 2);
+            switch (this->uniform(0, 6)) {
+                case 0: {
+                    input.insert(pos, tokens[this->uniform(0, size(tokens) - 1)]);
+                    break;
+                }
+                case 1: {
+                    input.insert(pos, this->uniform(1, 64), "ab-=:, \n"[this->uniform(0, 7)]);
+                    break;
+                }
+                case 2: {
+                    //duplicate a chunk, possibly many times
+                    size_t start = 2 + this->uniform(0, input.size() - 2);
+                    size_t length = this->uniform(0, input.size() - start);
+                    string chunk = input.substr(start, length);
+                    for (size_t i = this->uniform(1, 8); i > 0; --i)
+                        input.insert(pos, chunk);
+                    break;
+                }
+                case 3: {
+                    size_t length = this->uniform(0, input.size() - pos);
+                    input.erase(pos, min(length, size_t(16)));
+                    break;
+                }
+                case 4: {
+                    if (pos < input.size())
+                        input[pos] = char(this->uniform(0, 255));
+                    break;
+                }
+                case 5: {
+                    input[this->uniform(0, 1)] = char(this->uniform(0, 255));
+                    break;
+                }
+                case 6: {
+                    //a few copies of the last argument
+                    auto last = input.rfind('\n');
+                    string arg = (last == input.npos ? input.substr(2) : input.substr(last));
+                    if (last == input.npos)
+                        arg.insert(0, 1, '\n');
+                    for (size_t i = this->uniform(1, 16); i > 0; --i)
+                        input += arg;
+                    break;
+                }
+            }
+        }
+
+    private:
+        mt19937 m_random;
+        size_t m_minLength;
+        size_t m_maxLength;
+    };
+
+    auto readFile(const filesystem::path & path) -> string {
+        ifstream str(path, ios::binary);
+        return string(istreambuf_iterator<char>(str), istreambuf_iterator<char>());
+    }
+
+    auto collectFiles(const vector<string> & paths) -> vector<filesystem::path> {
+        vector<filesystem::path> ret;
+        for (auto & path: paths) {
+            if (filesystem::is_directory(path)) {
+                for (auto & entry: filesystem::directory_iterator(path)) {
+                    if (entry.is_regular_file())
+                        ret.push_back(entry.path());
+                }
+            } else {
+                ret.push_back(path);
+            }
+        }
+        sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+    auto replay(const vector<string> & paths, const Bench::Settings & settings) -> int {
+        auto files = collectFiles(paths);
+        if (files.empty()) {
+            fprintf(stderr, "no inputs to replay\n");
+            return EXIT_FAILURE;
+        }
+        Bench::Runner runner(settings);
+        printf("%-40s %8s %12s %9s %10s %12s\n", "input", "bytes", "median ns", "stddev", "ns/byte", "allocs/byte");
+        for (auto & file: files) {
+            auto input = readFile(file);
+            auto [data, size] = inputOf(input);
+            auto before = Bench::allocationCounters();
+            Bench::doNotOptimize(runOne(data, size));
+            auto allocations = (Bench::allocationCounters() - before).allocations;
+
+            auto stats = runner.run([&]() { return runOne(data, size); });
+            printf("%-40s %8zu %12.1f %8.2f%% %10.1f %12.2f\n", file.filename().string().c_str(), size, stats.median,
+                   stats.mean > 0 ? stats.stddev * 100 / stats.mean : 0, stats.median / double(max(size, size_t(1))),
+                   double(allocations) / double(max(size, size_t(1))));
+            fflush(stdout);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    struct SearchSettings {
+        size_t iterations = 2000;
+        size_t minLength = 256;
+        size_t maxLength = 4096;
+        size_t save = 8;
+        size_t poolSize = 32;
+        unsigned seed = 1;
+        Objective objective = Objective::time;
+        filesystem::path out = "fuzz-slowest";
+        vector<string> corpus;
+    };
+
+    auto search(const SearchSettings & settings) -> int {
+        vector<Candidate> pool;
+        auto add = [&](Candidate && candidate) {
+            pool.push_back(std::move(candidate));
+            sort(pool.begin(), pool.end(), [](const Candidate & lhs, const Candidate & rhs) { return lhs.cost > rhs.cost; });
+            if (pool.size() > settings.poolSize)
+                pool.pop_back();
+        };
+
+        Mutator mutator(settings.seed, settings.minLength, settings.maxLength);
+        for (auto & seed: builtInSeeds())
+            add(measure(mutator.fit(seed), settings.objective));
+        for (auto & file: collectFiles(settings.corpus))
+            add(measure(mutator.fit(readFile(file)), settings.objective));
+
+        mt19937 random(settings.seed);
+        for (size_t i = 0; i < settings.iterations; ++i) {
+            //prefer mutating the costliest inputs
+            auto parentIdx = min(uniform_int_distribution<size_t>(0, pool.size() - 1)(random),
+                                 uniform_int_distribution<size_t>(0, pool.size() - 1)(random));
+            auto candidate = measure(mutator.mutate(pool[parentIdx].input), settings.objective);
+            if (pool.size() < settings.poolSize || candidate.cost > pool.back().cost)
+                add(std::move(candidate));
+            if ((i + 1) % 500 == 0) {
+                fprintf(stderr, "%zu iterations, worst: %.1f ns/byte, %.2f allocs/byte, %zu bytes\n", i + 1,
+                        pool.front().nsPerByte, pool.front().allocationsPerByte, pool.front().input.size());
+            }
+        }
+
+        error_code ec;
+        filesystem::create_directories(settings.out, ec);
+        printf("%-24s %8s %10s %12s\n", "saved", "bytes", "ns/byte", "allocs/byte");
+        for (size_t i = 0; i < min(settings.save, pool.size()); ++i) {
+            auto name = "slow-" + to_string(i) + ".bin";
+            ofstream str(settings.out / name, ios::binary);
+            str.write(pool[i].input.data(), streamsize(pool[i].input.size()));
+            if (!str) {
+                fprintf(stderr, "cannot write %s\n", (settings.out / name).string().c_str());
+                return EXIT_FAILURE;
+            }
+            printf("%-24s %8zu %10.1f %12.2f\n", name.c_str(), pool[i].input.size(), pool[i].nsPerByte, pool[i].allocationsPerByte);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    auto parseNumber(string_view str, size_t & value) -> bool {
+        if (str.empty())
+            return false;
+        value = 0;
+        for (char c: str) {
+            if (c < '0' || c > '9')
+                return false;
+            value = value * 10 + size_t(c - '0');
+        }
+        return true;
+    }
+}
+
+int main(int argc, char * argv[]) {
+
+    SearchSettings settings;
+    bool replayMode = false;
+    auto usage = [&]() {
+        fprintf(stderr, "usage: %s [--iterations=N] [--min-len=N] [--max-len=N] [--objective=time|allocations] [--save=N] [--out=DIR] [--seed=N] [CORPUS...]\n"
+                        "       %s --replay [FILE|DIR...]\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    };
+    for (int i = 1; i < argc; ++i) {
+        string_view arg = argv[i];
+        auto valueOf = [&](string_view name, string_view & value) {
+            if (arg.substr(0, name.size()) != name)
+                return false;
+            value = arg.substr(name.size());
+            return true;
+        };
+        string_view value;
+        size_t number;
+        if (arg == "--replay") {
+            replayMode = true;
+        } else if (valueOf("--iterations=", value)) {
+            if (!parseNumber(value, settings.iterations))
+                return usage();
+        } else if (valueOf("--min-len=", value)) {
+            if (!parseNumber(value, settings.minLength))
+                return usage();
+        } else if (valueOf("--max-len=", value)) {
+            if (!parseNumber(value, settings.maxLength) || settings.maxLength < 3)
+                return usage();
+        } else if (valueOf("--save=", value)) {
+            if (!parseNumber(value, settings.save))
+                return usage();
+        } else if (valueOf("--seed=", value)) {
+            if (!parseNumber(value, number))
+                return usage();
+            settings.seed = unsigned(number);
+        } else if (valueOf("--out=", value)) {
+            settings.out = value;
+        } else if (valueOf("--objective=", value)) {
+            if (value == "time")
+                settings.objective = Objective::time;
+            else if (value == "allocations")
+                settings.objective = Objective::allocations;
+            else
+                return usage();
+        } else if (!arg.empty() && arg[0] == '-') {
+            return usage();
+        } else {
+            settings.corpus.emplace_back(arg);
+        }
+    }
+
+    setlocale(LC_ALL, "en_US.UTF-8");
+
+    if (settings.minLength > settings.maxLength)
+        return usage();
+
+    Bench::warnIfUnoptimized();
+    if (replayMode) {
+        Bench::Settings benchSettings;
+        return replay(settings.corpus, benchSettings);
+    }
+    return search(settings);
+}
+
+#endif
@@ -9,6 +9,8 @@
 #define HEADER_ARGUM_UBMRELLA_INCLUDED
 
 #include "parser.h"
+#include "response-file-writer.h"
+#include "quoting-splitter.h"
 #include "type-parsers.h"
 #include "detect-system.h"
 
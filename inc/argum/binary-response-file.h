@@ -0,0 +1,181 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_BINARY_RESPONSE_FILE_H_INCLUDED
+#define HEADER_ARGUM_BINARY_RESPONSE_FILE_H_INCLUDED
+
+#include "common.h"
+
+#include <string_view>
+#include <system_error>
+#include <memory>
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+
+namespace Argum {
+
+    /**
+     Binary response file format.
+
+     All integers are in native byte order.
+     - header: 8 bytes of `magic`, `uint32_t` character size in bytes, `uint32_t` reserved
+       (must be 0), `uint64_t` number of arguments
+     - for each argument: `uint64_t` length in characters followed by the characters,
+       padded with zeroes to a multiple of 8 bytes
+
+     Arguments are used as is, without any splitting, trimming or unquoting. Character size 1
+     means narrow multibyte text in the same encoding as text response files. When reading
+     with `wchar_t` such files are decoded. Otherwise the character size must match the
+     character type used to read the file.
+     */
+    ARGUM_MOD_EXPORTED
+    struct BinaryResponseFile {
+        static constexpr char magic[8] = {'A', 'R', 'G', 'U', 'M', 'B', 'R', 'F'};
+        static constexpr size_t headerSize = sizeof(magic) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+        static constexpr size_t alignment = 8;
+
+        static auto isBinary(const char * data, size_t size) -> bool {
+            return size >= sizeof(magic) && memcmp(data, magic, sizeof(magic)) == 0;
+        }
+
+        static constexpr auto paddedSize(size_t size) -> size_t {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+    };
+
+    namespace Impl {
+
+        //Iterates over arguments of a validated binary response file image
+        template<class Char>
+        class BinaryArgsCursor {
+        public:
+            using StringViewType = std::basic_string_view<Char>;
+
+            BinaryArgsCursor() = default;
+            BinaryArgsCursor(const char * first, uint64_t count): m_current(first), m_count(count) {
+            }
+
+            auto empty() const -> bool {
+                return this->m_count == 0;
+            }
+            auto position() const -> const char * {
+                return this->m_current;
+            }
+
+            auto next() -> StringViewType {
+                uint64_t length;
+                memcpy(&length, this->m_current, sizeof(length));
+                auto data = reinterpret_cast<const Char *>(this->m_current + sizeof(length));
+                this->m_current += sizeof(length) + BinaryResponseFile::paddedSize(size_t(length) * sizeof(Char));
+                --this->m_count;
+                return StringViewType(data, size_t(length));
+            }
+
+        private:
+            const char * m_current = nullptr;
+            uint64_t m_count = 0;
+        };
+
+        struct BinaryHeader {
+            uint32_t charSize;
+            uint64_t count;
+        };
+
+        //Checks that the whole image is well formed
+        inline auto validateBinaryArgs(const char * data, size_t size, BinaryHeader & header) -> std::error_code {
+            auto invalid = std::make_error_code(std::errc::illegal_byte_sequence);
+            if (size < BinaryResponseFile::headerSize || !BinaryResponseFile::isBinary(data, size))
+                return invalid;
+            uint32_t reserved;
+            memcpy(&header.charSize, data + sizeof(BinaryResponseFile::magic), sizeof(uint32_t));
+            memcpy(&reserved, data + sizeof(BinaryResponseFile::magic) + sizeof(uint32_t), sizeof(uint32_t));
+            memcpy(&header.count, data + sizeof(BinaryResponseFile::magic) + 2 * sizeof(uint32_t), sizeof(uint64_t));
+            if (reserved != 0 || (header.charSize != 1 && header.charSize != 2 && header.charSize != 4))
+                return invalid;
+
+            size_t remaining = size - BinaryResponseFile::headerSize;
+            const char * current = data + BinaryResponseFile::headerSize;
+            for (uint64_t i = 0; i < header.count; ++i) {
+                uint64_t length;
+                if (remaining < sizeof(length))
+                    return invalid;
+                memcpy(&length, current, sizeof(length));
+                remaining -= sizeof(length);
+                current += sizeof(length);
+                if (length > remaining / header.charSize)
+                    return invalid;
+                auto recordSize = std::min(BinaryResponseFile::paddedSize(size_t(length) * header.charSize), remaining);
+                remaining -= recordSize;
+                current += recordSize;
+            }
+            return {};
+        }
+
+        /**
+         Prepares a cursor over a binary response file image.
+
+         If the image is narrow and Char is `wchar_t` the arguments are decoded into a new wide
+         image stored in `decoded`.
+         */
+        template<class Char>
+        auto openBinaryArgs(const char * data, size_t size, std::unique_ptr<Char[]> & decoded,
+                            BinaryArgsCursor<Char> & cursor) -> std::error_code {
+
+            BinaryHeader header;
+            if (auto err = validateBinaryArgs(data, size, header))
+                return err;
+
+            if (header.charSize == sizeof(Char)) {
+                cursor = BinaryArgsCursor<Char>(data + BinaryResponseFile::headerSize, header.count);
+                return {};
+            }
+            if constexpr (std::is_same_v<Char, wchar_t>) {
+                if (header.charSize == 1) {
+                    //decoded text is never longer than its multibyte encoding and records only grow
+                    //by the character size
+                    size_t capacity = (BinaryResponseFile::headerSize + (size - BinaryResponseFile::headerSize) * sizeof(wchar_t) +
+                                       size_t(header.count) * BinaryResponseFile::alignment) / sizeof(wchar_t) + 1;
+                    decoded.reset(new wchar_t[capacity]);
+                    char * const start = reinterpret_cast<char *>(decoded.get());
+                    char * out = start + BinaryResponseFile::headerSize;
+                    BinaryArgsCursor<char> source(data + BinaryResponseFile::headerSize, header.count);
+                    while (!source.empty()) {
+                        auto arg = source.next();
+                        auto dest = reinterpret_cast<wchar_t *>(out + sizeof(uint64_t));
+                        uint64_t length = 0;
+                        mbstate_t state = mbstate_t();
+                        for (size_t pos = 0; pos < arg.size(); ) {
+                            auto byte = static_cast<unsigned char>(arg[pos]);
+                            if (byte < 0x80 && mbsinit(&state)) {
+                                dest[length++] = wchar_t(byte);
+                                ++pos;
+                                continue;
+                            }
+                            size_t res = mbrtowc(dest + length, arg.data() + pos, arg.size() - pos, &state);
+                            if (res == size_t(-1) || res == size_t(-2))
+                                return std::make_error_code(std::errc::illegal_byte_sequence);
+                            ++length;
+                            pos += (res == 0 ? 1 : res);
+                        }
+                        memcpy(out, &length, sizeof(length));
+                        auto recordSize = BinaryResponseFile::paddedSize(size_t(length) * sizeof(wchar_t));
+                        memset(out + sizeof(uint64_t) + size_t(length) * sizeof(wchar_t), 0, recordSize - size_t(length) * sizeof(wchar_t));
+                        out += sizeof(uint64_t) + recordSize;
+                    }
+                    cursor = BinaryArgsCursor<Char>(start + BinaryResponseFile::headerSize, header.count);
+                    return {};
+                }
+            }
+            return std::make_error_code(std::errc::illegal_byte_sequence);
+        }
+    }
+}
+
+#endif
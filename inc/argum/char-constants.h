@@ -33,6 +33,15 @@ namespace Argum {
         static constexpr auto squareBracketClose            = prefix ## ']'; \
         static constexpr auto pipe                          = prefix ## '|'; \
         static constexpr auto endl                          = prefix ## '\n'; \
+        static constexpr auto tab                           = prefix ## '\t'; \
+        static constexpr auto carriageReturn                = prefix ## '\r'; \
+        static constexpr auto backslash                     = prefix ## '\\'; \
+        static constexpr auto doubleQuote                   = prefix ## '"'; \
+        static constexpr auto singleQuote                   = prefix ## '\''; \
+        static constexpr auto hash                          = prefix ## '#'; \
+        static constexpr auto dollar                        = prefix ## '$'; \
+        static constexpr auto backtick                      = prefix ## '`'; \
+        static constexpr auto windowsQuotedChars            = prefix ## " \t\n\v\""; \
         static constexpr auto ellipsis                      = prefix ## "..."; \
         static constexpr auto esc                           = prefix ## '\x1B'; \
         static constexpr auto semicolon                     = prefix ## ';'; \
@@ -58,7 +67,7 @@ namespace Argum {
 
     #undef ARGUM_DEFINE_CHAR_CONSTANTS
     
-    inline auto CharConstants<char>::isSpace(char c) -> bool { return isspace(c); }
+    inline auto CharConstants<char>::isSpace(char c) -> bool { return isspace(static_cast<unsigned char>(c)); }
     inline auto CharConstants<wchar_t>::isSpace(wchar_t c) -> bool { return iswspace(c); }
 
     inline auto CharConstants<char>::toLong(const char * str, char ** str_end, int base) -> long {
@@ -123,6 +132,19 @@ namespace Argum {
         return str;
     }
 
+    template<class Char>
+    auto trim(std::basic_string_view<Char> str) -> std::basic_string_view<Char> {
+        auto firstNotSpace = std::find_if(str.begin(), str.end(), [](const auto c) {
+            return !CharConstants<Char>::isSpace(c);
+        });
+        str.remove_prefix(size_t(firstNotSpace - str.begin()));
+        auto lastNotSpace = std::find_if(str.rbegin(), str.rend(), [](const auto c) {
+            return !CharConstants<Char>::isSpace(c);
+        }).base();
+        str.remove_suffix(size_t(str.end() - lastNotSpace));
+        return str;
+    }
+
 }
 
 #endif
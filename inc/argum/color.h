@@ -211,6 +211,39 @@ namespace Argum {
     ARGUM_MOD_EXPORTED
     constexpr auto defaultWColorScheme() -> const WColorScheme & { return basicDefaultColorScheme<wchar_t>; }
 
+    /**
+     Colorized text as separate pieces: escape sequence prefix, the text itself and
+     escape sequence suffix. All pieces are views so producing it never allocates. 
+     Prefix and suffix are empty when no color is used.
+     */
+    ARGUM_MOD_EXPORTED
+    template<Character Char>
+    struct BasicColoredText {
+        using CharType = Char;
+        using StringViewType = std::basic_string_view<CharType>;
+        using StringType = std::basic_string<CharType>;
+
+        StringViewType prefix;
+        StringViewType text;
+        StringViewType suffix;
+
+        auto size() const -> size_t {
+            return prefix.size() + text.size() + suffix.size();
+        }
+
+        auto appendTo(StringType & dest) const -> StringType & {
+            return dest.append(prefix).append(text).append(suffix);
+        }
+
+        auto str() const -> StringType {
+            StringType ret;
+            ret.reserve(this->size());
+            return this->appendTo(ret);
+        }
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ColoredText)
+
     ARGUM_MOD_EXPORTED
     template<Character Char>
     class BasicColorizer {
@@ -219,6 +252,8 @@ namespace Argum {
         using StringViewType = std::basic_string_view<CharType>;
         using StringType = std::basic_string<CharType>;
         using Scheme = BasicColorScheme<Char>;
+        using ColoredText = BasicColoredText<Char>;
+        using SchemeElement = StringViewType Scheme::*;
 
     public:
         constexpr BasicColorizer() = default;
@@ -227,69 +262,69 @@ namespace Argum {
             m_scheme(&scheme)
         {}
 
+        constexpr auto scheme() const -> const Scheme & {
+            return *m_scheme;
+        }
+
+        /**
+         Allocation-free version of the methods below. Pass one of the scheme members, 
+         e.g. `colored(&Scheme::shortOption, str)`
+         */
+        auto colored(SchemeElement element, StringViewType str) const -> ColoredText {
+            auto prefix = m_scheme->*element;
+            if (prefix.empty())
+                return {{}, str, {}};
+            return {prefix, str, basicMakeColor<Char, Color::normal>()};
+        }
+
         
         auto heading(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->heading);
+            return this->colored(&Scheme::heading, str).str();
         }
 
         auto progName(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->progName);
+            return this->colored(&Scheme::progName, str).str();
         }
 
         auto shortOptionInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->shortOptionInUsage);
+            return this->colored(&Scheme::shortOptionInUsage, str).str();
         }
 
         auto longOptionInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->longOptionInUsage);
+            return this->colored(&Scheme::longOptionInUsage, str).str();
         }
 
         auto optionArgInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->optionArgInUsage);
+            return this->colored(&Scheme::optionArgInUsage, str).str();
         }
 
         auto positionalInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->positionalInUsage);
+            return this->colored(&Scheme::positionalInUsage, str).str();
         }
 
         auto shortOption(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->shortOption);
+            return this->colored(&Scheme::shortOption, str).str();
         }
 
         auto longOption(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->longOption);
+            return this->colored(&Scheme::longOption, str).str();
         }
 
         auto optionArg(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->optionArg);
+            return this->colored(&Scheme::optionArg, str).str();
         }
 
         auto positional(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->positional);
+            return this->colored(&Scheme::positional, str).str();
         }
 
         auto error(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->error);
+            return this->colored(&Scheme::error, str).str();
         }
 
         auto warning(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->warning);
+            return this->colored(&Scheme::warning, str).str();
         }
-    private:
-        static auto colorize(StringViewType str, StringViewType prefix) -> StringType {
-            if (!prefix.size())
-                return StringType(str);
-
-            auto suffix = basicMakeColor<Char, Color::normal>();
-
-            StringType ret;
-            ret.reserve(prefix.size() + str.size() + suffix.size());
-            ret = prefix;
-            ret += str;
-            ret += suffix;
-            return ret;
-        }
-
     private:
         const Scheme * m_scheme = &nullColorScheme<Char>;
     };
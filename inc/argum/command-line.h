@@ -11,6 +11,9 @@
 #include "expected.h"
 #include "messages.h"
 #include "simple-file.h"
+#include "mapped-file.h"
+#include "response-file-cache.h"
+#include "binary-response-file.h"
 
 #include <string>
 #include <string_view>
@@ -19,6 +22,15 @@
 #include <stack>
 #include <span>
 #include <algorithm>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 namespace Argum {
 
@@ -30,6 +42,166 @@ namespace Argum {
         return std::span(const_cast<const Char **>(argv), size_t(0));
     }
 
+    /**
+     Owns text of arguments that a splitter had to construct rather than point into the line
+     it was given, for example unescaped quoted strings.
+
+     Splitters used with BasicResponseFileReader::expandMapped() or expandLazily() receive 
+     it as an optional third argument. Memory is allocated in large chunks and stays valid 
+     for the lifetime of the store, including after it is moved.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicArgumentStore {
+    public:
+        //Returns uninitialized space for size characters
+        auto allocate(size_t size) -> Char * {
+            if (this->m_available < size) {
+                size_t allocSize = std::max(size, chunkSize);
+                this->m_chunks.emplace_back(new Char[allocSize]);
+                this->m_next = this->m_chunks.back().get();
+                this->m_available = allocSize;
+            }
+            auto ret = this->m_next;
+            this->m_next += size;
+            this->m_available -= size;
+            return ret;
+        }
+
+        //Returns the unused tail of the most recent allocation to the store
+        auto shrink(Char * ptr, size_t size, size_t newSize) -> void {
+            if (ptr + size == this->m_next) {
+                this->m_next -= (size - newSize);
+                this->m_available += (size - newSize);
+            }
+        }
+    private:
+        static constexpr size_t chunkSize = 16 * 1024;
+
+        std::vector<std::unique_ptr<Char[]>> m_chunks;
+        Char * m_next = nullptr;
+        size_t m_available = 0;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ArgumentStore)
+
+    namespace Impl {
+        //Keeps alive memory that expanded argument views point into
+        template<class Char>
+        struct ResponseFileStorage {
+            std::vector<MappedFile> mappings;
+            std::vector<std::unique_ptr<Char[]>> decoded;
+            BasicArgumentStore<Char> strings;
+        };
+
+        /**
+         Response files seen during a single expansion, keyed by canonical path so that each
+         file is read once no matter how many times and by which names it is referenced.
+         Names that have no canonical path, such as missing files or the `/dev/fd/N` names of 
+         pipes, are keyed by the name itself. Errors for them are reported when the file is read.
+
+         Names are remembered too so that repeated references by the same name do not touch 
+         the file system. Entries never move once created.
+         */
+        template<class Char, class Contents>
+        class LoadedResponseFiles {
+        public:
+            struct Entry {
+                Contents contents;
+                bool loaded = false;
+                //number of times the file is currently being expanded
+                unsigned active = 0;
+            };
+
+            auto find(std::basic_string_view<Char> filename) const -> Entry * {
+                auto it = this->m_byName.find(filename);
+                return it != this->m_byName.end() ? it->second : nullptr;
+            }
+
+            auto add(std::basic_string_view<Char> filename, const std::filesystem::path & canonicalPath) -> Entry * {
+                auto & entry = this->m_byPath[canonicalPath];
+                this->m_byName.emplace(std::basic_string<Char>(filename), &entry);
+                return &entry;
+            }
+
+            auto get(std::basic_string_view<Char> filename) -> Entry * {
+                if (auto ret = this->find(filename))
+                    return ret;
+                return this->add(filename, LoadedResponseFiles::keyFor(filename));
+            }
+
+            //Unresolvable names cannot collide with canonical paths, which are absolute and contain no links
+            static auto keyFor(std::basic_string_view<Char> filename) -> std::filesystem::path {
+                std::filesystem::path path(filename);
+                std::error_code ec;
+                auto canonicalPath = std::filesystem::canonical(path, ec);
+                if (ec)
+                    return path;
+                return canonicalPath;
+            }
+        private:
+            std::map<std::filesystem::path, Entry> m_byPath;
+            std::map<std::basic_string<Char>, Entry *, std::less<>> m_byName;
+        };
+
+        template<class Splitter, class Char>
+        concept MappedSplitter = 
+            std::is_invocable_v<Splitter, std::basic_string_view<Char>, std::back_insert_iterator<std::vector<std::basic_string_view<Char>>>> ||
+            std::is_invocable_v<Splitter, std::basic_string_view<Char>, std::back_insert_iterator<std::vector<std::basic_string_view<Char>>>, 
+                                BasicArgumentStore<Char> &>;
+    }
+
+    /**
+     Result of BasicResponseFileReader::expandMapped()
+
+     Holds the expanded arguments as string views together with the storage they 
+     point into: memory mappings of the response files (or, for `wchar_t`, their decoded 
+     contents). Arguments that came from the original command line refer to the original
+     strings which must outlive this object.
+
+     This is an ArgRange so it can be passed to BasicParser::parse() directly.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicExpandedArgs {
+    public:
+        using CharType = Char;
+        using StringViewType = std::basic_string_view<Char>;
+        using const_iterator = typename std::vector<StringViewType>::const_iterator;
+        using iterator = const_iterator;
+
+    public:
+        BasicExpandedArgs() = default;
+        BasicExpandedArgs(BasicExpandedArgs &&) = default;
+        auto operator=(BasicExpandedArgs &&) -> BasicExpandedArgs & = default;
+
+        auto begin() const -> const_iterator {
+            return this->m_args.begin();
+        }
+        auto end() const -> const_iterator {
+            return this->m_args.end();
+        }
+        auto size() const -> size_t {
+            return this->m_args.size();
+        }
+        auto empty() const -> bool {
+            return this->m_args.empty();
+        }
+        auto operator[](size_t idx) const -> StringViewType {
+            return this->m_args[idx];
+        }
+
+    private:
+        template<class> friend class BasicResponseFileReader;
+
+        Impl::ResponseFileStorage<CharType> m_storage;
+        std::vector<StringViewType> m_args;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ExpandedArgs)
+
+    ARGUM_MOD_EXPORTED template<class Char> class BasicLazyExpandedArgs;
+
     ARGUM_MOD_EXPORTED
     template<class Char>
     class BasicResponseFileReader {
@@ -42,13 +214,33 @@ namespace Argum {
             ARGUM_IMPLEMENT_EXCEPTION(Exception, BasicParsingException<CharType>, Error::ResponseFileError)
 
             Exception(const std::filesystem::path & filename_, std::error_code error_): 
-                BasicParsingException<CharType>(ErrorCode,
-                                                format(Messages<CharType>::errorReadingResponseFile(), filename_.native(), error_.message())),
-                filename(filename_),
-                error(error_) {
+                Exception(ErrorCode, filename_, error_) {
             }
             std::filesystem::path filename;
             std::error_code error;
+        protected:
+            Exception(Error code, const std::filesystem::path & filename_, std::error_code error_): 
+                BasicParsingException<CharType>(code),
+                filename(filename_),
+                error(error_) {
+            }
+
+            auto formatMessage() const -> StringType override {
+                return format<Messages<CharType>::errorReadingResponseFile>(this->filename.native(), this->error.message());
+            }
+        };
+
+        //Reported when a response file references itself, directly or through other files
+        struct CycleException : public Exception {
+            ARGUM_IMPLEMENT_EXCEPTION(CycleException, BasicParsingException<CharType>, Error::ResponseFileCycle)
+
+            CycleException(const std::filesystem::path & filename_):
+                Exception(ErrorCode, filename_, std::make_error_code(std::errc::too_many_symbolic_link_levels)) {
+            }
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages<CharType>::responseFileCycle>(this->filename.native());
+            }
         };
 
     public:
@@ -72,12 +264,7 @@ namespace Argum {
 
         template<ArgRange<CharType> Args>
         auto expand(const Args & args) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
-            return expand(args, [](StringType && str, auto dest) {
-                trimInPlace(str);
-                if (str.empty())
-                    return;
-                *dest = std::move(str);
-            });
+            return expand(args, DefaultSplitter());
         }
 
         template<ArgRange<Char> Args, class Splitter>
@@ -85,80 +272,862 @@ namespace Argum {
             requires(std::is_invocable_v<decltype(splitter), StringType &&, std::back_insert_iterator<std::vector<StringType>>>) {
             
             std::vector<StringType> ret;
+            LoadedFiles files;
             std::stack<StackEntry> stack;
 
             for(StringViewType arg: args) {
 
-                ARGUM_PROPAGATE_ERROR(this->handleArg(arg, ret, stack, splitter));
+                ARGUM_PROPAGATE_ERROR(this->handleArg(arg, ret, stack, files, splitter));
 
                 while(!stack.empty()) {
 
                     auto & entry = stack.top();
-                    if (entry.current == entry.items.end()) {
+                    if (entry.current == entry.file->contents.size()) {
+                        --entry.file->active;
                         stack.pop();
                         continue;
                     }
-                    ARGUM_PROPAGATE_ERROR(this->handleArg(*entry.current, ret, stack, std::forward<Splitter>(splitter)));
-                    ++entry.current;
+                    StringViewType item = entry.file->contents[entry.current++];
+                    ARGUM_PROPAGATE_ERROR(this->handleArg(item, ret, stack, files, splitter));
+                }
+            }
+            return ret;
+        }
+        /**
+         Expands response files without copying their contents into individual strings.
+
+         Each response file is memory mapped and the resulting arguments are views into 
+         the mapping. For `wchar_t` the file is decoded as a whole into a single buffer 
+         instead. 
+
+         The optional splitter is called as `splitter(line, dest)` with each line as a string 
+         view and must assign to `*dest` views that point into that line. If it needs to 
+         produce arguments that are not part of the line it can instead accept 
+         `splitter(line, dest, store)` and place them in the BasicArgumentStore.
+
+         Binary response files (see BinaryResponseFile) are expanded without any parsing: 
+         their arguments are views directly into the mapping (unless they need decoding) 
+         and the splitter is not called for them. This also applies to all other expansion 
+         methods.
+         */
+        auto expandMapped(int argc, CharType ** argv) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>) {
+            return expandMapped(makeArgSpan(argc, argv));
+        }
+
+        template<class Splitter>
+        auto expandMapped(int argc, CharType ** argv, Splitter && splitter) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>) {
+            return expandMapped(makeArgSpan(argc, argv), std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expandMapped(const Args & args) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>) {
+            return expandMapped(args, [](StringViewType line, auto dest) {
+                line = trim(line);
+                if (line.empty())
+                    return;
+                *dest = line;
+            });
+        }
+
+        template<ArgRange<CharType> Args, class Splitter>
+        auto expandMapped(const Args & args, Splitter && splitter) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>)
+            requires(Impl::MappedSplitter<decltype(splitter), CharType>) {
+
+            BasicExpandedArgs<CharType> ret;
+            MappedFiles files;
+            std::stack<MappedStackEntry> stack;
+
+            for(StringViewType arg: args) {
+
+                ARGUM_PROPAGATE_ERROR(this->handleMappedArg(arg, ret, stack, files));
+
+                while(!stack.empty()) {
+
+                    auto & entry = stack.top();
+                    if (entry.current == entry.pending.size()) {
+                        if (entry.source.empty()) {
+                            entry.file->contents.second = ret.m_args.size();
+                            entry.file->loaded = true;
+                            --entry.file->active;
+                            stack.pop();
+                            continue;
+                        }
+                        entry.pending.clear();
+                        entry.current = 0;
+                        entry.source.next(entry.pending, splitter, ret.m_storage.strings);
+                        continue;
+                    }
+                    auto item = entry.pending[entry.current++];
+                    ARGUM_PROPAGATE_ERROR(this->handleMappedArg(item, ret, stack, files));
                 }
             }
             return ret;
         }
+
+        /**
+         Expands response files on demand while the result is iterated.
+
+         Returns a forward range that reads response files only when iteration reaches them.
+         The memory used by the iteration is bounded by the nesting depth of response files
+         rather than by the number of arguments. Files are mapped the same way as by 
+         expandMapped() and stay mapped for the lifetime of the returned object. The 
+         splitter requirements are the same as for expandMapped(). The original arguments 
+         must outlive the result.
+
+         Errors are reported during iteration: by throwing an exception or, when using
+         BasicExpected, by ending the iteration and storing the error in 
+         BasicLazyExpandedArgs::error(). BasicParser::parse() handles both.
+         */
+        auto expandLazily(int argc, CharType ** argv) const -> BasicLazyExpandedArgs<CharType> {
+            return expandLazily(makeArgSpan(argc, argv));
+        }
+
+        template<class Splitter>
+        auto expandLazily(int argc, CharType ** argv, Splitter && splitter) const -> BasicLazyExpandedArgs<CharType> {
+            return expandLazily(makeArgSpan(argc, argv), std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expandLazily(const Args & args) const -> BasicLazyExpandedArgs<CharType> {
+            return expandLazily(args, [](StringViewType line, auto dest) {
+                line = trim(line);
+                if (line.empty())
+                    return;
+                *dest = line;
+            });
+        }
+
+        template<ArgRange<CharType> Args, class Splitter>
+        auto expandLazily(const Args & args, Splitter && splitter) const -> BasicLazyExpandedArgs<CharType>
+            requires(Impl::MappedSplitter<decltype(splitter), CharType>) {
+
+            std::vector<StringViewType> views;
+            for(StringViewType arg: args)
+                views.push_back(arg);
+            return BasicLazyExpandedArgs<CharType>(this->m_prefixes, std::move(views), std::forward<Splitter>(splitter));
+        }
+
+        /**
+         Expands response files reading them concurrently.
+
+         All response file arguments are located up front and read, together with response
+         files they reference, on up to `threadCount` threads (including the calling one).
+         Passing 0 uses a small default based on the number of available processors.
+         The results are then spliced in the original order and errors are reported exactly 
+         as by expand(). 
+         
+         This is beneficial when there are many response files or they reside on slow 
+         storage. The splitter is invoked concurrently and must be thread safe.
+         */
+        auto expandConcurrently(int argc, CharType ** argv, unsigned threadCount = 0) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expandConcurrently(makeArgSpan(argc, argv), threadCount);
+        }
+
+        template<class Splitter>
+        auto expandConcurrently(int argc, CharType ** argv, unsigned threadCount, Splitter && splitter) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expandConcurrently(makeArgSpan(argc, argv), threadCount, std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expandConcurrently(const Args & args, unsigned threadCount = 0) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expandConcurrently(args, threadCount, DefaultSplitter());
+        }
+
+        template<ArgRange<CharType> Args, class Splitter>
+        auto expandConcurrently(const Args & args, unsigned threadCount, Splitter && splitter) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>)
+            requires(std::is_invocable_v<decltype(splitter), StringType &&, std::back_insert_iterator<std::vector<StringType>>>) {
+
+            if (threadCount == 0)
+                threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+
+            //1. Find response files on the command line
+            PrefetchFiles files;
+            std::mutex mutex;
+            PrefetchNode root;
+            for(StringViewType arg: args) {
+                if (auto prefixSize = findPrefix(this->m_prefixes, arg))
+                    root.nested.emplace_back(root.items.size(), registerPrefetch(arg.substr(*prefixSize), root, files, mutex));
+                root.items.emplace_back(arg);
+            }
+
+            //2. Read them and the files they reference
+            if (!root.discovered.empty()) {
+                std::condition_variable cond;
+                std::deque<PrefetchNode *> pending(root.discovered.begin(), root.discovered.end());
+                size_t active = 0;
+
+                auto work = [&]() {
+                    std::unique_lock lock(mutex);
+                    for ( ; ; ) {
+                        cond.wait(lock, [&]() { return !pending.empty() || active == 0; });
+                        if (pending.empty())
+                            break;
+                        auto node = pending.front();
+                        pending.pop_front();
+                        ++active;
+                        lock.unlock();
+                        this->prefetch(*node, splitter, files, mutex);
+                        lock.lock();
+                    #ifndef ARGUM_NO_THROW
+                        try {
+                    #endif
+                            pending.insert(pending.end(), node->discovered.begin(), node->discovered.end());
+                    #ifndef ARGUM_NO_THROW
+                        } catch(...) {
+                            //files that cannot be queued are never read
+                            for (auto discovered: node->discovered)
+                                discovered->exception = std::current_exception();
+                        }
+                    #endif
+                        --active;
+                        cond.notify_all();
+                    }
+                };
+
+                std::vector<std::thread> threads;
+            #ifndef ARGUM_NO_THROW
+                try {
+            #endif
+                    threads.reserve(threadCount - 1);
+                    for (unsigned i = 1; i < threadCount; ++i)
+                        threads.emplace_back(work);
+            #ifndef ARGUM_NO_THROW
+                } catch(...) {
+                    //proceed with the threads that were started
+                }
+            #endif
+                work();
+                for (auto & thread: threads)
+                    thread.join();
+            }
+
+            //3. Splice the results in order
+            std::vector<StringType> ret;
+            countUses(root);
+            ARGUM_PROPAGATE_ERROR(splice(root, ret));
+            return ret;
+        }
+
+        /**
+         Enables persistent caching of split response files in the given directory.
+
+         Applies to expand() and expandConcurrently(). Results of the default splitter 
+         are always cached. Results of a custom splitter are cached only if `splitterId` is
+         not empty. It must uniquely identify the splitter behavior, so change it whenever 
+         the splitter changes.
+
+         See ResponseFileCache for details.
+         */
+        auto enableCache(std::filesystem::path directory, 
+                         uintmax_t maxSize = ResponseFileCache::defaultMaxSize,
+                         std::string splitterId = {}) -> BasicResponseFileReader & {
+            this->m_cache.emplace(std::move(directory), maxSize);
+            this->m_splitterId = std::move(splitterId);
+            return *this;
+        }
+
+        auto disableCache() -> BasicResponseFileReader & {
+            this->m_cache.reset();
+            this->m_splitterId.clear();
+            return *this;
+        }
+
     private:
+        template<class> friend class BasicLazyExpandedArgs;
+
+        struct DefaultSplitter {
+            template<class OutIt>
+            void operator()(StringType && str, OutIt dest) const {
+                trimInPlace(str);
+                if (str.empty())
+                    return;
+                *dest = std::move(str);
+            }
+        };
+        static constexpr std::string_view defaultSplitterId = "argum-trimmed-lines";
+
+        using LoadedFiles = Impl::LoadedResponseFiles<CharType, std::vector<StringType>>;
+
         struct StackEntry {
-            std::vector<StringType> items;
-            typename std::vector<StringType>::const_iterator current;
+            typename LoadedFiles::Entry * file;
+            size_t current;
         };
 
         template<class Splitter>
         auto handleArg(StringViewType arg, std::vector<StringType> & dest, 
-                       std::stack<StackEntry> & stack, 
-                       Splitter && splitter) -> ARGUM_EXPECTED(CharType, void) {
-
-            auto foundIt = std::find_if(this->m_prefixes.begin(), this->m_prefixes.end(), [arg](const StringViewType & prefix) {
-                return matchStrictPrefix(arg, prefix);
-            });
-
-            if (foundIt != this->m_prefixes.end()) {
-                auto filename = arg.substr(foundIt->size());
-                StackEntry nextEntry;
-                ARGUM_PROPAGATE_ERROR(this->readResponseFile(filename, nextEntry.items, std::forward<Splitter>(splitter)));
-                nextEntry.current = nextEntry.items.cbegin();
-                stack.emplace(std::move(nextEntry));
+                       std::stack<StackEntry> & stack, LoadedFiles & files,
+                       Splitter & splitter) -> ARGUM_EXPECTED(CharType, void) {
 
+            if (auto prefixSize = findPrefix(this->m_prefixes, arg)) {
+                auto filename = arg.substr(*prefixSize);
+                typename LoadedFiles::Entry * file;
+                ARGUM_CHECK_RESULT(file, enter(files, filename));
+                if (!file->loaded) {
+                    ARGUM_PROPAGATE_ERROR(this->readResponseFile(filename, file->contents, splitter));
+                    file->loaded = true;
+                }
+                stack.push(StackEntry{file, 0});
             } else {
                 dest.emplace_back(arg);
             }
             return ARGUM_VOID_SUCCESS;
         }
+
+        //Finds the file and marks it as being expanded, failing if it already is
+        template<class Files>
+        static auto enter(Files & files, StringViewType filename) -> ARGUM_EXPECTED(CharType, typename Files::Entry *) {
+            auto file = files.get(filename);
+            if (file->active)
+                ARGUM_THROW(CycleException, std::filesystem::path(filename));
+            ++file->active;
+            return file;
+        }
     
         template<class Splitter>
-        static auto readResponseFile(StringViewType filename, std::vector<StringType> & dest, 
-                                     Splitter && splitter) -> ARGUM_EXPECTED(CharType, void){
+        auto readResponseFile(StringViewType filename, std::vector<StringType> & dest, 
+                              Splitter && splitter) const -> ARGUM_EXPECTED(CharType, void){
 
             std::filesystem::path path(filename);
+            if (auto error = this->loadLines(path, dest, std::forward<Splitter>(splitter)))
+                ARGUM_THROW(Exception, path, error);
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        //Reads lines using the cache if enabled
+        template<class Splitter>
+        auto loadLines(const std::filesystem::path & path, std::vector<StringType> & dest, 
+                       Splitter && splitter) const -> std::error_code {
+            
+            std::string_view splitterId;
+            if (this->m_cache) {
+                if constexpr (std::is_same_v<std::remove_cvref_t<Splitter>, DefaultSplitter>)
+                    splitterId = defaultSplitterId;
+                else
+                    splitterId = this->m_splitterId;
+            }
+            if (splitterId.empty())
+                return readLines(path, dest, std::forward<Splitter>(splitter));
+
+            std::error_code ec;
+            auto absolutePath = std::filesystem::absolute(path, ec);
+            ResponseFileCache::FileKey key;
+            if (!ec)
+                key = ResponseFileCache::keyOf(absolutePath, ec);
+            if (ec)
+                return readLines(path, dest, std::forward<Splitter>(splitter));
+            
+            if (this->m_cache->load(absolutePath, key, splitterId, dest))
+                return {};
+            
+            auto start = dest.size();
+            auto error = readLines(path, dest, std::forward<Splitter>(splitter));
+            if (!error)
+                this->m_cache->store(absolutePath, key, splitterId, std::span<const StringType>(dest.data() + start, dest.size() - start));
+            return error;
+        }
+
+        template<class Splitter>
+        static auto readLines(const std::filesystem::path & path, std::vector<StringType> & dest, 
+                              Splitter && splitter) -> std::error_code {
             std::error_code error;
             SimpleFile file(path, "r", error);
             if (!file)
-                ARGUM_THROW(Exception, path, error);
+                return error;
+
+            auto start = file.peek(sizeof(BinaryResponseFile::magic), error);
+            if (error)
+                return error;
+            if (BinaryResponseFile::isBinary(start.data(), start.size()))
+                return readBinary(path, dest);
 
             do {
                 StringType line = file.readLine<CharType>(error);
                 if (error)
-                    ARGUM_THROW(Exception, path, error);
+                    return error;
                 
                 if (!line.empty())
                     splitter(std::move(line), std::back_inserter(dest));
             } while(!file.eof());
 
+            return error;
+        }
+
+        static auto readBinary(const std::filesystem::path & path, std::vector<StringType> & dest) -> std::error_code {
+            std::error_code error;
+            MappedFile file(path, error);
+            if (error)
+                return error;
+            std::unique_ptr<CharType[]> decoded;
+            Impl::BinaryArgsCursor<CharType> cursor;
+            if ((error = Impl::openBinaryArgs(file.data(), file.size(), decoded, cursor)))
+                return error;
+            while (!cursor.empty())
+                dest.emplace_back(cursor.next());
+            return error;
+        }
+
+        //A response file read ahead of time by expandConcurrently()
+        struct PrefetchNode {
+            StringType filename;
+            std::vector<StringType> items;
+            //indices of items that are response file references and their contents
+            std::vector<std::pair<size_t, PrefetchNode *>> nested;
+            //referenced files seen for the first time when reading this one
+            std::vector<PrefetchNode *> discovered;
+            //number of times the node is yet to be spliced
+            size_t uses = 0;
+            bool active = false;
+            std::error_code error;
+        #ifndef ARGUM_NO_THROW
+            std::exception_ptr exception;
+        #endif
+        };
+        using PrefetchFiles = Impl::LoadedResponseFiles<CharType, PrefetchNode>;
+
+        //Returns the node for a reference from parent, adding it to parent.discovered if it needs to be read
+        static auto registerPrefetch(StringViewType filename, PrefetchNode & parent, 
+                                     PrefetchFiles & files, std::mutex & mutex) -> PrefetchNode * {
+            typename PrefetchFiles::Entry * file;
+            {
+                std::lock_guard lock(mutex);
+                file = files.find(filename);
+                if (file)
+                    return &file->contents;
+            }
+            auto key = PrefetchFiles::keyFor(filename);
+            std::lock_guard lock(mutex);
+            file = files.add(filename, key);
+            auto & node = file->contents;
+            if (!file->loaded) {
+                file->loaded = true;
+            #ifndef ARGUM_NO_THROW
+                try {
+            #endif
+                    node.filename = filename;
+                    parent.discovered.push_back(&node);
+            #ifndef ARGUM_NO_THROW
+                } catch(...) {
+                    //the node is visible to other threads but will never be read
+                    node.exception = std::current_exception();
+                    throw;
+                }
+            #endif
+            }
+            return &node;
+        }
+
+        template<class Splitter>
+        auto prefetch(PrefetchNode & node, Splitter & splitter, PrefetchFiles & files, std::mutex & mutex) const -> void {
+        #ifndef ARGUM_NO_THROW
+            try {
+        #endif
+                node.error = this->loadLines(std::filesystem::path(node.filename), node.items, splitter);
+                for (size_t i = 0; i < node.items.size(); ++i) {
+                    if (auto prefixSize = findPrefix(this->m_prefixes, node.items[i]))
+                        node.nested.emplace_back(i, registerPrefetch(StringViewType(node.items[i]).substr(*prefixSize), node, files, mutex));
+                }
+        #ifndef ARGUM_NO_THROW
+            } catch(...) {
+                node.exception = std::current_exception();
+            }
+        #endif
+        }
+
+        //Counts how many times each node will be spliced. Cycles are reported by splice()
+        static auto countUses(PrefetchNode & node) -> void {
+            ++node.uses;
+            node.active = true;
+            for (auto & [idx, nested]: node.nested) {
+                if (!nested->active)
+                    countUses(*nested);
+            }
+            node.active = false;
+        }
+
+        static auto splice(PrefetchNode & node, std::vector<StringType> & dest) -> ARGUM_EXPECTED(CharType, void) {
+        #ifndef ARGUM_NO_THROW
+            if (node.exception)
+                std::rethrow_exception(node.exception);
+        #endif
+            if (node.error)
+                ARGUM_THROW(Exception, std::filesystem::path(node.filename), node.error);
+            
+            //items can be moved out on the last use only
+            bool lastUse = (--node.uses == 0);
+            node.active = true;
+            auto nestedIt = node.nested.begin();
+            for (size_t i = 0; i < node.items.size(); ++i) {
+                if (nestedIt != node.nested.end() && nestedIt->first == i) {
+                    auto & nested = *nestedIt->second;
+                    if (nested.active)
+                        ARGUM_THROW(CycleException, std::filesystem::path(nested.filename));
+                    ARGUM_PROPAGATE_ERROR(splice(nested, dest));
+                    ++nestedIt;
+                } else if (lastUse) {
+                    dest.emplace_back(std::move(node.items[i]));
+                } else {
+                    dest.emplace_back(node.items[i]);
+                }
+            }
+            node.active = false;
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        //Unread remainder of a mapped response file
+        struct MappedSource {
+            StringViewType text;
+            Impl::BinaryArgsCursor<CharType> binary;
+
+            auto empty() const -> bool {
+                return this->text.empty() && this->binary.empty();
+            }
+
+            //Appends arguments from the next line (or the next binary argument) to dest
+            template<class Splitter>
+            auto next(std::vector<StringViewType> & dest, Splitter & splitter, BasicArgumentStore<CharType> & store) -> void {
+                if (!this->binary.empty()) {
+                    dest.push_back(this->binary.next());
+                    return;
+                }
+                auto line = nextLine(this->text);
+                if (line.empty())
+                    return;
+                if constexpr (std::is_invocable_v<Splitter &, StringViewType, std::back_insert_iterator<std::vector<StringViewType>>, 
+                                                  BasicArgumentStore<CharType> &>)
+                    splitter(line, std::back_inserter(dest), store);
+                else
+                    splitter(line, std::back_inserter(dest));
+            }
+
+            friend auto operator==(const MappedSource & lhs, const MappedSource & rhs) -> bool {
+                return lhs.text.data() == rhs.text.data() && lhs.text.size() == rhs.text.size() &&
+                       lhs.binary.position() == rhs.binary.position();
+            }
+        };
+
+        /**
+         Range of the result holding the full expansion of each mapped response file. 
+         The expansion of a file is the same every time so later references just copy it.
+         */
+        using MappedFiles = Impl::LoadedResponseFiles<CharType, std::pair<size_t, size_t>>;
+
+        struct MappedStackEntry {
+            typename MappedFiles::Entry * file;
+            MappedSource source;
+            std::vector<StringViewType> pending;
+            size_t current = 0;
+        };
+
+        auto handleMappedArg(StringViewType arg, BasicExpandedArgs<CharType> & dest,
+                             std::stack<MappedStackEntry> & stack, MappedFiles & files) -> ARGUM_EXPECTED(CharType, void) {
+
+            if (auto prefixSize = findPrefix(this->m_prefixes, arg)) {
+                auto filename = arg.substr(*prefixSize);
+                typename MappedFiles::Entry * file;
+                ARGUM_CHECK_RESULT(file, enter(files, filename));
+                if (file->loaded) {
+                    auto [first, last] = file->contents;
+                    dest.m_args.reserve(dest.m_args.size() + (last - first));
+                    for (auto i = first; i != last; ++i)
+                        dest.m_args.push_back(dest.m_args[i]);
+                    --file->active;
+                    return ARGUM_VOID_SUCCESS;
+                }
+                MappedStackEntry nextEntry;
+                nextEntry.file = file;
+                ARGUM_PROPAGATE_ERROR(this->mapResponseFile(filename, dest.m_storage, nextEntry.source));
+                file->contents.first = dest.m_args.size();
+                stack.emplace(std::move(nextEntry));
+            } else {
+                dest.m_args.push_back(arg);
+            }
             return ARGUM_VOID_SUCCESS;
         }
+
+        static auto findPrefix(const std::vector<StringType> & prefixes, StringViewType arg) -> std::optional<size_t> {
+            auto foundIt = std::find_if(prefixes.begin(), prefixes.end(), [arg](const StringViewType & prefix) {
+                return matchStrictPrefix(arg, prefix);
+            });
+            if (foundIt == prefixes.end())
+                return std::nullopt;
+            return foundIt->size();
+        }
+
+        static auto mapResponseFile(StringViewType filename, Impl::ResponseFileStorage<CharType> & dest, 
+                                    MappedSource & contents) -> ARGUM_EXPECTED(CharType, void) {
+            
+            std::filesystem::path path(filename);
+            std::error_code error;
+            MappedFile file(path, error);
+            if (error)
+                ARGUM_THROW(Exception, path, error);
+
+            if (BinaryResponseFile::isBinary(file.data(), file.size())) {
+                std::unique_ptr<CharType[]> decoded;
+                if ((error = Impl::openBinaryArgs(file.data(), file.size(), decoded, contents.binary)))
+                    ARGUM_THROW(Exception, path, error);
+                dest.mappings.emplace_back(std::move(file));
+                if (decoded)
+                    dest.decoded.emplace_back(std::move(decoded));
+                return ARGUM_VOID_SUCCESS;
+            }
+
+            if constexpr (std::is_same_v<CharType, char>) {
+                contents.text = StringViewType(file.data(), file.size());
+                dest.mappings.emplace_back(std::move(file));
+            } else {
+                static_assert(std::is_same_v<CharType, wchar_t>, "only char and wchar_t are supported");
+                //decoded text is never longer than its multibyte encoding
+                std::unique_ptr<wchar_t[]> buffer(new wchar_t[file.size()]);
+                size_t length = 0;
+                if (!decode(file.data(), file.size(), buffer.get(), length))
+                    ARGUM_THROW(Exception, path, std::make_error_code(std::errc::illegal_byte_sequence));
+                contents.text = StringViewType(buffer.get(), length);
+                dest.decoded.emplace_back(std::move(buffer));
+            }
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        static auto decode(const char * first, size_t size, wchar_t * dest, size_t & length) -> bool {
+            mbstate_t state = mbstate_t();
+            const char * const last = first + size;
+            while (first != last) {
+                auto byte = static_cast<unsigned char>(*first);
+                //ASCII in initial shift state is the same in all supported encodings
+                if (byte < 0x80 && mbsinit(&state)) {
+                    dest[length++] = wchar_t(byte);
+                    ++first;
+                    continue;
+                }
+                size_t res = mbrtowc(dest + length, first, size_t(last - first), &state);
+                if (res == size_t(-1) || res == size_t(-2))
+                    return false;
+                ++length;
+                first += (res == 0 ? 1 : res);
+            }
+            return true;
+        }
+
+        static auto nextLine(StringViewType & rest) -> StringViewType {
+            auto pos = rest.find(CharConstants<CharType>::endl);
+            if (pos == rest.npos) {
+                auto ret = rest;
+                rest = StringViewType();
+                return ret;
+            }
+            auto ret = rest.substr(0, pos);
+            rest.remove_prefix(pos + 1);
+            return ret;
+        }
     private:
         std::vector<StringType> m_prefixes;
+        std::optional<ResponseFileCache> m_cache;
+        std::string m_splitterId;
     };
 
     ARGUM_DECLARE_FRIENDLY_NAMES(ResponseFileReader)
 
+    /**
+     Result of BasicResponseFileReader::expandLazily()
+
+     A forward range of arguments that expands response files as iteration reaches them.
+     An iterator is a cursor over the response files it is inside of so copying one costs 
+     only the nesting depth. Each file is read once but iterating again, or from a copy of 
+     an iterator, splits its lines again. The object owns the mappings of all response files read so far and must outlive 
+     any use of the arguments it produced.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicLazyExpandedArgs {
+    private:
+        using ReaderType = BasicResponseFileReader<Char>;
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+        using ParsingExceptionPtr = std::shared_ptr<BasicParsingException<Char>>;
+        using Splitter = std::function<void (StringViewType, std::back_insert_iterator<std::vector<StringViewType>>, 
+                                             BasicArgumentStore<CharType> &)>;
+
+    private:
+        //files are only split as the iteration reaches them so just the mapped contents are memoized
+        using LoadedFiles = Impl::LoadedResponseFiles<CharType, typename ReaderType::MappedSource>;
+
+        struct State {
+            std::vector<StringType> prefixes;
+            std::vector<StringViewType> args;
+            Splitter splitter;
+            Impl::ResponseFileStorage<CharType> storage;
+            LoadedFiles files;
+            ParsingExceptionPtr error;
+
+            auto load(StringViewType filename) -> ARGUM_EXPECTED(CharType, typename LoadedFiles::Entry *) {
+                auto file = this->files.get(filename);
+                if (!file->loaded) {
+                    ARGUM_PROPAGATE_ERROR(ReaderType::mapResponseFile(filename, this->storage, file->contents));
+                    file->loaded = true;
+                }
+                return file;
+            }
+        };
+
+    public:
+        class iterator {
+            friend BasicLazyExpandedArgs;
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = StringViewType;
+            using difference_type = std::ptrdiff_t;
+            using reference = StringViewType;
+            using pointer = const StringViewType *;
+
+        public:
+            iterator() = default;
+
+            auto operator*() const -> StringViewType {
+                return this->m_current;
+            }
+            auto operator->() const -> const StringViewType * {
+                return &this->m_current;
+            }
+            auto operator++() -> iterator & {
+                this->increment();
+                return *this;
+            }
+            auto operator++(int) -> iterator {
+                auto ret = *this;
+                this->increment();
+                return ret;
+            }
+            friend auto operator==(const iterator & lhs, const iterator & rhs) -> bool {
+                if (lhs.m_atEnd || rhs.m_atEnd)
+                    return lhs.m_atEnd == rhs.m_atEnd;
+                return lhs.m_argIdx == rhs.m_argIdx && lhs.m_stack == rhs.m_stack;
+            }
+
+        private:
+            //A response file being expanded: its unread remainder and the unused arguments of the current line
+            struct Level {
+                const typename LoadedFiles::Entry * file;
+                typename ReaderType::MappedSource source;
+                std::vector<StringViewType> pending;
+                size_t current = 0;
+
+                friend auto operator==(const Level & lhs, const Level & rhs) -> bool {
+                    return lhs.source == rhs.source && lhs.current == rhs.current;
+                }
+            };
+
+            iterator(State * state): m_state(state), m_atEnd(false) {
+                this->increment();
+            }
+
+            auto increment() -> void {
+            #ifdef ARGUM_USE_EXPECTED
+                if (auto err = this->advance().error()) {
+                    if (!this->m_state->error)
+                        this->m_state->error = std::move(err);
+                    this->m_stack.clear();
+                    this->m_atEnd = true;
+                }
+            #else
+                this->advance();
+            #endif
+            }
+
+            auto advance() -> ARGUM_EXPECTED(CharType, void) {
+                for ( ; ; ) {
+                    StringViewType candidate;
+                    if (!this->m_stack.empty()) {
+                        auto & level = this->m_stack.back();
+                        if (level.current == level.pending.size()) {
+                            if (level.source.empty()) {
+                                this->m_stack.pop_back();
+                                continue;
+                            }
+                            level.pending.clear();
+                            level.current = 0;
+                            level.source.next(level.pending, this->m_state->splitter, this->m_state->storage.strings);
+                            continue;
+                        }
+                        candidate = level.pending[level.current++];
+                    } else {
+                        if (this->m_argIdx == this->m_state->args.size()) {
+                            this->m_current = StringViewType();
+                            this->m_atEnd = true;
+                            return ARGUM_VOID_SUCCESS;
+                        }
+                        candidate = this->m_state->args[this->m_argIdx++];
+                    }
+
+                    if (auto prefixSize = ReaderType::findPrefix(this->m_state->prefixes, candidate)) {
+                        auto filename = candidate.substr(*prefixSize);
+                        typename LoadedFiles::Entry * file;
+                        ARGUM_CHECK_RESULT(file, this->m_state->load(filename));
+                        for (auto & level: this->m_stack) {
+                            if (level.file == file)
+                                ARGUM_THROW(typename ReaderType::CycleException, std::filesystem::path(filename));
+                        }
+                        this->m_stack.push_back(Level{file, file->contents, {}, 0});
+                        continue;
+                    }
+                    this->m_current = candidate;
+                    return ARGUM_VOID_SUCCESS;
+                }
+            }
+
+        private:
+            State * m_state = nullptr;
+            size_t m_argIdx = 0;
+            std::vector<Level> m_stack;
+            StringViewType m_current;
+            bool m_atEnd = true;
+        };
+        using const_iterator = iterator;
+
+    public:
+        BasicLazyExpandedArgs(BasicLazyExpandedArgs &&) = default;
+        auto operator=(BasicLazyExpandedArgs &&) -> BasicLazyExpandedArgs & = default;
+
+        auto begin() const -> iterator {
+            return iterator(this->m_state.get());
+        }
+        auto end() const -> iterator {
+            return iterator();
+        }
+
+        /**
+         The first error encountered while iterating.
+
+         Only set when using BasicExpected. Otherwise errors are thrown from iteration.
+         */
+        auto error() const -> ParsingExceptionPtr {
+            return this->m_state->error;
+        }
+    private:
+        friend ReaderType;
+
+        template<class SplitterArg>
+        BasicLazyExpandedArgs(std::vector<StringType> prefixes, std::vector<StringViewType> args, SplitterArg && splitter):
+            m_state(std::make_unique<State>()) {
+            this->m_state->prefixes = std::move(prefixes);
+            this->m_state->args = std::move(args);
+            if constexpr (std::is_invocable_v<SplitterArg &, StringViewType, std::back_insert_iterator<std::vector<StringViewType>>, 
+                                              BasicArgumentStore<CharType> &>) {
+                this->m_state->splitter = std::forward<SplitterArg>(splitter);
+            } else {
+                this->m_state->splitter = [splitter = std::forward<SplitterArg>(splitter)](StringViewType line, auto dest, BasicArgumentStore<CharType> &) mutable {
+                    splitter(line, dest);
+                };
+            }
+        }
+    private:
+        std::unique_ptr<State> m_state;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(LazyExpandedArgs)
+
 }
 
 #endif 
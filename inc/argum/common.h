@@ -12,6 +12,7 @@
 #include <string_view>
 #include <string>
 #include <concepts>
+#include <iterator>
 #include <exception>
 
 #include <assert.h>
@@ -105,7 +106,7 @@ namespace Argum {
         std::is_same_v<decltype(t != t), bool>;
         std::is_same_v<decltype(t == t), bool>;
         std::is_convertible_v<decltype(t[0]), std::basic_string_view<Char>>;
-    };
+    } || (std::forward_iterator<T> && std::is_convertible_v<std::iter_reference_t<T>, std::basic_string_view<Char>>);
 
     template<class T, class Char>
     concept ArgRange = requires(T & t) {
@@ -113,7 +114,7 @@ namespace Argum {
         requires ArgIterator<decltype(std::begin(t)), Char>;
         std::end(t);
         requires std::is_same_v<decltype(std::begin(t) != std::end(t)), bool>;
-        requires std::is_convertible_v<decltype(t[0]), std::basic_string_view<Char>>;
+        requires std::is_convertible_v<decltype(*std::begin(t)), std::basic_string_view<Char>>;
     };
 
 
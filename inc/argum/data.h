@@ -10,6 +10,7 @@
 
 #include "char-constants.h"
 #include "formatting.h"
+#include "messages.h"
 
 #include <string>
 #include <string_view>
@@ -18,6 +19,8 @@
 #include <limits>
 #include <memory>
 #include <tuple>
+#include <variant>
+#include <atomic>
 
 namespace Argum {
 
@@ -97,21 +100,32 @@ namespace Argum {
         ExtraPositional,
         ValidationError,
         ResponseFileError,
+        ResponseFileCycle,
+        ResponseFileWriteError,
 
-        Last = ResponseFileError,
+        Last = ResponseFileWriteError,
         UserError = int(Last) + 100
     };
 
+    /**
+     Base class for all parsing errors.
+
+     Derived classes can either pass a ready message to the constructor or keep only the data
+     describing the error and override formatMessage(). In the latter case the message, as well as
+     the narrow version returned by what() for wide characters, is only built on the first call to
+     message() or what(). If building them fails, for example because memory is exhausted, these
+     methods return a generic message instead and try again on the next call.
+     */
     ARGUM_MOD_EXPORTED
     template<class Char>
     class BasicParsingException : public std::exception {
     private:
-        using StringsType = std::conditional_t<std::is_same_v<Char, char>, 
-                                    std::tuple<std::string>,
-                                    std::tuple<std::string, std::basic_string<Char>>>;
+        using NarrowType = std::conditional_t<std::is_same_v<Char, char>, std::monostate, std::string>;
     public:
         auto message() const noexcept -> std::basic_string_view<Char> {
-            return std::get<std::tuple_size_v<StringsType> - 1>(this->m_strings);
+            if (!this->ensureStrings())
+                return Messages<Char>::messageUnavailable();
+            return this->m_message;
         }
 
         auto code() const noexcept -> Error {
@@ -133,7 +147,12 @@ namespace Argum {
         }
 
         auto what() const noexcept -> const char * override {
-            return std::get<0>(this->m_strings).c_str();
+            if (!this->ensureStrings())
+                return Messages<char>::messageUnavailable();
+            if constexpr (std::is_same_v<Char, char>)
+                return this->m_message.c_str();
+            else
+                return this->m_narrow.c_str();
         }
 
         virtual auto clone() const & -> std::shared_ptr<BasicParsingException> = 0;
@@ -143,20 +162,103 @@ namespace Argum {
         
     protected:
         BasicParsingException(Error code, std::basic_string<Char> message) : 
-            m_strings(BasicParsingException::initStrings(std::move(message))),
-            m_code(code) {
+            m_message(std::move(message)),
+            m_code(code),
+            m_lazy(false) {
+        }
+        //Message will be produced by formatMessage() when needed
+        BasicParsingException(Error code) : 
+            m_code(code),
+            m_lazy(true) {
+        }
+        //Copies do not share the lazily built strings and build their own when needed
+        BasicParsingException(const BasicParsingException & src):
+            std::exception(src),
+            m_message(src.m_lazy ? std::basic_string<Char>() : src.m_message),
+            m_code(src.m_code),
+            m_lazy(src.m_lazy) {
+        }
+        BasicParsingException(BasicParsingException && src):
+            std::exception(std::move(src)),
+            m_message(src.m_lazy ? std::basic_string<Char>() : std::move(src.m_message)),
+            m_code(src.m_code),
+            m_lazy(src.m_lazy) {
+        }
+        auto operator=(const BasicParsingException & src) -> BasicParsingException & {
+            if (this != &src) {
+                std::exception::operator=(src);
+                this->m_message = src.m_lazy ? std::basic_string<Char>() : src.m_message;
+                this->resetStrings(src);
+            }
+            return *this;
+        }
+        auto operator=(BasicParsingException && src) -> BasicParsingException & {
+            if (this != &src) {
+                std::exception::operator=(std::move(src));
+                this->m_message = src.m_lazy ? std::basic_string<Char>() : std::move(src.m_message);
+                this->resetStrings(src);
+            }
+            return *this;
+        }
+
+        virtual auto formatMessage() const -> std::basic_string<Char> {
+            return {};
         }
     private:
-        static auto initStrings(std::basic_string<Char> && message) -> StringsType {
-            if constexpr (std::is_same_v<Char, char>) {
-                return StringsType(std::move(message));
-            } else {
-                return StringsType(toString<char>(message), std::move(message));
+        enum StringsState : uint8_t {
+            StringsNotBuilt,
+            StringsBuilding,
+            StringsBuilt
+        };
+
+        //Returns false if the strings could not be built. Concurrent callers wait for the one building them.
+        auto ensureStrings() const noexcept -> bool {
+            auto state = this->m_stringsState.load(std::memory_order_acquire);
+            while (state != StringsBuilt) {
+                if (state == StringsBuilding) {
+                    this->m_stringsState.wait(StringsBuilding, std::memory_order_acquire);
+                    state = this->m_stringsState.load(std::memory_order_acquire);
+                    continue;
+                }
+                if (!this->m_stringsState.compare_exchange_weak(state, StringsBuilding, std::memory_order_acquire))
+                    continue;
+                bool built = this->buildStrings();
+                this->m_stringsState.store(built ? StringsBuilt : StringsNotBuilt, std::memory_order_release);
+                this->m_stringsState.notify_all();
+                return built;
+            }
+            return true;
+        }
+
+        auto buildStrings() const noexcept -> bool {
+        #ifndef ARGUM_NO_THROW
+            try {
+        #endif
+                if (this->m_lazy)
+                    this->m_message = this->formatMessage();
+                if constexpr (!std::is_same_v<Char, char>)
+                    this->m_narrow = toString<char>(this->m_message);
+                return true;
+        #ifndef ARGUM_NO_THROW
+            } catch (...) {
+                return false;
             }
+        #endif
+        }
+
+        auto resetStrings(const BasicParsingException & src) -> void {
+            if constexpr (!std::is_same_v<Char, char>)
+                this->m_narrow.clear();
+            this->m_code = src.m_code;
+            this->m_lazy = src.m_lazy;
+            this->m_stringsState.store(StringsNotBuilt, std::memory_order_relaxed);
         }
     private:
-        StringsType m_strings;
+        mutable std::basic_string<Char> m_message;
+        [[no_unique_address]] mutable NarrowType m_narrow;
+        mutable std::atomic<StringsState> m_stringsState = StringsNotBuilt;
         Error m_code;
+        bool m_lazy;
     };
     
     ARGUM_DECLARE_FRIENDLY_NAMES(ParsingException)
@@ -11,10 +11,14 @@
 #include "color.h"
 
 #include <string_view>
+#include <atomic>
+#include <limits>
 
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <signal.h>
 #if !defined(_WIN32) && __has_include(<unistd.h>)
     #define ARGUM_HAS_UNISTD_H
     #include <unistd.h>
@@ -59,7 +63,7 @@ namespace Argum {
         required    
     };
 
-    // Detect ColorStatus from the environment
+    // Detects ColorStatus from the environment, without caching
     // Logic taken from combination of:
     // https://no-color.org
     // https://force-color.org
@@ -68,7 +72,7 @@ namespace Argum {
     // https://gist.github.com/scop/4d5902b98f0503abec3fcbb00b38aec3
     // https://andrey-zherikov.github.io/argparse/ansi-coloring-and-styling.html#heuristic
     ARGUM_MOD_EXPORTED
-    inline auto environmentColorStatus() -> ColorStatus {
+    inline auto probeEnvironmentColorStatus() -> ColorStatus {
         using namespace std;
         using namespace std::literals;
 
@@ -126,63 +130,22 @@ namespace Argum {
         return ColorStatus::unknown;
     }
 
+    //Whether the file is a terminal, without caching
     ARGUM_MOD_EXPORTED
-    inline bool shouldUseColor(ColorStatus envColorStatus, FILE * fp) {
-        if (envColorStatus == ColorStatus::required)
-            return true;
-        if (envColorStatus == ColorStatus::forbidden)
-            return false;
-
+    inline auto probeIsTerminal(FILE * fp) -> bool {
 #if defined(ARGUM_HAS_UNISTD_H)
-        if (envColorStatus == ColorStatus::unknown)
-            return false;
-
         return isatty(fileno(fp));
-
 #elif defined(_WIN32)
         int desc = _fileno(fp);
-        if (desc < 0)
-            return false;
-
-        if (!_isatty(desc))
-            return false;
-
-        if (envColorStatus == ColorStatus::unknown) {
-        
-            HANDLE h = HANDLE(_get_osfhandle(_fileno(fp)));
-            if (h == INVALID_HANDLE_VALUE)
-                return false;
-
-            DWORD dwMode = 0;
-            if (!GetConsoleMode(h, &dwMode))
-                return false;
-
-            if (!(dwMode & ENABLE_VIRTUAL_TERMINAL_PROCESSING))
-                return false;
-        }
-
-        return true;
+        return desc >= 0 && _isatty(desc);
 #else
         return false;
 #endif
     }
 
+    //Width of the terminal the file refers to, without caching
     ARGUM_MOD_EXPORTED
-    inline auto colorizerForFile(ColorStatus envColorStatus, FILE * fp) -> Colorizer {
-        if (shouldUseColor(envColorStatus, fp))
-            return defaultColorizer();
-        return {};
-    }
-
-    ARGUM_MOD_EXPORTED
-    inline auto wideColorizerForFile(ColorStatus envColorStatus, FILE * fp) -> WColorizer {
-        if (shouldUseColor(envColorStatus, fp))
-            return defaultWColorizer();
-        return {};
-    }
-
-    ARGUM_MOD_EXPORTED
-    inline unsigned terminalWidth(FILE * fp) {
+    inline auto probeTerminalWidth(FILE * fp) -> unsigned {
         unsigned fallback = std::numeric_limits<unsigned>::max();
 
 #if defined(ARGUM_HAS_UNISTD_H) && defined(ARGUM_HAS_TIOCGWINSZ) 
@@ -232,6 +195,290 @@ namespace Argum {
 #endif
     }
 
+    /**
+     Snapshot of the environment color status and of the terminal properties of the standard streams.
+
+     Each value is probed on first use and cached. Values can also be injected with the `set...` 
+     methods. Injected values are kept until reset(). Probed ones are forgotten by invalidate() and, 
+     for terminal widths, when the terminal is resized if watchResize() was called. After redirecting
+     a standard stream to another file, for example with `dup2()` or `freopen()`, call 
+     invalidate(FILE *) for it. Files other than `stdin`, `stdout` and `stderr` are probed on every call.
+
+     The free functions environmentColorStatus(), shouldUseColor() and terminalWidth() use the
+     shared current() snapshot. All methods are safe to call concurrently.
+     */
+    ARGUM_MOD_EXPORTED
+    class TerminalInfo {
+    public:
+        TerminalInfo() = default;
+        TerminalInfo(const TerminalInfo &) = delete;
+        TerminalInfo & operator=(const TerminalInfo &) = delete;
+
+        static auto current() -> TerminalInfo & {
+            static TerminalInfo instance;
+            return instance;
+        }
+
+        auto colorStatus() -> ColorStatus {
+            unsigned ret;
+            uint64_t seen;
+            if (!this->m_colorStatus.get(ret, seen)) {
+                ret = unsigned(probeEnvironmentColorStatus());
+                this->m_colorStatus.storeProbed(seen, ret);
+            }
+            return ColorStatus(ret);
+        }
+
+        auto isTerminal(FILE * fp) -> bool {
+            auto slot = TerminalInfo::slotFor(this->m_isTerminal, fp);
+            if (!slot)
+                return probeIsTerminal(fp);
+            unsigned ret;
+            uint64_t seen;
+            if (!slot->get(ret, seen)) {
+                ret = probeIsTerminal(fp);
+                slot->storeProbed(seen, ret);
+            }
+            return ret;
+        }
+
+        auto width(FILE * fp) -> unsigned {
+            auto slot = TerminalInfo::slotFor(this->m_width, fp);
+            if (!slot)
+                return probeTerminalWidth(fp);
+            unsigned generation = s_resizeGeneration.load(std::memory_order_relaxed);
+            unsigned ret;
+            uint64_t seen;
+            if (!slot->get(ret, seen, generation)) {
+                ret = probeTerminalWidth(fp);
+                slot->storeProbed(seen, ret, generation);
+            }
+            return ret;
+        }
+
+        auto setColorStatus(ColorStatus status) -> void {
+            this->m_colorStatus.inject(unsigned(status));
+        }
+        auto setIsTerminal(FILE * fp, bool value) -> void {
+            if (auto slot = TerminalInfo::slotFor(this->m_isTerminal, fp))
+                slot->inject(value);
+        }
+        auto setWidth(FILE * fp, unsigned value) -> void {
+            if (auto slot = TerminalInfo::slotFor(this->m_width, fp))
+                slot->inject(value);
+        }
+
+        //Forgets probed values so that they are probed again on next use
+        auto invalidate() -> void {
+            this->forEachSlot([](Slot & slot) { slot.invalidate(false); });
+        }
+        //Forgets probed values for a file, for example after it has been redirected
+        auto invalidate(FILE * fp) -> void {
+            if (auto slot = TerminalInfo::slotFor(this->m_isTerminal, fp))
+                slot->invalidate(false);
+            if (auto slot = TerminalInfo::slotFor(this->m_width, fp))
+                slot->invalidate(false);
+        }
+        //Forgets both probed and injected values
+        auto reset() -> void {
+            this->forEachSlot([](Slot & slot) { slot.invalidate(true); });
+        }
+
+        /**
+         Installs a `SIGWINCH` handler that makes all snapshots re-probe terminal widths after a resize.
+
+         A previously installed handler is still invoked. Returns false if the platform has no 
+         `SIGWINCH` or the handler could not be installed.
+         */
+        static auto watchResize() -> bool {
+        #if defined(ARGUM_HAS_UNISTD_H) && defined(SIGWINCH)
+            static const bool installed = []() {
+                struct sigaction action{};
+                action.sa_sigaction = TerminalInfo::onResize;
+                sigemptyset(&action.sa_mask);
+                action.sa_flags = SA_RESTART | SA_SIGINFO;
+                return sigaction(SIGWINCH, &action, &previousResizeAction()) == 0;
+            }();
+            return installed;
+        #else
+            return false;
+        #endif
+        }
+
+        //Makes all snapshots re-probe terminal widths. Safe to call from a signal handler.
+        static auto notifyResize() -> void {
+            s_resizeGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    private:
+        /*
+         The value, its state and the resize generation it was probed at are packed into a single word
+         so that a probed value is only stored if the slot has not changed, and in particular has not 
+         had a value injected, since it was read.
+         */
+        class Slot {
+        public:
+            enum State : uint64_t { empty, probed, injected };
+
+            //Returns false if the value needs to be probed. `seen` receives the word to pass to storeProbed()
+            auto get(unsigned & value, uint64_t & seen, unsigned generation = 0) const -> bool {
+                seen = this->m_word.load(std::memory_order_acquire);
+                auto state = Slot::stateOf(seen);
+                if (state == empty)
+                    return false;
+                if (state == probed && Slot::generationOf(seen) != (generation & generationMask))
+                    return false;
+                value = Slot::valueOf(seen);
+                return true;
+            }
+            auto storeProbed(uint64_t seen, unsigned value, unsigned generation = 0) -> void {
+                this->m_word.compare_exchange_strong(seen, Slot::pack(value, probed, generation), 
+                                                     std::memory_order_release, std::memory_order_relaxed);
+            }
+            auto inject(unsigned value) -> void {
+                this->m_word.store(Slot::pack(value, injected, 0), std::memory_order_release);
+            }
+            auto invalidate(bool injectedToo) -> void {
+                auto word = this->m_word.load(std::memory_order_relaxed);
+                while (Slot::stateOf(word) == probed || (injectedToo && Slot::stateOf(word) == injected)) {
+                    //advance the generation so that the emptied word differs from the one a concurrent prober saw
+                    auto emptied = Slot::pack(0, empty, Slot::generationOf(word) + 1);
+                    if (this->m_word.compare_exchange_weak(word, emptied))
+                        break;
+                }
+            }
+        private:
+            static constexpr uint64_t generationMask = (uint64_t(1) << 30) - 1;
+
+            static auto pack(unsigned value, State state, uint64_t generation) -> uint64_t {
+                return uint64_t(value) | ((generation & generationMask) << 32) | (uint64_t(state) << 62);
+            }
+            static auto valueOf(uint64_t word) -> unsigned {
+                return unsigned(word & 0xFFFFFFFF);
+            }
+            static auto generationOf(uint64_t word) -> uint64_t {
+                return (word >> 32) & generationMask;
+            }
+            static auto stateOf(uint64_t word) -> State {
+                return State(word >> 62);
+            }
+        private:
+            std::atomic<uint64_t> m_word{0};
+        };
+
+        static constexpr int cachedDescriptors = 3;
+
+        static auto slotFor(Slot (&slots)[cachedDescriptors], FILE * fp) -> Slot * {
+        #if defined(_WIN32)
+            int desc = _fileno(fp);
+        #elif defined(ARGUM_HAS_UNISTD_H)
+            int desc = fileno(fp);
+        #else
+            int desc = (fp == stdin ? 0 : fp == stdout ? 1 : fp == stderr ? 2 : -1);
+        #endif
+            if (desc < 0 || desc >= cachedDescriptors)
+                return nullptr;
+            return &slots[desc];
+        }
+
+        template<class Func>
+        auto forEachSlot(Func func) -> void {
+            func(this->m_colorStatus);
+            for (auto & slot: this->m_isTerminal)
+                func(slot);
+            for (auto & slot: this->m_width)
+                func(slot);
+        }
+
+    #if defined(ARGUM_HAS_UNISTD_H) && defined(SIGWINCH)
+        static auto previousResizeAction() -> struct sigaction & {
+            static struct sigaction action{};
+            return action;
+        }
+
+        static void onResize(int sig, siginfo_t * info, void * context) {
+            TerminalInfo::notifyResize();
+            auto & previous = previousResizeAction();
+            if (previous.sa_flags & SA_SIGINFO) {
+                if (previous.sa_sigaction)
+                    previous.sa_sigaction(sig, info, context);
+            } else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+                previous.sa_handler(sig);
+            }
+        }
+    #endif
+
+    private:
+        static inline std::atomic<unsigned> s_resizeGeneration{0};
+
+        Slot m_colorStatus;
+        Slot m_isTerminal[cachedDescriptors];
+        Slot m_width[cachedDescriptors];
+    };
+
+    // Detect ColorStatus from the environment. The result is cached in TerminalInfo::current()
+    ARGUM_MOD_EXPORTED
+    inline auto environmentColorStatus() -> ColorStatus {
+        return TerminalInfo::current().colorStatus();
+    }
+
+    ARGUM_MOD_EXPORTED
+    inline bool shouldUseColor(ColorStatus envColorStatus, FILE * fp) {
+        if (envColorStatus == ColorStatus::required)
+            return true;
+        if (envColorStatus == ColorStatus::forbidden)
+            return false;
+
+#if defined(ARGUM_HAS_UNISTD_H)
+        if (envColorStatus == ColorStatus::unknown)
+            return false;
+
+        return TerminalInfo::current().isTerminal(fp);
+
+#elif defined(_WIN32)
+        if (!TerminalInfo::current().isTerminal(fp))
+            return false;
+
+        if (envColorStatus == ColorStatus::unknown) {
+        
+            HANDLE h = HANDLE(_get_osfhandle(_fileno(fp)));
+            if (h == INVALID_HANDLE_VALUE)
+                return false;
+
+            DWORD dwMode = 0;
+            if (!GetConsoleMode(h, &dwMode))
+                return false;
+
+            if (!(dwMode & ENABLE_VIRTUAL_TERMINAL_PROCESSING))
+                return false;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    ARGUM_MOD_EXPORTED
+    inline auto colorizerForFile(ColorStatus envColorStatus, FILE * fp) -> Colorizer {
+        if (shouldUseColor(envColorStatus, fp))
+            return defaultColorizer();
+        return {};
+    }
+
+    ARGUM_MOD_EXPORTED
+    inline auto wideColorizerForFile(ColorStatus envColorStatus, FILE * fp) -> WColorizer {
+        if (shouldUseColor(envColorStatus, fp))
+            return defaultWColorizer();
+        return {};
+    }
+
+    //Width of the terminal the file refers to. The result is cached in TerminalInfo::current()
+    ARGUM_MOD_EXPORTED
+    inline unsigned terminalWidth(FILE * fp) {
+        return TerminalInfo::current().width(fp);
+    }
+
 }
 
 #endif
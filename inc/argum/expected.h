@@ -13,6 +13,10 @@
 
 #include <variant>
 #include <optional>
+#include <algorithm>
+#include <atomic>
+
+#include <stdint.h>
 
 namespace Argum {
 
@@ -20,6 +24,137 @@ namespace Argum {
 
     ARGUM_MOD_EXPORTED template<class T> inline constexpr FailureType<T> Failure{};
 
+    /**
+     Compact representation of the most common parsing errors.
+
+     Stores the kind of the error, the index of the offending command line argument and a view of
+     the offending option name or argument in the command line. It never allocates, is trivially
+     copyable and is as small as a `std::shared_ptr`. The message and the exception object are only 
+     built when requested.
+
+     Since the subject is not copied, the error must not be inspected after the command line it 
+     refers to is destroyed. The exception object returned by exception() owns a copy.
+
+     Exceptions that declare `static constexpr bool IsCompact = true` and can be constructed from
+     `(StringViewType subject, int argumentIndex)` can be represented this way.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicParsingError {
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+        using ParsingException = BasicParsingException<Char>;
+        using ParsingExceptionPtr = std::shared_ptr<ParsingException>;
+
+        static constexpr size_t maxSubjectSize = UINT16_MAX;
+
+    public:
+        //Returns nullopt if the subject is too long or too many different exception types are represented
+        template<class Exception>
+        requires(std::is_base_of_v<ParsingException, Exception> && Exception::IsCompact)
+        static auto make(StringViewType subject, int argumentIndex = -1) -> std::optional<BasicParsingError> {
+            auto kind = kindOf<Exception>();
+            if (subject.size() > maxSubjectSize || kind == noKind)
+                return std::nullopt;
+            BasicParsingError ret;
+            ret.m_subject = subject.data();
+            ret.m_argumentIndex = argumentIndex;
+            ret.m_subjectSize = uint16_t(subject.size());
+            ret.m_kind = kind;
+            return ret;
+        }
+
+        auto code() const noexcept -> Error {
+            return kinds()[this->m_kind].code;
+        }
+
+        //Index of the offending argument in the command line or -1 if not known
+        auto argumentIndex() const noexcept -> int {
+            return this->m_argumentIndex;
+        }
+
+        //Offending option name or argument
+        auto subject() const noexcept -> StringViewType {
+            return StringViewType(this->m_subject, this->m_subjectSize);
+        }
+
+        auto message() const -> StringType {
+            switch(this->code()) {
+                case Error::UnrecognizedOption:     return format<Messages<Char>::unrecognizedOptionError>(this->subject());
+                case Error::MissingOptionArgument:  return format<Messages<Char>::missingOptionArgumentError>(this->subject());
+                case Error::ExtraOptionArgument:    return format<Messages<Char>::extraOptionArgumentError>(this->subject());
+                case Error::ExtraPositional:        return format<Messages<Char>::extraPositionalError>(this->subject());
+                default:                            return StringType(this->exception()->message());
+            }
+        }
+
+        //Creates the exception object this error stands for
+        auto exception() const -> ParsingExceptionPtr {
+            return kinds()[this->m_kind].materialize(this->subject(), this->argumentIndex());
+        }
+
+    private:
+        BasicParsingError() = default;
+
+        struct Kind {
+            Error code;
+            ParsingExceptionPtr (*materialize)(StringViewType subject, int argumentIndex);
+        };
+        static constexpr unsigned maxKinds = 64;
+        static constexpr uint8_t noKind = UINT8_MAX;
+
+        static auto kinds() -> Kind * {
+            static Kind ret[maxKinds];
+            return ret;
+        }
+
+        static auto kindCount() -> std::atomic<unsigned> & {
+            static std::atomic<unsigned> ret{0};
+            return ret;
+        }
+
+        //Assigns each exception type a slot in kinds() on first use
+        template<class Exception>
+        static auto kindOf() -> uint8_t {
+            static const uint8_t kind = []() {
+                unsigned idx = kindCount().fetch_add(1, std::memory_order_relaxed);
+                if (idx >= maxKinds)
+                    return noKind;
+                kinds()[idx] = {Exception::ErrorCode, [](StringViewType subject, int argumentIndex) -> ParsingExceptionPtr {
+                    return std::make_shared<Exception>(subject, argumentIndex);
+                }};
+                return uint8_t(idx);
+            }();
+            return kind;
+        }
+    private:
+        const Char * m_subject;
+        int m_argumentIndex;
+        uint16_t m_subjectSize;
+        uint8_t m_kind;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ParsingError)
+
+    namespace Impl {
+        //Error moved out of a failed BasicExpected to be returned as a BasicExpected of another type
+        template<class Char>
+        struct PropagatedError {
+            std::variant<BasicParsingError<Char>, std::shared_ptr<BasicParsingException<Char>>> error;
+        };
+    }
+
+    /**
+     Result of an operation that can fail with a parsing error.
+
+     Common parser errors are stored as BasicParsingError without allocating. Other errors are
+     stored as exception objects. Use errorCode() and errorMessage() to inspect an error without
+     materializing it. error() always returns an exception object. For a compact error a new one is 
+     created on each call. Call detachError() to replace a compact error with an exception object once,
+     after which the error no longer refers to the command line.
+     */
     ARGUM_MOD_EXPORTED
     template<class Char, class T>
     class [[nodiscard]] BasicExpected {
@@ -29,12 +164,13 @@ namespace Argum {
     public:
         using ParsingException = BasicParsingException<Char>;
         using ParsingExceptionPtr = std::shared_ptr<ParsingException>;
+        using ParsingError = BasicParsingError<Char>;
 
         using ConstLValueReference = std::add_lvalue_reference_t<const T>;
         using LValueReference = std::add_lvalue_reference_t<T>;
         using RValueReference = std::add_rvalue_reference_t<T>;
     private:
-        using ImplType = std::variant<ValueType, ParsingExceptionPtr>;
+        using ImplType = std::variant<ValueType, ParsingError, ParsingExceptionPtr>;
     public:
         BasicExpected() = default;
 
@@ -47,6 +183,15 @@ namespace Argum {
         BasicExpected(ParsingExceptionPtr err): m_impl(BasicExpected::validate(err)) {
         }
 
+        BasicExpected(ParsingError err): m_impl(err) {
+        }
+
+        BasicExpected(Impl::PropagatedError<Char> && err): 
+            m_impl(std::visit([](auto && val) {
+                    return ImplType(std::move(val));
+                }, std::move(err.error))) {
+        }
+
         template<class Exception, class... Args>
         requires(std::is_base_of_v<ParsingException, Exception>)
         BasicExpected(FailureType<Exception>, Args && ...args): 
@@ -57,7 +202,8 @@ namespace Argum {
         requires(std::is_constructible_v<T, OtherT> || std::is_same_v<T, void>)
         BasicExpected(const BasicExpected<Char, OtherT> & other): 
             m_impl(std::visit([&](const auto & val) {
-                    if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, ParsingExceptionPtr>) {
+                    using ValType = std::remove_cvref_t<decltype(val)>;
+                    if constexpr (std::is_same_v<ValType, ParsingExceptionPtr> || std::is_same_v<ValType, ParsingError>) {
                         return ImplType(val); 
                     } else if constexpr (!std::is_same_v<T, void>) {
                         return ImplType(val); 
@@ -122,13 +268,45 @@ namespace Argum {
         }
 
         auto error() const -> ParsingExceptionPtr {
-            return std::visit([](const auto & val) -> ParsingExceptionPtr {
-                if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, ParsingExceptionPtr>) {
-                    return val;
-                } else {
-                    return ParsingExceptionPtr();
-                }
-            }, this->m_impl);
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return compact->exception();
+            if (auto ptr = std::get_if<ParsingExceptionPtr>(&this->m_impl))
+                return *ptr;
+            return ParsingExceptionPtr();
+        }
+
+        //Replaces a compact error with an exception object that does not refer to the command line
+        auto detachError() -> void {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                this->m_impl = compact->exception();
+        }
+
+        //Compact error or nullptr if there is no error or it is stored as an exception
+        auto compactError() const -> const ParsingError * {
+            return std::get_if<ParsingError>(&this->m_impl);
+        }
+
+        auto errorCode() const -> std::optional<Error> {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return compact->code();
+            if (auto ptr = std::get_if<ParsingExceptionPtr>(&this->m_impl); ptr && *ptr)
+                return (*ptr)->code();
+            return std::nullopt;
+        }
+
+        auto errorMessage() const -> std::basic_string<Char> {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return compact->message();
+            if (auto ptr = std::get_if<ParsingExceptionPtr>(&this->m_impl); ptr && *ptr)
+                return std::basic_string<Char>((*ptr)->message());
+            return {};
+        }
+
+        //Moves the error out for propagation to a BasicExpected of another type. Must only be called on failure.
+        auto takeError() && -> Impl::PropagatedError<Char> {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return {*compact};
+            return {std::move(*std::get_if<ParsingExceptionPtr>(&this->m_impl))};
         }
 
         explicit operator bool() const {
@@ -143,6 +321,10 @@ namespace Argum {
                 ARGUM_INVALID_ARGUMENT("error must be non-null");
             return std::move(ptr);
         }
+
+        [[noreturn]] static auto raise(const ParsingError & err) {
+            BasicExpected::raise(err.exception());
+        }
         [[noreturn]] static auto raise(const ParsingExceptionPtr & ptr) {
             if (ptr)
                 ptr->raise();
@@ -204,7 +386,7 @@ namespace Argum {
 
     #ifdef ARGUM_USE_EXPECTED
         #define ARGUM_EXPECTED(c, type) BasicExpected<c, type>
-        #define ARGUM_PROPAGATE_ERROR(expr) if (auto err = (expr).error()) { return err; }
+        #define ARGUM_PROPAGATE_ERROR(expr) if (auto && argum_propagated = (expr); !argum_propagated) { return std::move(argum_propagated).takeError(); }
         #define ARGUM_CHECK_RESULT_IMPL(temp, var, expr) decltype(auto) temp = (expr); ARGUM_PROPAGATE_ERROR(temp); var = *temp
         #define ARGUM_CHECK_RESULT(var, expr)  ARGUM_CHECK_RESULT_IMPL(ARGUM_UNIQUE_NAME(argum_check_result), var, expr)
         #define ARGUM_THROW(type, ...) return {Failure<type> __VA_OPT__(,) __VA_ARGS__}
@@ -17,6 +17,8 @@
 #include <concepts>
 #include <optional>
 #include <algorithm>
+#include <array>
+#include <limits>
 
 #include <limits.h>
 #include <wchar.h>
@@ -108,70 +110,138 @@ namespace Argum {
         }
     }
 
-    inline auto stringWidth(const std::wstring_view & str) -> unsigned {
-
-        int res = Impl::simpleWidth(str.data(), str.size());
-        if (res >= 0)
-            return res;
+    namespace Impl {
         
-        std::wstring stripped;
-        enum {
-            stateNormal,
-            stateEsc,
-            stateControlStart,
-            stateControlIntermediate
-        } state = stateNormal;
-        for (wchar_t c: str) {
-            switch(state) {
-            break; case stateNormal: restart:
-                if (c == L'\x1b') {
-                    state = stateEsc;
-                    continue;
-                }
-                stripped += c;
+        struct TextWidth {
+            unsigned width = 0;     //sum of column widths of all characters
+            unsigned length = 0;    //number of characters
+            bool printable = true;  //false if some characters have no column width
+
+            //If some characters are not printable we fall back on number of characters
+            auto value() const -> unsigned {
+                return printable ? width : length;
+            }
 
-            break; case stateEsc:
-                if (c == L'[') {
-                    state = stateControlStart;
-                    continue;
-                }
-                state = stateNormal;
-                goto restart;
+            auto operator+=(const TextWidth & rhs) -> TextWidth & {
+                width += rhs.width;
+                length += rhs.length;
+                printable = printable && rhs.printable;
+                return *this;
+            }
+        };
 
-            break; case stateControlStart:
-                if (c >= 0x30 && c <= 0x3F) {
-                    continue;
-                }
-                if (c >= 0x20 && c <= 0x2F) {
-                    state = stateControlIntermediate;
-                    continue;
-                }
-                if (c >= 0x40 && c <= 0x7E) {
+        //Measures the string ignoring any ANSI escape sequences in it
+        inline auto measureWidth(const std::wstring_view & str) -> TextWidth {
+
+            if (str.find(L'\x1b') == str.npos) {
+                int res = simpleWidth(str.data(), str.size());
+                if (res >= 0)
+                    return {unsigned(res), unsigned(str.size()), true};
+                return {0, unsigned(str.size()), false};
+            }
+
+            std::wstring stripped;
+            enum {
+                stateNormal,
+                stateEsc,
+                stateControlStart,
+                stateControlIntermediate
+            } state = stateNormal;
+            for (wchar_t c: str) {
+                switch(state) {
+                break; case stateNormal: restart:
+                    if (c == L'\x1b') {
+                        state = stateEsc;
+                        continue;
+                    }
+                    stripped += c;
+
+                break; case stateEsc:
+                    if (c == L'[') {
+                        state = stateControlStart;
+                        continue;
+                    }
                     state = stateNormal;
-                    continue;
-                }
-                state = stateNormal;
-                goto restart;
+                    goto restart;
 
-            break; case stateControlIntermediate:
-                if (c >= 0x20 && c <= 0x2F) {
-                    state = stateControlIntermediate;
-                    continue;
-                }
-                if (c >= 0x40 && c <= 0x7E) {
+                break; case stateControlStart:
+                    if (c >= 0x30 && c <= 0x3F) {
+                        continue;
+                    }
+                    if (c >= 0x20 && c <= 0x2F) {
+                        state = stateControlIntermediate;
+                        continue;
+                    }
+                    if (c >= 0x40 && c <= 0x7E) {
+                        state = stateNormal;
+                        continue;
+                    }
+                    state = stateNormal;
+                    goto restart;
+
+                break; case stateControlIntermediate:
+                    if (c >= 0x20 && c <= 0x2F) {
+                        state = stateControlIntermediate;
+                        continue;
+                    }
+                    if (c >= 0x40 && c <= 0x7E) {
+                        state = stateNormal;
+                        continue;
+                    }
                     state = stateNormal;
-                    continue;
+                    goto restart;
                 }
-                state = stateNormal;
-                goto restart;
             }
+
+            int res = simpleWidth(stripped.data(), stripped.size());
+            if (res >= 0)
+                return {unsigned(res), unsigned(stripped.size()), true};
+            return {0, unsigned(stripped.size()), false};
         }
 
-        res = Impl::simpleWidth(stripped.data(), stripped.size());
-        if (res >= 0)
-            return res;
-        
-        return unsigned(stripped.size());
+        //Narrow version. The buffer is used for conversion and can be reused between calls
+        inline auto measureWidth(const std::string_view & str, std::wstring & buffer) -> TextWidth {
+            
+            buffer.clear();
+            mbstate_t state = mbstate_t();
+            for (auto current = str.data(), last = current + str.size(); current != last; ) {
+                wchar_t c;
+                size_t res = mbrtowc(&c, current, size_t(last - current), &state);
+                if (res == size_t(-1) || res == size_t(-2))
+                    return {};
+                if (res == 0)
+                    res = 1;
+                buffer += c;
+                current += res;
+            }
+            return measureWidth(buffer);
+        }
+    }
+
+    namespace Impl {
+        //Measures text known not to contain escape sequences. 
+        //The buffer is only used for conversion of non-ASCII narrow text
+        template<Character Char>
+        auto measurePlainWidth(std::basic_string_view<Char> str, std::wstring & buffer) -> TextWidth {
+
+            bool printableAscii = std::all_of(str.begin(), str.end(), [](Char c) {
+                return c >= Char(0x20) && c < Char(0x7F);
+            });
+            if (printableAscii)
+                return {unsigned(str.size()), unsigned(str.size()), true};
+
+            if constexpr (std::is_same_v<Char, wchar_t>) {
+                return measureWidth(str);
+            } else {
+                static_assert(std::is_same_v<Char, char>, "only char and wchar_t are supported");
+                return measureWidth(str, buffer);
+            }
+        }
+    }
+
+    inline auto stringWidth(const std::wstring_view & str) -> unsigned {
+
+        return Impl::measureWidth(str).value();
     }
 
     inline auto stringWidth(const std::string_view & str) -> unsigned {
@@ -188,21 +258,23 @@ namespace Argum {
         return ret;
     }
     
-    template<Character Char>
-    auto appendByIndex(std::basic_string<Char> & /*dest*/, size_t /*idx*/) {
+    template<Character Char, StringAppendable<Char>... Args>
+    auto appendByIndex(std::basic_string<Char> & dest, size_t idx, Args && ...args) {
 
-        //do nothing
+        size_t current = 0;
+        (void)((current++ == idx && (append(dest, std::forward<Args>(args)), true)) || ...);
     }
 
-    template<Character Char, StringAppendable<Char> First, StringAppendable<Char>... Rest>
-    auto appendByIndex(std::basic_string<Char> & dest, size_t idx, First && first, Rest && ...rest) {
+    namespace Impl {
 
-        if (idx == 0) {
-            append(dest, std::forward<First>(first));
-            return;
+        //Cheap estimate of how many characters appending val will produce
+        template<Character Char, class T>
+        auto formattedSizeHint(const T & val) -> size_t {
+            if constexpr (StringLike<T>)
+                return std::basic_string_view<CharTypeOf<T>>(val).size();
+            else
+                return 16;
         }
-
-        appendByIndex(dest, idx - 1, rest...);
     }
 
     template<Character Char>
@@ -264,6 +336,7 @@ namespace Argum {
         StringViewType fmtView(fmt);
 
         StringType ret;
+        ret.reserve((fmtView.size() + ... + Impl::formattedSizeHint<CharType>(args)));
 
         auto outStart = fmtView.data();
         auto current = outStart;
@@ -306,66 +379,275 @@ namespace Argum {
         return ret;
     }
 
-    template<StringLike T>
-    auto wordWrap(T && input, unsigned maxLength, 
-                  unsigned indent = 0, unsigned firstLineOffset = 0) -> std::basic_string<CharTypeOf<T>> {
+    namespace Impl {
 
-        using Char = CharTypeOf<T>;
+        //A piece of a format string: either literal text or a placeholder
+        struct FormatSegment {
+            size_t start = 0;   //offset of the segment text in the format string
+            size_t size = 0;    //size of the segment text
+            size_t argIdx = 0;  //1-based argument index for placeholders, 0 for literal text
+        };
+
+        //constexpr equivalent of parseFormatPlaceholder. Returns 0 if the text is not a valid index
+        template<Character Char>
+        constexpr auto parseFormatIndex(std::basic_string_view<Char> str) -> size_t {
+
+            if (str.empty())
+                return 0;
+            size_t ret = 0;
+            for (auto c: str) {
+                if (c < CharConstants<Char>::digit_0 || c > CharConstants<Char>::digit_0 + 9)
+                    return 0;
+                auto digit = size_t(c - CharConstants<Char>::digit_0);
+                if (ret > (std::numeric_limits<size_t>::max() - digit) / 10)
+                    return 0;
+                ret = ret * 10 + digit;
+            }
+            return ret;
+        }
+
+        //Splits fmt into segments exactly the way the runtime format() scans it, 
+        //calling handler for each non-empty one
+        template<Character Char, class Handler>
+        constexpr auto parseFormat(std::basic_string_view<Char> fmt, Handler handler) {
+
+            using CharConstants = CharConstants<Char>;
+
+            size_t outStart = 0;
+            size_t current = 0;
+            const size_t last = fmt.size();
+
+            auto flush = [&](size_t end) {
+                if (end != outStart)
+                    handler(FormatSegment{outStart, end - outStart, 0});
+            };
 
-        std::basic_string_view<Char> str(std::forward<T>(input));
+            while(current != last) {
+
+                if (fmt[current] == CharConstants::braceOpen) {
+                    ++current;
+                    if (current == last)
+                        break;
+                    if (fmt[current] == CharConstants::braceOpen) {
+                        flush(current);
+                        ++current;
+                        outStart = current;
+                        continue;
+                    }
+
+                    auto placeholderEnd = fmt.find(CharConstants::braceClose, current);
+                    if (placeholderEnd == fmt.npos)
+                        continue;
+                    auto argIdx = parseFormatIndex(fmt.substr(current, placeholderEnd - current));
+                    if (argIdx == 0)
+                        continue;
+
+                    flush(current - 1);
+                    handler(FormatSegment{current - 1, placeholderEnd + 2 - current, argIdx});
+                    current = placeholderEnd + 1;
+                    outStart = current;
+                } else {
+                    ++current;
+                }
+            }
+            flush(last);
+        }
+
+        template<Character Char>
+        constexpr auto countFormatSegments(std::basic_string_view<Char> fmt) -> size_t {
+            size_t ret = 0;
+            parseFormat(fmt, [&](FormatSegment) { ++ret; });
+            return ret;
+        }
+
+        //Format string with placeholders resolved at compile time
+        template<Character Char, size_t N>
+        class CompiledFormat {
+        public:
+            using StringViewType = std::basic_string_view<Char>;
+            using StringType = std::basic_string<Char>;
+
+            constexpr CompiledFormat(StringViewType fmt): m_fmt(fmt) {
+                size_t idx = 0;
+                parseFormat(fmt, [&](FormatSegment seg) { this->m_segments[idx++] = seg; });
+            }
+
+            template<StringAppendable<Char>... Args>
+            auto operator()(Args && ...args) const -> StringType {
+
+                [[maybe_unused]] const size_t argSizes[] = {formattedSizeHint<Char>(args)..., 0};
+
+                size_t size = 0;
+                for (auto & seg: this->m_segments)
+                    size += isText<sizeof...(Args)>(seg) ? seg.size : argSizes[seg.argIdx - 1];
+                
+                StringType ret;
+                ret.reserve(size);
+                for (auto & seg: this->m_segments) {
+                    if (isText<sizeof...(Args)>(seg))
+                        ret.append(this->m_fmt.data() + seg.start, seg.size);
+                    else
+                        appendByIndex(ret, seg.argIdx - 1, args...);
+                }
+                return ret;
+            }
+
+        private:
+            //placeholders referring to non-existent arguments are output as is, like in runtime format()
+            template<size_t ArgCount>
+            static constexpr auto isText(const FormatSegment & seg) -> bool {
+                return seg.argIdx == 0 || seg.argIdx > ArgCount;
+            }
+
+        private:
+            StringViewType m_fmt;
+            std::array<FormatSegment, N> m_segments;
+        };
+
+        template<auto Fmt>
+        using FormatCharType = CharTypeOf<decltype(Fmt())>;
+
+        template<auto Fmt>
+        concept ConstantFormat = requires {
+            typename std::integral_constant<size_t, countFormatSegments(std::basic_string_view<FormatCharType<Fmt>>(Fmt()))>;
+        };
+
+        template<auto Fmt>
+        requires(ConstantFormat<Fmt>)
+        constexpr auto compileFormat() {
+            using CharType = FormatCharType<Fmt>;
+            constexpr std::basic_string_view<CharType> fmt(Fmt());
+            return CompiledFormat<CharType, countFormatSegments(fmt)>(fmt);
+        }
+
+        template<auto Fmt>
+        requires(ConstantFormat<Fmt>)
+        inline constexpr auto compiledFormat = compileFormat<Fmt>();
+    }
+
+    /**
+     Same as format(fmt, args...) but with the format string supplied by a function, 
+     such as one of Messages<Char> members. When the function is constexpr the 
+     format string is parsed at compile time. Otherwise this falls back on runtime
+     parsing.
+     */
+    template<auto Fmt, StringAppendable<Impl::FormatCharType<Fmt>>... Args>
+    auto format(Args && ...args) {
+
+        if constexpr (Impl::ConstantFormat<Fmt>)
+            return Impl::compiledFormat<Fmt>(std::forward<Args>(args)...);
+        else
+            return format(Fmt(), std::forward<Args>(args)...);
+    }
+
+    template<Character Char>
+    auto appendWordWrapped(std::basic_string<Char> & dest, 
+                           std::basic_string_view<Char> str, 
+                           unsigned maxLength, 
+                           unsigned indent = 0, 
+                           unsigned firstLineOffset = 0) -> std::basic_string<Char> & {
+
+        constexpr auto space = CharConstants<Char>::space;
+        constexpr auto endl = CharConstants<Char>::endl;
+        constexpr auto npos = std::basic_string_view<Char>::npos;
         
         if (maxLength == 0 || str.empty())
-            return {};
+            return dest;
 
         if (indent >= maxLength)
             indent = maxLength - 1;
 
-        std::basic_string<Char> ret;
-        ret.reserve(str.size());
-        std::basic_string<Char> prefix;
+        unsigned prefixLength = 0;
         bool firstLine = true;
 
         unsigned curMaxLen;
         if (firstLineOffset >= maxLength) {
-            ret += CharConstants<Char>::endl;
-            prefix = std::basic_string<Char>(indent, CharConstants<char>::space);
-            ret += prefix;
+            dest += endl;
+            dest.append(indent, space);
+            prefixLength = indent;
             curMaxLen = maxLength - indent;
             firstLine = false;
         } else {
             curMaxLen = maxLength - firstLineOffset;
         }
+
+        dest.reserve(dest.size() + str.size() + (size_t(indent) + 1) * (str.size() / curMaxLen + 1));
+
+        [[maybe_unused]] std::wstring buffer;
+        auto measure = [&](std::basic_string_view<Char> text) {
+            if constexpr (std::is_same_v<Char, wchar_t>)
+                return Impl::measureWidth(text);
+            else
+                return Impl::measureWidth(text, buffer);
+        };
         
+        size_t start = 0;
+        size_t eolPos = str.find(endl);
         for ( ; ; ) {
-            auto eolPos = str.find(CharConstants<Char>::endl);
-            auto line = str.substr(0, eolPos);
-            bool needLineBreak = (eolPos != str.npos);
-            auto width = stringWidth(line);
-            while (width > curMaxLen) {
-                auto spacePos = line.rfind(CharConstants<Char>::space);
-                if (spacePos == line.npos)
+            if (eolPos < start)
+                eolPos = str.find(endl, start);
+            const size_t lineEnd = (eolPos != npos ? eolPos : str.size());
+            bool needLineBreak = (eolPos != npos);
+
+            //Accumulate word widths until the line no longer fits. 
+            //lastFit is the end of the longest fitting run of words
+            Impl::TextWidth width;
+            size_t lastFit = npos;
+            size_t wordStart = start;
+            size_t wordEnd;
+            for ( ; ; ) {
+                wordEnd = size_t(std::find(str.begin() + wordStart, str.begin() + lineEnd, space) - str.begin());
+                width += measure(str.substr(wordStart, wordEnd - wordStart));
+                if (width.value() > curMaxLen)
                     break;
-                line = line.substr(0, spacePos);
-                needLineBreak = true;
-                width = stringWidth(line);
+                lastFit = wordEnd;
+                if (wordEnd == lineEnd)
+                    break;
+                width += Impl::TextWidth{1, 1, true};
+                wordStart = wordEnd + 1;
             }
-            ret += prefix;
-            ret += line;
-            if (needLineBreak) {
-                ret += CharConstants<Char>::endl;
-                str = str.substr(line.size() + 1);
+
+            size_t lineSize;
+            if (lastFit == lineEnd) {
+                lineSize = lineEnd - start;
+            } else if (lastFit != npos) {
+                lineSize = lastFit - start;
+                needLineBreak = true;
+            } else if (wordEnd != lineEnd) {
+                //the first word doesn't fit - it gets its own line
+                lineSize = wordEnd - start;
+                needLineBreak = true;
             } else {
-                str = str.substr(line.size());
+                lineSize = lineEnd - start;
             }
-            if (str.empty())
+
+            dest.append(prefixLength, space);
+            dest.append(str.substr(start, lineSize));
+            start += lineSize;
+            if (needLineBreak) {
+                dest += endl;
+                ++start;
+            } 
+            if (start == str.size())
                 break;
 
             if (firstLine) {
-                prefix = std::basic_string<Char>(indent, CharConstants<char>::space);
+                prefixLength = indent;
                 curMaxLen = maxLength - indent;
                 firstLine = false;
             }
         }
+        return dest;
+    }
+
+    template<StringLike T>
+    auto wordWrap(T && input, unsigned maxLength, 
+                  unsigned indent = 0, unsigned firstLineOffset = 0) -> std::basic_string<CharTypeOf<T>> {
+
+        using Char = CharTypeOf<T>;
+
+        std::basic_string<Char> ret;
+        appendWordWrapped(ret, std::basic_string_view<Char>(std::forward<T>(input)), maxLength, indent, firstLineOffset);
         return ret;
     }
 
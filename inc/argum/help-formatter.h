@@ -11,6 +11,7 @@
 #include "messages.h"
 #include "formatting.h"
 #include "color.h"
+#include "output-sink.h"
 
 #include <string_view>
 #include <string>
@@ -23,6 +24,45 @@ namespace Argum {
     template<class Char> class BasicPositional;
     template<class Char> class BasicParser;
 
+    namespace Impl {
+
+        //Appends plain and colored pieces of text to a string keeping track of the display
+        //width of the text. This avoids having to strip escape sequences to measure it afterwards
+        template<Character Char>
+        class ColoredTextBuilder {
+        public:
+            using StringViewType = std::basic_string_view<Char>;
+            using StringType = std::basic_string<Char>;
+
+            ColoredTextBuilder(StringType & dest): m_dest(dest) {
+            }
+
+            auto append(Char c) -> ColoredTextBuilder & {
+                return this->append(StringViewType(&c, 1));
+            }
+
+            auto append(StringViewType str) -> ColoredTextBuilder & {
+                this->m_dest.append(str);
+                this->m_width += measurePlainWidth(str, this->m_buffer);
+                return *this;
+            }
+
+            auto append(const BasicColoredText<Char> & text) -> ColoredTextBuilder & {
+                text.appendTo(this->m_dest);
+                this->m_width += measurePlainWidth(text.text, this->m_buffer);
+                return *this;
+            }
+
+            auto width() const -> unsigned {
+                return this->m_width.value();
+            }
+        private:
+            StringType & m_dest;
+            TextWidth m_width;
+            std::wstring m_buffer;
+        };
+    }
+
     ARGUM_MOD_EXPORTED
     template<class Char>
     class BasicHelpFormatter {
@@ -33,12 +73,15 @@ namespace Argum {
         using Option = BasicOption<CharType>;
         using Positional = BasicPositional<CharType>;
         using Colorizer = BasicColorizer<CharType>;
+        using OutputSink = BasicOutputSink<CharType>;
 
         struct Layout {
             unsigned width = std::numeric_limits<unsigned>::max();
             unsigned helpLeadingGap = 2;
             unsigned helpNameMaxWidth = 20;
             unsigned helpDescriptionGap = 2;
+
+            friend auto operator==(const Layout &, const Layout &) -> bool = default;
         };
         static constexpr Layout defaultLayout = {};
 
@@ -46,6 +89,20 @@ namespace Argum {
             size_t positionalIdx = size_t(-1);
             size_t optionIdx = size_t(-1);
         };
+
+        struct ItemName {
+            StringType name;
+            unsigned width = 0;
+        };
+        /**
+         Help names of all positionals and options in parser order. 
+         Names do not depend on layout so can be computed once and reused for different widths
+         via useItemNames()
+         */
+        struct ItemNames {
+            std::vector<ItemName> positionals;
+            std::vector<ItemName> options;
+        };
     private:
         using CharConstants = Argum::CharConstants<CharType>;
         using Messages = Argum::Messages<CharType>;
@@ -68,12 +125,21 @@ namespace Argum {
 
         auto formatUsage(const std::optional<StringType> & subCommand,
                          const Colorizer & colorizer = {}) const -> StringType {
-            constexpr auto space = CharConstants::space;
-            return wordWrap(colorizer.heading(Messages::usageStart()).
-                                append(colorizer.progName(this->m_progName)).
-                                append({space}).
-                                append(this->formatSyntax(subCommand, colorizer)), 
-                            m_layout.width, m_layout.helpLeadingGap);
+            StringType ret;
+            this->appendUsage(ret, subCommand, colorizer);
+            return ret;
+        }
+
+        void formatUsage(OutputSink out, const Colorizer & colorizer = {}) const {
+            this->formatUsage(out, std::nullopt, colorizer);
+        }
+
+        void formatUsage(OutputSink out,
+                         const std::optional<StringType> & subCommand,
+                         const Colorizer & colorizer = {}) const {
+            StringType buffer;
+            this->appendUsage(buffer, subCommand, colorizer);
+            out.write(buffer);
         }
 
         auto formatHelp(const Colorizer & colorizer = {}) const -> StringType {
@@ -83,33 +149,73 @@ namespace Argum {
         auto formatHelp(const std::optional<StringType> & subCommand,
                         const Colorizer & colorizer = {}) const -> StringType {
 
+            StringType ret;
+            auto out = std::back_inserter(ret);
+            this->formatHelp(out, subCommand, colorizer);
+            return ret;
+        }
+
+        void formatHelp(OutputSink out, const Colorizer & colorizer = {}) const {
+            this->formatHelp(out, std::nullopt, colorizer);
+        }
+
+        /**
+         Writes help to the sink one item at a time. Only the text of a single 
+         item is held in memory at any moment.
+         */
+        void formatHelp(OutputSink out,
+                        const std::optional<StringType> & subCommand,
+                        const Colorizer & colorizer = {}) const {
+
             if (subCommand && this->m_parser.subCommandMark().positionalIdx == size_t(-1))
                 ARGUM_INVALID_ARGUMENT("subcommand must be defined to use this function with non null subcommand");
 
             constexpr auto endl = CharConstants::endl;
 
-            StringType ret;
+            const bool forSubCommand = bool(subCommand);
 
-            auto helpContent = this->calculateHelpContent(bool(subCommand), colorizer);
-            if (helpContent.maxNameLen > m_layout.helpNameMaxWidth)
-                helpContent.maxNameLen = m_layout.helpNameMaxWidth;
+            unsigned maxNameLen = 0;
+            size_t positionalCount = 0;
+            size_t optionCount = 0;
+            StringType buffer;
+            StringType scratch;
+
+            this->forEachPositionalInHelp(forSubCommand, [&](auto & pos, size_t idx) {
+                ++positionalCount;
+                maxNameLen = std::max(maxNameLen, this->loadItemName(scratch, pos, idx, colorizer));
+            });
+            this->forEachOptionInHelp(forSubCommand, [&](auto & opt, size_t idx) {
+                ++optionCount;
+                maxNameLen = std::max(maxNameLen, this->loadItemName(scratch, opt, idx, colorizer));
+            });
+            if (maxNameLen > m_layout.helpNameMaxWidth)
+                maxNameLen = m_layout.helpNameMaxWidth;
+
+            auto writeHeader = [&](StringViewType header) {
+                scratch.clear();
+                colorizer.colored(&Colorizer::Scheme::heading, header).appendTo(scratch);
+                buffer.clear();
+                appendWordWrapped(buffer, StringViewType(scratch), m_layout.width, m_layout.helpLeadingGap);
+                out.write(buffer);
+            };
+            auto writeItem = [&](auto & item, size_t idx) {
+                buffer.assign(1, endl);
+                auto nameWidth = this->loadItemName(scratch, item, idx, colorizer);
+                this->appendItemHelp(buffer, scratch, nameWidth, item.formatHelpDescription(), maxNameLen);
+                out.write(buffer);
+            };
 
-            if (!helpContent.positionalItems.empty()) {
-                ret.append(wordWrap(colorizer.heading(Messages::positionalHeader()), m_layout.width, m_layout.helpLeadingGap));
-                for(auto & [name, desc]: helpContent.positionalItems) {
-                    ret.append({endl}).append(this->formatItemHelp(name, desc, helpContent.maxNameLen));
-                }
-                ret.append(2, endl);
+            if (positionalCount != 0) {
+                writeHeader(Messages::positionalHeader());
+                this->forEachPositionalInHelp(forSubCommand, writeItem);
+                out.write(2, endl);
             }
 
-            if (!helpContent.optionItems.empty()) {
-                ret.append(wordWrap(colorizer.heading(Messages::optionsHeader()), m_layout.width, m_layout.helpLeadingGap));
-                for(auto & [name, desc]: helpContent.optionItems) {
-                    ret.append({endl}).append(this->formatItemHelp(name, desc, helpContent.maxNameLen));
-                }
-                ret.append(2, endl);
+            if (optionCount != 0) {
+                writeHeader(Messages::optionsHeader());
+                this->forEachOptionInHelp(forSubCommand, writeItem);
+                out.write(2, endl);
             }
-            return ret;
         }
 
         auto formatSyntax(const Colorizer & colorizer = {}) const -> StringType {
@@ -120,28 +226,8 @@ namespace Argum {
         auto formatSyntax(const std::optional<StringType> & subCommand,
                           const Colorizer & colorizer = {}) const -> StringType {
 
-            auto subCommandMark = this->m_parser.subCommandMark();
-            if (subCommand && subCommandMark.positionalIdx == size_t(-1))
-                ARGUM_INVALID_ARGUMENT("subcommand must be added to use this function with non null subcommand");
-
-            constexpr auto space = CharConstants::space;
-
-            auto getSyntax = [&](auto & obj) {
-                return obj.formatSyntax(this->m_parser, colorizer);
-            };
-
-            StringType ret = this->appendSyntax(
-                    join(this->optionsBegin(false), this->optionsEnd(false), space, getSyntax),
-                    join(this->positionalsBegin(false), this->positionalsEnd(false), space, getSyntax)
-            );
-            if (subCommand) {
-                ret = this->appendSyntax(std::move(ret), *subCommand); 
-                ret = this->appendSyntax(std::move(ret), join(this->optionsBegin(true), this->optionsEnd(true), space, getSyntax));
-                ret = this->appendSyntax(std::move(ret), join(this->positionalsBegin(true), this->positionalsEnd(true), space, getSyntax));
-            } else if (subCommandMark.positionalIdx != size_t(-1)) {
-                ret = this->appendSyntax(std::move(ret), getSyntax(this->m_parser.positionals()[subCommandMark.positionalIdx]));
-            }
-
+            StringType ret;
+            this->appendFullSyntax(ret, subCommand, colorizer);
             return ret;
         }
         
@@ -155,54 +241,54 @@ namespace Argum {
                                   const Colorizer & colorizer = {}) const -> HelpContent {
             
             HelpContent ret;
-            auto subCommandMark = this->m_parser.subCommandMark();
-
-            size_t positionalsSize;
-            if (forSubCommand || subCommandMark.positionalIdx == size_t(-1))
-                positionalsSize = this->m_parser.positionals().size();
-            else 
-                positionalsSize = subCommandMark.positionalIdx + 1;
-            for(size_t i = 0; i < positionalsSize; ++ i) {
-                if (forSubCommand && i == subCommandMark.positionalIdx)
-                    continue;
-                auto & pos = this->m_parser.positionals()[i];
-                auto name = pos.formatHelpName(this->m_parser, colorizer);
-                auto length = stringWidth(name);
-                if (length > ret.maxNameLen)
-                    ret.maxNameLen = length;
-                ret.positionalItems.emplace_back(std::move(name), pos.formatHelpDescription());
-            }
-            std::for_each(this->m_parser.options().begin(), this->optionsEnd(forSubCommand), [&](auto & opt){
-                auto name = opt.formatHelpName(this->m_parser, colorizer);
-                auto length = stringWidth(name);
+            auto addItem = [&](auto & items, auto & obj) {
+                StringType name;
+                auto length = obj.appendHelpName(name, this->m_parser, colorizer);
                 if (length > ret.maxNameLen)
                     ret.maxNameLen = length;
-                ret.optionItems.emplace_back(std::move(name), opt.formatHelpDescription());
+                items.emplace_back(std::move(name), obj.formatHelpDescription());
+            };
+            this->forEachPositionalInHelp(forSubCommand, [&](auto & pos, size_t /*idx*/) {
+                addItem(ret.positionalItems, pos);
+            });
+            this->forEachOptionInHelp(forSubCommand, [&](auto & opt, size_t /*idx*/) {
+                addItem(ret.optionItems, opt);
             });
             return ret;
         }
 
+        auto calculateItemNames(const Colorizer & colorizer = {}) const -> ItemNames {
+            
+            ItemNames ret;
+            auto addItems = [&](auto & dest, auto & items) {
+                dest.reserve(items.size());
+                for (auto & item: items) {
+                    auto & added = dest.emplace_back();
+                    added.width = item.appendHelpName(added.name, this->m_parser, colorizer);
+                }
+            };
+            addItems(ret.positionals, this->m_parser.positionals());
+            addItems(ret.options, this->m_parser.options());
+            return ret;
+        }
+
+        /**
+         Use precomputed names in formatHelp(). The names must have been calculated by calculateItemNames()
+         for the same parser state and colorizer and must outlive this object
+         */
+        void useItemNames(const ItemNames & names) {
+            this->m_itemNames = &names;
+        }
+
         auto formatItemHelp(StringViewType name, 
                             StringViewType description,
                             unsigned maxNameLen) const -> StringType {
             constexpr auto space = CharConstants::space;
-            constexpr auto endl = CharConstants::endl;
-
-            auto descColumnOffset = this->m_layout.helpLeadingGap + maxNameLen + this->m_layout.helpDescriptionGap;
-
-            StringType ret = wordWrap(StringType(this->m_layout.helpLeadingGap, space).append(name), this->m_layout.width, this->m_layout.helpLeadingGap);
-            auto lastEndlPos = ret.rfind(endl);
-            auto lastLineLen = stringWidth(StringViewType(ret.c_str() + (lastEndlPos + 1), ret.size() - (lastEndlPos + 1)));
-
-            if (lastLineLen > maxNameLen + this->m_layout.helpLeadingGap) {
-                ret += endl;
-                ret.append(descColumnOffset, space);
-            } else {
-                ret.append(descColumnOffset - lastLineLen, space);
-            }
-
-            ret.append(wordWrap(description, this->m_layout.width, descColumnOffset, descColumnOffset));
 
+            StringType ret;
+            StringType prefixedName(this->m_layout.helpLeadingGap, space);
+            prefixedName.append(name);
+            this->appendItemHelp(ret, prefixedName, stringWidth(name), description, maxNameLen);
             return ret;
         }
 
@@ -250,10 +336,150 @@ namespace Argum {
             
             return addend;
         }
+    private:
+        void appendUsage(StringType & dest,
+                         const std::optional<StringType> & subCommand,
+                         const Colorizer & colorizer) const {
+            constexpr auto space = CharConstants::space;
+
+            using Scheme = typename Colorizer::Scheme;
+
+            StringType usage;
+            colorizer.colored(&Scheme::heading, Messages::usageStart()).appendTo(usage);
+            colorizer.colored(&Scheme::progName, this->m_progName).appendTo(usage).append({space});
+            this->appendFullSyntax(usage, subCommand, colorizer);
+            appendWordWrapped(dest, StringViewType(usage), m_layout.width, m_layout.helpLeadingGap);
+        }
+
+        void appendFullSyntax(StringType & dest,
+                              const std::optional<StringType> & subCommand,
+                              const Colorizer & colorizer) const {
+
+            auto subCommandMark = this->m_parser.subCommandMark();
+            if (subCommand && subCommandMark.positionalIdx == size_t(-1))
+                ARGUM_INVALID_ARGUMENT("subcommand must be added to use this function with non null subcommand");
+
+            constexpr auto space = CharConstants::space;
+
+            const auto start = dest.size();
+
+            //Appends space separated items as a group separated from preceding syntax by a space
+            //Same as appendSyntax(base, join(first, last, space)) but without temporaries
+            auto appendGroup = [&](auto first, auto last) {
+                const auto groupStart = dest.size();
+                if (groupStart != start)
+                    dest += space;
+                const auto contentStart = dest.size();
+                for (auto it = first; it != last; ++it) {
+                    if (it != first)
+                        dest += space;
+                    dest += it->formatSyntax(this->m_parser, colorizer);
+                }
+                if (dest.size() == contentStart)
+                    dest.resize(groupStart);
+            };
+
+            appendGroup(this->optionsBegin(false), this->optionsEnd(false));
+            appendGroup(this->positionalsBegin(false), this->positionalsEnd(false));
+            if (subCommand) {
+                if (!subCommand->empty()) {
+                    if (dest.size() != start)
+                        dest += space;
+                    dest += *subCommand;
+                }
+                appendGroup(this->optionsBegin(true), this->optionsEnd(true));
+                appendGroup(this->positionalsBegin(true), this->positionalsEnd(true));
+            } else if (subCommandMark.positionalIdx != size_t(-1)) {
+                auto pos = this->m_parser.positionals().begin() + subCommandMark.positionalIdx;
+                appendGroup(pos, pos + 1);
+            }
+        }
+
+        //prefixedName is the item name preceded by helpLeadingGap spaces
+        void appendItemHelp(StringType & dest,
+                            StringViewType prefixedName,
+                            unsigned nameWidth,
+                            StringViewType description,
+                            unsigned maxNameLen) const {
+            constexpr auto space = CharConstants::space;
+            constexpr auto endl = CharConstants::endl;
+
+            auto descColumnOffset = this->m_layout.helpLeadingGap + maxNameLen + this->m_layout.helpDescriptionGap;
+
+            const auto start = dest.size();
+            appendWordWrapped(dest, prefixedName, this->m_layout.width, this->m_layout.helpLeadingGap);
+            unsigned lastLineLen;
+            //a wrap can replace a space with a line break keeping the size so look for the break itself
+            auto lastEndlPos = dest.rfind(endl);
+            if (lastEndlPos == dest.npos || lastEndlPos < start) {
+                //not wrapped so we already know the width
+                lastLineLen = this->m_layout.helpLeadingGap + nameWidth;
+            } else {
+                auto lastLineStart = lastEndlPos + 1;
+                lastLineLen = stringWidth(StringViewType(dest.c_str() + lastLineStart, dest.size() - lastLineStart));
+            }
+
+            if (lastLineLen > maxNameLen + this->m_layout.helpLeadingGap) {
+                dest += endl;
+                dest.append(descColumnOffset, space);
+            } else {
+                dest.append(descColumnOffset - lastLineLen, space);
+            }
+
+            appendWordWrapped(dest, description, this->m_layout.width, descColumnOffset, descColumnOffset);
+        }
+
+        template<class Func>
+        void forEachPositionalInHelp(bool forSubCommand, Func && func) const {
+            auto subCommandMark = this->m_parser.subCommandMark();
+
+            size_t positionalsSize;
+            if (forSubCommand || subCommandMark.positionalIdx == size_t(-1))
+                positionalsSize = this->m_parser.positionals().size();
+            else 
+                positionalsSize = subCommandMark.positionalIdx + 1;
+            for(size_t i = 0; i < positionalsSize; ++ i) {
+                if (forSubCommand && i == subCommandMark.positionalIdx)
+                    continue;
+                func(this->m_parser.positionals()[i], i);
+            }
+        }
+
+        template<class Func>
+        void forEachOptionInHelp(bool forSubCommand, Func && func) const {
+            auto first = this->m_parser.options().begin();
+            auto last = this->optionsEnd(forSubCommand);
+            for (auto it = first; it != last; ++it)
+                func(*it, size_t(it - first));
+        }
+
+        template<class Item>
+        auto cachedItemName(size_t idx) const -> const ItemName & {
+            if constexpr (std::is_same_v<Item, Positional>)
+                return this->m_itemNames->positionals[idx];
+            else
+                return this->m_itemNames->options[idx];
+        }
+
+        //Puts the item name preceded by helpLeadingGap spaces into dest and returns the name width
+        template<class Item>
+        auto loadItemName(StringType & dest, const Item & item, size_t idx, const Colorizer & colorizer) const -> unsigned {
+            constexpr auto space = CharConstants::space;
+
+            dest.assign(this->m_layout.helpLeadingGap, space);
+            if (this->m_itemNames) {
+                auto & cached = this->cachedItemName<Item>(idx);
+                dest.append(cached.name);
+                return cached.width;
+            }
+            return item.appendHelpName(dest, this->m_parser, colorizer);
+        }
+
     private:
         StringType m_progName;
         const BasicParser<Char> & m_parser;
         Layout m_layout;
+        const ItemNames * m_itemNames = nullptr;
     };
 
     ARGUM_DECLARE_FRIENDLY_NAMES(HelpFormatter)
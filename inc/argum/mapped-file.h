@@ -0,0 +1,222 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_MAPPED_FILE_H_INCLUDED
+#define HEADER_ARGUM_MAPPED_FILE_H_INCLUDED
+
+#include "common.h"
+
+#include <filesystem>
+#include <system_error>
+#include <memory>
+#include <algorithm>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <errno.h>
+
+#if !defined(_WIN32) && __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>)
+    #define ARGUM_HAS_MMAP
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+    #ifdef min
+        #undef min
+    #endif
+    #ifdef max
+        #undef max
+    #endif
+#endif
+
+namespace Argum {
+
+    /**
+     Read-only view of a whole file contents.
+
+     Regular files are memory mapped where the platform supports it. Other files, such as 
+     pipes and character devices, and all files elsewhere are read into an owned buffer. Either way data() stays valid and does not move for the
+     lifetime of the object, including after it is moved from.
+     */
+    class MappedFile {
+    public:
+        MappedFile(const std::filesystem::path & path, std::error_code & ec) {
+        #if defined(ARGUM_HAS_MMAP)
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                ec = lastError();
+                return;
+            }
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                ec = lastError();
+                close(fd);
+                return;
+            }
+            if (!S_ISREG(st.st_mode)) {
+                this->readAll([fd](char * buffer, size_t size) -> ptrdiff_t {
+                    for ( ; ; ) {
+                        auto ret = ::read(fd, buffer, size);
+                        if (ret >= 0 || errno != EINTR)
+                            return ret;
+                    }
+                }, ec);
+                close(fd);
+                return;
+            }
+            m_size = size_t(st.st_size);
+            if (m_size != 0) {
+                void * addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    ec = lastError();
+                    m_size = 0;
+                } else {
+                    m_data = static_cast<const char *>(addr);
+                }
+            }
+            close(fd);
+        #elif defined(_WIN32)
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                ec = lastError();
+                return;
+            }
+            if (GetFileType(file) != FILE_TYPE_DISK) {
+                this->readAll([file](char * buffer, size_t size) -> ptrdiff_t {
+                    DWORD read;
+                    if (!ReadFile(file, buffer, DWORD(std::min(size, size_t(MAXDWORD))), &read, nullptr))
+                        return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+                    return ptrdiff_t(read);
+                }, ec);
+                CloseHandle(file);
+                return;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size)) {
+                ec = lastError();
+                CloseHandle(file);
+                return;
+            }
+            m_size = size_t(size.QuadPart);
+            if (m_size != 0) {
+                HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    if (!m_data)
+                        ec = lastError();
+                    CloseHandle(mapping);
+                } else {
+                    ec = lastError();
+                }
+                if (!m_data)
+                    m_size = 0;
+            }
+            CloseHandle(file);
+        #else
+            FILE * fp = fopen(path.string().c_str(), "rb");
+            if (!fp) {
+                ec = lastError();
+                return;
+            }
+            this->readAll([fp](char * buffer, size_t size) -> ptrdiff_t {
+                auto read = fread(buffer, 1, size, fp);
+                if (read == 0 && ferror(fp))
+                    return -1;
+                return ptrdiff_t(read);
+            }, ec);
+            fclose(fp);
+        #endif
+        }
+        MappedFile(MappedFile && src):
+            m_data(src.m_data),
+            m_size(src.m_size),
+            m_buffer(std::move(src.m_buffer)) {
+            src.m_data = nullptr;
+            src.m_size = 0;
+        }
+        auto operator=(MappedFile && src) -> MappedFile & {
+            if (this != &src) {
+                unmap();
+                m_data = src.m_data;
+                m_size = src.m_size;
+                m_buffer = std::move(src.m_buffer);
+                src.m_data = nullptr;
+                src.m_size = 0;
+            }
+            return *this;
+        }
+        ~MappedFile() {
+            unmap();
+        }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        auto data() const -> const char * {
+            return m_data;
+        }
+        auto size() const -> size_t {
+            return m_size;
+        }
+    private:
+        //Reads into the owned buffer until readSome(buffer, size) returns 0 or, on error, -1
+        template<class Func>
+        void readAll(Func readSome, std::error_code & ec) {
+            size_t capacity = 0;
+            for ( ; ; ) {
+                if (m_size == capacity) {
+                    capacity = (capacity == 0 ? 64 * 1024 : capacity * 2);
+                    std::unique_ptr<char[]> newBuffer(new char[capacity]);
+                    std::copy(m_buffer.get(), m_buffer.get() + m_size, newBuffer.get());
+                    m_buffer = std::move(newBuffer);
+                }
+                auto read = readSome(m_buffer.get() + m_size, capacity - m_size);
+                if (read <= 0) {
+                    if (read < 0)
+                        ec = lastError();
+                    break;
+                }
+                m_size += size_t(read);
+            }
+            m_data = m_buffer.get();
+        }
+
+        void unmap() {
+        #if defined(ARGUM_HAS_MMAP)
+            if (m_data && !m_buffer)
+                munmap(const_cast<char *>(m_data), m_size);
+        #elif defined(_WIN32)
+            if (m_data && !m_buffer)
+                UnmapViewOfFile(m_data);
+        #endif
+        }
+
+        static auto lastError() -> std::error_code {
+        #ifdef _WIN32
+            return std::error_code(int(GetLastError()), std::system_category());
+        #else
+            return std::make_error_code(static_cast<std::errc>(errno));
+        #endif
+        }
+    private:
+        const char * m_data = nullptr;
+        size_t m_size = 0;
+        std::unique_ptr<char[]> m_buffer;
+    };
+}
+
+#endif
@@ -27,6 +27,9 @@ namespace Argum {
         static constexpr auto extraPositionalError()        { return pr ## "unexpected argument: {1}"; }\
         static constexpr auto validationError()             { return pr ## "invalid arguments: {1}"; }\
         static constexpr auto errorReadingResponseFile()    { return pr ## "error reading response file \"{1}\": {2}"; }\
+        static constexpr auto errorWritingResponseFile()    { return pr ## "error writing response file \"{1}\": {2}"; }\
+        static constexpr auto responseFileCycle()           { return pr ## "response file \"{1}\" references itself"; }\
+        static constexpr auto messageUnavailable()          { return pr ## "error message unavailable"; }\
         static constexpr auto option()                      { return pr ## "option"; }\
         static constexpr auto positionalArg()               { return pr ## "positional argument"; }\
         static constexpr auto usageStart()                  { return pr ## "Usage: "; }\
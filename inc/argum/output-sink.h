@@ -0,0 +1,121 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_OUTPUT_SINK_H_INCLUDED
+#define HEADER_ARGUM_OUTPUT_SINK_H_INCLUDED
+
+#include "common.h"
+
+#include <string_view>
+#include <ostream>
+#include <iterator>
+#include <span>
+#include <algorithm>
+
+#include <stdio.h>
+#include <wchar.h>
+
+namespace Argum {
+
+    /**
+     Destination for incrementally produced text such as help and usage.
+
+     A sink is a lightweight handle that refers to but does not own its destination.
+     It can be created from:
+     - `FILE *` (for `char` and `wchar_t` only)
+     - `std::basic_ostream`
+     - `std::span<Char>` - a fixed buffer. The span is advanced past the written
+       text and output that doesn't fit is dropped
+     - an output iterator, which is advanced in place
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicOutputSink {
+    public:
+        using CharType = Char;
+        using StringViewType = std::basic_string_view<CharType>;
+        using OStreamType = std::basic_ostream<CharType>;
+
+    public:
+        BasicOutputSink(FILE * fp) requires(std::is_same_v<CharType, char> || std::is_same_v<CharType, wchar_t>):
+            m_dest(fp),
+            m_write(writeFile) {
+        }
+
+        BasicOutputSink(OStreamType & str):
+            m_dest(&str),
+            m_write(writeStream) {
+        }
+
+        BasicOutputSink(std::span<CharType> & buffer):
+            m_dest(&buffer),
+            m_write(writeBuffer) {
+        }
+
+        template<std::output_iterator<const CharType &> It>
+        requires(!std::is_pointer_v<It>)
+        BasicOutputSink(It & it):
+            m_dest(&it),
+            m_write(writeIterator<It>) {
+        }
+
+        auto write(StringViewType str) const -> const BasicOutputSink & {
+            if (!str.empty())
+                this->m_write(this->m_dest, str);
+            return *this;
+        }
+
+        auto write(size_t count, CharType c) const -> const BasicOutputSink & {
+            CharType buffer[32];
+            std::fill(std::begin(buffer), std::end(buffer), c);
+            while (count != 0) {
+                auto chunk = std::min(count, std::size(buffer));
+                this->m_write(this->m_dest, StringViewType(buffer, chunk));
+                count -= chunk;
+            }
+            return *this;
+        }
+
+    private:
+        static void writeFile(void * dest, StringViewType str) {
+            auto fp = static_cast<FILE *>(dest);
+            if constexpr (std::is_same_v<CharType, char>) {
+                fwrite(str.data(), 1, str.size(), fp);
+            } else {
+                for (auto c: str) {
+                    if (fputwc(c, fp) == WEOF)
+                        break;
+                }
+            }
+        }
+
+        static void writeStream(void * dest, StringViewType str) {
+            static_cast<OStreamType *>(dest)->write(str.data(), std::streamsize(str.size()));
+        }
+
+        static void writeBuffer(void * dest, StringViewType str) {
+            auto & buffer = *static_cast<std::span<CharType> *>(dest);
+            auto size = std::min(str.size(), buffer.size());
+            std::copy(str.data(), str.data() + size, buffer.data());
+            buffer = buffer.subspan(size);
+        }
+
+        template<class It>
+        static void writeIterator(void * dest, StringViewType str) {
+            auto & it = *static_cast<It *>(dest);
+            it = std::copy(str.begin(), str.end(), std::move(it));
+        }
+
+    private:
+        void * m_dest;
+        void (*m_write)(void * dest, StringViewType str);
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(OutputSink)
+}
+
+#endif
@@ -0,0 +1,83 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_PARSE_STATS_H_INCLUDED
+#define HEADER_ARGUM_PARSE_STATS_H_INCLUDED
+
+#include "common.h"
+
+#include <chrono>
+
+#include <stddef.h>
+
+namespace Argum {
+
+    /**
+     Statistics of the work done while parsing a command line.
+
+     Pass a pointer to an instance to any of the `BasicParser` parse methods to have it filled in.
+     Counters and durations are added to rather than overwritten so a single object can accumulate
+     a parse together with the parses of its sub-commands. Use reset() to start over.
+
+     Allocations cannot be counted by the library itself. To have them reported set `allocationCounter`
+     to a function that returns the total number of allocations made by the process so far, for example
+     maintained by a replaced `operator new`.
+     */
+    ARGUM_MOD_EXPORTED
+    struct ParseStats {
+        using Clock = std::chrono::steady_clock;
+        using Duration = Clock::duration;
+
+        //Tokens found in the command line, by type
+        size_t optionTokens = 0;
+        size_t argumentTokens = 0;
+        size_t optionStopTokens = 0;
+        size_t unknownOptionTokens = 0;
+        size_t ambiguousOptionTokens = 0;
+
+        size_t prefixLookups = 0;               //searches for the option prefix of an argument
+        size_t optionLookups = 0;               //searches for an option name among the known ones
+        size_t abbreviationResolutions = 0;     //option names matched by an unambiguous abbreviation
+        size_t positionalRecalculations = 0;    //recalculations of how many arguments each positional takes
+        size_t handlerInvocations = 0;          //calls to option and positional handlers
+        size_t validatorEvaluations = 0;        //evaluations of validators, including the built-in occurrence checks
+
+        size_t (*allocationCounter)() = nullptr;
+        size_t allocations = 0;                 //only counted if allocationCounter is set
+
+        Duration totalTime{};                   //the whole parse
+        Duration handlersTime{};                //spent in handlers
+        Duration positionalRecalculationTime{}; //spent recalculating positionals, including tokenizing the rest of the command line
+        Duration validationTime{};              //spent in final validation
+
+        //Tokenizing and matching arguments, that is the total time minus all the phases above
+        auto tokenizingTime() const -> Duration {
+            return totalTime - handlersTime - positionalRecalculationTime - validationTime;
+        }
+
+        auto tokens() const -> size_t {
+            return optionTokens + argumentTokens + optionStopTokens + unknownOptionTokens + ambiguousOptionTokens;
+        }
+
+        //Clears all counters and durations keeping the allocationCounter
+        auto reset() -> void {
+            auto counter = this->allocationCounter;
+            *this = ParseStats{};
+            this->allocationCounter = counter;
+        }
+    };
+
+    namespace Impl {
+        //Increments a counter of stats if they are being collected
+        inline auto countIn(ParseStats * stats, size_t ParseStats::*counter) -> void {
+            if (stats)
+                ++(stats->*counter);
+        }
+    }
+}
+
+#endif
@@ -23,9 +23,12 @@
 #include <vector>
 #include <optional>
 #include <variant>
+#include <array>
 #include <functional>
 #include <algorithm>
 #include <concepts>
+#include <ranges>
+#include <utility>
 
 
 namespace Argum {
@@ -47,6 +50,7 @@ namespace Argum {
         using CharConstants = Argum::CharConstants<CharType>;
         using Messages = Argum::Messages<CharType>;
         using Colorizer = BasicColorizer<CharType>;
+        using ColorScheme = BasicColorScheme<CharType>;
         using HandlerReturnType = ARGUM_EXPECTED(CharType, void);
 
         using NoArgHandler = std::function<HandlerReturnType ()>; 
@@ -154,8 +158,10 @@ namespace Argum {
                 ret += brop;
             auto & mainName = this->m_names.main();
             bool isLong = parser.isOptionNameLong(mainName);
-            StringType nameAndArg = isLong ? colorizer.longOptionInUsage(mainName) : colorizer.shortOptionInUsage(mainName);
-            nameAndArg.append(this->formatArgSyntax(isLong, true, colorizer));
+            StringType nameAndArg;
+            Impl::ColoredTextBuilder<CharType> builder(nameAndArg);
+            builder.append(colorizer.colored(isLong ? &ColorScheme::longOptionInUsage : &ColorScheme::shortOptionInUsage, mainName));
+            this->appendArgSyntax(builder, isLong, true, colorizer);
             ret.append(nameAndArg);
             unsigned idx = 1;
             for (; idx < this->m_occurs.min(); ++idx) {
@@ -176,64 +182,75 @@ namespace Argum {
         }
 
         auto formatArgSyntax(bool forLongName, bool forUsage, const Colorizer & colorizer = {}) const -> StringType {
+            StringType ret;
+            Impl::ColoredTextBuilder<CharType> builder(ret);
+            this->appendArgSyntax(builder, forLongName, forUsage, colorizer);
+            return ret;
+        }
+
+        auto formatHelpName(const BasicParser<CharType> & parser, 
+                            const Colorizer & colorizer = {}) const -> StringType {
+            StringType ret;
+            this->appendHelpName(ret, parser, colorizer);
+            return ret;
+        }
+
+        /**
+         Appends help name to dest and returns its display width
+         */
+        auto appendHelpName(StringType & dest,
+                            const BasicParser<CharType> & parser, 
+                            const Colorizer & colorizer = {}) const -> unsigned {
+
+            Impl::ColoredTextBuilder<CharType> builder(dest);
+            bool first = true;
+            for (auto & name: this->m_names.all()) {
+                if (!first)
+                    builder.append(StringViewType(Messages::listJoiner()));
+                first = false;
+                auto isLong = parser.isOptionNameLong(name);
+                builder.append(colorizer.colored(isLong ? &ColorScheme::longOption : &ColorScheme::shortOption, name));
+                this->appendArgSyntax(builder, isLong, false, colorizer);
+            }
+            return builder.width();
+        }
+
+        auto formatHelpDescription() const -> const StringType & {
+            return this->m_description;
+        }
+    private:
+        void appendArgSyntax(Impl::ColoredTextBuilder<CharType> & dest, 
+                             bool forLongName, bool forUsage, const Colorizer & colorizer) const {
             constexpr auto space = CharConstants::space;
             constexpr auto brop = CharConstants::squareBracketOpen;
             constexpr auto brcl = CharConstants::squareBracketClose;
             constexpr auto eq = CharConstants::assignment;
 
-            StringType ret;
             std::visit([&](const auto & handler) {
                 using HandlerType = std::remove_cvref_t<decltype(handler)>;
                 constexpr auto argumentKind = BasicOption::template argumentKindOf<HandlerType>();
-                auto colorArg = forUsage ? colorizer.optionArgInUsage(this->m_argName) : colorizer.optionArg(this->m_argName);
+                auto colorArg = colorizer.colored(forUsage ? &ColorScheme::optionArgInUsage : &ColorScheme::optionArg, this->m_argName);
                 if constexpr (argumentKind == ArgumentKind::Optional) {
                     if (this->m_requireAttachedArgument)
                         if (forLongName)
-                            ret.append({brop, eq});
+                            dest.append(brop).append(eq);
                         else
-                            ret.append({brop});
+                            dest.append(brop);
                     else
-                        ret.append({space, brop});
-                    ret.append(colorArg).append({brcl});
+                        dest.append(space).append(brop);
+                    dest.append(colorArg).append(brcl);
                 } else if constexpr (argumentKind == ArgumentKind::Required)  {
                     if (this->m_requireAttachedArgument) {
                         if (forLongName)
-                            ret.append({eq});
+                            dest.append(eq);
                     } else {
-                        ret.append({space});
+                        dest.append(space);
                     }
-                    ret.append(colorArg);
+                    dest.append(colorArg);
                 }
             }, this->m_handler);
-            return ret;
         }
 
-        auto formatHelpName(const BasicParser<CharType> & parser, 
-                            const Colorizer & colorizer = {}) const -> StringType {
-
-            auto handleName = [&](const StringType & name) {
-                auto isLong = parser.isOptionNameLong(name);
-                StringType ret = isLong ? colorizer.longOption(name) : colorizer.shortOption(name);
-                ret += this->formatArgSyntax(isLong, false, colorizer);
-                return ret;
-            };
-
-            auto & all = this->m_names.all();
-            auto first = all.begin();
-            auto last = all.end();
-        
-            StringType ret = handleName(*first);
-            ++first;
-            std::for_each(first, last, [&](const auto & name) {
-                ret.append(Messages::listJoiner()).append(handleName(name));
-            });
-
-            return ret;
-        }
-
-        auto formatHelpDescription() const -> const StringType & {
-            return this->m_description;
-        }
     private:
         OptionNames m_names;
         Handler m_handler = []() -> ARGUM_EXPECTED(CharType, void) { return ARGUM_VOID_SUCCESS; };
@@ -259,6 +276,7 @@ namespace Argum {
     private:
         using CharConstants = Argum::CharConstants<CharType>;
         using Colorizer = BasicColorizer<CharType>;
+        using ColorScheme = BasicColorScheme<CharType>;
         using HandlerReturnType = ARGUM_EXPECTED(CharType, void);
 
     public:
@@ -303,7 +321,7 @@ namespace Argum {
 
             StringType ret;
 
-            StringType colorizedName = colorizer.positionalInUsage(this->m_name);
+            StringType colorizedName = colorizer.colored(&ColorScheme::positionalInUsage, this->m_name).str();
 
             if (this->m_occurs.min() == 0)
                 ret += brop;
@@ -318,7 +336,8 @@ namespace Argum {
                     for (++idx; idx < this->m_occurs.max(); ++idx)
                         ret.append({space}).append(colorizedName);
                 } else {
-                    ret.append({space}).append(colorizer.positionalInUsage(ellipsis));
+                    ret.append({space});
+                    colorizer.colored(&ColorScheme::positionalInUsage, ellipsis).appendTo(ret);
                 }
                 ret += brcl;
             }
@@ -330,7 +349,18 @@ namespace Argum {
 
         auto formatHelpName(const BasicParser<CharType> & /*parser*/,
                           const Colorizer & colorizer = {}) const -> StringType {
-            return colorizer.positional(this->m_name);
+            return colorizer.colored(&ColorScheme::positional, this->m_name).str();
+        }
+
+        /**
+         Appends help name to dest and returns its display width
+         */
+        auto appendHelpName(StringType & dest,
+                            const BasicParser<CharType> & /*parser*/,
+                            const Colorizer & colorizer = {}) const -> unsigned {
+            Impl::ColoredTextBuilder<CharType> builder(dest);
+            builder.append(colorizer.colored(&ColorScheme::positional, this->m_name));
+            return builder.width();
         }
 
         auto formatHelpDescription() const -> const StringType & {
@@ -354,12 +384,14 @@ namespace Argum {
         using StringViewType = std::basic_string_view<Char>;
         using OptionNames = BasicOptionNames<Char>;
         using ParsingException = BasicParsingException<Char>;
+        using ParsingExceptionPtr = std::shared_ptr<ParsingException>;
         using Option = BasicOption<Char>;
         using Positional = BasicPositional<Char>;
         using Settings = typename BasicTokenizer<Char>::Settings;
         using HelpFormatter = BasicHelpFormatter<CharType>;
         using SubCommandMark = typename HelpFormatter::SubCommandMark;
         using Colorizer = BasicColorizer<Char>;
+        using OutputSink = BasicOutputSink<Char>;
 
     private:
         using CharConstants = Argum::CharConstants<CharType>;
@@ -372,67 +404,98 @@ namespace Argum {
     public:
         struct UnrecognizedOption : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(UnrecognizedOption, ParsingException, Error::UnrecognizedOption)
+            static constexpr bool IsCompact = true;
 
-            UnrecognizedOption(StringViewType option_): 
-                ParsingException(ErrorCode, format(Messages::unrecognizedOptionError(), option_)),
-                option(option_) {
+            UnrecognizedOption(StringViewType option_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                option(option_),
+                argumentIndex(argumentIndex_) {
             }
             StringType option;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::unrecognizedOptionError>(this->option);
+            }
         };
 
         struct AmbiguousOption : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(AmbiguousOption, ParsingException, Error::AmbiguousOption)
 
             AmbiguousOption(StringViewType option_, std::vector<StringType> possibilities_): 
-                ParsingException(ErrorCode, 
-                                 format(Messages::ambiguousOptionError(), option_, 
-                                        join(possibilities_.begin(), possibilities_.end(), Messages::listJoiner()))),
+                ParsingException(ErrorCode),
                 option(option_),
                 possibilities(std::move(possibilities_)) {
             }
             StringType option;
             std::vector<StringType> possibilities;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::ambiguousOptionError>(this->option, 
+                                join(this->possibilities.begin(), this->possibilities.end(), Messages::listJoiner()));
+            }
         };
 
         struct MissingOptionArgument : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(MissingOptionArgument, ParsingException, Error::MissingOptionArgument)
+            static constexpr bool IsCompact = true;
 
-            MissingOptionArgument(StringViewType option_): 
-                ParsingException(ErrorCode, format(Messages::missingOptionArgumentError(), option_)),
-                option(option_) {
+            MissingOptionArgument(StringViewType option_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                option(option_),
+                argumentIndex(argumentIndex_) {
             }
             StringType option;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::missingOptionArgumentError>(this->option);
+            }
         };
 
         struct ExtraOptionArgument : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(ExtraOptionArgument, ParsingException, Error::ExtraOptionArgument)
+            static constexpr bool IsCompact = true;
 
-            ExtraOptionArgument(StringViewType option_): 
-                ParsingException(ErrorCode, format(Messages::extraOptionArgumentError(), option_)),
-                option(option_) {
+            ExtraOptionArgument(StringViewType option_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                option(option_),
+                argumentIndex(argumentIndex_) {
             }
             StringType option;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::extraOptionArgumentError>(this->option);
+            }
         };
 
         struct ExtraPositional : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(ExtraPositional, ParsingException, Error::ExtraPositional)
+            static constexpr bool IsCompact = true;
 
-            ExtraPositional(StringViewType value_): 
-                ParsingException(ErrorCode, format(Messages::extraPositionalError(), value_)),
-                value(value_) {
+            ExtraPositional(StringViewType value_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                value(value_),
+                argumentIndex(argumentIndex_) {
             }
             StringType value;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::extraPositionalError>(this->value);
+            }
         };
         
         struct ValidationError : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(ValidationError, ParsingException, Error::ValidationError)
 
             ValidationError(StringViewType message):
-                ParsingException(ErrorCode, format(Messages::validationError(), message)) {
+                ParsingException(ErrorCode, format<Messages::validationError>(message)) {
             }
             template<DescribableParserValidator<CharType> Validator>
             ValidationError(Validator validator):
-                ParsingException(ErrorCode, format(Messages::validationError(), describe(validator))) {
+                ParsingException(ErrorCode, format<Messages::validationError>(describe(validator))) {
             }
         };
 
@@ -477,39 +540,165 @@ namespace Argum {
             m_validators.emplace_back(std::move(v), std::move(desc));
         }
 
-        auto parse(int argc, CharType ** argv) const -> ARGUM_EXPECTED(CharType, void) {
-            return this->parse(makeArgSpan<CharType>(argc, argv));
+        /**
+         Enables or disables caching of rendered usage and help. 
+         
+         When enabled, formatUsage() and formatHelp() remember their output for each combination of
+         program name, subcommand, layout and colorizer scheme and reuse it until the parser is modified.
+         Help names of all items are also cached so re-rendering for a different width is cheaper.
+         Note that with the cache enabled concurrent calls to these methods are not safe.
+         */
+        auto enableRenderCache(bool enable = true) -> void {
+            if (enable) {
+                if (!this->m_renderCache)
+                    this->m_renderCache.emplace();
+            } else {
+                this->m_renderCache.reset();
+            }
+        }
+
+        /**
+         Parses arguments invoking handlers of the options and positionals found.
+
+         All parse methods accept an optional ParseStats object to fill in with statistics of the parse.
+         Without it no statistics are gathered or timed.
+
+         In ARGUM_USE_EXPECTED mode common errors refer to the text of the arguments (see BasicParsingError)
+         and must not be inspected after the arguments are destroyed. Methods that take arguments by 
+         rvalue reference convert such errors into exception objects before returning.
+         */
+        auto parse(int argc, CharType ** argv, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
+            return this->parse(makeArgSpan<CharType>(argc, argv), stats);
         }
 
         template<ArgRange<CharType> Args>
-        auto parse(const Args & args) const -> ARGUM_EXPECTED(CharType, void) {
+        auto parse(const Args & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
             
-            return this->parse(std::begin(args), std::end(args));
+            return this->parse(std::begin(args), std::end(args), stats);
+        }
+
+        template<ArgRange<CharType> Args>
+        requires(!std::is_lvalue_reference_v<Args> && !std::ranges::borrowed_range<Args>)
+        auto parse(Args && args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
+            
+            return detached([&]() { return this->parse(std::as_const(args), stats); });
+        }
+
+        /**
+         Parses arguments produced by BasicResponseFileReader::expandLazily()
+
+         Errors reading response files are reported the same way as parsing errors.
+         */
+        auto parse(const BasicLazyExpandedArgs<CharType> & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = this->parse(args.begin(), args.end(), stats);
+            if (auto err = args.error())
+                return err;
+            return ret;
+        #else
+            return this->parse(args.begin(), args.end(), stats);
+        #endif
         }
 
         template<ArgIterator<CharType> It>
-        auto parse(It argFirst, It argLast) const -> ARGUM_EXPECTED(CharType, void) {
+        auto parse(It argFirst, It argLast, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
             
             using ReturnType = ARGUM_EXPECTED(CharType, void);
             ParsingState parsingState(*this);
+            parsingState.collectStats(stats);
 
             return ReturnType(parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/false));
         }
 
-        auto parseUntilUnknown(int argc, CharType ** argv) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
-            return this->parseUntilUnknown(makeArgSpan<CharType>(argc, argv));
+        static constexpr size_t defaultMaxErrors = 20;
+
+        /**
+         Parses all arguments reporting every error found rather than stopping at the first one.
+
+         Unrecognized and ambiguous options, extra positionals, missing or extra option arguments,
+         errors reported by handlers and failed validators are recorded and parsing continues with the
+         next argument. Once `maxErrors` errors are found parsing stops. Handlers of the arguments that
+         were parsed successfully are invoked as usual. 
+         
+         Returns the errors in the order they were found, or an empty vector on success. 
+         */
+        auto parseCollectingErrors(int argc, CharType ** argv, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
+            return this->parseCollectingErrors(makeArgSpan<CharType>(argc, argv), maxErrors, stats);
         }
 
         template<ArgRange<CharType> Args>
-        auto parseUntilUnknown(const Args & args) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+        auto parseCollectingErrors(const Args & args, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
             
-            return this->parseUntilUnknown(std::begin(args), std::end(args));
+            return this->parseCollectingErrors(std::begin(args), std::end(args), maxErrors, stats);
+        }
+
+        auto parseCollectingErrors(const BasicLazyExpandedArgs<CharType> & args, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = this->parseCollectingErrors(args.begin(), args.end(), maxErrors, stats);
+            if (auto err = args.error())
+                ret.emplace_back(std::move(err));
+            return ret;
+        #else
+            return this->parseCollectingErrors(args.begin(), args.end(), maxErrors, stats);
+        #endif
         }
 
         template<ArgIterator<CharType> It>
-        auto parseUntilUnknown(It argFirst, It argLast) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+        auto parseCollectingErrors(It argFirst, It argLast, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
             
+            std::vector<ParsingExceptionPtr> ret;
             ParsingState parsingState(*this);
+            parsingState.collectErrors(ret, maxErrors);
+            parsingState.collectStats(stats);
+
+            //the error that reaches the limit stops parsing
+        #ifdef ARGUM_USE_EXPECTED
+            auto res = parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/false);
+            if (!res)
+                ret.emplace_back(res.error());
+        #else
+            try {
+                parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/false);
+            } catch (ParsingException & ex) {
+                ret.emplace_back(ex.clone());
+            }
+        #endif
+            return ret;
+        }
+
+        auto parseUntilUnknown(int argc, CharType ** argv, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return this->parseUntilUnknown(makeArgSpan<CharType>(argc, argv), stats);
+        }
+
+        template<ArgRange<CharType> Args>
+        auto parseUntilUnknown(const Args & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            
+            return this->parseUntilUnknown(std::begin(args), std::end(args), stats);
+        }
+
+        template<ArgRange<CharType> Args>
+        requires(!std::is_lvalue_reference_v<Args> && !std::ranges::borrowed_range<Args>)
+        auto parseUntilUnknown(Args && args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            
+            return detached([&]() { return this->parseUntilUnknown(std::as_const(args), stats); });
+        }
+
+        auto parseUntilUnknown(const BasicLazyExpandedArgs<CharType> & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = this->parseUntilUnknown(args.begin(), args.end(), stats);
+            if (auto err = args.error())
+                return err;
+            return ret;
+        #else
+            return this->parseUntilUnknown(args.begin(), args.end(), stats);
+        #endif
+        }
+
+        template<ArgIterator<CharType> It>
+        auto parseUntilUnknown(It argFirst, It argLast, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            
+            ParsingState parsingState(*this);
+            parsingState.collectStats(stats);
 
             return parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/true);
         }
@@ -561,6 +750,8 @@ namespace Argum {
         auto formatUsage(StringViewType progName, std::optional<StringType> subCommand,
                          unsigned width,
                          const Colorizer & colorizer) const -> StringType {
+            if (this->m_renderCache)
+                return this->cachedRender(RenderKind::usage, progName, subCommand, width, colorizer);
             typename HelpFormatter::Layout layout;
             layout.width = width;
             return HelpFormatter(*this, progName, layout).formatUsage(subCommand, colorizer);
@@ -599,13 +790,73 @@ namespace Argum {
         auto formatHelp(StringViewType progName, std::optional<StringType> subCommand,
                         unsigned width,
                         const Colorizer & colorizer) const -> StringType {
+            if (this->m_renderCache)
+                return this->cachedRender(RenderKind::help, progName, subCommand, width, colorizer);
+            StringType ret;
+            auto out = std::back_inserter(ret);
+            this->formatHelp(out, progName, subCommand, width, colorizer);
+            return ret;
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, 
+                         unsigned width = HelpFormatter::defaultLayout.width,
+                         const Colorizer & colorizer = {}) const {
+            this->formatUsage(out, progName, {}, width, colorizer);
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, const Colorizer & colorizer) const {
+            this->formatUsage(out, progName, {}, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                         const Colorizer & colorizer) const {
+            this->formatUsage(out, progName, subCommand, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                         unsigned width = HelpFormatter::defaultLayout.width,
+                         const Colorizer & colorizer = {}) const {
+            if (this->m_renderCache) {
+                out.write(this->cachedRender(RenderKind::usage, progName, subCommand, width, colorizer));
+                return;
+            }
+            typename HelpFormatter::Layout layout;
+            layout.width = width;
+            HelpFormatter(*this, progName, layout).formatUsage(out, subCommand, colorizer);
+        }
+
+        void formatHelp(OutputSink out, StringViewType progName, 
+                        unsigned width = HelpFormatter::defaultLayout.width,
+                        const Colorizer & colorizer = {}) const {
+            this->formatHelp(out, progName, {}, width, colorizer);
+        }
+
+        void formatHelp(OutputSink out, StringViewType progName, const Colorizer & colorizer) const {
+            this->formatHelp(out, progName, {}, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        void formatHelp(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                        const Colorizer & colorizer) const {
+            this->formatHelp(out, progName, subCommand, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        /**
+         Writes usage and help to the sink incrementally, without building the 
+         whole text in memory.
+         */
+        void formatHelp(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                        unsigned width = HelpFormatter::defaultLayout.width,
+                        const Colorizer & colorizer = {}) const {
+            if (this->m_renderCache) {
+                out.write(this->cachedRender(RenderKind::help, progName, subCommand, width, colorizer));
+                return;
+            }
             typename HelpFormatter::Layout layout;
             layout.width = width;           
             HelpFormatter formatter(*this, progName, layout);
-            StringType ret = formatter.formatUsage(subCommand, colorizer);
-            ret.append(2, CharConstants::endl);
-            ret.append(formatter.formatHelp(subCommand, colorizer));
-            return ret;
+            formatter.formatUsage(out, subCommand, colorizer);
+            out.write(2, CharConstants::endl);
+            formatter.formatHelp(out, subCommand, colorizer);
         }
 
         auto isOptionNameLong(const StringViewType name) const -> bool {
@@ -613,6 +864,122 @@ namespace Argum {
         }
 
     private:
+        enum class RenderKind {
+            usage,
+            help
+        };
+
+        using ColorScheme = BasicColorScheme<CharType>;
+        using ColorSchemeCopy = std::array<StringType, 12>;
+
+        static constexpr StringViewType ColorScheme::* colorSchemeFields[] = {
+            &ColorScheme::heading,
+            &ColorScheme::progName,
+            &ColorScheme::shortOptionInUsage,
+            &ColorScheme::longOptionInUsage,
+            &ColorScheme::optionArgInUsage,
+            &ColorScheme::positionalInUsage,
+            &ColorScheme::shortOption,
+            &ColorScheme::longOption,
+            &ColorScheme::optionArg,
+            &ColorScheme::positional,
+            &ColorScheme::error,
+            &ColorScheme::warning
+        };
+        static_assert(std::size(colorSchemeFields) == std::tuple_size_v<ColorSchemeCopy>);
+
+        //Schemes are compared by content since they are often temporaries or live on the stack
+        static auto copyColorScheme(const ColorScheme & scheme) -> ColorSchemeCopy {
+            ColorSchemeCopy ret;
+            for (size_t i = 0; i < ret.size(); ++i)
+                ret[i] = scheme.*colorSchemeFields[i];
+            return ret;
+        }
+
+        //Invokes a parse converting a compact error in its result into an exception object that does not 
+        //refer to the arguments
+        template<class Func>
+        static auto detached(Func && func) -> decltype(func()) {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = func();
+            ret.detachError();
+            return ret;
+        #else
+            return func();
+        #endif
+        }
+
+        static auto sameColorScheme(const ColorSchemeCopy & lhs, const ColorScheme & rhs) -> bool {
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (lhs[i] != rhs.*colorSchemeFields[i])
+                    return false;
+            }
+            return true;
+        }
+
+        struct RenderCacheEntry {
+            RenderKind kind;
+            StringType progName;
+            std::optional<StringType> subCommand;
+            typename HelpFormatter::Layout layout;
+            ColorSchemeCopy scheme;
+            StringType text;
+        };
+
+        struct RenderCache {
+            static constexpr size_t maxEntries = 8;
+
+            size_t updateCount = size_t(-1);
+            std::optional<ColorSchemeCopy> namesScheme;
+            typename HelpFormatter::ItemNames names;
+            std::vector<RenderCacheEntry> entries;
+        };
+
+        auto cachedRender(RenderKind kind, 
+                          StringViewType progName, 
+                          const std::optional<StringType> & subCommand,
+                          unsigned width,
+                          const Colorizer & colorizer) const -> const StringType & {
+            
+            auto & cache = *this->m_renderCache;
+            if (cache.updateCount != this->m_updateCount) {
+                cache.entries.clear();
+                cache.namesScheme.reset();
+                cache.updateCount = this->m_updateCount;
+            }
+
+            typename HelpFormatter::Layout layout;
+            layout.width = width;
+
+            auto & scheme = colorizer.scheme();
+            for (auto & entry: cache.entries) {
+                if (entry.kind == kind && entry.layout == layout && entry.progName == progName &&
+                    entry.subCommand == subCommand && sameColorScheme(entry.scheme, scheme))
+                    return entry.text;
+            }
+
+            HelpFormatter formatter(*this, progName, layout);
+            if (!cache.namesScheme || !sameColorScheme(*cache.namesScheme, scheme)) {
+                cache.names = formatter.calculateItemNames(colorizer);
+                cache.namesScheme = copyColorScheme(scheme);
+            }
+            formatter.useItemNames(cache.names);
+
+            if (cache.entries.size() == RenderCache::maxEntries)
+                cache.entries.erase(cache.entries.begin());
+            auto & entry = cache.entries.emplace_back(RenderCacheEntry{
+                kind, StringType(progName), subCommand, layout, copyColorScheme(scheme), {}
+            });
+
+            auto out = std::back_inserter(entry.text);
+            formatter.formatUsage(out, subCommand, colorizer);
+            if (kind == RenderKind::help) {
+                entry.text.append(2, CharConstants::endl);
+                formatter.formatHelp(out, subCommand, colorizer);
+            }
+            return entry.text;
+        }
+
         class ParsingState {
         public:
             ParsingState(const BasicParser & owner): 
@@ -620,57 +987,98 @@ namespace Argum {
                 m_updateCountAtLastRecalc(owner.m_updateCount - 1) {
             }
 
+            auto collectErrors(std::vector<ParsingExceptionPtr> & errors, size_t maxErrors) -> void {
+                m_errors = &errors;
+                m_maxErrors = maxErrors;
+            }
+
+            auto collectStats(ParseStats * stats) -> void {
+                m_stats = stats;
+            }
+
             template<ArgIterator<CharType> It>
             auto parse(It argFirst, It argLast, bool stopOnUnknown) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
             
+                PhaseTimer totalTimer(m_stats, &ParseStats::totalTime);
+                AllocationCounter allocationCounter(m_stats);
+
+                //tracks the current argument without requiring random access to arguments
+                It current = argFirst;
+                unsigned currentIdx = 0;
+                //text at the start of an argument as a view into the command line for compact errors
+                auto inArgument = [&](StringViewType text, unsigned argIdx) -> std::optional<StringViewType> {
+                #ifdef ARGUM_USE_EXPECTED
+                    for ( ; currentIdx < argIdx; ++currentIdx)
+                        ++current;
+                    StringViewType arg = *current;
+                    if (arg.starts_with(text))
+                        return arg.substr(0, text.size());
+                #else
+                    (void)text; (void)argIdx;
+                #endif
+                    return std::nullopt;
+                };
                 ARGUM_CHECK_RESULT(auto ret, m_owner.m_tokenizer.tokenize(argFirst, argLast, [&](auto && token) -> ARGUM_EXPECTED(CharType, typename Tokenizer::TokenResult) {
 
                     using TokenType = std::remove_cvref_t<decltype(token)>;
 
                     if constexpr (std::is_same_v<TokenType, typename Tokenizer::OptionToken>) {
 
-                        ARGUM_PROPAGATE_ERROR(resetOption(token.idx, token.usedName, token.argument));
+                        Impl::countIn(m_stats, &ParseStats::optionTokens);
+                        ARGUM_PROPAGATE_ERROR(resetOption(token.idx, token.argIdx, token.usedName, inArgument(token.usedName, token.argIdx), 
+                                                          token.argument));
                         return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::OptionStopToken>) {
 
+                        Impl::countIn(m_stats, &ParseStats::optionStopTokens);
                         ARGUM_PROPAGATE_ERROR(completeOption());
                         return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::ArgumentToken>) {
 
-                        ARGUM_CHECK_RESULT(auto result, handlePositional(token.value, argFirst + token.argIdx, argLast));
+                        Impl::countIn(m_stats, &ParseStats::argumentTokens);
+                        for ( ; currentIdx < token.argIdx; ++currentIdx)
+                            ++current;
+                        ARGUM_CHECK_RESULT(auto result, handlePositional(token.value, current, argLast));
                         if (!result) {
                             if (stopOnUnknown)
                                 return Tokenizer::StopBefore;
-                            ARGUM_THROW(ExtraPositional, token.value);
+                            ARGUM_PROPAGATE_ERROR(failAt<ExtraPositional>(token.value, inArgument(token.value, token.argIdx), int(token.argIdx)));
                         }
                         return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::UnknownOptionToken>) {
 
+                        Impl::countIn(m_stats, &ParseStats::unknownOptionTokens);
                         ARGUM_PROPAGATE_ERROR(completeOption());
                         if (stopOnUnknown)
                             return Tokenizer::StopBefore;
-                        ARGUM_THROW(UnrecognizedOption, token.name);
+                        ARGUM_PROPAGATE_ERROR(failAt<UnrecognizedOption>(token.name, inArgument(token.name, token.argIdx), int(token.argIdx)));
+                        return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::AmbiguousOptionToken>) {
 
+                        Impl::countIn(m_stats, &ParseStats::ambiguousOptionTokens);
                         ARGUM_PROPAGATE_ERROR(completeOption());
-                        ARGUM_THROW(AmbiguousOption, token.name, std::move(token.possibilities));
+                        ARGUM_PROPAGATE_ERROR(fail<AmbiguousOption>(token.name, std::move(token.possibilities)));
+                        return Tokenizer::Continue;
                     } 
-                }));
+                }, m_stats));
                 ARGUM_PROPAGATE_ERROR(completeOption());
                 ARGUM_PROPAGATE_ERROR(validate());
                 return ret;
             }
 
         private:
-            auto resetOption(unsigned index, StringViewType name, const std::optional<StringViewType> & argument) -> ARGUM_EXPECTED(CharType, void) {
+            auto resetOption(unsigned index, unsigned argIdx, StringViewType name, std::optional<StringViewType> nameInArgument, 
+                             const std::optional<StringViewType> & argument) -> ARGUM_EXPECTED(CharType, void) {
                 ARGUM_PROPAGATE_ERROR(completeOption());
                 m_optionName = std::move(name);
+                m_optionNameInArgument = nameInArgument;
                 m_optionArgument = argument;
                 m_optionIndex = int(index);
+                m_optionArgIdx = int(argIdx);
                 return ARGUM_VOID_SUCCESS;
             }
 
@@ -685,14 +1093,14 @@ namespace Argum {
                     constexpr auto argumentKind = Option::template argumentKindOf<HandlerType>();
                     if constexpr (argumentKind == OptionArgumentKind::None) {
                         if (m_optionArgument)
-                            ARGUM_THROW(ExtraOptionArgument, m_optionName);
-                        ARGUM_PROPAGATE_ERROR(handler());
+                            return failAt<ExtraOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx);
+                        ARGUM_PROPAGATE_ERROR(callHandler(handler));
                     } else if constexpr (argumentKind == OptionArgumentKind::Optional) {
-                        ARGUM_PROPAGATE_ERROR(handler(m_optionArgument));
+                        ARGUM_PROPAGATE_ERROR(callHandler(handler, m_optionArgument));
                     } else {
                         if (!m_optionArgument)
-                            ARGUM_THROW(MissingOptionArgument, m_optionName);
-                        ARGUM_PROPAGATE_ERROR(handler(*m_optionArgument));
+                            return failAt<MissingOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx);
+                        ARGUM_PROPAGATE_ERROR(callHandler(handler, *m_optionArgument));
                     }
                     return ARGUM_VOID_SUCCESS;
                 }, option.m_handler));
@@ -713,26 +1121,29 @@ namespace Argum {
                         using HandlerType = std::remove_cvref_t<decltype(handler)>;
                         constexpr auto argumentKind = Option::template argumentKindOf<HandlerType>();
                         if constexpr (argumentKind == OptionArgumentKind::None) {
-                            if (m_optionArgument)
-                                ARGUM_THROW(ExtraOptionArgument, m_optionName);
-                            ARGUM_PROPAGATE_ERROR(handler());
+                            if (m_optionArgument) {
+                                ARGUM_PROPAGATE_ERROR(failAt<ExtraOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx));
+                            } else {
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler));
+                            }
                             return false;
                         } else if constexpr (argumentKind == OptionArgumentKind::Optional) {
                             if (requireAttachedArgument || m_optionArgument) {
-                                ARGUM_PROPAGATE_ERROR(handler(m_optionArgument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, m_optionArgument));
                                 return false;
                             } else {
-                                ARGUM_PROPAGATE_ERROR(handler(argument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, argument));
                                 return true;
                             }
                         } else {
                             if (m_optionArgument) {
-                                ARGUM_PROPAGATE_ERROR(handler(*m_optionArgument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, *m_optionArgument));
                                 return false;
                             } else if (requireAttachedArgument) {
-                                ARGUM_THROW(MissingOptionArgument, m_optionName);
+                                ARGUM_PROPAGATE_ERROR(failAt<MissingOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx));
+                                return false;
                             } else {
-                                ARGUM_PROPAGATE_ERROR(handler(argument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, argument));
                                 return true;
                             }
                         }
@@ -745,10 +1156,10 @@ namespace Argum {
             auto validateOptionMax(const Option & option) -> ARGUM_EXPECTED(CharType, void) {
                 auto & name = option.m_names.main();
                 ++m_validationData.optionCount(name);
+                Impl::countIn(m_stats, &ParseStats::validatorEvaluations);
                 auto validator = optionOccursAtMost(name, option.m_occurs.max());
-                if (!validator(m_validationData)) {
-                    ARGUM_THROW(ValidationError, validator);
-                }
+                if (!validator(m_validationData))
+                    return fail<ValidationError>(validator);
                 return ARGUM_VOID_SUCCESS;
             }
 
@@ -782,7 +1193,7 @@ namespace Argum {
                 }
                 
                 auto & count = m_validationData.positionalCount(positional->m_name);
-                ARGUM_PROPAGATE_ERROR(positional->m_handler(value));
+                ARGUM_PROPAGATE_ERROR(callHandler(positional->m_handler, value));
                 ++count;
                 return true;
             }
@@ -792,25 +1203,43 @@ namespace Argum {
 
                 if (m_updateCountAtLastRecalc == m_owner.m_updateCount)
                     return;
+
+                Impl::countIn(m_stats, &ParseStats::positionalRecalculations);
+                PhaseTimer timer(m_stats, &ParseStats::positionalRecalculationTime);
                 
-                //1. Count remaining positional arguments
-                unsigned remainingPositionalCount = countRemainingPositionals(remainingArgFirst, argLast);
-                
-                //2. Build the partitioner for positional ranges
-                Partitioner<unsigned> partitioner;
-                
-                auto fillStartIndex = m_positionalIndex + 1;
+                auto fillStartIndex = unsigned(m_positionalIndex + 1);
+                unsigned alreadyProcessed = 0;
                 if (m_positionalIndex >= 0) {
                     auto & positional = m_owner.m_positionals[unsigned(m_positionalIndex)];
                     auto count = m_validationData.positionalCount(positional.m_name);
                     if (positional.m_occurs.max() > count) {
-                        remainingPositionalCount += count; //account for already processed
-                        partitioner.addRange(positional.m_occurs.min(), positional.m_occurs.max());
+                        alreadyProcessed = count;
                         --fillStartIndex;
                     }
                 }
-                std::for_each(m_owner.m_positionals.begin() + (m_positionalIndex + 1), m_owner.m_positionals.end(),
-                                [&] (const Positional & positional) {
+                auto first = m_owner.m_positionals.begin() + fillStartIndex;
+                auto last = m_owner.m_positionals.end();
+                m_positionalSizes.resize(m_owner.m_positionals.size());
+
+                //If only the last positional can take a variable number of arguments each one simply takes
+                //as many as it can. Counting the arguments would require tokenizing the rest of the command 
+                //line which, for lazily expanded arguments, means reading all remaining response files.
+                if (first == last || std::all_of(first, last - 1, [](const Positional & positional) {
+                        return positional.m_occurs.min() == positional.m_occurs.max(); 
+                    })) {
+                    std::transform(first, last, m_positionalSizes.begin() + fillStartIndex, [](const Positional & positional) {
+                        return positional.m_occurs.max();
+                    });
+                    this->m_updateCountAtLastRecalc = m_owner.m_updateCount;
+                    return;
+                }
+
+                //1. Count remaining positional arguments, accounting for already processed
+                unsigned remainingPositionalCount = countRemainingPositionals(remainingArgFirst, argLast) + alreadyProcessed;
+                
+                //2. Build the partitioner for positional ranges
+                Partitioner<unsigned> partitioner;
+                std::for_each(first, last, [&] (const Positional & positional) {
                     partitioner.addRange(positional.m_occurs.min(), positional.m_occurs.max());
                 });
 
@@ -820,7 +1249,6 @@ namespace Argum {
                 ARGUM_ALWAYS_ASSERT(res); //this must be true by construction
 
                 //4. Fill in expected sizes based on regex matches
-                m_positionalSizes.resize(m_owner.m_positionals.size());
                 std::copy(res->begin(), res->end() - 1, m_positionalSizes.begin() + fillStartIndex);
 
                 this->m_updateCountAtLastRecalc = m_owner.m_updateCount;
@@ -838,7 +1266,7 @@ namespace Argum {
 
                         auto & option = m_owner.m_options[token.idx];
                         if (option.canHaveArgument()) {
-                            currentOptionExpectsArgument = !token.argument;
+                            currentOptionExpectsArgument = !token.argument && !option.m_requireAttachedArgument;
                         } else {
                             currentOptionExpectsArgument = false;
                         }
@@ -859,13 +1287,15 @@ namespace Argum {
                         currentOptionExpectsArgument = false;
                     }
                     return Tokenizer::Continue;
-                });
+                }, m_stats);
                 
                 return remainingPositionalCount;
             }
 
             auto validate() -> ARGUM_EXPECTED(CharType, void) {
 
+                PhaseTimer timer(m_stats, &ParseStats::validationTime);
+
                 //We could use normal validators for this but it is faster to do it manually
                 for(auto idx = (m_positionalIndex >= 0 ? unsigned(m_positionalIndex) : 0u); 
                     idx != unsigned(m_owner.m_positionals.size());
@@ -873,30 +1303,136 @@ namespace Argum {
                     
                     auto & positional = m_owner.m_positionals[unsigned(idx)];
                     auto validator = positionalOccursAtLeast(positional.m_name, positional.m_occurs.min());
-                    if (!validator(m_validationData))
-                        ARGUM_THROW(ValidationError, validator);
+                    Impl::countIn(m_stats, &ParseStats::validatorEvaluations);
+                    if (!validator(m_validationData)) {
+                        ARGUM_PROPAGATE_ERROR(fail<ValidationError>(validator));
+                    }
                 }
                 
                 for(auto & [validator, desc]: m_owner.m_validators) {
-                    if (!validator(m_validationData))
-                        ARGUM_THROW(ValidationError, desc);
+                    Impl::countIn(m_stats, &ParseStats::validatorEvaluations);
+                    if (!validator(m_validationData)) {
+                        ARGUM_PROPAGATE_ERROR(fail<ValidationError>(desc));
+                    }
                 }
 
                 return ARGUM_VOID_SUCCESS;
             }
 
+            //Whether the next error can be recorded and parsing continued
+            auto canRecover() const -> bool {
+                return m_errors && m_errors->size() + 1 < m_maxErrors;
+            }
+
+            //Reports an error: records it when collecting errors and there is room, fails otherwise
+            template<class Exception, class... Args>
+            auto fail(Args && ...args) -> ARGUM_EXPECTED(CharType, void) {
+                if (canRecover()) {
+                    m_errors->emplace_back(std::make_shared<Exception>(std::forward<Args>(args)...));
+                    return ARGUM_VOID_SUCCESS;
+                }
+                ARGUM_THROW(Exception, std::forward<Args>(args)...);
+            }
+
+            //Reports an error about text of an argument. Unless the error is recorded, in ARGUM_USE_EXPECTED 
+            //mode it refers to the text in the command line, if found there, rather than copying it
+            template<class Exception>
+            auto failAt(StringViewType subject, std::optional<StringViewType> inCommandLine, int argIdx) -> ARGUM_EXPECTED(CharType, void) {
+            #ifdef ARGUM_USE_EXPECTED
+                if (inCommandLine && !canRecover()) {
+                    if (auto compact = BasicParsingError<CharType>::template make<Exception>(*inCommandLine, argIdx))
+                        return *compact;
+                }
+            #else
+                (void)inCommandLine;
+            #endif
+                return fail<Exception>(subject, argIdx);
+            }
+
+            //Invokes a user handler recording its error when collecting errors
+            template<class Handler, class... Args>
+            auto callHandler(const Handler & handler, Args && ...args) -> ARGUM_EXPECTED(CharType, void) {
+                Impl::countIn(m_stats, &ParseStats::handlerInvocations);
+                PhaseTimer timer(m_stats, &ParseStats::handlersTime);
+            #ifdef ARGUM_USE_EXPECTED
+                auto res = handler(std::forward<Args>(args)...);
+                if (!res && canRecover()) {
+                    m_errors->emplace_back(res.error());
+                    return {};
+                }
+                return res;
+            #else
+                if (!m_errors)
+                    return handler(std::forward<Args>(args)...);
+                try {
+                    handler(std::forward<Args>(args)...);
+                } catch (ParsingException & ex) {
+                    if (!canRecover())
+                        throw;
+                    m_errors->emplace_back(ex.clone());
+                }
+            #endif
+            }
+
+            //Adds the time until its destruction to a phase of stats if they are being collected
+            class PhaseTimer {
+            public:
+                PhaseTimer(ParseStats * stats, ParseStats::Duration ParseStats::*phase):
+                    m_stats(stats),
+                    m_phase(phase) {
+                    if (m_stats)
+                        m_start = ParseStats::Clock::now();
+                }
+                ~PhaseTimer() {
+                    if (m_stats)
+                        m_stats->*m_phase += ParseStats::Clock::now() - m_start;
+                }
+                PhaseTimer(const PhaseTimer &) = delete;
+                PhaseTimer & operator=(const PhaseTimer &) = delete;
+            private:
+                ParseStats * m_stats;
+                ParseStats::Duration ParseStats::*m_phase;
+                ParseStats::Clock::time_point m_start;
+            };
+
+            //Adds the allocations made until its destruction to stats if they are being collected
+            class AllocationCounter {
+            public:
+                AllocationCounter(ParseStats * stats):
+                    m_stats(stats && stats->allocationCounter ? stats : nullptr) {
+                    if (m_stats)
+                        m_start = m_stats->allocationCounter();
+                }
+                ~AllocationCounter() {
+                    if (m_stats)
+                        m_stats->allocations += m_stats->allocationCounter() - m_start;
+                }
+                AllocationCounter(const AllocationCounter &) = delete;
+                AllocationCounter & operator=(const AllocationCounter &) = delete;
+            private:
+                ParseStats * m_stats;
+                size_t m_start = 0;
+            };
+
         private:
             const BasicParser & m_owner;
             size_t m_updateCountAtLastRecalc;
 
             int m_optionIndex = -1;
+            int m_optionArgIdx = -1;
             StringType m_optionName;
+            std::optional<StringViewType> m_optionNameInArgument;
             std::optional<StringType> m_optionArgument;
 
             int m_positionalIndex = -1;
             std::vector<unsigned> m_positionalSizes;
             
             ValidationData m_validationData;
+
+            std::vector<ParsingExceptionPtr> * m_errors = nullptr;
+            size_t m_maxErrors = 0;
+
+            ParseStats * m_stats = nullptr;
         };
 
     private:
@@ -906,6 +1442,7 @@ namespace Argum {
         std::vector<std::pair<ValidatorFunction, StringType>> m_validators;
         size_t m_updateCount = 0;
         SubCommandMark m_subCommandMark;
+        mutable std::optional<RenderCache> m_renderCache;
     };
 
     ARGUM_DECLARE_FRIENDLY_NAMES(Parser)
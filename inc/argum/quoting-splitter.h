@@ -0,0 +1,229 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_QUOTING_SPLITTER_H_INCLUDED
+#define HEADER_ARGUM_QUOTING_SPLITTER_H_INCLUDED
+
+#include "command-line.h"
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <type_traits>
+
+#include <stdint.h>
+
+namespace Argum {
+
+    /**
+     Response file splitter that allows multiple, quoted arguments on each line.
+
+     With `Syntax::posixShell` the rules follow POSIX shell word splitting without any expansions:
+     - arguments are separated by whitespace
+     - outside of quotes a backslash escapes the next character
+     - inside single quotes all characters are literal
+     - inside double quotes a backslash only escapes `$`, `` ` ``, `"` and `\`
+     - a `#` at the start of an argument starts a comment that extends to the end of the line
+
+     With `Syntax::gcc` the rules are the ones of GCC `@file` arguments: arguments are separated by
+     whitespace, single and double quotes group characters, and a backslash escapes the next
+     character everywhere, including inside quotes.
+
+     Lines are split independently: a quote that is not closed on its line is closed at its end and
+     a backslash at the end of the line is ignored.
+
+     Each line is scanned once. Arguments that need no unescaping are produced as views into the
+     line (or, when splitting owned lines, by moving the line if it is a single argument). Others
+     are unescaped directly into their final storage.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicQuotingSplitter {
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+
+        enum class Syntax {
+            posixShell,
+            gcc
+        };
+
+    public:
+        BasicQuotingSplitter(Syntax syntax = Syntax::posixShell): m_syntax(syntax) {
+        }
+
+        auto syntax() const -> Syntax {
+            return this->m_syntax;
+        }
+
+        //Splitter for BasicResponseFileReader::expand() and expandConcurrently()
+        template<class OutIt>
+        void operator()(StringType && line, OutIt dest) const {
+            OwningEmitter<OutIt> emitter{line, dest, {}};
+            this->split(StringViewType(line), emitter);
+        }
+
+        //Splitter for BasicResponseFileReader::expandMapped() and expandLazily()
+        template<class OutIt>
+        void operator()(StringViewType line, OutIt dest, BasicArgumentStore<CharType> & store) const {
+            ViewEmitter<OutIt> emitter{store, dest, 0};
+            this->split(line, emitter);
+        }
+
+    private:
+        using Constants = CharConstants<CharType>;
+
+        template<class OutIt>
+        struct OwningEmitter {
+            StringType & line;
+            OutIt & dest;
+            //scratch space for unescaping, allocated once per line
+            StringType buffer;
+
+            void view(StringViewType arg) {
+                if (arg.data() == line.data() && arg.size() == line.size())
+                    *dest = std::move(line);
+                else
+                    *dest = StringType(arg);
+            }
+            auto begin(size_t maxSize) -> CharType * {
+                if (this->buffer.size() < maxSize)
+                    this->buffer.resize(maxSize);
+                return this->buffer.data();
+            }
+            void finish(CharType * data, size_t size) {
+                *dest = StringType(data, size);
+            }
+        };
+
+        template<class OutIt>
+        struct ViewEmitter {
+            BasicArgumentStore<CharType> & store;
+            OutIt & dest;
+            size_t allocated = 0;
+
+            void view(StringViewType arg) {
+                *dest = arg;
+            }
+            auto begin(size_t maxSize) -> CharType * {
+                this->allocated = maxSize;
+                return this->store.allocate(maxSize);
+            }
+            void finish(CharType * data, size_t size) {
+                this->store.shrink(data, this->allocated, size);
+                *dest = StringViewType(data, size);
+            }
+        };
+
+        template<class Emitter>
+        void split(StringViewType line, Emitter & emitter) const {
+            if (this->m_syntax == Syntax::gcc)
+                splitLine<Syntax::gcc>(line, emitter);
+            else
+                splitLine<Syntax::posixShell>(line, emitter);
+        }
+
+        template<Syntax syntax, class Emitter>
+        static void splitLine(StringViewType line, Emitter & emitter) {
+            enum class State { unquoted, singleQuoted, doubleQuoted };
+
+            const CharType * current = line.data();
+            const CharType * const last = current + line.size();
+            for ( ; ; ) {
+                while (current != last && isSpace(*current))
+                    ++current;
+                if (current == last)
+                    break;
+                if constexpr (syntax == Syntax::posixShell) {
+                    if (*current == Constants::hash)
+                        break;
+                }
+
+                const CharType * const start = current;
+                //set once the argument differs from its source text
+                CharType * outStart = nullptr;
+                CharType * out = nullptr;
+                auto startCopy = [&]() {
+                    outStart = emitter.begin(size_t(last - start));
+                    out = std::copy(start, current, outStart);
+                };
+
+                State state = State::unquoted;
+                for ( ; current != last; ++current) {
+                    CharType c = *current;
+                    if (state == State::unquoted) {
+                        if (isSpace(c))
+                            break;
+                        if (c == Constants::singleQuote || c == Constants::doubleQuote) {
+                            if (!out)
+                                startCopy();
+                            state = (c == Constants::singleQuote ? State::singleQuoted : State::doubleQuoted);
+                            continue;
+                        }
+                        if (c == Constants::backslash) {
+                            if (!out)
+                                startCopy();
+                            if (current + 1 != last)
+                                *out++ = *++current;
+                            continue;
+                        }
+                    } else if (state == State::singleQuoted) {
+                        if (c == Constants::singleQuote) {
+                            state = State::unquoted;
+                            continue;
+                        }
+                        if constexpr (syntax == Syntax::gcc) {
+                            if (c == Constants::backslash) {
+                                if (current + 1 != last)
+                                    *out++ = *++current;
+                                continue;
+                            }
+                        }
+                    } else {
+                        if (c == Constants::doubleQuote) {
+                            state = State::unquoted;
+                            continue;
+                        }
+                        if (c == Constants::backslash) {
+                            if (current + 1 == last)
+                                continue;
+                            if (syntax == Syntax::gcc || isShellEscapableInDoubleQuotes(current[1])) {
+                                *out++ = *++current;
+                                continue;
+                            }
+                        }
+                    }
+                    if (out)
+                        *out++ = c;
+                }
+                if (out)
+                    emitter.finish(outStart, size_t(out - outStart));
+                else
+                    emitter.view(StringViewType(start, size_t(current - start)));
+            }
+        }
+
+        static auto isSpace(CharType c) -> bool {
+            //avoid the locale lookup for ASCII
+            if (std::make_unsigned_t<CharType>(c) < 0x80)
+                return c == Constants::space || (c >= Constants::tab && c <= Constants::carriageReturn);
+            return Constants::isSpace(c);
+        }
+
+        static auto isShellEscapableInDoubleQuotes(CharType c) -> bool {
+            return c == Constants::dollar || c == Constants::backtick ||
+                   c == Constants::doubleQuote || c == Constants::backslash;
+        }
+    private:
+        Syntax m_syntax;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(QuotingSplitter)
+}
+
+#endif
@@ -0,0 +1,361 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_RESPONSE_FILE_CACHE_H_INCLUDED
+#define HEADER_ARGUM_RESPONSE_FILE_CACHE_H_INCLUDED
+
+#include "mapped-file.h"
+
+#include <filesystem>
+#include <chrono>
+#include <system_error>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <random>
+#include <mutex>
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <locale.h>
+
+#if !defined(_WIN32) && __has_include(<sys/stat.h>)
+    #include <sys/stat.h>
+#endif
+
+namespace Argum {
+
+    /**
+     Persistent cache of split response file contents.
+
+     Each response file is cached in a separate file in the cache directory. It stores
+     the arguments produced by splitting the response file in a compact binary form
+     together with the key of the source: its path, size, modification time and inode.
+     Entries for `wchar_t` arguments are also keyed by the `LC_CTYPE` locale they were 
+     decoded with.
+     A cached entry is used only if the key still matches. Otherwise the file is re-read
+     and the entry rewritten. When the total size of the cache exceeds the limit the least
+     recently used entries are removed.
+
+     All failures to read or write the cache are silently ignored.
+     */
+    ARGUM_MOD_EXPORTED
+    class ResponseFileCache {
+    public:
+        static constexpr uintmax_t defaultMaxSize = 64 * 1024 * 1024;
+        static constexpr std::string_view extension = ".argum-cache";
+
+        struct FileKey {
+            uint64_t size = 0;
+            int64_t mtime = 0;
+            uint64_t inode = 0;
+
+            friend auto operator==(const FileKey &, const FileKey &) -> bool = default;
+        };
+
+    public:
+        ResponseFileCache(std::filesystem::path directory, uintmax_t maxSize = defaultMaxSize):
+            m_directory(std::move(directory)),
+            m_maxSize(maxSize) {
+        }
+
+        auto directory() const -> const std::filesystem::path & {
+            return this->m_directory;
+        }
+        auto maxSize() const -> uintmax_t {
+            return this->m_maxSize;
+        }
+
+        static auto keyOf(const std::filesystem::path & path, std::error_code & ec) -> FileKey {
+            FileKey ret;
+            ret.size = uint64_t(std::filesystem::file_size(path, ec));
+            if (ec)
+                return ret;
+            ret.mtime = int64_t(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+            if (ec)
+                return ret;
+        #if !defined(_WIN32) && __has_include(<sys/stat.h>)
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0)
+                ret.inode = uint64_t(st.st_ino);
+        #endif
+            return ret;
+        }
+
+        /**
+         Appends cached arguments for `path` to dest.
+
+         Returns false if there is no valid entry for the path, key and splitter.
+         */
+        template<class Char>
+        auto load(const std::filesystem::path & path, const FileKey & key, std::string_view splitterId,
+                  std::vector<std::basic_string<Char>> & dest) const -> bool {
+
+            auto id = identity<Char>(path, splitterId);
+            auto entryPath = this->entryPathFor(id);
+            std::error_code ec;
+            MappedFile file(entryPath, ec);
+            if (ec)
+                return false;
+
+            Reader reader{file.data(), file.data() + file.size()};
+            if (!reader.matchHeader(sizeof(Char), key, id))
+                return false;
+
+            uint64_t count;
+            if (!reader.read(count) || count > reader.remaining() / sizeof(uint64_t))
+                return false;
+            auto initialSize = dest.size();
+            dest.reserve(initialSize + size_t(count));
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t length;
+                if (!reader.read(length) || length > reader.remaining() / sizeof(Char)) {
+                    dest.resize(initialSize);
+                    return false;
+                }
+                auto & arg = dest.emplace_back(size_t(length), Char());
+                reader.read(arg.data(), size_t(length) * sizeof(Char));
+            }
+            //mark as recently used
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), ec);
+            return true;
+        }
+
+        /**
+         Stores arguments for `path`, evicting old entries if the cache grows too large.
+
+         Scanning the cache directory for eviction is done only occasionally: with a probability 
+         proportional to the size of the stored entry so that, on average, it happens once per 
+         1/16 of the maximum size written. The cache may therefore temporarily exceed its maximum 
+         size by about that much.
+         */
+        template<class Char>
+        auto store(const std::filesystem::path & path, const FileKey & key, std::string_view splitterId,
+                   std::span<const std::basic_string<Char>> args) const -> void {
+
+            std::error_code ec;
+            std::filesystem::create_directories(this->m_directory, ec);
+            if (ec)
+                return;
+
+            auto id = identity<Char>(path, splitterId);
+            std::string buffer;
+            size_t size = headerSize(id) + sizeof(uint64_t);
+            for (auto & arg: args)
+                size += sizeof(uint64_t) + arg.size() * sizeof(Char);
+            buffer.reserve(size);
+            writeHeader(buffer, sizeof(Char), key, id);
+            write(buffer, uint64_t(args.size()));
+            for (auto & arg: args) {
+                write(buffer, uint64_t(arg.size()));
+                buffer.append(reinterpret_cast<const char *>(arg.data()), arg.size() * sizeof(Char));
+            }
+
+            //write to a unique temporary and rename so that concurrent readers never see partial entries
+            auto entryPath = this->entryPathFor(id);
+            auto tempPath = entryPath;
+            tempPath += "." + std::to_string(randomNumber()) + temporaryExtension;
+            FILE * fp = openFile(tempPath);
+            if (!fp)
+                return;
+            bool written = (fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size());
+            written = (fclose(fp) == 0) && written;
+            if (written)
+                std::filesystem::rename(tempPath, entryPath, ec);
+            if (!written || ec) {
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+            auto evictionThreshold = std::max(this->m_maxSize / 16, uintmax_t(1));
+            if (buffer.size() >= evictionThreshold || randomNumber() % evictionThreshold < buffer.size())
+                this->evict();
+        }
+
+        //Removes all cache entries and temporaries left behind by writers that did not finish
+        auto clear() const -> void {
+            std::error_code ec;
+            auto now = std::filesystem::file_time_type::clock::now();
+            for (auto & item: std::filesystem::directory_iterator(this->m_directory, ec)) {
+                auto kind = kindOf(item.path());
+                if (kind == FileKind::entry || (kind == FileKind::temporary && isStale(item, now)))
+                    std::filesystem::remove(item.path(), ec);
+            }
+        }
+
+    private:
+        static constexpr char magic[8] = {'A', 'R', 'G', 'U', 'M', 'R', 'C', '1'};
+        static constexpr char temporaryExtension[] = ".tmp";
+        //temporaries older than this are assumed to be left behind by a writer that crashed or was killed
+        static constexpr auto staleTemporaryAge = std::chrono::minutes(1);
+
+        enum class FileKind {
+            other,
+            entry,
+            temporary
+        };
+
+        struct Reader {
+            const char * current;
+            const char * last;
+
+            auto remaining() const -> size_t {
+                return size_t(last - current);
+            }
+            auto read(void * dest, size_t size) -> bool {
+                if (remaining() < size)
+                    return false;
+                memcpy(dest, current, size);
+                current += size;
+                return true;
+            }
+            template<class T>
+            auto read(T & val) -> bool {
+                return read(&val, sizeof(T));
+            }
+            auto matchHeader(uint32_t charSize, const FileKey & key, std::string_view id) -> bool {
+                char storedMagic[sizeof(magic)];
+                uint32_t storedCharSize;
+                FileKey storedKey;
+                uint64_t idSize;
+                if (!read(storedMagic) || memcmp(storedMagic, magic, sizeof(magic)) != 0 ||
+                    !read(storedCharSize) || storedCharSize != charSize ||
+                    !read(storedKey.size) || !read(storedKey.mtime) || !read(storedKey.inode) || storedKey != key ||
+                    !read(idSize) || idSize != id.size() || remaining() < id.size() ||
+                    memcmp(current, id.data(), id.size()) != 0)
+                    return false;
+                current += id.size();
+                return true;
+            }
+        };
+
+        template<class T>
+        static auto write(std::string & dest, const T & val) -> void {
+            dest.append(reinterpret_cast<const char *>(&val), sizeof(T));
+        }
+
+        static auto headerSize(std::string_view id) -> size_t {
+            return sizeof(magic) + sizeof(uint32_t) + 3 * sizeof(uint64_t) + sizeof(uint64_t) + id.size();
+        }
+
+        static auto writeHeader(std::string & dest, uint32_t charSize, const FileKey & key, std::string_view id) -> void {
+            dest.append(magic, sizeof(magic));
+            write(dest, charSize);
+            write(dest, key.size);
+            write(dest, key.mtime);
+            write(dest, key.inode);
+            write(dest, uint64_t(id.size()));
+            dest.append(id);
+        }
+
+        //full identity of an entry: the source path, splitter and, for wide characters, the locale used to decode them
+        template<class Char>
+        static auto identity(const std::filesystem::path & path, std::string_view splitterId) -> std::string {
+            auto & native = path.native();
+            std::string ret(reinterpret_cast<const char *>(native.data()), native.size() * sizeof(native[0]));
+            ret += '\0';
+            ret += splitterId;
+            if constexpr (!std::is_same_v<Char, char>) {
+                ret += '\0';
+                if (auto locale = setlocale(LC_CTYPE, nullptr))
+                    ret += locale;
+            }
+            return ret;
+        }
+
+        auto entryPathFor(std::string_view id) const -> std::filesystem::path {
+            //FNV-1a
+            uint64_t hash = 14695981039346656037ull;
+            for (auto c: id) {
+                hash ^= uint64_t(static_cast<unsigned char>(c));
+                hash *= 1099511628211ull;
+            }
+            char name[17];
+            snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+            auto ret = this->m_directory / name;
+            ret += extension;
+            return ret;
+        }
+
+        //Entries are named <hash><extension> and temporaries <hash><extension>.<random><temporaryExtension>
+        static auto kindOf(const std::filesystem::path & path) -> FileKind {
+            if (path.extension() == extension)
+                return FileKind::entry;
+            if (path.extension() == temporaryExtension && path.stem().stem().extension() == extension)
+                return FileKind::temporary;
+            return FileKind::other;
+        }
+
+        static auto isStale(const std::filesystem::directory_entry & item, std::filesystem::file_time_type now) -> bool {
+            std::error_code ec;
+            auto time = item.last_write_time(ec);
+            return !ec && now - time > staleTemporaryAge;
+        }
+
+        static auto openFile(const std::filesystem::path & path) -> FILE * {
+        #ifndef _MSC_VER
+            return fopen(path.string().c_str(), "wb");
+        #else
+            return _wfopen(path.native().c_str(), L"wb");
+        #endif
+        }
+
+        //process-wide generator for temporary names and eviction sampling, seeded once
+        static auto randomNumber() -> uint64_t {
+            static std::mutex mutex;
+            static std::mt19937_64 generator{std::random_device()()};
+            std::lock_guard lock(mutex);
+            return generator();
+        }
+
+        auto evict() const -> void {
+            struct Entry {
+                std::filesystem::path path;
+                std::filesystem::file_time_type time;
+                uintmax_t size;
+            };
+            std::vector<Entry> entries;
+            uintmax_t total = 0;
+            std::error_code ec;
+            auto now = std::filesystem::file_time_type::clock::now();
+            for (auto & item: std::filesystem::directory_iterator(this->m_directory, ec)) {
+                auto kind = kindOf(item.path());
+                if (kind == FileKind::other)
+                    continue;
+                if (kind == FileKind::temporary && isStale(item, now)) {
+                    std::filesystem::remove(item.path(), ec);
+                    continue;
+                }
+                Entry entry{item.path(), item.last_write_time(ec), item.file_size(ec)};
+                if (ec)
+                    continue;
+                total += entry.size;
+                //temporaries still being written count towards the size but cannot be removed
+                if (kind == FileKind::entry)
+                    entries.emplace_back(std::move(entry));
+            }
+            if (total <= this->m_maxSize)
+                return;
+            std::sort(entries.begin(), entries.end(), [](const Entry & lhs, const Entry & rhs) {
+                return lhs.time < rhs.time;
+            });
+            for (auto & entry: entries) {
+                if (total <= this->m_maxSize)
+                    break;
+                if (std::filesystem::remove(entry.path, ec))
+                    total -= entry.size;
+            }
+        }
+    private:
+        std::filesystem::path m_directory;
+        uintmax_t m_maxSize;
+    };
+}
+
+#endif
@@ -0,0 +1,304 @@
+//
+// Copyright 2022 Eugene Gershnik
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://github.com/gershnik/argum/blob/master/LICENSE
+//
+#ifndef HEADER_ARGUM_RESPONSE_FILE_WRITER_H_INCLUDED
+#define HEADER_ARGUM_RESPONSE_FILE_WRITER_H_INCLUDED
+
+#include "command-line.h"
+
+#include <filesystem>
+#include <system_error>
+#include <string>
+#include <string_view>
+
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <limits.h>
+
+#if !defined(_WIN32) && __has_include(<unistd.h>)
+    #define ARGUM_HAS_UNISTD_H
+    #include <unistd.h>
+#endif
+
+namespace Argum {
+
+    /**
+     Writes response files that BasicResponseFileReader with its default splitter reads back
+     into the same arguments.
+
+     The default splitter has no quoting: each line is one argument with surrounding whitespace
+     trimmed and empty lines skipped. Arguments that cannot survive this - empty ones, ones
+     containing a newline or starting or ending with whitespace - are only representable in the
+     binary format (see BinaryResponseFile). With `Format::automatic` the text format is used
+     when possible and the binary one otherwise.
+
+     Note that the reader expands arguments starting with its prefix in either format.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicResponseFileWriter {
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+
+        enum class Format {
+            automatic,
+            lines,
+            binary
+        };
+
+        struct Exception : public BasicParsingException<CharType> {
+            ARGUM_IMPLEMENT_EXCEPTION(Exception, BasicParsingException<CharType>, Error::ResponseFileWriteError)
+
+            Exception(const std::filesystem::path & filename_, std::error_code error_):
+                BasicParsingException<CharType>(ErrorCode),
+                filename(filename_),
+                error(error_) {
+            }
+            std::filesystem::path filename;
+            std::error_code error;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages<CharType>::errorWritingResponseFile>(this->filename.native(), this->error.message());
+            }
+        };
+
+    public:
+        BasicResponseFileWriter(Format format = Format::automatic): m_format(format) {
+        }
+
+        auto outputFormat() const -> Format {
+            return this->m_format;
+        }
+
+        //Whether the argument is read back unchanged from a line of a text response file
+        static auto representableAsLine(StringViewType arg) -> bool {
+            return !arg.empty() &&
+                   !CharConstants<CharType>::isSpace(arg.front()) &&
+                   !CharConstants<CharType>::isSpace(arg.back()) &&
+                   arg.find(CharConstants<CharType>::endl) == StringViewType::npos;
+        }
+
+        //The format that will be used for the given arguments. In automatic format `wchar_t` arguments 
+        //that the current locale cannot encode are written in binary even if this returns lines.
+        template<ArgRange<CharType> Args>
+        auto formatFor(const Args & args) const -> Format {
+            if (this->m_format != Format::automatic)
+                return this->m_format;
+            for (StringViewType arg: args) {
+                if (!representableAsLine(arg))
+                    return Format::binary;
+            }
+            return Format::lines;
+        }
+
+        /**
+         Writes the arguments to a file with a single write call.
+         */
+        template<ArgRange<CharType> Args>
+        auto write(const std::filesystem::path & path, const Args & args) const -> ARGUM_EXPECTED(CharType, void) {
+            std::string buffer;
+            std::error_code error = this->serialize(args, buffer);
+            if (!error) {
+                SimpleFile file(path, "wb", error);
+                if (file)
+                    file.write(buffer.data(), buffer.size(), error);
+            }
+            if (error)
+                ARGUM_THROW(Exception, path, error);
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        /**
+         Appends the file image for the arguments to dest.
+
+         The image size is computed upfront so that dest is allocated once. For `wchar_t`
+         in text format the arguments are encoded according to the current locale and the
+         size is only an estimate. In automatic format arguments that the locale cannot
+         encode are written in binary format instead.
+         */
+        template<ArgRange<CharType> Args>
+        auto serialize(const Args & args, std::string & dest) const -> std::error_code {
+            auto format = this->formatFor(args);
+            if (format == Format::lines) {
+                auto originalSize = dest.size();
+                auto error = serializeLines(args, dest);
+                if (!error || this->m_format != Format::automatic)
+                    return error;
+                dest.resize(originalSize);
+            }
+            serializeBinary(args, dest);
+            return {};
+        }
+
+        /**
+         Maximum size of a command line that can be passed to a new process.
+
+         On Windows this is the `CreateProcess` limit in characters. Elsewhere it is `ARG_MAX` in
+         bytes less 2048 bytes of headroom as recommended by POSIX for `xargs`. The environment
+         passed to the process counts against the same limit on most systems and is not
+         accounted for.
+         */
+        static auto commandLineLimit() -> size_t {
+        #if defined(_WIN32)
+            return 32767;
+        #else
+            long argMax = -1;
+            #ifdef ARGUM_HAS_UNISTD_H
+                argMax = sysconf(_SC_ARG_MAX);
+            #endif
+            if (argMax <= 0)
+                argMax = 4096; //_POSIX_ARG_MAX
+            return size_t(argMax) > 2 * headroom ? size_t(argMax) - headroom : size_t(argMax) / 2;
+        #endif
+        }
+
+        /**
+         Projected size of the command line made of the arguments in the units of commandLineLimit().
+
+         On Windows this includes the separators and the quoting a process launcher needs to add.
+         Elsewhere it includes the terminating null and pointer of each argument in the
+         argument array. For `wchar_t` each non-ASCII character is assumed to take `MB_CUR_MAX`
+         bytes.
+         */
+        template<ArgRange<CharType> Args>
+        static auto commandLineSize(const Args & args) -> size_t {
+            size_t ret = 0;
+            for (StringViewType arg: args)
+                ret += argumentSize(arg);
+            return ret;
+        }
+
+        /**
+         Whether the arguments should be passed via a response file rather than directly.
+
+         Besides the total size, on Linux each single argument must not exceed `MAX_ARG_STRLEN`.
+         */
+        template<ArgRange<CharType> Args>
+        static auto needsResponseFile(const Args & args, size_t limit = commandLineLimit()) -> bool {
+            size_t total = 0;
+            for (StringViewType arg: args) {
+                size_t size = argumentSize(arg);
+            #ifdef __linux__
+                if (size > maxArgumentSize)
+                    return true;
+            #endif
+                total += size;
+                if (total > limit)
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        static constexpr size_t headroom = 2048;
+    #ifdef __linux__
+        //MAX_ARG_STRLEN is 32 pages
+        static constexpr size_t maxArgumentSize = 32 * 4096;
+    #endif
+
+        static auto argumentSize(StringViewType arg) -> size_t {
+        #ifdef _WIN32
+            //separator and the quoting rules of CommandLineToArgvW
+            size_t ret = arg.size() + 1;
+            if (!arg.empty() && arg.find_first_of(CharConstants<CharType>::windowsQuotedChars) == StringViewType::npos)
+                return ret;
+            ret += 2;
+            size_t backslashes = 0;
+            for (auto c: arg) {
+                if (c == CharConstants<CharType>::backslash) {
+                    ++backslashes;
+                    continue;
+                }
+                if (c == CharConstants<CharType>::doubleQuote)
+                    ret += backslashes + 1;
+                backslashes = 0;
+            }
+            return ret + backslashes;
+        #else
+            size_t ret = arg.size() + 1 + sizeof(char *);
+            if constexpr (!std::is_same_v<CharType, char>) {
+                for (auto c: arg) {
+                    if (uint32_t(c) >= 0x80)
+                        ret += MB_CUR_MAX - 1;
+                }
+            }
+            return ret;
+        #endif
+        }
+
+        template<ArgRange<CharType> Args>
+        static auto serializeLines(const Args & args, std::string & dest) -> std::error_code {
+            size_t size = 0;
+            for (StringViewType arg: args)
+                size += arg.size() + 1;
+            dest.reserve(dest.size() + size);
+            for (StringViewType arg: args) {
+                if constexpr (std::is_same_v<CharType, char>) {
+                    dest.append(arg);
+                } else {
+                    mbstate_t state = mbstate_t();
+                    for (auto c: arg) {
+                        //ASCII in initial shift state is the same in all supported encodings
+                        if (uint32_t(c) < 0x80 && mbsinit(&state)) {
+                            dest += char(c);
+                            continue;
+                        }
+                        char encoded[MB_LEN_MAX];
+                        size_t res = wcrtomb(encoded, c, &state);
+                        if (res == size_t(-1))
+                            return std::make_error_code(std::errc::illegal_byte_sequence);
+                        dest.append(encoded, res);
+                    }
+                    char encoded[MB_LEN_MAX];
+                    size_t res = wcrtomb(encoded, L'\0', &state);
+                    if (res == size_t(-1))
+                        return std::make_error_code(std::errc::illegal_byte_sequence);
+                    //the returned size includes the terminating null which is not needed
+                    dest.append(encoded, res - 1);
+                }
+                dest += '\n';
+            }
+            return {};
+        }
+
+        template<ArgRange<CharType> Args>
+        static auto serializeBinary(const Args & args, std::string & dest) -> void {
+            uint64_t count = 0;
+            size_t size = BinaryResponseFile::headerSize;
+            for (StringViewType arg: args) {
+                size += sizeof(uint64_t) + BinaryResponseFile::paddedSize(arg.size() * sizeof(CharType));
+                ++count;
+            }
+            dest.reserve(dest.size() + size);
+            dest.append(BinaryResponseFile::magic, sizeof(BinaryResponseFile::magic));
+            append(dest, uint32_t(sizeof(CharType)));
+            append(dest, uint32_t(0));
+            append(dest, count);
+            for (StringViewType arg: args) {
+                size_t byteSize = arg.size() * sizeof(CharType);
+                append(dest, uint64_t(arg.size()));
+                dest.append(reinterpret_cast<const char *>(arg.data()), byteSize);
+                dest.append(BinaryResponseFile::paddedSize(byteSize) - byteSize, '\0');
+            }
+        }
+
+        template<class T>
+        static auto append(std::string & dest, const T & val) -> void {
+            dest.append(reinterpret_cast<const char *>(&val), sizeof(T));
+        }
+
+    private:
+        Format m_format;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ResponseFileWriter)
+}
+
+#endif
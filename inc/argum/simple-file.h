@@ -12,8 +12,14 @@
 
 #include <filesystem>
 #include <system_error>
+#include <memory>
+#include <string_view>
+#include <algorithm>
 
 #include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include <errno.h>
 
 namespace Argum {
 
@@ -30,15 +36,27 @@ namespace Argum {
                 ec = std::make_error_code(static_cast<std::errc>(err));
             }
         }
-        SimpleFile(SimpleFile && src) {
-            m_fp = src.m_fp;
+        SimpleFile(SimpleFile && src):
+            m_fp(src.m_fp),
+            m_buffer(std::move(src.m_buffer)),
+            m_bufferPos(src.m_bufferPos),
+            m_bufferEnd(src.m_bufferEnd),
+            m_eof(src.m_eof),
+            m_state(src.m_state) {
             src.m_fp = nullptr;
         }
         auto operator=(SimpleFile && src) -> SimpleFile & {
-            if (m_fp)
-                fclose(m_fp);
-            m_fp = nullptr;
-            m_fp = src.m_fp;
+            if (this != &src) {
+                if (m_fp)
+                    fclose(m_fp);
+                m_fp = src.m_fp;
+                src.m_fp = nullptr;
+                m_buffer = std::move(src.m_buffer);
+                m_bufferPos = src.m_bufferPos;
+                m_bufferEnd = src.m_bufferEnd;
+                m_eof = src.m_eof;
+                m_state = src.m_state;
+            }
             return *this;
         }
         ~SimpleFile() {
@@ -51,49 +69,139 @@ namespace Argum {
         operator bool() const {
             return m_fp != nullptr;
         }
+        //true once readLine() reached the end of file
         auto eof() const -> bool {
-            return feof(m_fp) != 0;
+            return m_eof;
+        }
+
+        //Returns up to size bytes at the current position without consuming them
+        auto peek(size_t size, std::error_code & ec) -> std::string_view {
+            if (m_bufferPos == m_bufferEnd && !fillBuffer(ec))
+                return {};
+            return std::string_view(m_buffer.get() + m_bufferPos, std::min(size, m_bufferEnd - m_bufferPos));
         }
 
+        /**
+         Writes the whole buffer with a single unbuffered write and flushes it.
+
+         Must be the first operation on the file.
+         */
+        auto write(const char * data, size_t size, std::error_code & ec) -> bool {
+            setvbuf(m_fp, nullptr, _IONBF, 0);
+            errno = 0;
+            if (fwrite(data, 1, size, m_fp) == size && fflush(m_fp) == 0)
+                return true;
+            ec = lastError();
+            return false;
+        }
+
+        /**
+         Reads the next line without the line terminator.
+
+         The file is read in large blocks. For `char` lines are located with memchr and
+         appended as whole slices. For `wchar_t` the blocks are decoded with mbrtowc 
+         according to the current locale, the same way fgetwc would.
+         */
         template<Character Char>
         std::basic_string<Char> readLine(std::error_code & ec) {
+            static_assert(std::is_same_v<Char, char> || std::is_same_v<Char, wchar_t>, 
+                          "only char and wchar_t are supported");
             std::basic_string<Char> buf;
             for ( ; ; ) {
-                Char c;
+                if (m_bufferPos == m_bufferEnd && !fillBuffer(ec))
+                    break;
+                
+                const char * const first = m_buffer.get() + m_bufferPos;
+                const char * const last = m_buffer.get() + m_bufferEnd;
                 if constexpr (std::is_same_v<Char, char>) {
-                    int res = fgetc(m_fp);
-                    if (res == EOF) {
-                        checkError(ec);
+                    auto found = static_cast<const char *>(memchr(first, CharConstants<char>::endl, size_t(last - first)));
+                    if (found) {
+                        buf.append(first, found);
+                        m_bufferPos += size_t(found - first) + 1;
                         break;
                     }
-                    c = Char(res);
-                } else if constexpr (std::is_same_v<Char, wchar_t>) {
-                    wint_t res = fgetwc(m_fp);
-                    if (res == WEOF) {
-                        checkError(ec);
+                    buf.append(first, last);
+                    m_bufferPos = m_bufferEnd;
+                } else {
+                    if (decodeLine(buf, ec))
                         break;
-                    }
-                    c = Char(res);
                 }
-                
-                if (c == CharConstants<Char>::endl)
-                    break;
-                buf += c;
             }
             return buf;
         }
     private:
+        static constexpr size_t bufferSize = 64 * 1024;
+
+        //Reads the next block. Returns false on end of file or error
+        auto fillBuffer(std::error_code & ec) -> bool {
+            if (!m_buffer)
+                m_buffer.reset(new char[bufferSize]);
+            m_bufferPos = 0;
+            errno = 0;
+            m_bufferEnd = fread(m_buffer.get(), 1, bufferSize, m_fp);
+            if (m_bufferEnd == 0) {
+                if (!checkError(ec))
+                    m_eof = true;
+                return false;
+            }
+            return true;
+        }
+
+        //Decodes buffered bytes appending them to dest. Returns true if end of line 
+        //was found or an error occurred
+        auto decodeLine(std::wstring & dest, std::error_code & ec) -> bool {
+            const char * const data = m_buffer.get();
+            while (m_bufferPos != m_bufferEnd) {
+                auto byte = static_cast<unsigned char>(data[m_bufferPos]);
+                wchar_t c;
+                //ASCII in initial shift state is the same in all supported encodings
+                if (byte < 0x80 && mbsinit(&m_state)) {
+                    c = wchar_t(byte);
+                    ++m_bufferPos;
+                } else {
+                    size_t res = mbrtowc(&c, data + m_bufferPos, m_bufferEnd - m_bufferPos, &m_state);
+                    if (res == size_t(-2)) {
+                        //incomplete character: the bytes are stored in m_state, continue with the next block
+                        m_bufferPos = m_bufferEnd;
+                        return false;
+                    }
+                    if (res == size_t(-1)) {
+                        ec = std::make_error_code(std::errc::illegal_byte_sequence);
+                        m_bufferPos = m_bufferEnd;
+                        return true;
+                    }
+                    m_bufferPos += (res == 0 ? 1 : res);
+                }
+                if (c == CharConstants<wchar_t>::endl)
+                    return true;
+                dest += c;
+            }
+            return false;
+        }
+
         auto checkError(std::error_code & ec) const -> bool{
             if (ferror(m_fp)) {
-                int err = errno;
-                 ec = std::make_error_code(static_cast<std::errc>(err));
+                 ec = lastError();
                  return true;
             }
             return false;
         }
+
+        //stdio functions are not required to set errno on failure
+        static auto lastError() -> std::error_code {
+            int err = errno;
+            if (err == 0)
+                return std::make_error_code(std::errc::io_error);
+            return std::make_error_code(static_cast<std::errc>(err));
+        }
     private:
         FILE * m_fp;
+        std::unique_ptr<char[]> m_buffer;
+        size_t m_bufferPos = 0;
+        size_t m_bufferEnd = 0;
+        bool m_eof = false;
+        mbstate_t m_state = mbstate_t();
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -10,6 +10,7 @@
 
 #include "expected.h"
 #include "flat-map.h"
+#include "parse-stats.h"
 
 #include <vector>
 #include <optional>
@@ -272,7 +273,7 @@ namespace Argum {
         }
 
         template<ArgIterator<CharType> It, class Func>
-        auto tokenize(It argFirst, It argLast, Func && handler) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>)  {
+        auto tokenize(It argFirst, It argLast, Func && handler, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>)  {
 
             static_assert(IsHandler<Func, CharType, TokenResult, OptionToken>, "handler must handle OptionToken and return correct return type");
             static_assert(IsHandler<Func, CharType, TokenResult, ArgumentToken>, "handler must handle ArgumentToken and return correct return type");
@@ -294,6 +295,7 @@ namespace Argum {
                 std::optional<TokenResult> result;
                 if (!noMoreOptions) {
 
+                    Impl::countIn(stats, &ParseStats::prefixLookups);
                     if (auto prefixFindResult = this->findLongestPrefix(arg)) {
                     
                         auto type = prefixFindResult->type;
@@ -311,13 +313,13 @@ namespace Argum {
                             if ((type & LongPrefix) == LongPrefix) {
                                 ARGUM_CHECK_RESULT(result, this->handleLongPrefix(argIdx, arg,
                                                                          prefixFindResult->index, prefixFindResult->size,
-                                                                         std::forward<Func>(handler)));
+                                                                         std::forward<Func>(handler), stats));
                                 if (result == TokenResult::StopAfter)
                                     consumed = unsigned(arg.size());
                             } else if ((type & ShortPrefix) == ShortPrefix) {
                                 ARGUM_CHECK_RESULT(result, this->handleShortPrefix(argIdx, arg,
                                                                           prefixFindResult->index, prefixFindResult->size,
-                                                                          consumed, handler));
+                                                                          consumed, handler, stats));
                                 unconsumedPrefixSize = prefixFindResult->size;
                             }
                         }
@@ -383,7 +385,8 @@ namespace Argum {
                               StringViewType option, 
                               PrefixId prefixId,
                               unsigned nameStart,
-                              Func && handler) const -> ARGUM_EXPECTED(CharType, TokenResult) {
+                              Func && handler,
+                              ParseStats * stats) const -> ARGUM_EXPECTED(CharType, TokenResult) {
             
             auto [name, arg] = this->splitDelimitedArgument(option, nameStart);
             if (name.size() == 0)
@@ -403,9 +406,12 @@ namespace Argum {
             }
             auto & longsMap = mapIt->value();
 
+            Impl::countIn(stats, &ParseStats::optionLookups);
             if (this->m_allowAbrreviation) {
                 const auto & [first, last] = findMatchOrMatchingPrefixRange(longsMap, name);
                 if (last - first == 1) {
+                    if (first->key() != name)
+                        Impl::countIn(stats, &ParseStats::abbreviationResolutions);
                     return this->callHandler(std::forward<Func>(handler), OptionToken{argIdx, first->value(), std::move(usedName), std::move(arg)});
                 } else if (last != first) {
                     StringType actualPrefix(option.substr(0, nameStart));
@@ -431,9 +437,10 @@ namespace Argum {
                                PrefixId prefixId,
                                unsigned nameStart,
                                unsigned & consumed,
-                               Func && handler) const -> ARGUM_EXPECTED(CharType, TokenResult) {
+                               Func && handler,
+                               ParseStats * stats) const -> ARGUM_EXPECTED(CharType, TokenResult) {
 
-            if (auto maybeResult = this->handleShortOption(argIdx, option, prefixId, nameStart, consumed, handler)) {
+            if (auto maybeResult = this->handleShortOption(argIdx, option, prefixId, nameStart, consumed, handler, stats)) {
                 return std::move(*maybeResult);
             } 
 
@@ -455,7 +462,8 @@ namespace Argum {
                                PrefixId prefixId,
                                unsigned nameStart, 
                                unsigned & consumed,
-                               Func && handler) const -> std::optional<ARGUM_EXPECTED(CharType, TokenResult)> {
+                               Func && handler,
+                               ParseStats * stats) const -> std::optional<ARGUM_EXPECTED(CharType, TokenResult)> {
 
             StringViewType chars = option.substr(nameStart);
             assert(!chars.empty());
@@ -464,6 +472,7 @@ namespace Argum {
             
             auto mapIt = this->m_singleShorts.find(prefixId);
             if (mapIt != this->m_singleShorts.end()) {
+                Impl::countIn(stats, &ParseStats::optionLookups);
                 auto it = mapIt->value().find(chars[0]);
                 if (it != mapIt->value().end())
                     singleLetterNameIdx = it->value();
@@ -473,7 +482,7 @@ namespace Argum {
 
                 ARGUM_CHECK_RESULT(auto maybeResult, 
                     this->handleMultiShortOption(argIdx, option, prefixId, nameStart, 
-                                                 singleLetterNameIdx.has_value(), std::forward<Func>(handler)));
+                                                 singleLetterNameIdx.has_value(), std::forward<Func>(handler), stats));
                 if (maybeResult) {
                     if (*maybeResult == TokenResult::StopAfter)
                         consumed = unsigned(option.size());
@@ -496,6 +505,7 @@ namespace Argum {
                 unsigned charsConsumed = 1;
                 if (chars.size() > 1) {
 
+                    Impl::countIn(stats, &ParseStats::optionLookups);
                     auto it = shortsMap.find(chars[1]);
                     if (it == shortsMap.end()) {
                         arg = chars.substr(1);
@@ -529,7 +539,8 @@ namespace Argum {
                                     PrefixId prefixId,
                                     unsigned nameStart,
                                     bool mustMatchExact,
-                                    Func && handler) const -> ARGUM_EXPECTED(CharType, std::optional<TokenResult>) {
+                                    Func && handler,
+                                    ParseStats * stats) const -> ARGUM_EXPECTED(CharType, std::optional<TokenResult>) {
 
             auto [name, arg] = this->splitDelimitedArgument(option, nameStart);
             if (name.size() == 0)
@@ -541,12 +552,15 @@ namespace Argum {
             }
             auto & multiShortsMap = mapIt->value();
 
+            Impl::countIn(stats, &ParseStats::optionLookups);
             if (this->m_allowAbrreviation) {
                 const auto & [first, last] = findMatchOrMatchingPrefixRange(multiShortsMap, name);
                 if (last != first) {
                     StringType usedName(option.data(), name.data() + name.size());
                     if (last - first == 1) {
                         if (!mustMatchExact || first->key() == name) {
+                            if (first->key() != name)
+                                Impl::countIn(stats, &ParseStats::abbreviationResolutions);
                             return this->callHandler(std::forward<Func>(handler), OptionToken{argIdx, first->value(), std::move(usedName), std::move(arg)});
                         } else {
                             std::vector<StringType> candidates = {
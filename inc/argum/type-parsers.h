@@ -29,7 +29,7 @@ namespace Argum {
         std::basic_string<Char> value(std::forward<S>(str));
 
         if (value.empty())
-            ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+            ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
 
         T ret;
         Char * endPtr;
@@ -41,14 +41,14 @@ namespace Argum {
                 auto res = CharConstants::toLong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res < (decltype(res))std::numeric_limits<T>::min() || res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             } else  {
                 auto res = CharConstants::toLongLong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res < (decltype(res))std::numeric_limits<T>::min() || res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             }
@@ -59,23 +59,23 @@ namespace Argum {
                 auto res = CharConstants::toULong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             } else  {
                 auto res = CharConstants::toULongLong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             }
         }
         if (errno == ERANGE)
-            ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+            ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
         for ( ; endPtr != value.data() + value.size(); ++endPtr) {
             if (!CharConstants::isSpace(*endPtr))
-                ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+                ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
         }
         
         return ret;
@@ -94,7 +94,7 @@ namespace Argum {
         std::basic_string<Char> value(std::forward<S>(str));
 
         if (value.empty())
-            ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+            ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
 
         T ret;
         Char * endPtr;
@@ -109,10 +109,10 @@ namespace Argum {
         }
 
         if (errno == ERANGE)
-            ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+            ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
         for ( ; endPtr != value.data() + value.size(); ++endPtr) {
             if (!CharConstants::isSpace(*endPtr))
-                ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+                ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
         }
         
         return ret;
@@ -171,7 +171,7 @@ namespace Argum {
             });
             if (it == this->m_choices.end()) {
                 if (!m_allowElse)
-                    ARGUM_THROW(ValidationError, format(Messages::notAValidChoice(), value, this->m_description));
+                    ARGUM_THROW(ValidationError, format<Messages::notAValidChoice>(value, this->m_description));
                 return this->m_choices.size();
             }
             return it - this->m_choices.begin();
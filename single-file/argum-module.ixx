@@ -10,11 +10,18 @@ module;
 
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
+#if !defined(_WIN32) && __has_include(<fcntl.h>)
+    #include <fcntl.h>
+#endif
 #ifdef _WIN32
     #include <io.h>
 #endif
 #include <limits.h>
+#include <locale.h>
 #include <math.h>
+#include <signal.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,6 +29,12 @@ module;
 #if !defined(_WIN32) && __has_include(<sys/ioctl.h>)
     #include <sys/ioctl.h>
 #endif
+#if !defined(_WIN32) && __has_include(<sys/mman.h>)
+    #include <sys/mman.h>
+#endif
+#if !defined(_WIN32) && __has_include(<sys/stat.h>)
+    #include <sys/stat.h>
+#endif
 #if !defined(_WIN32) && __has_include(<termios.h>)
     #include <termios.h>
 #endif
@@ -154,7 +167,7 @@ namespace Argum {
         std::is_same_v<decltype(t != t), bool>;
         std::is_same_v<decltype(t == t), bool>;
         std::is_convertible_v<decltype(t[0]), std::basic_string_view<Char>>;
-    };
+    } || (std::forward_iterator<T> && std::is_convertible_v<std::iter_reference_t<T>, std::basic_string_view<Char>>);
 
     template<class T, class Char>
     concept ArgRange = requires(T & t) {
@@ -162,7 +175,7 @@ namespace Argum {
         requires ArgIterator<decltype(std::begin(t)), Char>;
         std::end(t);
         requires std::is_same_v<decltype(std::begin(t) != std::end(t)), bool>;
-        requires std::is_convertible_v<decltype(t[0]), std::basic_string_view<Char>>;
+        requires std::is_convertible_v<decltype(*std::begin(t)), std::basic_string_view<Char>>;
     };
 
 
@@ -288,6 +301,15 @@ namespace Argum {
         static constexpr auto squareBracketClose            = prefix ## ']'; \
         static constexpr auto pipe                          = prefix ## '|'; \
         static constexpr auto endl                          = prefix ## '\n'; \
+        static constexpr auto tab                           = prefix ## '\t'; \
+        static constexpr auto carriageReturn                = prefix ## '\r'; \
+        static constexpr auto backslash                     = prefix ## '\\'; \
+        static constexpr auto doubleQuote                   = prefix ## '"'; \
+        static constexpr auto singleQuote                   = prefix ## '\''; \
+        static constexpr auto hash                          = prefix ## '#'; \
+        static constexpr auto dollar                        = prefix ## '$'; \
+        static constexpr auto backtick                      = prefix ## '`'; \
+        static constexpr auto windowsQuotedChars            = prefix ## " \t\n\v\""; \
         static constexpr auto ellipsis                      = prefix ## "..."; \
         static constexpr auto esc                           = prefix ## '\x1B'; \
         static constexpr auto semicolon                     = prefix ## ';'; \
@@ -313,7 +335,7 @@ namespace Argum {
 
     #undef ARGUM_DEFINE_CHAR_CONSTANTS
     
-    inline auto CharConstants<char>::isSpace(char c) -> bool { return isspace(c); }
+    inline auto CharConstants<char>::isSpace(char c) -> bool { return isspace(static_cast<unsigned char>(c)); }
     inline auto CharConstants<wchar_t>::isSpace(wchar_t c) -> bool { return iswspace(c); }
 
     inline auto CharConstants<char>::toLong(const char * str, char ** str_end, int base) -> long {
@@ -378,6 +400,19 @@ namespace Argum {
         return str;
     }
 
+    template<class Char>
+    auto trim(std::basic_string_view<Char> str) -> std::basic_string_view<Char> {
+        auto firstNotSpace = std::find_if(str.begin(), str.end(), [](const auto c) {
+            return !CharConstants<Char>::isSpace(c);
+        });
+        str.remove_prefix(size_t(firstNotSpace - str.begin()));
+        auto lastNotSpace = std::find_if(str.rbegin(), str.rend(), [](const auto c) {
+            return !CharConstants<Char>::isSpace(c);
+        }).base();
+        str.remove_suffix(size_t(str.end() - lastNotSpace));
+        return str;
+    }
+
 }
 
 #endif
@@ -401,6 +436,9 @@ namespace Argum {
         static constexpr auto extraPositionalError()        { return pr ## "unexpected argument: {1}"; }\
         static constexpr auto validationError()             { return pr ## "invalid arguments: {1}"; }\
         static constexpr auto errorReadingResponseFile()    { return pr ## "error reading response file \"{1}\": {2}"; }\
+        static constexpr auto errorWritingResponseFile()    { return pr ## "error writing response file \"{1}\": {2}"; }\
+        static constexpr auto responseFileCycle()           { return pr ## "response file \"{1}\" references itself"; }\
+        static constexpr auto messageUnavailable()          { return pr ## "error message unavailable"; }\
         static constexpr auto option()                      { return pr ## "option"; }\
         static constexpr auto positionalArg()               { return pr ## "positional argument"; }\
         static constexpr auto usageStart()                  { return pr ## "Usage: "; }\
@@ -543,32 +581,718 @@ namespace Argum {
 * Latest version: http://www.cl.cam.ac.uk/~mgk25/ucs/wcwidth.c
 */
 
+#ifndef HEADER_ARGUM_WCWIDTH_TABLES_H_INCLUDED
+#define HEADER_ARGUM_WCWIDTH_TABLES_H_INCLUDED
+
 
 namespace Argum::Wcwidth {
 
-struct interval {
-    int first;
-    int last;
+constexpr unsigned widthPageBits = 8;
+
+struct WidthPage {
+    uint32_t zero[8];
+    uint32_t wide[8];
 };
 
-/* auxiliary function for binary search in interval table */
-inline int bisearch(char32_t ucs, const struct interval *table, int max) {
-    int min = 0;
-    int mid;
+/* index of WidthPage for each 256 code points page */
+inline constexpr uint8_t widthPageIndex[4352] = {
+      0,   0,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,
+     14,  15,   0,  16,   0,   0,   0,  17,  18,  19,  20,  21,  22,  23,   0,   0,
+     24,   0,   0,  25,   0,  26,  27,  28,   0,   0,   0,  29,  30,  31,  32,  33,
+     34,  35,  36,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  38,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  39,   0,  40,   0,  41,  42,  43,  44,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  45,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,  37,  37,  46,   0,   0,  47,  48,
+      0,  49,  50,  51,   0,   0,   0,   0,   0,   0,  52,   0,   0,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,   0,  67,  68,  69,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,  70,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  71,  72,   0,   0,   0,  73,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  74,  37,  37,  37,  37,  75,  76,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  77,
+     37,  78,  79,   0,   0,   0,   0,   0,   0,   0,   0,   0,  80,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  81,
+      0,  82,  83,   0,   0,   0,   0,   0,   0,   0,  84,   0,   0,   0,   0,   0,
+     85,  72,  86,   0,   0,   0,   0,   0,  87,  88,   0,   0,   0,   0,   0,   0,
+     89,  90,  91,  92,  93,  94,  95,  96,   0,  97,  98,   0,   0,   0,   0,   0,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  99,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,
+     37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  37,  99,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    100, 101,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
 
-    if (int(ucs) < table[0].first || int(ucs) > table[max].last)
-        return 0;
-    while (max >= min) {
-        mid = (min + max) / 2;
-        if (int(ucs) > table[mid].last)
-            min = mid + 1;
-        else if (int(ucs) < table[mid].first)
-            max = mid - 1;
-        else
-            return 1;
-    }
+/* bitmaps of zero-width and wide code points for each distinct page */
+inline constexpr WidthPage widthPages[102] = {
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0000FFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000003F8, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFE0000, 0xBFFFFFFF, 0x000000B6, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x17FF003F, 0x00000000, 0xFFFFF800, 0x00010000, 0x00000000, 0x00000000, 0xBFC00000, 0x00003D9F},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00028000, 0xFFFF0000, 0x000007FF, 0x00000000, 0x00000000, 0x0001FFC0, 0x00000000, 0x200FF800},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xFBC00000, 0x00003EEF, 0x0E000000, 0x00000000, 0xFF030000, 0x00000000, 0xFFFFFC00, 0xFFFFFFFF},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000007, 0x14000000, 0x00FE21FE, 0x0000000C, 0x00000002, 0x10000000, 0x0000201E, 0x4000000C},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000006, 0x10000000, 0x00023986, 0x00230000, 0x00000006, 0x10000000, 0x000021BE, 0xFC00000C},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000002, 0x90000000, 0x0060201E, 0x0000000C, 0x00000004, 0x00000000, 0x00002001, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000011, 0xD0000000, 0x00603DC1, 0x0000000C, 0x00000002, 0x90000000, 0x00003040, 0x0000000C},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000003, 0x18000000, 0x0000201E, 0x0000000C, 0x00000002, 0x00000000, 0x005C0400, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x07F20000, 0x00007F80, 0x00000000, 0x00000000, 0x1FF20000, 0x00003F00, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x03000000, 0x02A00000, 0x00000000, 0x7FFE0000, 0xFEFFE0DF, 0x1FFFFFFF, 0x00000040, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x66FDE000, 0xC3000000, 0x001E0001, 0x20002064, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0xE0000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x001C0000, 0x000C0000, 0x000C0000, 0x000C0000, 0x00000000, 0x3FB00000, 0x200FFE40, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x0000F800, 0x00000000, 0x00000000, 0x00000000, 0x00000060, 0x00000200, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x0E040187, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x09800000, 0x00000000, 0x7F400000, 0x9FF81FE5, 0x00000000, 0xFFFF0000, 0x00007FFF, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x0000000F, 0x17D00000, 0x00000004, 0x000FF800, 0x00000003, 0x00003B3C, 0x00000000, 0x0003A340},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00CFF000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFF70000, 0x031021FD},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x0000F800, 0x00007C00, 0x00000000, 0x0000FFDF, 0x00000000, 0x00000000, 0xFFFF0000, 0x0001FFFF},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x0C000000, 0x00000600, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00091E00}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x60000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00300000, 0x00000000, 0x000FFF00, 0x80000000, 0x00080000, 0x60000C02, 0x00104030, 0x242C0400}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000C20, 0x00000100, 0x00B85000, 0x00000000, 0x00E00000, 0x80010000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x18000000, 0x00000000, 0x00210000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00038000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x80000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFBFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000FFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF, 0x0FFF0000}
+    },
+    {
+        {0x00000000, 0x00003C00, 0x00000000, 0x00000000, 0x06000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0x7FFFC3FF, 0xFFFFFFFE, 0xFFFFFFFF, 0xF87FFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFE0, 0xFFFEFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF7FFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF000F}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x7FFFFFFF, 0xFFFFFFFF, 0xFFFF00FF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF1FFF, 0xFFFFFFFF, 0x0000007F, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x3FF78000, 0xC0000000, 0x00000000, 0x00000000, 0x00030000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000844, 0x00001060, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000030, 0x8003FFFF},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00003FC0, 0x0003FF80, 0x00000000, 0x00000007, 0x33C80000, 0x00000000, 0x00000020},
+        {0x00000000, 0x00000000, 0x00000000, 0x1FFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00667E00, 0x00001008, 0x10000000, 0x00000000, 0xC19D0000, 0x00000002, 0x00403000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00002120},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0000000F, 0x00000000, 0x00000000}
+    },
+    {
+        {0x40000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x0000FFFF, 0x0000FFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000},
+        {0x03FF0000, 0xFFFF0000, 0xFFF7FFFF, 0x00000F7F, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0E000000},
+        {0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x0000007F}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x20000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000001},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x07C00000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x0000F06E, 0x87000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000060},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x000000F0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00001800, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x0001FFC0, 0x00000000, 0x0000003C, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000002, 0xFF000000, 0x0000007F, 0x80190000, 0x00000003, 0x26780000, 0x00002004, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000007, 0x001FEF80, 0x00000000, 0x00080000, 0x00000003, 0x7FC00000, 0x00009E00, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x40D38000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000, 0x000007F8},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000003, 0x18000000, 0x00000001, 0x001F1FC0, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0xFF000000, 0x4000005C, 0x00000000, 0x00000000, 0x85F80000, 0x0000000D, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xB03C0000, 0x30000001, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0xA7F80000, 0x00000001, 0x00000000, 0x00000000, 0x00BF2800, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xE0000000, 0x00000FBC, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x06FF8000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x58000000, 0x00000008, 0x00000000, 0x00000000, 0x00000000, 0x0CF00000, 0x00000001},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x000007FE, 0x79F80000, 0x0E7E0080, 0x00000000, 0x037FFC00, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0xBF7F0000, 0x00000000, 0x00000000, 0xFFFC0000, 0x006DFCFF, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0xB47E0000, 0x000000BF, 0x00000000, 0x00A30000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00180000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x01FF0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x001F0000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x007F0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00008000, 0x00000000, 0x00078000, 0x00000000, 0x00000000, 0x00000010},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0003000F}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00FFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x000001FF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x6FEF0000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0x00000007, 0x00070000, 0xFFFF00F0, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0FFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x60000000, 0x0000000F, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xFFFFFFFF, 0xFFFF3FFF, 0x0000007F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0xFFF80380, 0x00000FE7, 0x00003C00, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x0000001C, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xFFFFFFFF, 0xF87FFFFF, 0xFFFFFFFF, 0x00201FFF, 0xF8000010, 0x0000FFFE, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xF9FFFF7F, 0x000007DB, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00004000, 0x00000000, 0x0000F000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x007F0000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x000007F0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000010, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00008000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x07FE4000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFF0007, 0x0FFFFFFF, 0x000301FF, 0x0000003F, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFBFE001, 0xFFFFFFFF, 0xDFFFFFFF, 0x000FFFFF, 0xFFFFFFFF, 0x000F87FF, 0xFF11FFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0x7FFFFFFF, 0xFFFFFFFD, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x9FFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0x3FFFFFFF, 0xFFFF7800, 0x040000FF, 0x00600000, 0x00000010, 0x00000000, 0xF8000000}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0x0000FFFF, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xE0E7103F, 0x1FF01800}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00010FFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFF000, 0xF7FFFFFF, 0xFFFFFFBF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x1F1F0000, 0xFFFF007F, 0x07FF1FFF, 0x03FF003F, 0x007F00FF}
+    },
+    {
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x3FFFFFFF}
+    },
+    {
+        {0x00000002, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+    {
+        {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0000FFFF},
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000}
+    },
+};
+
+}
+
+#endif
+
+
+namespace Argum::Wcwidth {
 
-    return 0;
+/* auxiliary function for O(1) lookup in a page bitmap */
+inline bool testbit(char32_t ucs, const uint32_t *bits) {
+    auto offset = unsigned(ucs) & ((1u << widthPageBits) - 1);
+    return (bits[offset >> 5] >> (offset & 31)) & 1;
 }
 
 
@@ -606,86 +1330,22 @@ inline int bisearch(char32_t ucs, const struct interval *table, int max) {
 
 inline int mk_wcwidth(char32_t ucs)
 {
-    /* sorted list of non-overlapping intervals of non-spacing characters */
-    /* generated by "uniset +cat=Me +cat=Mn +cat=Cf -00AD +1160-11FF +200B c" */
-    static constexpr struct interval combining[] = {
-        { 0x0300, 0x036F }, { 0x0483, 0x0486 }, { 0x0488, 0x0489 },
-        { 0x0591, 0x05BD }, { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 },
-        { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0600, 0x0603 },
-        { 0x0610, 0x0615 }, { 0x064B, 0x065E }, { 0x0670, 0x0670 },
-        { 0x06D6, 0x06E4 }, { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED },
-        { 0x070F, 0x070F }, { 0x0711, 0x0711 }, { 0x0730, 0x074A },
-        { 0x07A6, 0x07B0 }, { 0x07EB, 0x07F3 }, { 0x0901, 0x0902 },
-        { 0x093C, 0x093C }, { 0x0941, 0x0948 }, { 0x094D, 0x094D },
-        { 0x0951, 0x0954 }, { 0x0962, 0x0963 }, { 0x0981, 0x0981 },
-        { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD },
-        { 0x09E2, 0x09E3 }, { 0x0A01, 0x0A02 }, { 0x0A3C, 0x0A3C },
-        { 0x0A41, 0x0A42 }, { 0x0A47, 0x0A48 }, { 0x0A4B, 0x0A4D },
-        { 0x0A70, 0x0A71 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC },
-        { 0x0AC1, 0x0AC5 }, { 0x0AC7, 0x0AC8 }, { 0x0ACD, 0x0ACD },
-        { 0x0AE2, 0x0AE3 }, { 0x0B01, 0x0B01 }, { 0x0B3C, 0x0B3C },
-        { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B43 }, { 0x0B4D, 0x0B4D },
-        { 0x0B56, 0x0B56 }, { 0x0B82, 0x0B82 }, { 0x0BC0, 0x0BC0 },
-        { 0x0BCD, 0x0BCD }, { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C48 },
-        { 0x0C4A, 0x0C4D }, { 0x0C55, 0x0C56 }, { 0x0CBC, 0x0CBC },
-        { 0x0CBF, 0x0CBF }, { 0x0CC6, 0x0CC6 }, { 0x0CCC, 0x0CCD },
-        { 0x0CE2, 0x0CE3 }, { 0x0D41, 0x0D43 }, { 0x0D4D, 0x0D4D },
-        { 0x0DCA, 0x0DCA }, { 0x0DD2, 0x0DD4 }, { 0x0DD6, 0x0DD6 },
-        { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E },
-        { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EB9 }, { 0x0EBB, 0x0EBC },
-        { 0x0EC8, 0x0ECD }, { 0x0F18, 0x0F19 }, { 0x0F35, 0x0F35 },
-        { 0x0F37, 0x0F37 }, { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E },
-        { 0x0F80, 0x0F84 }, { 0x0F86, 0x0F87 }, { 0x0F90, 0x0F97 },
-        { 0x0F99, 0x0FBC }, { 0x0FC6, 0x0FC6 }, { 0x102D, 0x1030 },
-        { 0x1032, 0x1032 }, { 0x1036, 0x1037 }, { 0x1039, 0x1039 },
-        { 0x1058, 0x1059 }, { 0x1160, 0x11FF }, { 0x135F, 0x135F },
-        { 0x1712, 0x1714 }, { 0x1732, 0x1734 }, { 0x1752, 0x1753 },
-        { 0x1772, 0x1773 }, { 0x17B4, 0x17B5 }, { 0x17B7, 0x17BD },
-        { 0x17C6, 0x17C6 }, { 0x17C9, 0x17D3 }, { 0x17DD, 0x17DD },
-        { 0x180B, 0x180D }, { 0x18A9, 0x18A9 }, { 0x1920, 0x1922 },
-        { 0x1927, 0x1928 }, { 0x1932, 0x1932 }, { 0x1939, 0x193B },
-        { 0x1A17, 0x1A18 }, { 0x1B00, 0x1B03 }, { 0x1B34, 0x1B34 },
-        { 0x1B36, 0x1B3A }, { 0x1B3C, 0x1B3C }, { 0x1B42, 0x1B42 },
-        { 0x1B6B, 0x1B73 }, { 0x1DC0, 0x1DCA }, { 0x1DFE, 0x1DFF },
-        { 0x200B, 0x200F }, { 0x202A, 0x202E }, { 0x2060, 0x2063 },
-        { 0x206A, 0x206F }, { 0x20D0, 0x20EF }, { 0x302A, 0x302F },
-        { 0x3099, 0x309A }, { 0xA806, 0xA806 }, { 0xA80B, 0xA80B },
-        { 0xA825, 0xA826 }, { 0xFB1E, 0xFB1E }, { 0xFE00, 0xFE0F },
-        { 0xFE20, 0xFE23 }, { 0xFEFF, 0xFEFF }, { 0xFFF9, 0xFFFB },
-        { 0x10A01, 0x10A03 }, { 0x10A05, 0x10A06 }, { 0x10A0C, 0x10A0F },
-        { 0x10A38, 0x10A3A }, { 0x10A3F, 0x10A3F }, { 0x1D167, 0x1D169 },
-        { 0x1D173, 0x1D182 }, { 0x1D185, 0x1D18B }, { 0x1D1AA, 0x1D1AD },
-        { 0x1D242, 0x1D244 }, { 0xE0001, 0xE0001 }, { 0xE0020, 0xE007F },
-        { 0xE0100, 0xE01EF }
-    };
-
     /* test for 8-bit control characters */
     if (ucs == 0)
         return 0;
     if (ucs < 32 || (ucs >= 0x7f && ucs < 0xa0))
         return -1;
 
-    /* binary search in table of non-spacing characters */
-    if (bisearch(ucs, combining,
-        sizeof(combining) / sizeof(struct interval) - 1))
+    if (ucs > 0x10FFFF)
+        return 1;
+
+    /* two-level lookup: page first, then bit within the page. The tables are 
+       generated by .tools/generate-wcwidth.py using the rules above */
+    const WidthPage & page = widthPages[widthPageIndex[ucs >> widthPageBits]];
+    if (testbit(ucs, page.zero))
         return 0;
 
-    /* if we arrive here, ucs is not a combining or C0/C1 control character */
-
-    return 1 + 
-        (ucs >= 0x1100 &&
-            (ucs <= 0x115f ||                    /* Hangul Jamo init. consonants */
-                ucs == 0x2329 || ucs == 0x232a ||
-                (ucs >= 0x2e80 && ucs <= 0xa4cf &&
-                    ucs != 0x303f) ||                  /* CJK ... Yi */
-                (ucs >= 0xac00 && ucs <= 0xd7a3) || /* Hangul Syllables */
-                (ucs >= 0xf900 && ucs <= 0xfaff) || /* CJK Compatibility Ideographs */
-                (ucs >= 0xfe10 && ucs <= 0xfe19) || /* Vertical forms */
-                (ucs >= 0xfe30 && ucs <= 0xfe6f) || /* CJK Compatibility Forms */
-                (ucs >= 0xff00 && ucs <= 0xff60) || /* Fullwidth Forms */
-                (ucs >= 0xffe0 && ucs <= 0xffe6) ||
-                (ucs >= 0x20000 && ucs <= 0x2fffd) ||
-                (ucs >= 0x30000 && ucs <= 0x3fffd)));
+    return 1 + testbit(ucs, page.wide);
 }
 
 
@@ -839,70 +1499,138 @@ namespace Argum {
         }
     }
 
-    inline auto stringWidth(const std::wstring_view & str) -> unsigned {
-
-        int res = Impl::simpleWidth(str.data(), str.size());
-        if (res >= 0)
-            return res;
+    namespace Impl {
         
-        std::wstring stripped;
-        enum {
-            stateNormal,
-            stateEsc,
-            stateControlStart,
-            stateControlIntermediate
-        } state = stateNormal;
-        for (wchar_t c: str) {
-            switch(state) {
-            break; case stateNormal: restart:
-                if (c == L'\x1b') {
-                    state = stateEsc;
-                    continue;
-                }
-                stripped += c;
+        struct TextWidth {
+            unsigned width = 0;     //sum of column widths of all characters
+            unsigned length = 0;    //number of characters
+            bool printable = true;  //false if some characters have no column width
+
+            //If some characters are not printable we fall back on number of characters
+            auto value() const -> unsigned {
+                return printable ? width : length;
+            }
 
-            break; case stateEsc:
-                if (c == L'[') {
-                    state = stateControlStart;
-                    continue;
-                }
-                state = stateNormal;
-                goto restart;
+            auto operator+=(const TextWidth & rhs) -> TextWidth & {
+                width += rhs.width;
+                length += rhs.length;
+                printable = printable && rhs.printable;
+                return *this;
+            }
+        };
 
-            break; case stateControlStart:
-                if (c >= 0x30 && c <= 0x3F) {
-                    continue;
-                }
-                if (c >= 0x20 && c <= 0x2F) {
-                    state = stateControlIntermediate;
-                    continue;
-                }
-                if (c >= 0x40 && c <= 0x7E) {
+        //Measures the string ignoring any ANSI escape sequences in it
+        inline auto measureWidth(const std::wstring_view & str) -> TextWidth {
+
+            if (str.find(L'\x1b') == str.npos) {
+                int res = simpleWidth(str.data(), str.size());
+                if (res >= 0)
+                    return {unsigned(res), unsigned(str.size()), true};
+                return {0, unsigned(str.size()), false};
+            }
+
+            std::wstring stripped;
+            enum {
+                stateNormal,
+                stateEsc,
+                stateControlStart,
+                stateControlIntermediate
+            } state = stateNormal;
+            for (wchar_t c: str) {
+                switch(state) {
+                break; case stateNormal: restart:
+                    if (c == L'\x1b') {
+                        state = stateEsc;
+                        continue;
+                    }
+                    stripped += c;
+
+                break; case stateEsc:
+                    if (c == L'[') {
+                        state = stateControlStart;
+                        continue;
+                    }
                     state = stateNormal;
-                    continue;
-                }
-                state = stateNormal;
-                goto restart;
+                    goto restart;
 
-            break; case stateControlIntermediate:
-                if (c >= 0x20 && c <= 0x2F) {
-                    state = stateControlIntermediate;
-                    continue;
-                }
-                if (c >= 0x40 && c <= 0x7E) {
+                break; case stateControlStart:
+                    if (c >= 0x30 && c <= 0x3F) {
+                        continue;
+                    }
+                    if (c >= 0x20 && c <= 0x2F) {
+                        state = stateControlIntermediate;
+                        continue;
+                    }
+                    if (c >= 0x40 && c <= 0x7E) {
+                        state = stateNormal;
+                        continue;
+                    }
                     state = stateNormal;
-                    continue;
+                    goto restart;
+
+                break; case stateControlIntermediate:
+                    if (c >= 0x20 && c <= 0x2F) {
+                        state = stateControlIntermediate;
+                        continue;
+                    }
+                    if (c >= 0x40 && c <= 0x7E) {
+                        state = stateNormal;
+                        continue;
+                    }
+                    state = stateNormal;
+                    goto restart;
                 }
-                state = stateNormal;
-                goto restart;
             }
+
+            int res = simpleWidth(stripped.data(), stripped.size());
+            if (res >= 0)
+                return {unsigned(res), unsigned(stripped.size()), true};
+            return {0, unsigned(stripped.size()), false};
+        }
+
+        //Narrow version. The buffer is used for conversion and can be reused between calls
+        inline auto measureWidth(const std::string_view & str, std::wstring & buffer) -> TextWidth {
+            
+            buffer.clear();
+            mbstate_t state = mbstate_t();
+            for (auto current = str.data(), last = current + str.size(); current != last; ) {
+                wchar_t c;
+                size_t res = mbrtowc(&c, current, size_t(last - current), &state);
+                if (res == size_t(-1) || res == size_t(-2))
+                    return {};
+                if (res == 0)
+                    res = 1;
+                buffer += c;
+                current += res;
+            }
+            return measureWidth(buffer);
         }
+    }
 
-        res = Impl::simpleWidth(stripped.data(), stripped.size());
-        if (res >= 0)
-            return res;
-        
-        return unsigned(stripped.size());
+    namespace Impl {
+        //Measures text known not to contain escape sequences. 
+        //The buffer is only used for conversion of non-ASCII narrow text
+        template<Character Char>
+        auto measurePlainWidth(std::basic_string_view<Char> str, std::wstring & buffer) -> TextWidth {
+
+            bool printableAscii = std::all_of(str.begin(), str.end(), [](Char c) {
+                return c >= Char(0x20) && c < Char(0x7F);
+            });
+            if (printableAscii)
+                return {unsigned(str.size()), unsigned(str.size()), true};
+
+            if constexpr (std::is_same_v<Char, wchar_t>) {
+                return measureWidth(str);
+            } else {
+                static_assert(std::is_same_v<Char, char>, "only char and wchar_t are supported");
+                return measureWidth(str, buffer);
+            }
+        }
+    }
+
+    inline auto stringWidth(const std::wstring_view & str) -> unsigned {
+
+        return Impl::measureWidth(str).value();
     }
 
     inline auto stringWidth(const std::string_view & str) -> unsigned {
@@ -919,21 +1647,23 @@ namespace Argum {
         return ret;
     }
     
-    template<Character Char>
-    auto appendByIndex(std::basic_string<Char> & /*dest*/, size_t /*idx*/) {
+    template<Character Char, StringAppendable<Char>... Args>
+    auto appendByIndex(std::basic_string<Char> & dest, size_t idx, Args && ...args) {
 
-        //do nothing
+        size_t current = 0;
+        (void)((current++ == idx && (append(dest, std::forward<Args>(args)), true)) || ...);
     }
 
-    template<Character Char, StringAppendable<Char> First, StringAppendable<Char>... Rest>
-    auto appendByIndex(std::basic_string<Char> & dest, size_t idx, First && first, Rest && ...rest) {
+    namespace Impl {
 
-        if (idx == 0) {
-            append(dest, std::forward<First>(first));
-            return;
+        //Cheap estimate of how many characters appending val will produce
+        template<Character Char, class T>
+        auto formattedSizeHint(const T & val) -> size_t {
+            if constexpr (StringLike<T>)
+                return std::basic_string_view<CharTypeOf<T>>(val).size();
+            else
+                return 16;
         }
-
-        appendByIndex(dest, idx - 1, rest...);
     }
 
     template<Character Char>
@@ -995,6 +1725,7 @@ namespace Argum {
         StringViewType fmtView(fmt);
 
         StringType ret;
+        ret.reserve((fmtView.size() + ... + Impl::formattedSizeHint<CharType>(args)));
 
         auto outStart = fmtView.data();
         auto current = outStart;
@@ -1037,66 +1768,275 @@ namespace Argum {
         return ret;
     }
 
-    template<StringLike T>
-    auto wordWrap(T && input, unsigned maxLength, 
-                  unsigned indent = 0, unsigned firstLineOffset = 0) -> std::basic_string<CharTypeOf<T>> {
+    namespace Impl {
 
-        using Char = CharTypeOf<T>;
+        //A piece of a format string: either literal text or a placeholder
+        struct FormatSegment {
+            size_t start = 0;   //offset of the segment text in the format string
+            size_t size = 0;    //size of the segment text
+            size_t argIdx = 0;  //1-based argument index for placeholders, 0 for literal text
+        };
+
+        //constexpr equivalent of parseFormatPlaceholder. Returns 0 if the text is not a valid index
+        template<Character Char>
+        constexpr auto parseFormatIndex(std::basic_string_view<Char> str) -> size_t {
+
+            if (str.empty())
+                return 0;
+            size_t ret = 0;
+            for (auto c: str) {
+                if (c < CharConstants<Char>::digit_0 || c > CharConstants<Char>::digit_0 + 9)
+                    return 0;
+                auto digit = size_t(c - CharConstants<Char>::digit_0);
+                if (ret > (std::numeric_limits<size_t>::max() - digit) / 10)
+                    return 0;
+                ret = ret * 10 + digit;
+            }
+            return ret;
+        }
+
+        //Splits fmt into segments exactly the way the runtime format() scans it, 
+        //calling handler for each non-empty one
+        template<Character Char, class Handler>
+        constexpr auto parseFormat(std::basic_string_view<Char> fmt, Handler handler) {
+
+            using CharConstants = CharConstants<Char>;
+
+            size_t outStart = 0;
+            size_t current = 0;
+            const size_t last = fmt.size();
+
+            auto flush = [&](size_t end) {
+                if (end != outStart)
+                    handler(FormatSegment{outStart, end - outStart, 0});
+            };
+
+            while(current != last) {
+
+                if (fmt[current] == CharConstants::braceOpen) {
+                    ++current;
+                    if (current == last)
+                        break;
+                    if (fmt[current] == CharConstants::braceOpen) {
+                        flush(current);
+                        ++current;
+                        outStart = current;
+                        continue;
+                    }
+
+                    auto placeholderEnd = fmt.find(CharConstants::braceClose, current);
+                    if (placeholderEnd == fmt.npos)
+                        continue;
+                    auto argIdx = parseFormatIndex(fmt.substr(current, placeholderEnd - current));
+                    if (argIdx == 0)
+                        continue;
+
+                    flush(current - 1);
+                    handler(FormatSegment{current - 1, placeholderEnd + 2 - current, argIdx});
+                    current = placeholderEnd + 1;
+                    outStart = current;
+                } else {
+                    ++current;
+                }
+            }
+            flush(last);
+        }
+
+        template<Character Char>
+        constexpr auto countFormatSegments(std::basic_string_view<Char> fmt) -> size_t {
+            size_t ret = 0;
+            parseFormat(fmt, [&](FormatSegment) { ++ret; });
+            return ret;
+        }
+
+        //Format string with placeholders resolved at compile time
+        template<Character Char, size_t N>
+        class CompiledFormat {
+        public:
+            using StringViewType = std::basic_string_view<Char>;
+            using StringType = std::basic_string<Char>;
+
+            constexpr CompiledFormat(StringViewType fmt): m_fmt(fmt) {
+                size_t idx = 0;
+                parseFormat(fmt, [&](FormatSegment seg) { this->m_segments[idx++] = seg; });
+            }
+
+            template<StringAppendable<Char>... Args>
+            auto operator()(Args && ...args) const -> StringType {
+
+                [[maybe_unused]] const size_t argSizes[] = {formattedSizeHint<Char>(args)..., 0};
+
+                size_t size = 0;
+                for (auto & seg: this->m_segments)
+                    size += isText<sizeof...(Args)>(seg) ? seg.size : argSizes[seg.argIdx - 1];
+                
+                StringType ret;
+                ret.reserve(size);
+                for (auto & seg: this->m_segments) {
+                    if (isText<sizeof...(Args)>(seg))
+                        ret.append(this->m_fmt.data() + seg.start, seg.size);
+                    else
+                        appendByIndex(ret, seg.argIdx - 1, args...);
+                }
+                return ret;
+            }
+
+        private:
+            //placeholders referring to non-existent arguments are output as is, like in runtime format()
+            template<size_t ArgCount>
+            static constexpr auto isText(const FormatSegment & seg) -> bool {
+                return seg.argIdx == 0 || seg.argIdx > ArgCount;
+            }
+
+        private:
+            StringViewType m_fmt;
+            std::array<FormatSegment, N> m_segments;
+        };
+
+        template<auto Fmt>
+        using FormatCharType = CharTypeOf<decltype(Fmt())>;
+
+        template<auto Fmt>
+        concept ConstantFormat = requires {
+            typename std::integral_constant<size_t, countFormatSegments(std::basic_string_view<FormatCharType<Fmt>>(Fmt()))>;
+        };
+
+        template<auto Fmt>
+        requires(ConstantFormat<Fmt>)
+        constexpr auto compileFormat() {
+            using CharType = FormatCharType<Fmt>;
+            constexpr std::basic_string_view<CharType> fmt(Fmt());
+            return CompiledFormat<CharType, countFormatSegments(fmt)>(fmt);
+        }
 
-        std::basic_string_view<Char> str(std::forward<T>(input));
+        template<auto Fmt>
+        requires(ConstantFormat<Fmt>)
+        inline constexpr auto compiledFormat = compileFormat<Fmt>();
+    }
+
+    /**
+     Same as format(fmt, args...) but with the format string supplied by a function, 
+     such as one of Messages<Char> members. When the function is constexpr the 
+     format string is parsed at compile time. Otherwise this falls back on runtime
+     parsing.
+     */
+    template<auto Fmt, StringAppendable<Impl::FormatCharType<Fmt>>... Args>
+    auto format(Args && ...args) {
+
+        if constexpr (Impl::ConstantFormat<Fmt>)
+            return Impl::compiledFormat<Fmt>(std::forward<Args>(args)...);
+        else
+            return format(Fmt(), std::forward<Args>(args)...);
+    }
+
+    template<Character Char>
+    auto appendWordWrapped(std::basic_string<Char> & dest, 
+                           std::basic_string_view<Char> str, 
+                           unsigned maxLength, 
+                           unsigned indent = 0, 
+                           unsigned firstLineOffset = 0) -> std::basic_string<Char> & {
+
+        constexpr auto space = CharConstants<Char>::space;
+        constexpr auto endl = CharConstants<Char>::endl;
+        constexpr auto npos = std::basic_string_view<Char>::npos;
         
         if (maxLength == 0 || str.empty())
-            return {};
+            return dest;
 
         if (indent >= maxLength)
             indent = maxLength - 1;
 
-        std::basic_string<Char> ret;
-        ret.reserve(str.size());
-        std::basic_string<Char> prefix;
+        unsigned prefixLength = 0;
         bool firstLine = true;
 
         unsigned curMaxLen;
         if (firstLineOffset >= maxLength) {
-            ret += CharConstants<Char>::endl;
-            prefix = std::basic_string<Char>(indent, CharConstants<char>::space);
-            ret += prefix;
+            dest += endl;
+            dest.append(indent, space);
+            prefixLength = indent;
             curMaxLen = maxLength - indent;
             firstLine = false;
         } else {
             curMaxLen = maxLength - firstLineOffset;
         }
+
+        dest.reserve(dest.size() + str.size() + (size_t(indent) + 1) * (str.size() / curMaxLen + 1));
+
+        [[maybe_unused]] std::wstring buffer;
+        auto measure = [&](std::basic_string_view<Char> text) {
+            if constexpr (std::is_same_v<Char, wchar_t>)
+                return Impl::measureWidth(text);
+            else
+                return Impl::measureWidth(text, buffer);
+        };
         
+        size_t start = 0;
+        size_t eolPos = str.find(endl);
         for ( ; ; ) {
-            auto eolPos = str.find(CharConstants<Char>::endl);
-            auto line = str.substr(0, eolPos);
-            bool needLineBreak = (eolPos != str.npos);
-            auto width = stringWidth(line);
-            while (width > curMaxLen) {
-                auto spacePos = line.rfind(CharConstants<Char>::space);
-                if (spacePos == line.npos)
+            if (eolPos < start)
+                eolPos = str.find(endl, start);
+            const size_t lineEnd = (eolPos != npos ? eolPos : str.size());
+            bool needLineBreak = (eolPos != npos);
+
+            //Accumulate word widths until the line no longer fits. 
+            //lastFit is the end of the longest fitting run of words
+            Impl::TextWidth width;
+            size_t lastFit = npos;
+            size_t wordStart = start;
+            size_t wordEnd;
+            for ( ; ; ) {
+                wordEnd = size_t(std::find(str.begin() + wordStart, str.begin() + lineEnd, space) - str.begin());
+                width += measure(str.substr(wordStart, wordEnd - wordStart));
+                if (width.value() > curMaxLen)
                     break;
-                line = line.substr(0, spacePos);
-                needLineBreak = true;
-                width = stringWidth(line);
+                lastFit = wordEnd;
+                if (wordEnd == lineEnd)
+                    break;
+                width += Impl::TextWidth{1, 1, true};
+                wordStart = wordEnd + 1;
             }
-            ret += prefix;
-            ret += line;
-            if (needLineBreak) {
-                ret += CharConstants<Char>::endl;
-                str = str.substr(line.size() + 1);
+
+            size_t lineSize;
+            if (lastFit == lineEnd) {
+                lineSize = lineEnd - start;
+            } else if (lastFit != npos) {
+                lineSize = lastFit - start;
+                needLineBreak = true;
+            } else if (wordEnd != lineEnd) {
+                //the first word doesn't fit - it gets its own line
+                lineSize = wordEnd - start;
+                needLineBreak = true;
             } else {
-                str = str.substr(line.size());
+                lineSize = lineEnd - start;
             }
-            if (str.empty())
+
+            dest.append(prefixLength, space);
+            dest.append(str.substr(start, lineSize));
+            start += lineSize;
+            if (needLineBreak) {
+                dest += endl;
+                ++start;
+            } 
+            if (start == str.size())
                 break;
 
             if (firstLine) {
-                prefix = std::basic_string<Char>(indent, CharConstants<char>::space);
+                prefixLength = indent;
                 curMaxLen = maxLength - indent;
                 firstLine = false;
             }
         }
+        return dest;
+    }
+
+    template<StringLike T>
+    auto wordWrap(T && input, unsigned maxLength, 
+                  unsigned indent = 0, unsigned firstLineOffset = 0) -> std::basic_string<CharTypeOf<T>> {
+
+        using Char = CharTypeOf<T>;
+
+        std::basic_string<Char> ret;
+        appendWordWrapped(ret, std::basic_string_view<Char>(std::forward<T>(input)), maxLength, indent, firstLineOffset);
         return ret;
     }
 
@@ -1866,21 +2806,32 @@ namespace Argum {
         ExtraPositional,
         ValidationError,
         ResponseFileError,
+        ResponseFileCycle,
+        ResponseFileWriteError,
 
-        Last = ResponseFileError,
+        Last = ResponseFileWriteError,
         UserError = int(Last) + 100
     };
 
+    /**
+     Base class for all parsing errors.
+
+     Derived classes can either pass a ready message to the constructor or keep only the data
+     describing the error and override formatMessage(). In the latter case the message, as well as
+     the narrow version returned by what() for wide characters, is only built on the first call to
+     message() or what(). If building them fails, for example because memory is exhausted, these
+     methods return a generic message instead and try again on the next call.
+     */
     ARGUM_MOD_EXPORTED
     template<class Char>
     class BasicParsingException : public std::exception {
     private:
-        using StringsType = std::conditional_t<std::is_same_v<Char, char>, 
-                                    std::tuple<std::string>,
-                                    std::tuple<std::string, std::basic_string<Char>>>;
+        using NarrowType = std::conditional_t<std::is_same_v<Char, char>, std::monostate, std::string>;
     public:
         auto message() const noexcept -> std::basic_string_view<Char> {
-            return std::get<std::tuple_size_v<StringsType> - 1>(this->m_strings);
+            if (!this->ensureStrings())
+                return Messages<Char>::messageUnavailable();
+            return this->m_message;
         }
 
         auto code() const noexcept -> Error {
@@ -1902,7 +2853,12 @@ namespace Argum {
         }
 
         auto what() const noexcept -> const char * override {
-            return std::get<0>(this->m_strings).c_str();
+            if (!this->ensureStrings())
+                return Messages<char>::messageUnavailable();
+            if constexpr (std::is_same_v<Char, char>)
+                return this->m_message.c_str();
+            else
+                return this->m_narrow.c_str();
         }
 
         virtual auto clone() const & -> std::shared_ptr<BasicParsingException> = 0;
@@ -1912,20 +2868,103 @@ namespace Argum {
         
     protected:
         BasicParsingException(Error code, std::basic_string<Char> message) : 
-            m_strings(BasicParsingException::initStrings(std::move(message))),
-            m_code(code) {
+            m_message(std::move(message)),
+            m_code(code),
+            m_lazy(false) {
+        }
+        //Message will be produced by formatMessage() when needed
+        BasicParsingException(Error code) : 
+            m_code(code),
+            m_lazy(true) {
+        }
+        //Copies do not share the lazily built strings and build their own when needed
+        BasicParsingException(const BasicParsingException & src):
+            std::exception(src),
+            m_message(src.m_lazy ? std::basic_string<Char>() : src.m_message),
+            m_code(src.m_code),
+            m_lazy(src.m_lazy) {
+        }
+        BasicParsingException(BasicParsingException && src):
+            std::exception(std::move(src)),
+            m_message(src.m_lazy ? std::basic_string<Char>() : std::move(src.m_message)),
+            m_code(src.m_code),
+            m_lazy(src.m_lazy) {
+        }
+        auto operator=(const BasicParsingException & src) -> BasicParsingException & {
+            if (this != &src) {
+                std::exception::operator=(src);
+                this->m_message = src.m_lazy ? std::basic_string<Char>() : src.m_message;
+                this->resetStrings(src);
+            }
+            return *this;
+        }
+        auto operator=(BasicParsingException && src) -> BasicParsingException & {
+            if (this != &src) {
+                std::exception::operator=(std::move(src));
+                this->m_message = src.m_lazy ? std::basic_string<Char>() : std::move(src.m_message);
+                this->resetStrings(src);
+            }
+            return *this;
+        }
+
+        virtual auto formatMessage() const -> std::basic_string<Char> {
+            return {};
         }
     private:
-        static auto initStrings(std::basic_string<Char> && message) -> StringsType {
-            if constexpr (std::is_same_v<Char, char>) {
-                return StringsType(std::move(message));
-            } else {
-                return StringsType(toString<char>(message), std::move(message));
+        enum StringsState : uint8_t {
+            StringsNotBuilt,
+            StringsBuilding,
+            StringsBuilt
+        };
+
+        //Returns false if the strings could not be built. Concurrent callers wait for the one building them.
+        auto ensureStrings() const noexcept -> bool {
+            auto state = this->m_stringsState.load(std::memory_order_acquire);
+            while (state != StringsBuilt) {
+                if (state == StringsBuilding) {
+                    this->m_stringsState.wait(StringsBuilding, std::memory_order_acquire);
+                    state = this->m_stringsState.load(std::memory_order_acquire);
+                    continue;
+                }
+                if (!this->m_stringsState.compare_exchange_weak(state, StringsBuilding, std::memory_order_acquire))
+                    continue;
+                bool built = this->buildStrings();
+                this->m_stringsState.store(built ? StringsBuilt : StringsNotBuilt, std::memory_order_release);
+                this->m_stringsState.notify_all();
+                return built;
+            }
+            return true;
+        }
+
+        auto buildStrings() const noexcept -> bool {
+        #ifndef ARGUM_NO_THROW
+            try {
+        #endif
+                if (this->m_lazy)
+                    this->m_message = this->formatMessage();
+                if constexpr (!std::is_same_v<Char, char>)
+                    this->m_narrow = toString<char>(this->m_message);
+                return true;
+        #ifndef ARGUM_NO_THROW
+            } catch (...) {
+                return false;
             }
+        #endif
+        }
+
+        auto resetStrings(const BasicParsingException & src) -> void {
+            if constexpr (!std::is_same_v<Char, char>)
+                this->m_narrow.clear();
+            this->m_code = src.m_code;
+            this->m_lazy = src.m_lazy;
+            this->m_stringsState.store(StringsNotBuilt, std::memory_order_relaxed);
         }
     private:
-        StringsType m_strings;
+        mutable std::basic_string<Char> m_message;
+        [[no_unique_address]] mutable NarrowType m_narrow;
+        mutable std::atomic<StringsState> m_stringsState = StringsNotBuilt;
         Error m_code;
+        bool m_lazy;
     };
     
     ARGUM_DECLARE_FRIENDLY_NAMES(ParsingException)
@@ -1949,50 +2988,193 @@ namespace Argum {
 #endif
 
 
+
 namespace Argum {
 
     ARGUM_MOD_EXPORTED template<class T> using FailureType = std::in_place_type_t<T>;
 
     ARGUM_MOD_EXPORTED template<class T> inline constexpr FailureType<T> Failure{};
 
+    /**
+     Compact representation of the most common parsing errors.
+
+     Stores the kind of the error, the index of the offending command line argument and a view of
+     the offending option name or argument in the command line. It never allocates, is trivially
+     copyable and is as small as a `std::shared_ptr`. The message and the exception object are only 
+     built when requested.
+
+     Since the subject is not copied, the error must not be inspected after the command line it 
+     refers to is destroyed. The exception object returned by exception() owns a copy.
+
+     Exceptions that declare `static constexpr bool IsCompact = true` and can be constructed from
+     `(StringViewType subject, int argumentIndex)` can be represented this way.
+     */
     ARGUM_MOD_EXPORTED
-    template<class Char, class T>
-    class [[nodiscard]] BasicExpected {
-        template<class OtherChar, class Other> friend class BasicExpected;
-    private:
-        using ValueType = std::conditional_t<std::is_same_v<T, void>, std::monostate, T>;
+    template<class Char>
+    class BasicParsingError {
     public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
         using ParsingException = BasicParsingException<Char>;
         using ParsingExceptionPtr = std::shared_ptr<ParsingException>;
 
-        using ConstLValueReference = std::add_lvalue_reference_t<const T>;
-        using LValueReference = std::add_lvalue_reference_t<T>;
-        using RValueReference = std::add_rvalue_reference_t<T>;
-    private:
-        using ImplType = std::variant<ValueType, ParsingExceptionPtr>;
+        static constexpr size_t maxSubjectSize = UINT16_MAX;
+
     public:
-        BasicExpected() = default;
+        //Returns nullopt if the subject is too long or too many different exception types are represented
+        template<class Exception>
+        requires(std::is_base_of_v<ParsingException, Exception> && Exception::IsCompact)
+        static auto make(StringViewType subject, int argumentIndex = -1) -> std::optional<BasicParsingError> {
+            auto kind = kindOf<Exception>();
+            if (subject.size() > maxSubjectSize || kind == noKind)
+                return std::nullopt;
+            BasicParsingError ret;
+            ret.m_subject = subject.data();
+            ret.m_argumentIndex = argumentIndex;
+            ret.m_subjectSize = uint16_t(subject.size());
+            ret.m_kind = kind;
+            return ret;
+        }
 
-        template<class... Args>
-        requires(std::is_constructible_v<T, Args &&...> && !std::is_same_v<T, void>)
-        BasicExpected(Args && ...args): 
-            m_impl(std::in_place_type_t<T>(), std::forward<Args>(args)...) {
+        auto code() const noexcept -> Error {
+            return kinds()[this->m_kind].code;
         }
 
-        BasicExpected(ParsingExceptionPtr err): m_impl(BasicExpected::validate(err)) {
+        //Index of the offending argument in the command line or -1 if not known
+        auto argumentIndex() const noexcept -> int {
+            return this->m_argumentIndex;
         }
 
-        template<class Exception, class... Args>
-        requires(std::is_base_of_v<ParsingException, Exception>)
-        BasicExpected(FailureType<Exception>, Args && ...args): 
-            m_impl(std::make_shared<Exception>(std::forward<Args>(args)...)) {
+        //Offending option name or argument
+        auto subject() const noexcept -> StringViewType {
+            return StringViewType(this->m_subject, this->m_subjectSize);
         }
 
-        template<class OtherT>
-        requires(std::is_constructible_v<T, OtherT> || std::is_same_v<T, void>)
-        BasicExpected(const BasicExpected<Char, OtherT> & other): 
-            m_impl(std::visit([&](const auto & val) {
-                    if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, ParsingExceptionPtr>) {
+        auto message() const -> StringType {
+            switch(this->code()) {
+                case Error::UnrecognizedOption:     return format<Messages<Char>::unrecognizedOptionError>(this->subject());
+                case Error::MissingOptionArgument:  return format<Messages<Char>::missingOptionArgumentError>(this->subject());
+                case Error::ExtraOptionArgument:    return format<Messages<Char>::extraOptionArgumentError>(this->subject());
+                case Error::ExtraPositional:        return format<Messages<Char>::extraPositionalError>(this->subject());
+                default:                            return StringType(this->exception()->message());
+            }
+        }
+
+        //Creates the exception object this error stands for
+        auto exception() const -> ParsingExceptionPtr {
+            return kinds()[this->m_kind].materialize(this->subject(), this->argumentIndex());
+        }
+
+    private:
+        BasicParsingError() = default;
+
+        struct Kind {
+            Error code;
+            ParsingExceptionPtr (*materialize)(StringViewType subject, int argumentIndex);
+        };
+        static constexpr unsigned maxKinds = 64;
+        static constexpr uint8_t noKind = UINT8_MAX;
+
+        static auto kinds() -> Kind * {
+            static Kind ret[maxKinds];
+            return ret;
+        }
+
+        static auto kindCount() -> std::atomic<unsigned> & {
+            static std::atomic<unsigned> ret{0};
+            return ret;
+        }
+
+        //Assigns each exception type a slot in kinds() on first use
+        template<class Exception>
+        static auto kindOf() -> uint8_t {
+            static const uint8_t kind = []() {
+                unsigned idx = kindCount().fetch_add(1, std::memory_order_relaxed);
+                if (idx >= maxKinds)
+                    return noKind;
+                kinds()[idx] = {Exception::ErrorCode, [](StringViewType subject, int argumentIndex) -> ParsingExceptionPtr {
+                    return std::make_shared<Exception>(subject, argumentIndex);
+                }};
+                return uint8_t(idx);
+            }();
+            return kind;
+        }
+    private:
+        const Char * m_subject;
+        int m_argumentIndex;
+        uint16_t m_subjectSize;
+        uint8_t m_kind;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ParsingError)
+
+    namespace Impl {
+        //Error moved out of a failed BasicExpected to be returned as a BasicExpected of another type
+        template<class Char>
+        struct PropagatedError {
+            std::variant<BasicParsingError<Char>, std::shared_ptr<BasicParsingException<Char>>> error;
+        };
+    }
+
+    /**
+     Result of an operation that can fail with a parsing error.
+
+     Common parser errors are stored as BasicParsingError without allocating. Other errors are
+     stored as exception objects. Use errorCode() and errorMessage() to inspect an error without
+     materializing it. error() always returns an exception object. For a compact error a new one is 
+     created on each call. Call detachError() to replace a compact error with an exception object once,
+     after which the error no longer refers to the command line.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char, class T>
+    class [[nodiscard]] BasicExpected {
+        template<class OtherChar, class Other> friend class BasicExpected;
+    private:
+        using ValueType = std::conditional_t<std::is_same_v<T, void>, std::monostate, T>;
+    public:
+        using ParsingException = BasicParsingException<Char>;
+        using ParsingExceptionPtr = std::shared_ptr<ParsingException>;
+        using ParsingError = BasicParsingError<Char>;
+
+        using ConstLValueReference = std::add_lvalue_reference_t<const T>;
+        using LValueReference = std::add_lvalue_reference_t<T>;
+        using RValueReference = std::add_rvalue_reference_t<T>;
+    private:
+        using ImplType = std::variant<ValueType, ParsingError, ParsingExceptionPtr>;
+    public:
+        BasicExpected() = default;
+
+        template<class... Args>
+        requires(std::is_constructible_v<T, Args &&...> && !std::is_same_v<T, void>)
+        BasicExpected(Args && ...args): 
+            m_impl(std::in_place_type_t<T>(), std::forward<Args>(args)...) {
+        }
+
+        BasicExpected(ParsingExceptionPtr err): m_impl(BasicExpected::validate(err)) {
+        }
+
+        BasicExpected(ParsingError err): m_impl(err) {
+        }
+
+        BasicExpected(Impl::PropagatedError<Char> && err): 
+            m_impl(std::visit([](auto && val) {
+                    return ImplType(std::move(val));
+                }, std::move(err.error))) {
+        }
+
+        template<class Exception, class... Args>
+        requires(std::is_base_of_v<ParsingException, Exception>)
+        BasicExpected(FailureType<Exception>, Args && ...args): 
+            m_impl(std::make_shared<Exception>(std::forward<Args>(args)...)) {
+        }
+
+        template<class OtherT>
+        requires(std::is_constructible_v<T, OtherT> || std::is_same_v<T, void>)
+        BasicExpected(const BasicExpected<Char, OtherT> & other): 
+            m_impl(std::visit([&](const auto & val) {
+                    using ValType = std::remove_cvref_t<decltype(val)>;
+                    if constexpr (std::is_same_v<ValType, ParsingExceptionPtr> || std::is_same_v<ValType, ParsingError>) {
                         return ImplType(val); 
                     } else if constexpr (!std::is_same_v<T, void>) {
                         return ImplType(val); 
@@ -2057,13 +3239,45 @@ namespace Argum {
         }
 
         auto error() const -> ParsingExceptionPtr {
-            return std::visit([](const auto & val) -> ParsingExceptionPtr {
-                if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, ParsingExceptionPtr>) {
-                    return val;
-                } else {
-                    return ParsingExceptionPtr();
-                }
-            }, this->m_impl);
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return compact->exception();
+            if (auto ptr = std::get_if<ParsingExceptionPtr>(&this->m_impl))
+                return *ptr;
+            return ParsingExceptionPtr();
+        }
+
+        //Replaces a compact error with an exception object that does not refer to the command line
+        auto detachError() -> void {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                this->m_impl = compact->exception();
+        }
+
+        //Compact error or nullptr if there is no error or it is stored as an exception
+        auto compactError() const -> const ParsingError * {
+            return std::get_if<ParsingError>(&this->m_impl);
+        }
+
+        auto errorCode() const -> std::optional<Error> {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return compact->code();
+            if (auto ptr = std::get_if<ParsingExceptionPtr>(&this->m_impl); ptr && *ptr)
+                return (*ptr)->code();
+            return std::nullopt;
+        }
+
+        auto errorMessage() const -> std::basic_string<Char> {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return compact->message();
+            if (auto ptr = std::get_if<ParsingExceptionPtr>(&this->m_impl); ptr && *ptr)
+                return std::basic_string<Char>((*ptr)->message());
+            return {};
+        }
+
+        //Moves the error out for propagation to a BasicExpected of another type. Must only be called on failure.
+        auto takeError() && -> Impl::PropagatedError<Char> {
+            if (auto compact = std::get_if<ParsingError>(&this->m_impl))
+                return {*compact};
+            return {std::move(*std::get_if<ParsingExceptionPtr>(&this->m_impl))};
         }
 
         explicit operator bool() const {
@@ -2078,6 +3292,10 @@ namespace Argum {
                 ARGUM_INVALID_ARGUMENT("error must be non-null");
             return std::move(ptr);
         }
+
+        [[noreturn]] static auto raise(const ParsingError & err) {
+            BasicExpected::raise(err.exception());
+        }
         [[noreturn]] static auto raise(const ParsingExceptionPtr & ptr) {
             if (ptr)
                 ptr->raise();
@@ -2139,7 +3357,7 @@ namespace Argum {
 
     #ifdef ARGUM_USE_EXPECTED
         #define ARGUM_EXPECTED(c, type) BasicExpected<c, type>
-        #define ARGUM_PROPAGATE_ERROR(expr) if (auto err = (expr).error()) { return err; }
+        #define ARGUM_PROPAGATE_ERROR(expr) if (auto && argum_propagated = (expr); !argum_propagated) { return std::move(argum_propagated).takeError(); }
         #define ARGUM_CHECK_RESULT_IMPL(temp, var, expr) decltype(auto) temp = (expr); ARGUM_PROPAGATE_ERROR(temp); var = *temp
         #define ARGUM_CHECK_RESULT(var, expr)  ARGUM_CHECK_RESULT_IMPL(ARGUM_UNIQUE_NAME(argum_check_result), var, expr)
         #define ARGUM_THROW(type, ...) return {Failure<type> __VA_OPT__(,) __VA_ARGS__}
@@ -2155,6 +3373,79 @@ namespace Argum {
 
 
 
+#endif
+#ifndef HEADER_ARGUM_PARSE_STATS_H_INCLUDED
+#define HEADER_ARGUM_PARSE_STATS_H_INCLUDED
+
+
+
+
+namespace Argum {
+
+    /**
+     Statistics of the work done while parsing a command line.
+
+     Pass a pointer to an instance to any of the `BasicParser` parse methods to have it filled in.
+     Counters and durations are added to rather than overwritten so a single object can accumulate
+     a parse together with the parses of its sub-commands. Use reset() to start over.
+
+     Allocations cannot be counted by the library itself. To have them reported set `allocationCounter`
+     to a function that returns the total number of allocations made by the process so far, for example
+     maintained by a replaced `operator new`.
+     */
+    ARGUM_MOD_EXPORTED
+    struct ParseStats {
+        using Clock = std::chrono::steady_clock;
+        using Duration = Clock::duration;
+
+        //Tokens found in the command line, by type
+        size_t optionTokens = 0;
+        size_t argumentTokens = 0;
+        size_t optionStopTokens = 0;
+        size_t unknownOptionTokens = 0;
+        size_t ambiguousOptionTokens = 0;
+
+        size_t prefixLookups = 0;               //searches for the option prefix of an argument
+        size_t optionLookups = 0;               //searches for an option name among the known ones
+        size_t abbreviationResolutions = 0;     //option names matched by an unambiguous abbreviation
+        size_t positionalRecalculations = 0;    //recalculations of how many arguments each positional takes
+        size_t handlerInvocations = 0;          //calls to option and positional handlers
+        size_t validatorEvaluations = 0;        //evaluations of validators, including the built-in occurrence checks
+
+        size_t (*allocationCounter)() = nullptr;
+        size_t allocations = 0;                 //only counted if allocationCounter is set
+
+        Duration totalTime{};                   //the whole parse
+        Duration handlersTime{};                //spent in handlers
+        Duration positionalRecalculationTime{}; //spent recalculating positionals, including tokenizing the rest of the command line
+        Duration validationTime{};              //spent in final validation
+
+        //Tokenizing and matching arguments, that is the total time minus all the phases above
+        auto tokenizingTime() const -> Duration {
+            return totalTime - handlersTime - positionalRecalculationTime - validationTime;
+        }
+
+        auto tokens() const -> size_t {
+            return optionTokens + argumentTokens + optionStopTokens + unknownOptionTokens + ambiguousOptionTokens;
+        }
+
+        //Clears all counters and durations keeping the allocationCounter
+        auto reset() -> void {
+            auto counter = this->allocationCounter;
+            *this = ParseStats{};
+            this->allocationCounter = counter;
+        }
+    };
+
+    namespace Impl {
+        //Increments a counter of stats if they are being collected
+        inline auto countIn(ParseStats * stats, size_t ParseStats::*counter) -> void {
+            if (stats)
+                ++(stats->*counter);
+        }
+    }
+}
+
 #endif
 
 
@@ -2410,7 +3701,7 @@ namespace Argum {
         }
 
         template<ArgIterator<CharType> It, class Func>
-        auto tokenize(It argFirst, It argLast, Func && handler) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>)  {
+        auto tokenize(It argFirst, It argLast, Func && handler, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>)  {
 
             static_assert(IsHandler<Func, CharType, TokenResult, OptionToken>, "handler must handle OptionToken and return correct return type");
             static_assert(IsHandler<Func, CharType, TokenResult, ArgumentToken>, "handler must handle ArgumentToken and return correct return type");
@@ -2432,6 +3723,7 @@ namespace Argum {
                 std::optional<TokenResult> result;
                 if (!noMoreOptions) {
 
+                    Impl::countIn(stats, &ParseStats::prefixLookups);
                     if (auto prefixFindResult = this->findLongestPrefix(arg)) {
                     
                         auto type = prefixFindResult->type;
@@ -2449,13 +3741,13 @@ namespace Argum {
                             if ((type & LongPrefix) == LongPrefix) {
                                 ARGUM_CHECK_RESULT(result, this->handleLongPrefix(argIdx, arg,
                                                                          prefixFindResult->index, prefixFindResult->size,
-                                                                         std::forward<Func>(handler)));
+                                                                         std::forward<Func>(handler), stats));
                                 if (result == TokenResult::StopAfter)
                                     consumed = unsigned(arg.size());
                             } else if ((type & ShortPrefix) == ShortPrefix) {
                                 ARGUM_CHECK_RESULT(result, this->handleShortPrefix(argIdx, arg,
                                                                           prefixFindResult->index, prefixFindResult->size,
-                                                                          consumed, handler));
+                                                                          consumed, handler, stats));
                                 unconsumedPrefixSize = prefixFindResult->size;
                             }
                         }
@@ -2521,7 +3813,8 @@ namespace Argum {
                               StringViewType option, 
                               PrefixId prefixId,
                               unsigned nameStart,
-                              Func && handler) const -> ARGUM_EXPECTED(CharType, TokenResult) {
+                              Func && handler,
+                              ParseStats * stats) const -> ARGUM_EXPECTED(CharType, TokenResult) {
             
             auto [name, arg] = this->splitDelimitedArgument(option, nameStart);
             if (name.size() == 0)
@@ -2541,9 +3834,12 @@ namespace Argum {
             }
             auto & longsMap = mapIt->value();
 
+            Impl::countIn(stats, &ParseStats::optionLookups);
             if (this->m_allowAbrreviation) {
                 const auto & [first, last] = findMatchOrMatchingPrefixRange(longsMap, name);
                 if (last - first == 1) {
+                    if (first->key() != name)
+                        Impl::countIn(stats, &ParseStats::abbreviationResolutions);
                     return this->callHandler(std::forward<Func>(handler), OptionToken{argIdx, first->value(), std::move(usedName), std::move(arg)});
                 } else if (last != first) {
                     StringType actualPrefix(option.substr(0, nameStart));
@@ -2569,9 +3865,10 @@ namespace Argum {
                                PrefixId prefixId,
                                unsigned nameStart,
                                unsigned & consumed,
-                               Func && handler) const -> ARGUM_EXPECTED(CharType, TokenResult) {
+                               Func && handler,
+                               ParseStats * stats) const -> ARGUM_EXPECTED(CharType, TokenResult) {
 
-            if (auto maybeResult = this->handleShortOption(argIdx, option, prefixId, nameStart, consumed, handler)) {
+            if (auto maybeResult = this->handleShortOption(argIdx, option, prefixId, nameStart, consumed, handler, stats)) {
                 return std::move(*maybeResult);
             } 
 
@@ -2593,7 +3890,8 @@ namespace Argum {
                                PrefixId prefixId,
                                unsigned nameStart, 
                                unsigned & consumed,
-                               Func && handler) const -> std::optional<ARGUM_EXPECTED(CharType, TokenResult)> {
+                               Func && handler,
+                               ParseStats * stats) const -> std::optional<ARGUM_EXPECTED(CharType, TokenResult)> {
 
             StringViewType chars = option.substr(nameStart);
             assert(!chars.empty());
@@ -2602,6 +3900,7 @@ namespace Argum {
             
             auto mapIt = this->m_singleShorts.find(prefixId);
             if (mapIt != this->m_singleShorts.end()) {
+                Impl::countIn(stats, &ParseStats::optionLookups);
                 auto it = mapIt->value().find(chars[0]);
                 if (it != mapIt->value().end())
                     singleLetterNameIdx = it->value();
@@ -2611,7 +3910,7 @@ namespace Argum {
 
                 ARGUM_CHECK_RESULT(auto maybeResult, 
                     this->handleMultiShortOption(argIdx, option, prefixId, nameStart, 
-                                                 singleLetterNameIdx.has_value(), std::forward<Func>(handler)));
+                                                 singleLetterNameIdx.has_value(), std::forward<Func>(handler), stats));
                 if (maybeResult) {
                     if (*maybeResult == TokenResult::StopAfter)
                         consumed = unsigned(option.size());
@@ -2634,6 +3933,7 @@ namespace Argum {
                 unsigned charsConsumed = 1;
                 if (chars.size() > 1) {
 
+                    Impl::countIn(stats, &ParseStats::optionLookups);
                     auto it = shortsMap.find(chars[1]);
                     if (it == shortsMap.end()) {
                         arg = chars.substr(1);
@@ -2667,7 +3967,8 @@ namespace Argum {
                                     PrefixId prefixId,
                                     unsigned nameStart,
                                     bool mustMatchExact,
-                                    Func && handler) const -> ARGUM_EXPECTED(CharType, std::optional<TokenResult>) {
+                                    Func && handler,
+                                    ParseStats * stats) const -> ARGUM_EXPECTED(CharType, std::optional<TokenResult>) {
 
             auto [name, arg] = this->splitDelimitedArgument(option, nameStart);
             if (name.size() == 0)
@@ -2679,12 +3980,15 @@ namespace Argum {
             }
             auto & multiShortsMap = mapIt->value();
 
+            Impl::countIn(stats, &ParseStats::optionLookups);
             if (this->m_allowAbrreviation) {
                 const auto & [first, last] = findMatchOrMatchingPrefixRange(multiShortsMap, name);
                 if (last != first) {
                     StringType usedName(option.data(), name.data() + name.size());
                     if (last - first == 1) {
                         if (!mustMatchExact || first->key() == name) {
+                            if (first->key() != name)
+                                Impl::countIn(stats, &ParseStats::abbreviationResolutions);
                             return this->callHandler(std::forward<Func>(handler), OptionToken{argIdx, first->value(), std::move(usedName), std::move(arg)});
                         } else {
                             std::vector<StringType> candidates = {
@@ -2905,15 +4209,27 @@ namespace Argum {
                 ec = std::make_error_code(static_cast<std::errc>(err));
             }
         }
-        SimpleFile(SimpleFile && src) {
-            m_fp = src.m_fp;
+        SimpleFile(SimpleFile && src):
+            m_fp(src.m_fp),
+            m_buffer(std::move(src.m_buffer)),
+            m_bufferPos(src.m_bufferPos),
+            m_bufferEnd(src.m_bufferEnd),
+            m_eof(src.m_eof),
+            m_state(src.m_state) {
             src.m_fp = nullptr;
         }
         auto operator=(SimpleFile && src) -> SimpleFile & {
-            if (m_fp)
-                fclose(m_fp);
-            m_fp = nullptr;
-            m_fp = src.m_fp;
+            if (this != &src) {
+                if (m_fp)
+                    fclose(m_fp);
+                m_fp = src.m_fp;
+                src.m_fp = nullptr;
+                m_buffer = std::move(src.m_buffer);
+                m_bufferPos = src.m_bufferPos;
+                m_bufferEnd = src.m_bufferEnd;
+                m_eof = src.m_eof;
+                m_state = src.m_state;
+            }
             return *this;
         }
         ~SimpleFile() {
@@ -2926,191 +4242,1945 @@ namespace Argum {
         operator bool() const {
             return m_fp != nullptr;
         }
+        //true once readLine() reached the end of file
         auto eof() const -> bool {
-            return feof(m_fp) != 0;
+            return m_eof;
+        }
+
+        //Returns up to size bytes at the current position without consuming them
+        auto peek(size_t size, std::error_code & ec) -> std::string_view {
+            if (m_bufferPos == m_bufferEnd && !fillBuffer(ec))
+                return {};
+            return std::string_view(m_buffer.get() + m_bufferPos, std::min(size, m_bufferEnd - m_bufferPos));
+        }
+
+        /**
+         Writes the whole buffer with a single unbuffered write and flushes it.
+
+         Must be the first operation on the file.
+         */
+        auto write(const char * data, size_t size, std::error_code & ec) -> bool {
+            setvbuf(m_fp, nullptr, _IONBF, 0);
+            errno = 0;
+            if (fwrite(data, 1, size, m_fp) == size && fflush(m_fp) == 0)
+                return true;
+            ec = lastError();
+            return false;
         }
 
+        /**
+         Reads the next line without the line terminator.
+
+         The file is read in large blocks. For `char` lines are located with memchr and
+         appended as whole slices. For `wchar_t` the blocks are decoded with mbrtowc 
+         according to the current locale, the same way fgetwc would.
+         */
         template<Character Char>
         std::basic_string<Char> readLine(std::error_code & ec) {
+            static_assert(std::is_same_v<Char, char> || std::is_same_v<Char, wchar_t>, 
+                          "only char and wchar_t are supported");
             std::basic_string<Char> buf;
             for ( ; ; ) {
-                Char c;
+                if (m_bufferPos == m_bufferEnd && !fillBuffer(ec))
+                    break;
+                
+                const char * const first = m_buffer.get() + m_bufferPos;
+                const char * const last = m_buffer.get() + m_bufferEnd;
                 if constexpr (std::is_same_v<Char, char>) {
-                    int res = fgetc(m_fp);
-                    if (res == EOF) {
-                        checkError(ec);
+                    auto found = static_cast<const char *>(memchr(first, CharConstants<char>::endl, size_t(last - first)));
+                    if (found) {
+                        buf.append(first, found);
+                        m_bufferPos += size_t(found - first) + 1;
                         break;
                     }
-                    c = Char(res);
-                } else if constexpr (std::is_same_v<Char, wchar_t>) {
-                    wint_t res = fgetwc(m_fp);
-                    if (res == WEOF) {
-                        checkError(ec);
+                    buf.append(first, last);
+                    m_bufferPos = m_bufferEnd;
+                } else {
+                    if (decodeLine(buf, ec))
                         break;
-                    }
-                    c = Char(res);
                 }
-                
-                if (c == CharConstants<Char>::endl)
-                    break;
-                buf += c;
             }
             return buf;
         }
     private:
+        static constexpr size_t bufferSize = 64 * 1024;
+
+        //Reads the next block. Returns false on end of file or error
+        auto fillBuffer(std::error_code & ec) -> bool {
+            if (!m_buffer)
+                m_buffer.reset(new char[bufferSize]);
+            m_bufferPos = 0;
+            errno = 0;
+            m_bufferEnd = fread(m_buffer.get(), 1, bufferSize, m_fp);
+            if (m_bufferEnd == 0) {
+                if (!checkError(ec))
+                    m_eof = true;
+                return false;
+            }
+            return true;
+        }
+
+        //Decodes buffered bytes appending them to dest. Returns true if end of line 
+        //was found or an error occurred
+        auto decodeLine(std::wstring & dest, std::error_code & ec) -> bool {
+            const char * const data = m_buffer.get();
+            while (m_bufferPos != m_bufferEnd) {
+                auto byte = static_cast<unsigned char>(data[m_bufferPos]);
+                wchar_t c;
+                //ASCII in initial shift state is the same in all supported encodings
+                if (byte < 0x80 && mbsinit(&m_state)) {
+                    c = wchar_t(byte);
+                    ++m_bufferPos;
+                } else {
+                    size_t res = mbrtowc(&c, data + m_bufferPos, m_bufferEnd - m_bufferPos, &m_state);
+                    if (res == size_t(-2)) {
+                        //incomplete character: the bytes are stored in m_state, continue with the next block
+                        m_bufferPos = m_bufferEnd;
+                        return false;
+                    }
+                    if (res == size_t(-1)) {
+                        ec = std::make_error_code(std::errc::illegal_byte_sequence);
+                        m_bufferPos = m_bufferEnd;
+                        return true;
+                    }
+                    m_bufferPos += (res == 0 ? 1 : res);
+                }
+                if (c == CharConstants<wchar_t>::endl)
+                    return true;
+                dest += c;
+            }
+            return false;
+        }
+
         auto checkError(std::error_code & ec) const -> bool{
             if (ferror(m_fp)) {
-                int err = errno;
-                 ec = std::make_error_code(static_cast<std::errc>(err));
+                 ec = lastError();
                  return true;
             }
             return false;
         }
+
+        //stdio functions are not required to set errno on failure
+        static auto lastError() -> std::error_code {
+            int err = errno;
+            if (err == 0)
+                return std::make_error_code(std::errc::io_error);
+            return std::make_error_code(static_cast<std::errc>(err));
+        }
     private:
         FILE * m_fp;
+        std::unique_ptr<char[]> m_buffer;
+        size_t m_bufferPos = 0;
+        size_t m_bufferEnd = 0;
+        bool m_eof = false;
+        mbstate_t m_state = mbstate_t();
     };
 }
 
 #endif
+#ifndef HEADER_ARGUM_MAPPED_FILE_H_INCLUDED
+#define HEADER_ARGUM_MAPPED_FILE_H_INCLUDED
 
-namespace Argum {
 
-    ARGUM_MOD_EXPORTED 
-    template<class Char>
-    auto makeArgSpan(int argc, Char ** argv) -> std::span<const Char *> {
-        if (argc > 0)
-            return std::span(const_cast<const Char **>(argv + 1), size_t(argc - 1));
-        return std::span(const_cast<const Char **>(argv), size_t(0));
-    }
 
-    ARGUM_MOD_EXPORTED
-    template<class Char>
-    class BasicResponseFileReader {
-    public:
-        using CharType = Char;
-        using StringType = std::basic_string<Char>;
-        using StringViewType = std::basic_string_view<Char>;
 
-        struct Exception : public BasicParsingException<CharType> {
-            ARGUM_IMPLEMENT_EXCEPTION(Exception, BasicParsingException<CharType>, Error::ResponseFileError)
+#if !defined(_WIN32) && __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>)
+    #define ARGUM_HAS_MMAP
+#endif
 
-            Exception(const std::filesystem::path & filename_, std::error_code error_): 
-                BasicParsingException<CharType>(ErrorCode,
-                                                format(Messages<CharType>::errorReadingResponseFile(), filename_.native(), error_.message())),
-                filename(filename_),
-                error(error_) {
-            }
-            std::filesystem::path filename;
-            std::error_code error;
-        };
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifdef min
+        #undef min
+    #endif
+    #ifdef max
+        #undef max
+    #endif
+#endif
+
+namespace Argum {
+
+    /**
+     Read-only view of a whole file contents.
 
+     Regular files are memory mapped where the platform supports it. Other files, such as 
+     pipes and character devices, and all files elsewhere are read into an owned buffer. Either way data() stays valid and does not move for the
+     lifetime of the object, including after it is moved from.
+     */
+    class MappedFile {
     public:
-        BasicResponseFileReader(char prefix) {
-            m_prefixes.emplace_back(1, prefix);
+        MappedFile(const std::filesystem::path & path, std::error_code & ec) {
+        #if defined(ARGUM_HAS_MMAP)
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                ec = lastError();
+                return;
+            }
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                ec = lastError();
+                close(fd);
+                return;
+            }
+            if (!S_ISREG(st.st_mode)) {
+                this->readAll([fd](char * buffer, size_t size) -> ptrdiff_t {
+                    for ( ; ; ) {
+                        auto ret = ::read(fd, buffer, size);
+                        if (ret >= 0 || errno != EINTR)
+                            return ret;
+                    }
+                }, ec);
+                close(fd);
+                return;
+            }
+            m_size = size_t(st.st_size);
+            if (m_size != 0) {
+                void * addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    ec = lastError();
+                    m_size = 0;
+                } else {
+                    m_data = static_cast<const char *>(addr);
+                }
+            }
+            close(fd);
+        #elif defined(_WIN32)
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                ec = lastError();
+                return;
+            }
+            if (GetFileType(file) != FILE_TYPE_DISK) {
+                this->readAll([file](char * buffer, size_t size) -> ptrdiff_t {
+                    DWORD read;
+                    if (!ReadFile(file, buffer, DWORD(std::min(size, size_t(MAXDWORD))), &read, nullptr))
+                        return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+                    return ptrdiff_t(read);
+                }, ec);
+                CloseHandle(file);
+                return;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size)) {
+                ec = lastError();
+                CloseHandle(file);
+                return;
+            }
+            m_size = size_t(size.QuadPart);
+            if (m_size != 0) {
+                HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    if (!m_data)
+                        ec = lastError();
+                    CloseHandle(mapping);
+                } else {
+                    ec = lastError();
+                }
+                if (!m_data)
+                    m_size = 0;
+            }
+            CloseHandle(file);
+        #else
+            FILE * fp = fopen(path.string().c_str(), "rb");
+            if (!fp) {
+                ec = lastError();
+                return;
+            }
+            this->readAll([fp](char * buffer, size_t size) -> ptrdiff_t {
+                auto read = fread(buffer, 1, size, fp);
+                if (read == 0 && ferror(fp))
+                    return -1;
+                return ptrdiff_t(read);
+            }, ec);
+            fclose(fp);
+        #endif
         }
-        BasicResponseFileReader(StringType prefix): m_prefixes(1, prefix) {
-            m_prefixes.emplace_back(std::move(prefix));
+        MappedFile(MappedFile && src):
+            m_data(src.m_data),
+            m_size(src.m_size),
+            m_buffer(std::move(src.m_buffer)) {
+            src.m_data = nullptr;
+            src.m_size = 0;
+        }
+        auto operator=(MappedFile && src) -> MappedFile & {
+            if (this != &src) {
+                unmap();
+                m_data = src.m_data;
+                m_size = src.m_size;
+                m_buffer = std::move(src.m_buffer);
+                src.m_data = nullptr;
+                src.m_size = 0;
+            }
+            return *this;
         }
-        BasicResponseFileReader(std::initializer_list<StringType> prefixes): m_prefixes(prefixes) {
+        ~MappedFile() {
+            unmap();
         }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
 
-        auto expand(int argc, CharType ** argv) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
-            return expand(makeArgSpan(argc, argv));
+        auto data() const -> const char * {
+            return m_data;
+        }
+        auto size() const -> size_t {
+            return m_size;
+        }
+    private:
+        //Reads into the owned buffer until readSome(buffer, size) returns 0 or, on error, -1
+        template<class Func>
+        void readAll(Func readSome, std::error_code & ec) {
+            size_t capacity = 0;
+            for ( ; ; ) {
+                if (m_size == capacity) {
+                    capacity = (capacity == 0 ? 64 * 1024 : capacity * 2);
+                    std::unique_ptr<char[]> newBuffer(new char[capacity]);
+                    std::copy(m_buffer.get(), m_buffer.get() + m_size, newBuffer.get());
+                    m_buffer = std::move(newBuffer);
+                }
+                auto read = readSome(m_buffer.get() + m_size, capacity - m_size);
+                if (read <= 0) {
+                    if (read < 0)
+                        ec = lastError();
+                    break;
+                }
+                m_size += size_t(read);
+            }
+            m_data = m_buffer.get();
         }
 
-        template<class Splitter>
-        auto expand(int argc, CharType ** argv, Splitter && splitter) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
-            return expand(makeArgSpan(argc, argv), std::forward<Splitter>(splitter));
+        void unmap() {
+        #if defined(ARGUM_HAS_MMAP)
+            if (m_data && !m_buffer)
+                munmap(const_cast<char *>(m_data), m_size);
+        #elif defined(_WIN32)
+            if (m_data && !m_buffer)
+                UnmapViewOfFile(m_data);
+        #endif
         }
 
-        template<ArgRange<CharType> Args>
-        auto expand(const Args & args) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
-            return expand(args, [](StringType && str, auto dest) {
-                trimInPlace(str);
-                if (str.empty())
-                    return;
-                *dest = std::move(str);
-            });
+        static auto lastError() -> std::error_code {
+        #ifdef _WIN32
+            return std::error_code(int(GetLastError()), std::system_category());
+        #else
+            return std::make_error_code(static_cast<std::errc>(errno));
+        #endif
         }
+    private:
+        const char * m_data = nullptr;
+        size_t m_size = 0;
+        std::unique_ptr<char[]> m_buffer;
+    };
+}
 
-        template<ArgRange<Char> Args, class Splitter>
-        auto expand(const Args & args, Splitter && splitter) -> ARGUM_EXPECTED(CharType, std::vector<StringType>)
-            requires(std::is_invocable_v<decltype(splitter), StringType &&, std::back_insert_iterator<std::vector<StringType>>>) {
-            
-            std::vector<StringType> ret;
-            std::stack<StackEntry> stack;
+#endif
+#ifndef HEADER_ARGUM_RESPONSE_FILE_CACHE_H_INCLUDED
+#define HEADER_ARGUM_RESPONSE_FILE_CACHE_H_INCLUDED
 
-            for(StringViewType arg: args) {
 
-                ARGUM_PROPAGATE_ERROR(this->handleArg(arg, ret, stack, splitter));
 
-                while(!stack.empty()) {
 
-                    auto & entry = stack.top();
-                    if (entry.current == entry.items.end()) {
-                        stack.pop();
-                        continue;
-                    }
-                    ARGUM_PROPAGATE_ERROR(this->handleArg(*entry.current, ret, stack, std::forward<Splitter>(splitter)));
-                    ++entry.current;
-                }
-            }
+#if !defined(_WIN32) && __has_include(<sys/stat.h>)
+#endif
+
+namespace Argum {
+
+    /**
+     Persistent cache of split response file contents.
+
+     Each response file is cached in a separate file in the cache directory. It stores
+     the arguments produced by splitting the response file in a compact binary form
+     together with the key of the source: its path, size, modification time and inode.
+     Entries for `wchar_t` arguments are also keyed by the `LC_CTYPE` locale they were 
+     decoded with.
+     A cached entry is used only if the key still matches. Otherwise the file is re-read
+     and the entry rewritten. When the total size of the cache exceeds the limit the least
+     recently used entries are removed.
+
+     All failures to read or write the cache are silently ignored.
+     */
+    ARGUM_MOD_EXPORTED
+    class ResponseFileCache {
+    public:
+        static constexpr uintmax_t defaultMaxSize = 64 * 1024 * 1024;
+        static constexpr std::string_view extension = ".argum-cache";
+
+        struct FileKey {
+            uint64_t size = 0;
+            int64_t mtime = 0;
+            uint64_t inode = 0;
+
+            friend auto operator==(const FileKey &, const FileKey &) -> bool = default;
+        };
+
+    public:
+        ResponseFileCache(std::filesystem::path directory, uintmax_t maxSize = defaultMaxSize):
+            m_directory(std::move(directory)),
+            m_maxSize(maxSize) {
+        }
+
+        auto directory() const -> const std::filesystem::path & {
+            return this->m_directory;
+        }
+        auto maxSize() const -> uintmax_t {
+            return this->m_maxSize;
+        }
+
+        static auto keyOf(const std::filesystem::path & path, std::error_code & ec) -> FileKey {
+            FileKey ret;
+            ret.size = uint64_t(std::filesystem::file_size(path, ec));
+            if (ec)
+                return ret;
+            ret.mtime = int64_t(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+            if (ec)
+                return ret;
+        #if !defined(_WIN32) && __has_include(<sys/stat.h>)
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0)
+                ret.inode = uint64_t(st.st_ino);
+        #endif
+            return ret;
+        }
+
+        /**
+         Appends cached arguments for `path` to dest.
+
+         Returns false if there is no valid entry for the path, key and splitter.
+         */
+        template<class Char>
+        auto load(const std::filesystem::path & path, const FileKey & key, std::string_view splitterId,
+                  std::vector<std::basic_string<Char>> & dest) const -> bool {
+
+            auto id = identity<Char>(path, splitterId);
+            auto entryPath = this->entryPathFor(id);
+            std::error_code ec;
+            MappedFile file(entryPath, ec);
+            if (ec)
+                return false;
+
+            Reader reader{file.data(), file.data() + file.size()};
+            if (!reader.matchHeader(sizeof(Char), key, id))
+                return false;
+
+            uint64_t count;
+            if (!reader.read(count) || count > reader.remaining() / sizeof(uint64_t))
+                return false;
+            auto initialSize = dest.size();
+            dest.reserve(initialSize + size_t(count));
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t length;
+                if (!reader.read(length) || length > reader.remaining() / sizeof(Char)) {
+                    dest.resize(initialSize);
+                    return false;
+                }
+                auto & arg = dest.emplace_back(size_t(length), Char());
+                reader.read(arg.data(), size_t(length) * sizeof(Char));
+            }
+            //mark as recently used
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), ec);
+            return true;
+        }
+
+        /**
+         Stores arguments for `path`, evicting old entries if the cache grows too large.
+
+         Scanning the cache directory for eviction is done only occasionally: with a probability 
+         proportional to the size of the stored entry so that, on average, it happens once per 
+         1/16 of the maximum size written. The cache may therefore temporarily exceed its maximum 
+         size by about that much.
+         */
+        template<class Char>
+        auto store(const std::filesystem::path & path, const FileKey & key, std::string_view splitterId,
+                   std::span<const std::basic_string<Char>> args) const -> void {
+
+            std::error_code ec;
+            std::filesystem::create_directories(this->m_directory, ec);
+            if (ec)
+                return;
+
+            auto id = identity<Char>(path, splitterId);
+            std::string buffer;
+            size_t size = headerSize(id) + sizeof(uint64_t);
+            for (auto & arg: args)
+                size += sizeof(uint64_t) + arg.size() * sizeof(Char);
+            buffer.reserve(size);
+            writeHeader(buffer, sizeof(Char), key, id);
+            write(buffer, uint64_t(args.size()));
+            for (auto & arg: args) {
+                write(buffer, uint64_t(arg.size()));
+                buffer.append(reinterpret_cast<const char *>(arg.data()), arg.size() * sizeof(Char));
+            }
+
+            //write to a unique temporary and rename so that concurrent readers never see partial entries
+            auto entryPath = this->entryPathFor(id);
+            auto tempPath = entryPath;
+            tempPath += "." + std::to_string(randomNumber()) + temporaryExtension;
+            FILE * fp = openFile(tempPath);
+            if (!fp)
+                return;
+            bool written = (fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size());
+            written = (fclose(fp) == 0) && written;
+            if (written)
+                std::filesystem::rename(tempPath, entryPath, ec);
+            if (!written || ec) {
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+            auto evictionThreshold = std::max(this->m_maxSize / 16, uintmax_t(1));
+            if (buffer.size() >= evictionThreshold || randomNumber() % evictionThreshold < buffer.size())
+                this->evict();
+        }
+
+        //Removes all cache entries and temporaries left behind by writers that did not finish
+        auto clear() const -> void {
+            std::error_code ec;
+            auto now = std::filesystem::file_time_type::clock::now();
+            for (auto & item: std::filesystem::directory_iterator(this->m_directory, ec)) {
+                auto kind = kindOf(item.path());
+                if (kind == FileKind::entry || (kind == FileKind::temporary && isStale(item, now)))
+                    std::filesystem::remove(item.path(), ec);
+            }
+        }
+
+    private:
+        static constexpr char magic[8] = {'A', 'R', 'G', 'U', 'M', 'R', 'C', '1'};
+        static constexpr char temporaryExtension[] = ".tmp";
+        //temporaries older than this are assumed to be left behind by a writer that crashed or was killed
+        static constexpr auto staleTemporaryAge = std::chrono::minutes(1);
+
+        enum class FileKind {
+            other,
+            entry,
+            temporary
+        };
+
+        struct Reader {
+            const char * current;
+            const char * last;
+
+            auto remaining() const -> size_t {
+                return size_t(last - current);
+            }
+            auto read(void * dest, size_t size) -> bool {
+                if (remaining() < size)
+                    return false;
+                memcpy(dest, current, size);
+                current += size;
+                return true;
+            }
+            template<class T>
+            auto read(T & val) -> bool {
+                return read(&val, sizeof(T));
+            }
+            auto matchHeader(uint32_t charSize, const FileKey & key, std::string_view id) -> bool {
+                char storedMagic[sizeof(magic)];
+                uint32_t storedCharSize;
+                FileKey storedKey;
+                uint64_t idSize;
+                if (!read(storedMagic) || memcmp(storedMagic, magic, sizeof(magic)) != 0 ||
+                    !read(storedCharSize) || storedCharSize != charSize ||
+                    !read(storedKey.size) || !read(storedKey.mtime) || !read(storedKey.inode) || storedKey != key ||
+                    !read(idSize) || idSize != id.size() || remaining() < id.size() ||
+                    memcmp(current, id.data(), id.size()) != 0)
+                    return false;
+                current += id.size();
+                return true;
+            }
+        };
+
+        template<class T>
+        static auto write(std::string & dest, const T & val) -> void {
+            dest.append(reinterpret_cast<const char *>(&val), sizeof(T));
+        }
+
+        static auto headerSize(std::string_view id) -> size_t {
+            return sizeof(magic) + sizeof(uint32_t) + 3 * sizeof(uint64_t) + sizeof(uint64_t) + id.size();
+        }
+
+        static auto writeHeader(std::string & dest, uint32_t charSize, const FileKey & key, std::string_view id) -> void {
+            dest.append(magic, sizeof(magic));
+            write(dest, charSize);
+            write(dest, key.size);
+            write(dest, key.mtime);
+            write(dest, key.inode);
+            write(dest, uint64_t(id.size()));
+            dest.append(id);
+        }
+
+        //full identity of an entry: the source path, splitter and, for wide characters, the locale used to decode them
+        template<class Char>
+        static auto identity(const std::filesystem::path & path, std::string_view splitterId) -> std::string {
+            auto & native = path.native();
+            std::string ret(reinterpret_cast<const char *>(native.data()), native.size() * sizeof(native[0]));
+            ret += '\0';
+            ret += splitterId;
+            if constexpr (!std::is_same_v<Char, char>) {
+                ret += '\0';
+                if (auto locale = setlocale(LC_CTYPE, nullptr))
+                    ret += locale;
+            }
+            return ret;
+        }
+
+        auto entryPathFor(std::string_view id) const -> std::filesystem::path {
+            //FNV-1a
+            uint64_t hash = 14695981039346656037ull;
+            for (auto c: id) {
+                hash ^= uint64_t(static_cast<unsigned char>(c));
+                hash *= 1099511628211ull;
+            }
+            char name[17];
+            snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+            auto ret = this->m_directory / name;
+            ret += extension;
+            return ret;
+        }
+
+        //Entries are named <hash><extension> and temporaries <hash><extension>.<random><temporaryExtension>
+        static auto kindOf(const std::filesystem::path & path) -> FileKind {
+            if (path.extension() == extension)
+                return FileKind::entry;
+            if (path.extension() == temporaryExtension && path.stem().stem().extension() == extension)
+                return FileKind::temporary;
+            return FileKind::other;
+        }
+
+        static auto isStale(const std::filesystem::directory_entry & item, std::filesystem::file_time_type now) -> bool {
+            std::error_code ec;
+            auto time = item.last_write_time(ec);
+            return !ec && now - time > staleTemporaryAge;
+        }
+
+        static auto openFile(const std::filesystem::path & path) -> FILE * {
+        #ifndef _MSC_VER
+            return fopen(path.string().c_str(), "wb");
+        #else
+            return _wfopen(path.native().c_str(), L"wb");
+        #endif
+        }
+
+        //process-wide generator for temporary names and eviction sampling, seeded once
+        static auto randomNumber() -> uint64_t {
+            static std::mutex mutex;
+            static std::mt19937_64 generator{std::random_device()()};
+            std::lock_guard lock(mutex);
+            return generator();
+        }
+
+        auto evict() const -> void {
+            struct Entry {
+                std::filesystem::path path;
+                std::filesystem::file_time_type time;
+                uintmax_t size;
+            };
+            std::vector<Entry> entries;
+            uintmax_t total = 0;
+            std::error_code ec;
+            auto now = std::filesystem::file_time_type::clock::now();
+            for (auto & item: std::filesystem::directory_iterator(this->m_directory, ec)) {
+                auto kind = kindOf(item.path());
+                if (kind == FileKind::other)
+                    continue;
+                if (kind == FileKind::temporary && isStale(item, now)) {
+                    std::filesystem::remove(item.path(), ec);
+                    continue;
+                }
+                Entry entry{item.path(), item.last_write_time(ec), item.file_size(ec)};
+                if (ec)
+                    continue;
+                total += entry.size;
+                //temporaries still being written count towards the size but cannot be removed
+                if (kind == FileKind::entry)
+                    entries.emplace_back(std::move(entry));
+            }
+            if (total <= this->m_maxSize)
+                return;
+            std::sort(entries.begin(), entries.end(), [](const Entry & lhs, const Entry & rhs) {
+                return lhs.time < rhs.time;
+            });
+            for (auto & entry: entries) {
+                if (total <= this->m_maxSize)
+                    break;
+                if (std::filesystem::remove(entry.path, ec))
+                    total -= entry.size;
+            }
+        }
+    private:
+        std::filesystem::path m_directory;
+        uintmax_t m_maxSize;
+    };
+}
+
+#endif
+#ifndef HEADER_ARGUM_BINARY_RESPONSE_FILE_H_INCLUDED
+#define HEADER_ARGUM_BINARY_RESPONSE_FILE_H_INCLUDED
+
+
+
+
+namespace Argum {
+
+    /**
+     Binary response file format.
+
+     All integers are in native byte order.
+     - header: 8 bytes of `magic`, `uint32_t` character size in bytes, `uint32_t` reserved
+       (must be 0), `uint64_t` number of arguments
+     - for each argument: `uint64_t` length in characters followed by the characters,
+       padded with zeroes to a multiple of 8 bytes
+
+     Arguments are used as is, without any splitting, trimming or unquoting. Character size 1
+     means narrow multibyte text in the same encoding as text response files. When reading
+     with `wchar_t` such files are decoded. Otherwise the character size must match the
+     character type used to read the file.
+     */
+    ARGUM_MOD_EXPORTED
+    struct BinaryResponseFile {
+        static constexpr char magic[8] = {'A', 'R', 'G', 'U', 'M', 'B', 'R', 'F'};
+        static constexpr size_t headerSize = sizeof(magic) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+        static constexpr size_t alignment = 8;
+
+        static auto isBinary(const char * data, size_t size) -> bool {
+            return size >= sizeof(magic) && memcmp(data, magic, sizeof(magic)) == 0;
+        }
+
+        static constexpr auto paddedSize(size_t size) -> size_t {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+    };
+
+    namespace Impl {
+
+        //Iterates over arguments of a validated binary response file image
+        template<class Char>
+        class BinaryArgsCursor {
+        public:
+            using StringViewType = std::basic_string_view<Char>;
+
+            BinaryArgsCursor() = default;
+            BinaryArgsCursor(const char * first, uint64_t count): m_current(first), m_count(count) {
+            }
+
+            auto empty() const -> bool {
+                return this->m_count == 0;
+            }
+            auto position() const -> const char * {
+                return this->m_current;
+            }
+
+            auto next() -> StringViewType {
+                uint64_t length;
+                memcpy(&length, this->m_current, sizeof(length));
+                auto data = reinterpret_cast<const Char *>(this->m_current + sizeof(length));
+                this->m_current += sizeof(length) + BinaryResponseFile::paddedSize(size_t(length) * sizeof(Char));
+                --this->m_count;
+                return StringViewType(data, size_t(length));
+            }
+
+        private:
+            const char * m_current = nullptr;
+            uint64_t m_count = 0;
+        };
+
+        struct BinaryHeader {
+            uint32_t charSize;
+            uint64_t count;
+        };
+
+        //Checks that the whole image is well formed
+        inline auto validateBinaryArgs(const char * data, size_t size, BinaryHeader & header) -> std::error_code {
+            auto invalid = std::make_error_code(std::errc::illegal_byte_sequence);
+            if (size < BinaryResponseFile::headerSize || !BinaryResponseFile::isBinary(data, size))
+                return invalid;
+            uint32_t reserved;
+            memcpy(&header.charSize, data + sizeof(BinaryResponseFile::magic), sizeof(uint32_t));
+            memcpy(&reserved, data + sizeof(BinaryResponseFile::magic) + sizeof(uint32_t), sizeof(uint32_t));
+            memcpy(&header.count, data + sizeof(BinaryResponseFile::magic) + 2 * sizeof(uint32_t), sizeof(uint64_t));
+            if (reserved != 0 || (header.charSize != 1 && header.charSize != 2 && header.charSize != 4))
+                return invalid;
+
+            size_t remaining = size - BinaryResponseFile::headerSize;
+            const char * current = data + BinaryResponseFile::headerSize;
+            for (uint64_t i = 0; i < header.count; ++i) {
+                uint64_t length;
+                if (remaining < sizeof(length))
+                    return invalid;
+                memcpy(&length, current, sizeof(length));
+                remaining -= sizeof(length);
+                current += sizeof(length);
+                if (length > remaining / header.charSize)
+                    return invalid;
+                auto recordSize = std::min(BinaryResponseFile::paddedSize(size_t(length) * header.charSize), remaining);
+                remaining -= recordSize;
+                current += recordSize;
+            }
+            return {};
+        }
+
+        /**
+         Prepares a cursor over a binary response file image.
+
+         If the image is narrow and Char is `wchar_t` the arguments are decoded into a new wide
+         image stored in `decoded`.
+         */
+        template<class Char>
+        auto openBinaryArgs(const char * data, size_t size, std::unique_ptr<Char[]> & decoded,
+                            BinaryArgsCursor<Char> & cursor) -> std::error_code {
+
+            BinaryHeader header;
+            if (auto err = validateBinaryArgs(data, size, header))
+                return err;
+
+            if (header.charSize == sizeof(Char)) {
+                cursor = BinaryArgsCursor<Char>(data + BinaryResponseFile::headerSize, header.count);
+                return {};
+            }
+            if constexpr (std::is_same_v<Char, wchar_t>) {
+                if (header.charSize == 1) {
+                    //decoded text is never longer than its multibyte encoding and records only grow
+                    //by the character size
+                    size_t capacity = (BinaryResponseFile::headerSize + (size - BinaryResponseFile::headerSize) * sizeof(wchar_t) +
+                                       size_t(header.count) * BinaryResponseFile::alignment) / sizeof(wchar_t) + 1;
+                    decoded.reset(new wchar_t[capacity]);
+                    char * const start = reinterpret_cast<char *>(decoded.get());
+                    char * out = start + BinaryResponseFile::headerSize;
+                    BinaryArgsCursor<char> source(data + BinaryResponseFile::headerSize, header.count);
+                    while (!source.empty()) {
+                        auto arg = source.next();
+                        auto dest = reinterpret_cast<wchar_t *>(out + sizeof(uint64_t));
+                        uint64_t length = 0;
+                        mbstate_t state = mbstate_t();
+                        for (size_t pos = 0; pos < arg.size(); ) {
+                            auto byte = static_cast<unsigned char>(arg[pos]);
+                            if (byte < 0x80 && mbsinit(&state)) {
+                                dest[length++] = wchar_t(byte);
+                                ++pos;
+                                continue;
+                            }
+                            size_t res = mbrtowc(dest + length, arg.data() + pos, arg.size() - pos, &state);
+                            if (res == size_t(-1) || res == size_t(-2))
+                                return std::make_error_code(std::errc::illegal_byte_sequence);
+                            ++length;
+                            pos += (res == 0 ? 1 : res);
+                        }
+                        memcpy(out, &length, sizeof(length));
+                        auto recordSize = BinaryResponseFile::paddedSize(size_t(length) * sizeof(wchar_t));
+                        memset(out + sizeof(uint64_t) + size_t(length) * sizeof(wchar_t), 0, recordSize - size_t(length) * sizeof(wchar_t));
+                        out += sizeof(uint64_t) + recordSize;
+                    }
+                    cursor = BinaryArgsCursor<Char>(start + BinaryResponseFile::headerSize, header.count);
+                    return {};
+                }
+            }
+            return std::make_error_code(std::errc::illegal_byte_sequence);
+        }
+    }
+}
+
+#endif
+
+
+namespace Argum {
+
+    ARGUM_MOD_EXPORTED 
+    template<class Char>
+    auto makeArgSpan(int argc, Char ** argv) -> std::span<const Char *> {
+        if (argc > 0)
+            return std::span(const_cast<const Char **>(argv + 1), size_t(argc - 1));
+        return std::span(const_cast<const Char **>(argv), size_t(0));
+    }
+
+    /**
+     Owns text of arguments that a splitter had to construct rather than point into the line
+     it was given, for example unescaped quoted strings.
+
+     Splitters used with BasicResponseFileReader::expandMapped() or expandLazily() receive 
+     it as an optional third argument. Memory is allocated in large chunks and stays valid 
+     for the lifetime of the store, including after it is moved.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicArgumentStore {
+    public:
+        //Returns uninitialized space for size characters
+        auto allocate(size_t size) -> Char * {
+            if (this->m_available < size) {
+                size_t allocSize = std::max(size, chunkSize);
+                this->m_chunks.emplace_back(new Char[allocSize]);
+                this->m_next = this->m_chunks.back().get();
+                this->m_available = allocSize;
+            }
+            auto ret = this->m_next;
+            this->m_next += size;
+            this->m_available -= size;
+            return ret;
+        }
+
+        //Returns the unused tail of the most recent allocation to the store
+        auto shrink(Char * ptr, size_t size, size_t newSize) -> void {
+            if (ptr + size == this->m_next) {
+                this->m_next -= (size - newSize);
+                this->m_available += (size - newSize);
+            }
+        }
+    private:
+        static constexpr size_t chunkSize = 16 * 1024;
+
+        std::vector<std::unique_ptr<Char[]>> m_chunks;
+        Char * m_next = nullptr;
+        size_t m_available = 0;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ArgumentStore)
+
+    namespace Impl {
+        //Keeps alive memory that expanded argument views point into
+        template<class Char>
+        struct ResponseFileStorage {
+            std::vector<MappedFile> mappings;
+            std::vector<std::unique_ptr<Char[]>> decoded;
+            BasicArgumentStore<Char> strings;
+        };
+
+        /**
+         Response files seen during a single expansion, keyed by canonical path so that each
+         file is read once no matter how many times and by which names it is referenced.
+         Names that have no canonical path, such as missing files or the `/dev/fd/N` names of 
+         pipes, are keyed by the name itself. Errors for them are reported when the file is read.
+
+         Names are remembered too so that repeated references by the same name do not touch 
+         the file system. Entries never move once created.
+         */
+        template<class Char, class Contents>
+        class LoadedResponseFiles {
+        public:
+            struct Entry {
+                Contents contents;
+                bool loaded = false;
+                //number of times the file is currently being expanded
+                unsigned active = 0;
+            };
+
+            auto find(std::basic_string_view<Char> filename) const -> Entry * {
+                auto it = this->m_byName.find(filename);
+                return it != this->m_byName.end() ? it->second : nullptr;
+            }
+
+            auto add(std::basic_string_view<Char> filename, const std::filesystem::path & canonicalPath) -> Entry * {
+                auto & entry = this->m_byPath[canonicalPath];
+                this->m_byName.emplace(std::basic_string<Char>(filename), &entry);
+                return &entry;
+            }
+
+            auto get(std::basic_string_view<Char> filename) -> Entry * {
+                if (auto ret = this->find(filename))
+                    return ret;
+                return this->add(filename, LoadedResponseFiles::keyFor(filename));
+            }
+
+            //Unresolvable names cannot collide with canonical paths, which are absolute and contain no links
+            static auto keyFor(std::basic_string_view<Char> filename) -> std::filesystem::path {
+                std::filesystem::path path(filename);
+                std::error_code ec;
+                auto canonicalPath = std::filesystem::canonical(path, ec);
+                if (ec)
+                    return path;
+                return canonicalPath;
+            }
+        private:
+            std::map<std::filesystem::path, Entry> m_byPath;
+            std::map<std::basic_string<Char>, Entry *, std::less<>> m_byName;
+        };
+
+        template<class Splitter, class Char>
+        concept MappedSplitter = 
+            std::is_invocable_v<Splitter, std::basic_string_view<Char>, std::back_insert_iterator<std::vector<std::basic_string_view<Char>>>> ||
+            std::is_invocable_v<Splitter, std::basic_string_view<Char>, std::back_insert_iterator<std::vector<std::basic_string_view<Char>>>, 
+                                BasicArgumentStore<Char> &>;
+    }
+
+    /**
+     Result of BasicResponseFileReader::expandMapped()
+
+     Holds the expanded arguments as string views together with the storage they 
+     point into: memory mappings of the response files (or, for `wchar_t`, their decoded 
+     contents). Arguments that came from the original command line refer to the original
+     strings which must outlive this object.
+
+     This is an ArgRange so it can be passed to BasicParser::parse() directly.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicExpandedArgs {
+    public:
+        using CharType = Char;
+        using StringViewType = std::basic_string_view<Char>;
+        using const_iterator = typename std::vector<StringViewType>::const_iterator;
+        using iterator = const_iterator;
+
+    public:
+        BasicExpandedArgs() = default;
+        BasicExpandedArgs(BasicExpandedArgs &&) = default;
+        auto operator=(BasicExpandedArgs &&) -> BasicExpandedArgs & = default;
+
+        auto begin() const -> const_iterator {
+            return this->m_args.begin();
+        }
+        auto end() const -> const_iterator {
+            return this->m_args.end();
+        }
+        auto size() const -> size_t {
+            return this->m_args.size();
+        }
+        auto empty() const -> bool {
+            return this->m_args.empty();
+        }
+        auto operator[](size_t idx) const -> StringViewType {
+            return this->m_args[idx];
+        }
+
+    private:
+        template<class> friend class BasicResponseFileReader;
+
+        Impl::ResponseFileStorage<CharType> m_storage;
+        std::vector<StringViewType> m_args;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ExpandedArgs)
+
+    ARGUM_MOD_EXPORTED template<class Char> class BasicLazyExpandedArgs;
+
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicResponseFileReader {
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+
+        struct Exception : public BasicParsingException<CharType> {
+            ARGUM_IMPLEMENT_EXCEPTION(Exception, BasicParsingException<CharType>, Error::ResponseFileError)
+
+            Exception(const std::filesystem::path & filename_, std::error_code error_): 
+                Exception(ErrorCode, filename_, error_) {
+            }
+            std::filesystem::path filename;
+            std::error_code error;
+        protected:
+            Exception(Error code, const std::filesystem::path & filename_, std::error_code error_): 
+                BasicParsingException<CharType>(code),
+                filename(filename_),
+                error(error_) {
+            }
+
+            auto formatMessage() const -> StringType override {
+                return format<Messages<CharType>::errorReadingResponseFile>(this->filename.native(), this->error.message());
+            }
+        };
+
+        //Reported when a response file references itself, directly or through other files
+        struct CycleException : public Exception {
+            ARGUM_IMPLEMENT_EXCEPTION(CycleException, BasicParsingException<CharType>, Error::ResponseFileCycle)
+
+            CycleException(const std::filesystem::path & filename_):
+                Exception(ErrorCode, filename_, std::make_error_code(std::errc::too_many_symbolic_link_levels)) {
+            }
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages<CharType>::responseFileCycle>(this->filename.native());
+            }
+        };
+
+    public:
+        BasicResponseFileReader(char prefix) {
+            m_prefixes.emplace_back(1, prefix);
+        }
+        BasicResponseFileReader(StringType prefix): m_prefixes(1, prefix) {
+            m_prefixes.emplace_back(std::move(prefix));
+        }
+        BasicResponseFileReader(std::initializer_list<StringType> prefixes): m_prefixes(prefixes) {
+        }
+
+        auto expand(int argc, CharType ** argv) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expand(makeArgSpan(argc, argv));
+        }
+
+        template<class Splitter>
+        auto expand(int argc, CharType ** argv, Splitter && splitter) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expand(makeArgSpan(argc, argv), std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expand(const Args & args) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expand(args, DefaultSplitter());
+        }
+
+        template<ArgRange<Char> Args, class Splitter>
+        auto expand(const Args & args, Splitter && splitter) -> ARGUM_EXPECTED(CharType, std::vector<StringType>)
+            requires(std::is_invocable_v<decltype(splitter), StringType &&, std::back_insert_iterator<std::vector<StringType>>>) {
+            
+            std::vector<StringType> ret;
+            LoadedFiles files;
+            std::stack<StackEntry> stack;
+
+            for(StringViewType arg: args) {
+
+                ARGUM_PROPAGATE_ERROR(this->handleArg(arg, ret, stack, files, splitter));
+
+                while(!stack.empty()) {
+
+                    auto & entry = stack.top();
+                    if (entry.current == entry.file->contents.size()) {
+                        --entry.file->active;
+                        stack.pop();
+                        continue;
+                    }
+                    StringViewType item = entry.file->contents[entry.current++];
+                    ARGUM_PROPAGATE_ERROR(this->handleArg(item, ret, stack, files, splitter));
+                }
+            }
+            return ret;
+        }
+        /**
+         Expands response files without copying their contents into individual strings.
+
+         Each response file is memory mapped and the resulting arguments are views into 
+         the mapping. For `wchar_t` the file is decoded as a whole into a single buffer 
+         instead. 
+
+         The optional splitter is called as `splitter(line, dest)` with each line as a string 
+         view and must assign to `*dest` views that point into that line. If it needs to 
+         produce arguments that are not part of the line it can instead accept 
+         `splitter(line, dest, store)` and place them in the BasicArgumentStore.
+
+         Binary response files (see BinaryResponseFile) are expanded without any parsing: 
+         their arguments are views directly into the mapping (unless they need decoding) 
+         and the splitter is not called for them. This also applies to all other expansion 
+         methods.
+         */
+        auto expandMapped(int argc, CharType ** argv) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>) {
+            return expandMapped(makeArgSpan(argc, argv));
+        }
+
+        template<class Splitter>
+        auto expandMapped(int argc, CharType ** argv, Splitter && splitter) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>) {
+            return expandMapped(makeArgSpan(argc, argv), std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expandMapped(const Args & args) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>) {
+            return expandMapped(args, [](StringViewType line, auto dest) {
+                line = trim(line);
+                if (line.empty())
+                    return;
+                *dest = line;
+            });
+        }
+
+        template<ArgRange<CharType> Args, class Splitter>
+        auto expandMapped(const Args & args, Splitter && splitter) -> ARGUM_EXPECTED(CharType, BasicExpandedArgs<CharType>)
+            requires(Impl::MappedSplitter<decltype(splitter), CharType>) {
+
+            BasicExpandedArgs<CharType> ret;
+            MappedFiles files;
+            std::stack<MappedStackEntry> stack;
+
+            for(StringViewType arg: args) {
+
+                ARGUM_PROPAGATE_ERROR(this->handleMappedArg(arg, ret, stack, files));
+
+                while(!stack.empty()) {
+
+                    auto & entry = stack.top();
+                    if (entry.current == entry.pending.size()) {
+                        if (entry.source.empty()) {
+                            entry.file->contents.second = ret.m_args.size();
+                            entry.file->loaded = true;
+                            --entry.file->active;
+                            stack.pop();
+                            continue;
+                        }
+                        entry.pending.clear();
+                        entry.current = 0;
+                        entry.source.next(entry.pending, splitter, ret.m_storage.strings);
+                        continue;
+                    }
+                    auto item = entry.pending[entry.current++];
+                    ARGUM_PROPAGATE_ERROR(this->handleMappedArg(item, ret, stack, files));
+                }
+            }
+            return ret;
+        }
+
+        /**
+         Expands response files on demand while the result is iterated.
+
+         Returns a forward range that reads response files only when iteration reaches them.
+         The memory used by the iteration is bounded by the nesting depth of response files
+         rather than by the number of arguments. Files are mapped the same way as by 
+         expandMapped() and stay mapped for the lifetime of the returned object. The 
+         splitter requirements are the same as for expandMapped(). The original arguments 
+         must outlive the result.
+
+         Errors are reported during iteration: by throwing an exception or, when using
+         BasicExpected, by ending the iteration and storing the error in 
+         BasicLazyExpandedArgs::error(). BasicParser::parse() handles both.
+         */
+        auto expandLazily(int argc, CharType ** argv) const -> BasicLazyExpandedArgs<CharType> {
+            return expandLazily(makeArgSpan(argc, argv));
+        }
+
+        template<class Splitter>
+        auto expandLazily(int argc, CharType ** argv, Splitter && splitter) const -> BasicLazyExpandedArgs<CharType> {
+            return expandLazily(makeArgSpan(argc, argv), std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expandLazily(const Args & args) const -> BasicLazyExpandedArgs<CharType> {
+            return expandLazily(args, [](StringViewType line, auto dest) {
+                line = trim(line);
+                if (line.empty())
+                    return;
+                *dest = line;
+            });
+        }
+
+        template<ArgRange<CharType> Args, class Splitter>
+        auto expandLazily(const Args & args, Splitter && splitter) const -> BasicLazyExpandedArgs<CharType>
+            requires(Impl::MappedSplitter<decltype(splitter), CharType>) {
+
+            std::vector<StringViewType> views;
+            for(StringViewType arg: args)
+                views.push_back(arg);
+            return BasicLazyExpandedArgs<CharType>(this->m_prefixes, std::move(views), std::forward<Splitter>(splitter));
+        }
+
+        /**
+         Expands response files reading them concurrently.
+
+         All response file arguments are located up front and read, together with response
+         files they reference, on up to `threadCount` threads (including the calling one).
+         Passing 0 uses a small default based on the number of available processors.
+         The results are then spliced in the original order and errors are reported exactly 
+         as by expand(). 
+         
+         This is beneficial when there are many response files or they reside on slow 
+         storage. The splitter is invoked concurrently and must be thread safe.
+         */
+        auto expandConcurrently(int argc, CharType ** argv, unsigned threadCount = 0) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expandConcurrently(makeArgSpan(argc, argv), threadCount);
+        }
+
+        template<class Splitter>
+        auto expandConcurrently(int argc, CharType ** argv, unsigned threadCount, Splitter && splitter) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expandConcurrently(makeArgSpan(argc, argv), threadCount, std::forward<Splitter>(splitter));
+        }
+
+        template<ArgRange<CharType> Args>
+        auto expandConcurrently(const Args & args, unsigned threadCount = 0) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return expandConcurrently(args, threadCount, DefaultSplitter());
+        }
+
+        template<ArgRange<CharType> Args, class Splitter>
+        auto expandConcurrently(const Args & args, unsigned threadCount, Splitter && splitter) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>)
+            requires(std::is_invocable_v<decltype(splitter), StringType &&, std::back_insert_iterator<std::vector<StringType>>>) {
+
+            if (threadCount == 0)
+                threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+
+            //1. Find response files on the command line
+            PrefetchFiles files;
+            std::mutex mutex;
+            PrefetchNode root;
+            for(StringViewType arg: args) {
+                if (auto prefixSize = findPrefix(this->m_prefixes, arg))
+                    root.nested.emplace_back(root.items.size(), registerPrefetch(arg.substr(*prefixSize), root, files, mutex));
+                root.items.emplace_back(arg);
+            }
+
+            //2. Read them and the files they reference
+            if (!root.discovered.empty()) {
+                std::condition_variable cond;
+                std::deque<PrefetchNode *> pending(root.discovered.begin(), root.discovered.end());
+                size_t active = 0;
+
+                auto work = [&]() {
+                    std::unique_lock lock(mutex);
+                    for ( ; ; ) {
+                        cond.wait(lock, [&]() { return !pending.empty() || active == 0; });
+                        if (pending.empty())
+                            break;
+                        auto node = pending.front();
+                        pending.pop_front();
+                        ++active;
+                        lock.unlock();
+                        this->prefetch(*node, splitter, files, mutex);
+                        lock.lock();
+                    #ifndef ARGUM_NO_THROW
+                        try {
+                    #endif
+                            pending.insert(pending.end(), node->discovered.begin(), node->discovered.end());
+                    #ifndef ARGUM_NO_THROW
+                        } catch(...) {
+                            //files that cannot be queued are never read
+                            for (auto discovered: node->discovered)
+                                discovered->exception = std::current_exception();
+                        }
+                    #endif
+                        --active;
+                        cond.notify_all();
+                    }
+                };
+
+                std::vector<std::thread> threads;
+            #ifndef ARGUM_NO_THROW
+                try {
+            #endif
+                    threads.reserve(threadCount - 1);
+                    for (unsigned i = 1; i < threadCount; ++i)
+                        threads.emplace_back(work);
+            #ifndef ARGUM_NO_THROW
+                } catch(...) {
+                    //proceed with the threads that were started
+                }
+            #endif
+                work();
+                for (auto & thread: threads)
+                    thread.join();
+            }
+
+            //3. Splice the results in order
+            std::vector<StringType> ret;
+            countUses(root);
+            ARGUM_PROPAGATE_ERROR(splice(root, ret));
+            return ret;
+        }
+
+        /**
+         Enables persistent caching of split response files in the given directory.
+
+         Applies to expand() and expandConcurrently(). Results of the default splitter 
+         are always cached. Results of a custom splitter are cached only if `splitterId` is
+         not empty. It must uniquely identify the splitter behavior, so change it whenever 
+         the splitter changes.
+
+         See ResponseFileCache for details.
+         */
+        auto enableCache(std::filesystem::path directory, 
+                         uintmax_t maxSize = ResponseFileCache::defaultMaxSize,
+                         std::string splitterId = {}) -> BasicResponseFileReader & {
+            this->m_cache.emplace(std::move(directory), maxSize);
+            this->m_splitterId = std::move(splitterId);
+            return *this;
+        }
+
+        auto disableCache() -> BasicResponseFileReader & {
+            this->m_cache.reset();
+            this->m_splitterId.clear();
+            return *this;
+        }
+
+    private:
+        template<class> friend class BasicLazyExpandedArgs;
+
+        struct DefaultSplitter {
+            template<class OutIt>
+            void operator()(StringType && str, OutIt dest) const {
+                trimInPlace(str);
+                if (str.empty())
+                    return;
+                *dest = std::move(str);
+            }
+        };
+        static constexpr std::string_view defaultSplitterId = "argum-trimmed-lines";
+
+        using LoadedFiles = Impl::LoadedResponseFiles<CharType, std::vector<StringType>>;
+
+        struct StackEntry {
+            typename LoadedFiles::Entry * file;
+            size_t current;
+        };
+
+        template<class Splitter>
+        auto handleArg(StringViewType arg, std::vector<StringType> & dest, 
+                       std::stack<StackEntry> & stack, LoadedFiles & files,
+                       Splitter & splitter) -> ARGUM_EXPECTED(CharType, void) {
+
+            if (auto prefixSize = findPrefix(this->m_prefixes, arg)) {
+                auto filename = arg.substr(*prefixSize);
+                typename LoadedFiles::Entry * file;
+                ARGUM_CHECK_RESULT(file, enter(files, filename));
+                if (!file->loaded) {
+                    ARGUM_PROPAGATE_ERROR(this->readResponseFile(filename, file->contents, splitter));
+                    file->loaded = true;
+                }
+                stack.push(StackEntry{file, 0});
+            } else {
+                dest.emplace_back(arg);
+            }
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        //Finds the file and marks it as being expanded, failing if it already is
+        template<class Files>
+        static auto enter(Files & files, StringViewType filename) -> ARGUM_EXPECTED(CharType, typename Files::Entry *) {
+            auto file = files.get(filename);
+            if (file->active)
+                ARGUM_THROW(CycleException, std::filesystem::path(filename));
+            ++file->active;
+            return file;
+        }
+    
+        template<class Splitter>
+        auto readResponseFile(StringViewType filename, std::vector<StringType> & dest, 
+                              Splitter && splitter) const -> ARGUM_EXPECTED(CharType, void){
+
+            std::filesystem::path path(filename);
+            if (auto error = this->loadLines(path, dest, std::forward<Splitter>(splitter)))
+                ARGUM_THROW(Exception, path, error);
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        //Reads lines using the cache if enabled
+        template<class Splitter>
+        auto loadLines(const std::filesystem::path & path, std::vector<StringType> & dest, 
+                       Splitter && splitter) const -> std::error_code {
+            
+            std::string_view splitterId;
+            if (this->m_cache) {
+                if constexpr (std::is_same_v<std::remove_cvref_t<Splitter>, DefaultSplitter>)
+                    splitterId = defaultSplitterId;
+                else
+                    splitterId = this->m_splitterId;
+            }
+            if (splitterId.empty())
+                return readLines(path, dest, std::forward<Splitter>(splitter));
+
+            std::error_code ec;
+            auto absolutePath = std::filesystem::absolute(path, ec);
+            ResponseFileCache::FileKey key;
+            if (!ec)
+                key = ResponseFileCache::keyOf(absolutePath, ec);
+            if (ec)
+                return readLines(path, dest, std::forward<Splitter>(splitter));
+            
+            if (this->m_cache->load(absolutePath, key, splitterId, dest))
+                return {};
+            
+            auto start = dest.size();
+            auto error = readLines(path, dest, std::forward<Splitter>(splitter));
+            if (!error)
+                this->m_cache->store(absolutePath, key, splitterId, std::span<const StringType>(dest.data() + start, dest.size() - start));
+            return error;
+        }
+
+        template<class Splitter>
+        static auto readLines(const std::filesystem::path & path, std::vector<StringType> & dest, 
+                              Splitter && splitter) -> std::error_code {
+            std::error_code error;
+            SimpleFile file(path, "r", error);
+            if (!file)
+                return error;
+
+            auto start = file.peek(sizeof(BinaryResponseFile::magic), error);
+            if (error)
+                return error;
+            if (BinaryResponseFile::isBinary(start.data(), start.size()))
+                return readBinary(path, dest);
+
+            do {
+                StringType line = file.readLine<CharType>(error);
+                if (error)
+                    return error;
+                
+                if (!line.empty())
+                    splitter(std::move(line), std::back_inserter(dest));
+            } while(!file.eof());
+
+            return error;
+        }
+
+        static auto readBinary(const std::filesystem::path & path, std::vector<StringType> & dest) -> std::error_code {
+            std::error_code error;
+            MappedFile file(path, error);
+            if (error)
+                return error;
+            std::unique_ptr<CharType[]> decoded;
+            Impl::BinaryArgsCursor<CharType> cursor;
+            if ((error = Impl::openBinaryArgs(file.data(), file.size(), decoded, cursor)))
+                return error;
+            while (!cursor.empty())
+                dest.emplace_back(cursor.next());
+            return error;
+        }
+
+        //A response file read ahead of time by expandConcurrently()
+        struct PrefetchNode {
+            StringType filename;
+            std::vector<StringType> items;
+            //indices of items that are response file references and their contents
+            std::vector<std::pair<size_t, PrefetchNode *>> nested;
+            //referenced files seen for the first time when reading this one
+            std::vector<PrefetchNode *> discovered;
+            //number of times the node is yet to be spliced
+            size_t uses = 0;
+            bool active = false;
+            std::error_code error;
+        #ifndef ARGUM_NO_THROW
+            std::exception_ptr exception;
+        #endif
+        };
+        using PrefetchFiles = Impl::LoadedResponseFiles<CharType, PrefetchNode>;
+
+        //Returns the node for a reference from parent, adding it to parent.discovered if it needs to be read
+        static auto registerPrefetch(StringViewType filename, PrefetchNode & parent, 
+                                     PrefetchFiles & files, std::mutex & mutex) -> PrefetchNode * {
+            typename PrefetchFiles::Entry * file;
+            {
+                std::lock_guard lock(mutex);
+                file = files.find(filename);
+                if (file)
+                    return &file->contents;
+            }
+            auto key = PrefetchFiles::keyFor(filename);
+            std::lock_guard lock(mutex);
+            file = files.add(filename, key);
+            auto & node = file->contents;
+            if (!file->loaded) {
+                file->loaded = true;
+            #ifndef ARGUM_NO_THROW
+                try {
+            #endif
+                    node.filename = filename;
+                    parent.discovered.push_back(&node);
+            #ifndef ARGUM_NO_THROW
+                } catch(...) {
+                    //the node is visible to other threads but will never be read
+                    node.exception = std::current_exception();
+                    throw;
+                }
+            #endif
+            }
+            return &node;
+        }
+
+        template<class Splitter>
+        auto prefetch(PrefetchNode & node, Splitter & splitter, PrefetchFiles & files, std::mutex & mutex) const -> void {
+        #ifndef ARGUM_NO_THROW
+            try {
+        #endif
+                node.error = this->loadLines(std::filesystem::path(node.filename), node.items, splitter);
+                for (size_t i = 0; i < node.items.size(); ++i) {
+                    if (auto prefixSize = findPrefix(this->m_prefixes, node.items[i]))
+                        node.nested.emplace_back(i, registerPrefetch(StringViewType(node.items[i]).substr(*prefixSize), node, files, mutex));
+                }
+        #ifndef ARGUM_NO_THROW
+            } catch(...) {
+                node.exception = std::current_exception();
+            }
+        #endif
+        }
+
+        //Counts how many times each node will be spliced. Cycles are reported by splice()
+        static auto countUses(PrefetchNode & node) -> void {
+            ++node.uses;
+            node.active = true;
+            for (auto & [idx, nested]: node.nested) {
+                if (!nested->active)
+                    countUses(*nested);
+            }
+            node.active = false;
+        }
+
+        static auto splice(PrefetchNode & node, std::vector<StringType> & dest) -> ARGUM_EXPECTED(CharType, void) {
+        #ifndef ARGUM_NO_THROW
+            if (node.exception)
+                std::rethrow_exception(node.exception);
+        #endif
+            if (node.error)
+                ARGUM_THROW(Exception, std::filesystem::path(node.filename), node.error);
+            
+            //items can be moved out on the last use only
+            bool lastUse = (--node.uses == 0);
+            node.active = true;
+            auto nestedIt = node.nested.begin();
+            for (size_t i = 0; i < node.items.size(); ++i) {
+                if (nestedIt != node.nested.end() && nestedIt->first == i) {
+                    auto & nested = *nestedIt->second;
+                    if (nested.active)
+                        ARGUM_THROW(CycleException, std::filesystem::path(nested.filename));
+                    ARGUM_PROPAGATE_ERROR(splice(nested, dest));
+                    ++nestedIt;
+                } else if (lastUse) {
+                    dest.emplace_back(std::move(node.items[i]));
+                } else {
+                    dest.emplace_back(node.items[i]);
+                }
+            }
+            node.active = false;
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        //Unread remainder of a mapped response file
+        struct MappedSource {
+            StringViewType text;
+            Impl::BinaryArgsCursor<CharType> binary;
+
+            auto empty() const -> bool {
+                return this->text.empty() && this->binary.empty();
+            }
+
+            //Appends arguments from the next line (or the next binary argument) to dest
+            template<class Splitter>
+            auto next(std::vector<StringViewType> & dest, Splitter & splitter, BasicArgumentStore<CharType> & store) -> void {
+                if (!this->binary.empty()) {
+                    dest.push_back(this->binary.next());
+                    return;
+                }
+                auto line = nextLine(this->text);
+                if (line.empty())
+                    return;
+                if constexpr (std::is_invocable_v<Splitter &, StringViewType, std::back_insert_iterator<std::vector<StringViewType>>, 
+                                                  BasicArgumentStore<CharType> &>)
+                    splitter(line, std::back_inserter(dest), store);
+                else
+                    splitter(line, std::back_inserter(dest));
+            }
+
+            friend auto operator==(const MappedSource & lhs, const MappedSource & rhs) -> bool {
+                return lhs.text.data() == rhs.text.data() && lhs.text.size() == rhs.text.size() &&
+                       lhs.binary.position() == rhs.binary.position();
+            }
+        };
+
+        /**
+         Range of the result holding the full expansion of each mapped response file. 
+         The expansion of a file is the same every time so later references just copy it.
+         */
+        using MappedFiles = Impl::LoadedResponseFiles<CharType, std::pair<size_t, size_t>>;
+
+        struct MappedStackEntry {
+            typename MappedFiles::Entry * file;
+            MappedSource source;
+            std::vector<StringViewType> pending;
+            size_t current = 0;
+        };
+
+        auto handleMappedArg(StringViewType arg, BasicExpandedArgs<CharType> & dest,
+                             std::stack<MappedStackEntry> & stack, MappedFiles & files) -> ARGUM_EXPECTED(CharType, void) {
+
+            if (auto prefixSize = findPrefix(this->m_prefixes, arg)) {
+                auto filename = arg.substr(*prefixSize);
+                typename MappedFiles::Entry * file;
+                ARGUM_CHECK_RESULT(file, enter(files, filename));
+                if (file->loaded) {
+                    auto [first, last] = file->contents;
+                    dest.m_args.reserve(dest.m_args.size() + (last - first));
+                    for (auto i = first; i != last; ++i)
+                        dest.m_args.push_back(dest.m_args[i]);
+                    --file->active;
+                    return ARGUM_VOID_SUCCESS;
+                }
+                MappedStackEntry nextEntry;
+                nextEntry.file = file;
+                ARGUM_PROPAGATE_ERROR(this->mapResponseFile(filename, dest.m_storage, nextEntry.source));
+                file->contents.first = dest.m_args.size();
+                stack.emplace(std::move(nextEntry));
+            } else {
+                dest.m_args.push_back(arg);
+            }
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        static auto findPrefix(const std::vector<StringType> & prefixes, StringViewType arg) -> std::optional<size_t> {
+            auto foundIt = std::find_if(prefixes.begin(), prefixes.end(), [arg](const StringViewType & prefix) {
+                return matchStrictPrefix(arg, prefix);
+            });
+            if (foundIt == prefixes.end())
+                return std::nullopt;
+            return foundIt->size();
+        }
+
+        static auto mapResponseFile(StringViewType filename, Impl::ResponseFileStorage<CharType> & dest, 
+                                    MappedSource & contents) -> ARGUM_EXPECTED(CharType, void) {
+            
+            std::filesystem::path path(filename);
+            std::error_code error;
+            MappedFile file(path, error);
+            if (error)
+                ARGUM_THROW(Exception, path, error);
+
+            if (BinaryResponseFile::isBinary(file.data(), file.size())) {
+                std::unique_ptr<CharType[]> decoded;
+                if ((error = Impl::openBinaryArgs(file.data(), file.size(), decoded, contents.binary)))
+                    ARGUM_THROW(Exception, path, error);
+                dest.mappings.emplace_back(std::move(file));
+                if (decoded)
+                    dest.decoded.emplace_back(std::move(decoded));
+                return ARGUM_VOID_SUCCESS;
+            }
+
+            if constexpr (std::is_same_v<CharType, char>) {
+                contents.text = StringViewType(file.data(), file.size());
+                dest.mappings.emplace_back(std::move(file));
+            } else {
+                static_assert(std::is_same_v<CharType, wchar_t>, "only char and wchar_t are supported");
+                //decoded text is never longer than its multibyte encoding
+                std::unique_ptr<wchar_t[]> buffer(new wchar_t[file.size()]);
+                size_t length = 0;
+                if (!decode(file.data(), file.size(), buffer.get(), length))
+                    ARGUM_THROW(Exception, path, std::make_error_code(std::errc::illegal_byte_sequence));
+                contents.text = StringViewType(buffer.get(), length);
+                dest.decoded.emplace_back(std::move(buffer));
+            }
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        static auto decode(const char * first, size_t size, wchar_t * dest, size_t & length) -> bool {
+            mbstate_t state = mbstate_t();
+            const char * const last = first + size;
+            while (first != last) {
+                auto byte = static_cast<unsigned char>(*first);
+                //ASCII in initial shift state is the same in all supported encodings
+                if (byte < 0x80 && mbsinit(&state)) {
+                    dest[length++] = wchar_t(byte);
+                    ++first;
+                    continue;
+                }
+                size_t res = mbrtowc(dest + length, first, size_t(last - first), &state);
+                if (res == size_t(-1) || res == size_t(-2))
+                    return false;
+                ++length;
+                first += (res == 0 ? 1 : res);
+            }
+            return true;
+        }
+
+        static auto nextLine(StringViewType & rest) -> StringViewType {
+            auto pos = rest.find(CharConstants<CharType>::endl);
+            if (pos == rest.npos) {
+                auto ret = rest;
+                rest = StringViewType();
+                return ret;
+            }
+            auto ret = rest.substr(0, pos);
+            rest.remove_prefix(pos + 1);
             return ret;
         }
     private:
-        struct StackEntry {
-            std::vector<StringType> items;
-            typename std::vector<StringType>::const_iterator current;
+        std::vector<StringType> m_prefixes;
+        std::optional<ResponseFileCache> m_cache;
+        std::string m_splitterId;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ResponseFileReader)
+
+    /**
+     Result of BasicResponseFileReader::expandLazily()
+
+     A forward range of arguments that expands response files as iteration reaches them.
+     An iterator is a cursor over the response files it is inside of so copying one costs 
+     only the nesting depth. Each file is read once but iterating again, or from a copy of 
+     an iterator, splits its lines again. The object owns the mappings of all response files read so far and must outlive 
+     any use of the arguments it produced.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicLazyExpandedArgs {
+    private:
+        using ReaderType = BasicResponseFileReader<Char>;
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+        using ParsingExceptionPtr = std::shared_ptr<BasicParsingException<Char>>;
+        using Splitter = std::function<void (StringViewType, std::back_insert_iterator<std::vector<StringViewType>>, 
+                                             BasicArgumentStore<CharType> &)>;
+
+    private:
+        //files are only split as the iteration reaches them so just the mapped contents are memoized
+        using LoadedFiles = Impl::LoadedResponseFiles<CharType, typename ReaderType::MappedSource>;
+
+        struct State {
+            std::vector<StringType> prefixes;
+            std::vector<StringViewType> args;
+            Splitter splitter;
+            Impl::ResponseFileStorage<CharType> storage;
+            LoadedFiles files;
+            ParsingExceptionPtr error;
+
+            auto load(StringViewType filename) -> ARGUM_EXPECTED(CharType, typename LoadedFiles::Entry *) {
+                auto file = this->files.get(filename);
+                if (!file->loaded) {
+                    ARGUM_PROPAGATE_ERROR(ReaderType::mapResponseFile(filename, this->storage, file->contents));
+                    file->loaded = true;
+                }
+                return file;
+            }
         };
 
-        template<class Splitter>
-        auto handleArg(StringViewType arg, std::vector<StringType> & dest, 
-                       std::stack<StackEntry> & stack, 
-                       Splitter && splitter) -> ARGUM_EXPECTED(CharType, void) {
+    public:
+        class iterator {
+            friend BasicLazyExpandedArgs;
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = StringViewType;
+            using difference_type = std::ptrdiff_t;
+            using reference = StringViewType;
+            using pointer = const StringViewType *;
 
-            auto foundIt = std::find_if(this->m_prefixes.begin(), this->m_prefixes.end(), [arg](const StringViewType & prefix) {
-                return matchStrictPrefix(arg, prefix);
-            });
+        public:
+            iterator() = default;
 
-            if (foundIt != this->m_prefixes.end()) {
-                auto filename = arg.substr(foundIt->size());
-                StackEntry nextEntry;
-                ARGUM_PROPAGATE_ERROR(this->readResponseFile(filename, nextEntry.items, std::forward<Splitter>(splitter)));
-                nextEntry.current = nextEntry.items.cbegin();
-                stack.emplace(std::move(nextEntry));
+            auto operator*() const -> StringViewType {
+                return this->m_current;
+            }
+            auto operator->() const -> const StringViewType * {
+                return &this->m_current;
+            }
+            auto operator++() -> iterator & {
+                this->increment();
+                return *this;
+            }
+            auto operator++(int) -> iterator {
+                auto ret = *this;
+                this->increment();
+                return ret;
+            }
+            friend auto operator==(const iterator & lhs, const iterator & rhs) -> bool {
+                if (lhs.m_atEnd || rhs.m_atEnd)
+                    return lhs.m_atEnd == rhs.m_atEnd;
+                return lhs.m_argIdx == rhs.m_argIdx && lhs.m_stack == rhs.m_stack;
+            }
 
-            } else {
-                dest.emplace_back(arg);
+        private:
+            //A response file being expanded: its unread remainder and the unused arguments of the current line
+            struct Level {
+                const typename LoadedFiles::Entry * file;
+                typename ReaderType::MappedSource source;
+                std::vector<StringViewType> pending;
+                size_t current = 0;
+
+                friend auto operator==(const Level & lhs, const Level & rhs) -> bool {
+                    return lhs.source == rhs.source && lhs.current == rhs.current;
+                }
+            };
+
+            iterator(State * state): m_state(state), m_atEnd(false) {
+                this->increment();
             }
-            return ARGUM_VOID_SUCCESS;
-        }
-    
-        template<class Splitter>
-        static auto readResponseFile(StringViewType filename, std::vector<StringType> & dest, 
-                                     Splitter && splitter) -> ARGUM_EXPECTED(CharType, void){
 
-            std::filesystem::path path(filename);
-            std::error_code error;
-            SimpleFile file(path, "r", error);
-            if (!file)
-                ARGUM_THROW(Exception, path, error);
+            auto increment() -> void {
+            #ifdef ARGUM_USE_EXPECTED
+                if (auto err = this->advance().error()) {
+                    if (!this->m_state->error)
+                        this->m_state->error = std::move(err);
+                    this->m_stack.clear();
+                    this->m_atEnd = true;
+                }
+            #else
+                this->advance();
+            #endif
+            }
 
-            do {
-                StringType line = file.readLine<CharType>(error);
-                if (error)
-                    ARGUM_THROW(Exception, path, error);
-                
-                if (!line.empty())
-                    splitter(std::move(line), std::back_inserter(dest));
-            } while(!file.eof());
+            auto advance() -> ARGUM_EXPECTED(CharType, void) {
+                for ( ; ; ) {
+                    StringViewType candidate;
+                    if (!this->m_stack.empty()) {
+                        auto & level = this->m_stack.back();
+                        if (level.current == level.pending.size()) {
+                            if (level.source.empty()) {
+                                this->m_stack.pop_back();
+                                continue;
+                            }
+                            level.pending.clear();
+                            level.current = 0;
+                            level.source.next(level.pending, this->m_state->splitter, this->m_state->storage.strings);
+                            continue;
+                        }
+                        candidate = level.pending[level.current++];
+                    } else {
+                        if (this->m_argIdx == this->m_state->args.size()) {
+                            this->m_current = StringViewType();
+                            this->m_atEnd = true;
+                            return ARGUM_VOID_SUCCESS;
+                        }
+                        candidate = this->m_state->args[this->m_argIdx++];
+                    }
 
-            return ARGUM_VOID_SUCCESS;
+                    if (auto prefixSize = ReaderType::findPrefix(this->m_state->prefixes, candidate)) {
+                        auto filename = candidate.substr(*prefixSize);
+                        typename LoadedFiles::Entry * file;
+                        ARGUM_CHECK_RESULT(file, this->m_state->load(filename));
+                        for (auto & level: this->m_stack) {
+                            if (level.file == file)
+                                ARGUM_THROW(typename ReaderType::CycleException, std::filesystem::path(filename));
+                        }
+                        this->m_stack.push_back(Level{file, file->contents, {}, 0});
+                        continue;
+                    }
+                    this->m_current = candidate;
+                    return ARGUM_VOID_SUCCESS;
+                }
+            }
+
+        private:
+            State * m_state = nullptr;
+            size_t m_argIdx = 0;
+            std::vector<Level> m_stack;
+            StringViewType m_current;
+            bool m_atEnd = true;
+        };
+        using const_iterator = iterator;
+
+    public:
+        BasicLazyExpandedArgs(BasicLazyExpandedArgs &&) = default;
+        auto operator=(BasicLazyExpandedArgs &&) -> BasicLazyExpandedArgs & = default;
+
+        auto begin() const -> iterator {
+            return iterator(this->m_state.get());
+        }
+        auto end() const -> iterator {
+            return iterator();
+        }
+
+        /**
+         The first error encountered while iterating.
+
+         Only set when using BasicExpected. Otherwise errors are thrown from iteration.
+         */
+        auto error() const -> ParsingExceptionPtr {
+            return this->m_state->error;
         }
     private:
-        std::vector<StringType> m_prefixes;
+        friend ReaderType;
+
+        template<class SplitterArg>
+        BasicLazyExpandedArgs(std::vector<StringType> prefixes, std::vector<StringViewType> args, SplitterArg && splitter):
+            m_state(std::make_unique<State>()) {
+            this->m_state->prefixes = std::move(prefixes);
+            this->m_state->args = std::move(args);
+            if constexpr (std::is_invocable_v<SplitterArg &, StringViewType, std::back_insert_iterator<std::vector<StringViewType>>, 
+                                              BasicArgumentStore<CharType> &>) {
+                this->m_state->splitter = std::forward<SplitterArg>(splitter);
+            } else {
+                this->m_state->splitter = [splitter = std::forward<SplitterArg>(splitter)](StringViewType line, auto dest, BasicArgumentStore<CharType> &) mutable {
+                    splitter(line, dest);
+                };
+            }
+        }
+    private:
+        std::unique_ptr<State> m_state;
     };
 
-    ARGUM_DECLARE_FRIENDLY_NAMES(ResponseFileReader)
+    ARGUM_DECLARE_FRIENDLY_NAMES(LazyExpandedArgs)
 
 }
 
@@ -3322,6 +6392,39 @@ namespace Argum {
     ARGUM_MOD_EXPORTED
     constexpr auto defaultWColorScheme() -> const WColorScheme & { return basicDefaultColorScheme<wchar_t>; }
 
+    /**
+     Colorized text as separate pieces: escape sequence prefix, the text itself and
+     escape sequence suffix. All pieces are views so producing it never allocates. 
+     Prefix and suffix are empty when no color is used.
+     */
+    ARGUM_MOD_EXPORTED
+    template<Character Char>
+    struct BasicColoredText {
+        using CharType = Char;
+        using StringViewType = std::basic_string_view<CharType>;
+        using StringType = std::basic_string<CharType>;
+
+        StringViewType prefix;
+        StringViewType text;
+        StringViewType suffix;
+
+        auto size() const -> size_t {
+            return prefix.size() + text.size() + suffix.size();
+        }
+
+        auto appendTo(StringType & dest) const -> StringType & {
+            return dest.append(prefix).append(text).append(suffix);
+        }
+
+        auto str() const -> StringType {
+            StringType ret;
+            ret.reserve(this->size());
+            return this->appendTo(ret);
+        }
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ColoredText)
+
     ARGUM_MOD_EXPORTED
     template<Character Char>
     class BasicColorizer {
@@ -3330,6 +6433,8 @@ namespace Argum {
         using StringViewType = std::basic_string_view<CharType>;
         using StringType = std::basic_string<CharType>;
         using Scheme = BasicColorScheme<Char>;
+        using ColoredText = BasicColoredText<Char>;
+        using SchemeElement = StringViewType Scheme::*;
 
     public:
         constexpr BasicColorizer() = default;
@@ -3338,69 +6443,69 @@ namespace Argum {
             m_scheme(&scheme)
         {}
 
+        constexpr auto scheme() const -> const Scheme & {
+            return *m_scheme;
+        }
+
+        /**
+         Allocation-free version of the methods below. Pass one of the scheme members, 
+         e.g. `colored(&Scheme::shortOption, str)`
+         */
+        auto colored(SchemeElement element, StringViewType str) const -> ColoredText {
+            auto prefix = m_scheme->*element;
+            if (prefix.empty())
+                return {{}, str, {}};
+            return {prefix, str, basicMakeColor<Char, Color::normal>()};
+        }
+
         
         auto heading(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->heading);
+            return this->colored(&Scheme::heading, str).str();
         }
 
         auto progName(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->progName);
+            return this->colored(&Scheme::progName, str).str();
         }
 
         auto shortOptionInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->shortOptionInUsage);
+            return this->colored(&Scheme::shortOptionInUsage, str).str();
         }
 
         auto longOptionInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->longOptionInUsage);
+            return this->colored(&Scheme::longOptionInUsage, str).str();
         }
 
         auto optionArgInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->optionArgInUsage);
+            return this->colored(&Scheme::optionArgInUsage, str).str();
         }
 
         auto positionalInUsage(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->positionalInUsage);
+            return this->colored(&Scheme::positionalInUsage, str).str();
         }
 
         auto shortOption(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->shortOption);
+            return this->colored(&Scheme::shortOption, str).str();
         }
 
         auto longOption(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->longOption);
+            return this->colored(&Scheme::longOption, str).str();
         }
 
         auto optionArg(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->optionArg);
+            return this->colored(&Scheme::optionArg, str).str();
         }
 
         auto positional(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->positional);
+            return this->colored(&Scheme::positional, str).str();
         }
 
         auto error(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->error);
+            return this->colored(&Scheme::error, str).str();
         }
 
         auto warning(StringViewType str) const -> StringType {
-            return this->colorize(str, m_scheme->warning);
-        }
-    private:
-        static auto colorize(StringViewType str, StringViewType prefix) -> StringType {
-            if (!prefix.size())
-                return StringType(str);
-
-            auto suffix = basicMakeColor<Char, Color::normal>();
-
-            StringType ret;
-            ret.reserve(prefix.size() + str.size() + suffix.size());
-            ret = prefix;
-            ret += str;
-            ret += suffix;
-            return ret;
+            return this->colored(&Scheme::warning, str).str();
         }
-
     private:
         const Scheme * m_scheme = &nullColorScheme<Char>;
     };
@@ -3417,6 +6522,112 @@ namespace Argum {
     }
 }
 
+#endif
+#ifndef HEADER_ARGUM_OUTPUT_SINK_H_INCLUDED
+#define HEADER_ARGUM_OUTPUT_SINK_H_INCLUDED
+
+
+
+
+namespace Argum {
+
+    /**
+     Destination for incrementally produced text such as help and usage.
+
+     A sink is a lightweight handle that refers to but does not own its destination.
+     It can be created from:
+     - `FILE *` (for `char` and `wchar_t` only)
+     - `std::basic_ostream`
+     - `std::span<Char>` - a fixed buffer. The span is advanced past the written
+       text and output that doesn't fit is dropped
+     - an output iterator, which is advanced in place
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicOutputSink {
+    public:
+        using CharType = Char;
+        using StringViewType = std::basic_string_view<CharType>;
+        using OStreamType = std::basic_ostream<CharType>;
+
+    public:
+        BasicOutputSink(FILE * fp) requires(std::is_same_v<CharType, char> || std::is_same_v<CharType, wchar_t>):
+            m_dest(fp),
+            m_write(writeFile) {
+        }
+
+        BasicOutputSink(OStreamType & str):
+            m_dest(&str),
+            m_write(writeStream) {
+        }
+
+        BasicOutputSink(std::span<CharType> & buffer):
+            m_dest(&buffer),
+            m_write(writeBuffer) {
+        }
+
+        template<std::output_iterator<const CharType &> It>
+        requires(!std::is_pointer_v<It>)
+        BasicOutputSink(It & it):
+            m_dest(&it),
+            m_write(writeIterator<It>) {
+        }
+
+        auto write(StringViewType str) const -> const BasicOutputSink & {
+            if (!str.empty())
+                this->m_write(this->m_dest, str);
+            return *this;
+        }
+
+        auto write(size_t count, CharType c) const -> const BasicOutputSink & {
+            CharType buffer[32];
+            std::fill(std::begin(buffer), std::end(buffer), c);
+            while (count != 0) {
+                auto chunk = std::min(count, std::size(buffer));
+                this->m_write(this->m_dest, StringViewType(buffer, chunk));
+                count -= chunk;
+            }
+            return *this;
+        }
+
+    private:
+        static void writeFile(void * dest, StringViewType str) {
+            auto fp = static_cast<FILE *>(dest);
+            if constexpr (std::is_same_v<CharType, char>) {
+                fwrite(str.data(), 1, str.size(), fp);
+            } else {
+                for (auto c: str) {
+                    if (fputwc(c, fp) == WEOF)
+                        break;
+                }
+            }
+        }
+
+        static void writeStream(void * dest, StringViewType str) {
+            static_cast<OStreamType *>(dest)->write(str.data(), std::streamsize(str.size()));
+        }
+
+        static void writeBuffer(void * dest, StringViewType str) {
+            auto & buffer = *static_cast<std::span<CharType> *>(dest);
+            auto size = std::min(str.size(), buffer.size());
+            std::copy(str.data(), str.data() + size, buffer.data());
+            buffer = buffer.subspan(size);
+        }
+
+        template<class It>
+        static void writeIterator(void * dest, StringViewType str) {
+            auto & it = *static_cast<It *>(dest);
+            it = std::copy(str.begin(), str.end(), std::move(it));
+        }
+
+    private:
+        void * m_dest;
+        void (*m_write)(void * dest, StringViewType str);
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(OutputSink)
+}
+
 #endif
 
 
@@ -3426,6 +6637,45 @@ namespace Argum {
     template<class Char> class BasicPositional;
     template<class Char> class BasicParser;
 
+    namespace Impl {
+
+        //Appends plain and colored pieces of text to a string keeping track of the display
+        //width of the text. This avoids having to strip escape sequences to measure it afterwards
+        template<Character Char>
+        class ColoredTextBuilder {
+        public:
+            using StringViewType = std::basic_string_view<Char>;
+            using StringType = std::basic_string<Char>;
+
+            ColoredTextBuilder(StringType & dest): m_dest(dest) {
+            }
+
+            auto append(Char c) -> ColoredTextBuilder & {
+                return this->append(StringViewType(&c, 1));
+            }
+
+            auto append(StringViewType str) -> ColoredTextBuilder & {
+                this->m_dest.append(str);
+                this->m_width += measurePlainWidth(str, this->m_buffer);
+                return *this;
+            }
+
+            auto append(const BasicColoredText<Char> & text) -> ColoredTextBuilder & {
+                text.appendTo(this->m_dest);
+                this->m_width += measurePlainWidth(text.text, this->m_buffer);
+                return *this;
+            }
+
+            auto width() const -> unsigned {
+                return this->m_width.value();
+            }
+        private:
+            StringType & m_dest;
+            TextWidth m_width;
+            std::wstring m_buffer;
+        };
+    }
+
     ARGUM_MOD_EXPORTED
     template<class Char>
     class BasicHelpFormatter {
@@ -3436,12 +6686,15 @@ namespace Argum {
         using Option = BasicOption<CharType>;
         using Positional = BasicPositional<CharType>;
         using Colorizer = BasicColorizer<CharType>;
+        using OutputSink = BasicOutputSink<CharType>;
 
         struct Layout {
             unsigned width = std::numeric_limits<unsigned>::max();
             unsigned helpLeadingGap = 2;
             unsigned helpNameMaxWidth = 20;
             unsigned helpDescriptionGap = 2;
+
+            friend auto operator==(const Layout &, const Layout &) -> bool = default;
         };
         static constexpr Layout defaultLayout = {};
 
@@ -3449,6 +6702,20 @@ namespace Argum {
             size_t positionalIdx = size_t(-1);
             size_t optionIdx = size_t(-1);
         };
+
+        struct ItemName {
+            StringType name;
+            unsigned width = 0;
+        };
+        /**
+         Help names of all positionals and options in parser order. 
+         Names do not depend on layout so can be computed once and reused for different widths
+         via useItemNames()
+         */
+        struct ItemNames {
+            std::vector<ItemName> positionals;
+            std::vector<ItemName> options;
+        };
     private:
         using CharConstants = Argum::CharConstants<CharType>;
         using Messages = Argum::Messages<CharType>;
@@ -3471,12 +6738,21 @@ namespace Argum {
 
         auto formatUsage(const std::optional<StringType> & subCommand,
                          const Colorizer & colorizer = {}) const -> StringType {
-            constexpr auto space = CharConstants::space;
-            return wordWrap(colorizer.heading(Messages::usageStart()).
-                                append(colorizer.progName(this->m_progName)).
-                                append({space}).
-                                append(this->formatSyntax(subCommand, colorizer)), 
-                            m_layout.width, m_layout.helpLeadingGap);
+            StringType ret;
+            this->appendUsage(ret, subCommand, colorizer);
+            return ret;
+        }
+
+        void formatUsage(OutputSink out, const Colorizer & colorizer = {}) const {
+            this->formatUsage(out, std::nullopt, colorizer);
+        }
+
+        void formatUsage(OutputSink out,
+                         const std::optional<StringType> & subCommand,
+                         const Colorizer & colorizer = {}) const {
+            StringType buffer;
+            this->appendUsage(buffer, subCommand, colorizer);
+            out.write(buffer);
         }
 
         auto formatHelp(const Colorizer & colorizer = {}) const -> StringType {
@@ -3486,33 +6762,73 @@ namespace Argum {
         auto formatHelp(const std::optional<StringType> & subCommand,
                         const Colorizer & colorizer = {}) const -> StringType {
 
+            StringType ret;
+            auto out = std::back_inserter(ret);
+            this->formatHelp(out, subCommand, colorizer);
+            return ret;
+        }
+
+        void formatHelp(OutputSink out, const Colorizer & colorizer = {}) const {
+            this->formatHelp(out, std::nullopt, colorizer);
+        }
+
+        /**
+         Writes help to the sink one item at a time. Only the text of a single 
+         item is held in memory at any moment.
+         */
+        void formatHelp(OutputSink out,
+                        const std::optional<StringType> & subCommand,
+                        const Colorizer & colorizer = {}) const {
+
             if (subCommand && this->m_parser.subCommandMark().positionalIdx == size_t(-1))
                 ARGUM_INVALID_ARGUMENT("subcommand must be defined to use this function with non null subcommand");
 
             constexpr auto endl = CharConstants::endl;
 
-            StringType ret;
+            const bool forSubCommand = bool(subCommand);
 
-            auto helpContent = this->calculateHelpContent(bool(subCommand), colorizer);
-            if (helpContent.maxNameLen > m_layout.helpNameMaxWidth)
-                helpContent.maxNameLen = m_layout.helpNameMaxWidth;
+            unsigned maxNameLen = 0;
+            size_t positionalCount = 0;
+            size_t optionCount = 0;
+            StringType buffer;
+            StringType scratch;
+
+            this->forEachPositionalInHelp(forSubCommand, [&](auto & pos, size_t idx) {
+                ++positionalCount;
+                maxNameLen = std::max(maxNameLen, this->loadItemName(scratch, pos, idx, colorizer));
+            });
+            this->forEachOptionInHelp(forSubCommand, [&](auto & opt, size_t idx) {
+                ++optionCount;
+                maxNameLen = std::max(maxNameLen, this->loadItemName(scratch, opt, idx, colorizer));
+            });
+            if (maxNameLen > m_layout.helpNameMaxWidth)
+                maxNameLen = m_layout.helpNameMaxWidth;
+
+            auto writeHeader = [&](StringViewType header) {
+                scratch.clear();
+                colorizer.colored(&Colorizer::Scheme::heading, header).appendTo(scratch);
+                buffer.clear();
+                appendWordWrapped(buffer, StringViewType(scratch), m_layout.width, m_layout.helpLeadingGap);
+                out.write(buffer);
+            };
+            auto writeItem = [&](auto & item, size_t idx) {
+                buffer.assign(1, endl);
+                auto nameWidth = this->loadItemName(scratch, item, idx, colorizer);
+                this->appendItemHelp(buffer, scratch, nameWidth, item.formatHelpDescription(), maxNameLen);
+                out.write(buffer);
+            };
 
-            if (!helpContent.positionalItems.empty()) {
-                ret.append(wordWrap(colorizer.heading(Messages::positionalHeader()), m_layout.width, m_layout.helpLeadingGap));
-                for(auto & [name, desc]: helpContent.positionalItems) {
-                    ret.append({endl}).append(this->formatItemHelp(name, desc, helpContent.maxNameLen));
-                }
-                ret.append(2, endl);
+            if (positionalCount != 0) {
+                writeHeader(Messages::positionalHeader());
+                this->forEachPositionalInHelp(forSubCommand, writeItem);
+                out.write(2, endl);
             }
 
-            if (!helpContent.optionItems.empty()) {
-                ret.append(wordWrap(colorizer.heading(Messages::optionsHeader()), m_layout.width, m_layout.helpLeadingGap));
-                for(auto & [name, desc]: helpContent.optionItems) {
-                    ret.append({endl}).append(this->formatItemHelp(name, desc, helpContent.maxNameLen));
-                }
-                ret.append(2, endl);
+            if (optionCount != 0) {
+                writeHeader(Messages::optionsHeader());
+                this->forEachOptionInHelp(forSubCommand, writeItem);
+                out.write(2, endl);
             }
-            return ret;
         }
 
         auto formatSyntax(const Colorizer & colorizer = {}) const -> StringType {
@@ -3523,89 +6839,69 @@ namespace Argum {
         auto formatSyntax(const std::optional<StringType> & subCommand,
                           const Colorizer & colorizer = {}) const -> StringType {
 
-            auto subCommandMark = this->m_parser.subCommandMark();
-            if (subCommand && subCommandMark.positionalIdx == size_t(-1))
-                ARGUM_INVALID_ARGUMENT("subcommand must be added to use this function with non null subcommand");
-
-            constexpr auto space = CharConstants::space;
-
-            auto getSyntax = [&](auto & obj) {
-                return obj.formatSyntax(this->m_parser, colorizer);
-            };
-
-            StringType ret = this->appendSyntax(
-                    join(this->optionsBegin(false), this->optionsEnd(false), space, getSyntax),
-                    join(this->positionalsBegin(false), this->positionalsEnd(false), space, getSyntax)
-            );
-            if (subCommand) {
-                ret = this->appendSyntax(std::move(ret), *subCommand); 
-                ret = this->appendSyntax(std::move(ret), join(this->optionsBegin(true), this->optionsEnd(true), space, getSyntax));
-                ret = this->appendSyntax(std::move(ret), join(this->positionalsBegin(true), this->positionalsEnd(true), space, getSyntax));
-            } else if (subCommandMark.positionalIdx != size_t(-1)) {
-                ret = this->appendSyntax(std::move(ret), getSyntax(this->m_parser.positionals()[subCommandMark.positionalIdx]));
-            }
-
+            StringType ret;
+            this->appendFullSyntax(ret, subCommand, colorizer);
             return ret;
         }
         
-
-        struct HelpContent {
-            unsigned maxNameLen = 0;
-            std::vector<std::pair<StringType, StringType>> optionItems;
-            std::vector<std::pair<StringType, StringType>> positionalItems;
-        };
-        auto calculateHelpContent(bool forSubCommand, 
-                                  const Colorizer & colorizer = {}) const -> HelpContent {
-            
-            HelpContent ret;
-            auto subCommandMark = this->m_parser.subCommandMark();
-
-            size_t positionalsSize;
-            if (forSubCommand || subCommandMark.positionalIdx == size_t(-1))
-                positionalsSize = this->m_parser.positionals().size();
-            else 
-                positionalsSize = subCommandMark.positionalIdx + 1;
-            for(size_t i = 0; i < positionalsSize; ++ i) {
-                if (forSubCommand && i == subCommandMark.positionalIdx)
-                    continue;
-                auto & pos = this->m_parser.positionals()[i];
-                auto name = pos.formatHelpName(this->m_parser, colorizer);
-                auto length = stringWidth(name);
-                if (length > ret.maxNameLen)
-                    ret.maxNameLen = length;
-                ret.positionalItems.emplace_back(std::move(name), pos.formatHelpDescription());
-            }
-            std::for_each(this->m_parser.options().begin(), this->optionsEnd(forSubCommand), [&](auto & opt){
-                auto name = opt.formatHelpName(this->m_parser, colorizer);
-                auto length = stringWidth(name);
+
+        struct HelpContent {
+            unsigned maxNameLen = 0;
+            std::vector<std::pair<StringType, StringType>> optionItems;
+            std::vector<std::pair<StringType, StringType>> positionalItems;
+        };
+        auto calculateHelpContent(bool forSubCommand, 
+                                  const Colorizer & colorizer = {}) const -> HelpContent {
+            
+            HelpContent ret;
+            auto addItem = [&](auto & items, auto & obj) {
+                StringType name;
+                auto length = obj.appendHelpName(name, this->m_parser, colorizer);
                 if (length > ret.maxNameLen)
                     ret.maxNameLen = length;
-                ret.optionItems.emplace_back(std::move(name), opt.formatHelpDescription());
+                items.emplace_back(std::move(name), obj.formatHelpDescription());
+            };
+            this->forEachPositionalInHelp(forSubCommand, [&](auto & pos, size_t /*idx*/) {
+                addItem(ret.positionalItems, pos);
+            });
+            this->forEachOptionInHelp(forSubCommand, [&](auto & opt, size_t /*idx*/) {
+                addItem(ret.optionItems, opt);
             });
             return ret;
         }
 
+        auto calculateItemNames(const Colorizer & colorizer = {}) const -> ItemNames {
+            
+            ItemNames ret;
+            auto addItems = [&](auto & dest, auto & items) {
+                dest.reserve(items.size());
+                for (auto & item: items) {
+                    auto & added = dest.emplace_back();
+                    added.width = item.appendHelpName(added.name, this->m_parser, colorizer);
+                }
+            };
+            addItems(ret.positionals, this->m_parser.positionals());
+            addItems(ret.options, this->m_parser.options());
+            return ret;
+        }
+
+        /**
+         Use precomputed names in formatHelp(). The names must have been calculated by calculateItemNames()
+         for the same parser state and colorizer and must outlive this object
+         */
+        void useItemNames(const ItemNames & names) {
+            this->m_itemNames = &names;
+        }
+
         auto formatItemHelp(StringViewType name, 
                             StringViewType description,
                             unsigned maxNameLen) const -> StringType {
             constexpr auto space = CharConstants::space;
-            constexpr auto endl = CharConstants::endl;
-
-            auto descColumnOffset = this->m_layout.helpLeadingGap + maxNameLen + this->m_layout.helpDescriptionGap;
-
-            StringType ret = wordWrap(StringType(this->m_layout.helpLeadingGap, space).append(name), this->m_layout.width, this->m_layout.helpLeadingGap);
-            auto lastEndlPos = ret.rfind(endl);
-            auto lastLineLen = stringWidth(StringViewType(ret.c_str() + (lastEndlPos + 1), ret.size() - (lastEndlPos + 1)));
-
-            if (lastLineLen > maxNameLen + this->m_layout.helpLeadingGap) {
-                ret += endl;
-                ret.append(descColumnOffset, space);
-            } else {
-                ret.append(descColumnOffset - lastLineLen, space);
-            }
-
-            ret.append(wordWrap(description, this->m_layout.width, descColumnOffset, descColumnOffset));
 
+            StringType ret;
+            StringType prefixedName(this->m_layout.helpLeadingGap, space);
+            prefixedName.append(name);
+            this->appendItemHelp(ret, prefixedName, stringWidth(name), description, maxNameLen);
             return ret;
         }
 
@@ -3653,10 +6949,150 @@ namespace Argum {
             
             return addend;
         }
+    private:
+        void appendUsage(StringType & dest,
+                         const std::optional<StringType> & subCommand,
+                         const Colorizer & colorizer) const {
+            constexpr auto space = CharConstants::space;
+
+            using Scheme = typename Colorizer::Scheme;
+
+            StringType usage;
+            colorizer.colored(&Scheme::heading, Messages::usageStart()).appendTo(usage);
+            colorizer.colored(&Scheme::progName, this->m_progName).appendTo(usage).append({space});
+            this->appendFullSyntax(usage, subCommand, colorizer);
+            appendWordWrapped(dest, StringViewType(usage), m_layout.width, m_layout.helpLeadingGap);
+        }
+
+        void appendFullSyntax(StringType & dest,
+                              const std::optional<StringType> & subCommand,
+                              const Colorizer & colorizer) const {
+
+            auto subCommandMark = this->m_parser.subCommandMark();
+            if (subCommand && subCommandMark.positionalIdx == size_t(-1))
+                ARGUM_INVALID_ARGUMENT("subcommand must be added to use this function with non null subcommand");
+
+            constexpr auto space = CharConstants::space;
+
+            const auto start = dest.size();
+
+            //Appends space separated items as a group separated from preceding syntax by a space
+            //Same as appendSyntax(base, join(first, last, space)) but without temporaries
+            auto appendGroup = [&](auto first, auto last) {
+                const auto groupStart = dest.size();
+                if (groupStart != start)
+                    dest += space;
+                const auto contentStart = dest.size();
+                for (auto it = first; it != last; ++it) {
+                    if (it != first)
+                        dest += space;
+                    dest += it->formatSyntax(this->m_parser, colorizer);
+                }
+                if (dest.size() == contentStart)
+                    dest.resize(groupStart);
+            };
+
+            appendGroup(this->optionsBegin(false), this->optionsEnd(false));
+            appendGroup(this->positionalsBegin(false), this->positionalsEnd(false));
+            if (subCommand) {
+                if (!subCommand->empty()) {
+                    if (dest.size() != start)
+                        dest += space;
+                    dest += *subCommand;
+                }
+                appendGroup(this->optionsBegin(true), this->optionsEnd(true));
+                appendGroup(this->positionalsBegin(true), this->positionalsEnd(true));
+            } else if (subCommandMark.positionalIdx != size_t(-1)) {
+                auto pos = this->m_parser.positionals().begin() + subCommandMark.positionalIdx;
+                appendGroup(pos, pos + 1);
+            }
+        }
+
+        //prefixedName is the item name preceded by helpLeadingGap spaces
+        void appendItemHelp(StringType & dest,
+                            StringViewType prefixedName,
+                            unsigned nameWidth,
+                            StringViewType description,
+                            unsigned maxNameLen) const {
+            constexpr auto space = CharConstants::space;
+            constexpr auto endl = CharConstants::endl;
+
+            auto descColumnOffset = this->m_layout.helpLeadingGap + maxNameLen + this->m_layout.helpDescriptionGap;
+
+            const auto start = dest.size();
+            appendWordWrapped(dest, prefixedName, this->m_layout.width, this->m_layout.helpLeadingGap);
+            unsigned lastLineLen;
+            //a wrap can replace a space with a line break keeping the size so look for the break itself
+            auto lastEndlPos = dest.rfind(endl);
+            if (lastEndlPos == dest.npos || lastEndlPos < start) {
+                //not wrapped so we already know the width
+                lastLineLen = this->m_layout.helpLeadingGap + nameWidth;
+            } else {
+                auto lastLineStart = lastEndlPos + 1;
+                lastLineLen = stringWidth(StringViewType(dest.c_str() + lastLineStart, dest.size() - lastLineStart));
+            }
+
+            if (lastLineLen > maxNameLen + this->m_layout.helpLeadingGap) {
+                dest += endl;
+                dest.append(descColumnOffset, space);
+            } else {
+                dest.append(descColumnOffset - lastLineLen, space);
+            }
+
+            appendWordWrapped(dest, description, this->m_layout.width, descColumnOffset, descColumnOffset);
+        }
+
+        template<class Func>
+        void forEachPositionalInHelp(bool forSubCommand, Func && func) const {
+            auto subCommandMark = this->m_parser.subCommandMark();
+
+            size_t positionalsSize;
+            if (forSubCommand || subCommandMark.positionalIdx == size_t(-1))
+                positionalsSize = this->m_parser.positionals().size();
+            else 
+                positionalsSize = subCommandMark.positionalIdx + 1;
+            for(size_t i = 0; i < positionalsSize; ++ i) {
+                if (forSubCommand && i == subCommandMark.positionalIdx)
+                    continue;
+                func(this->m_parser.positionals()[i], i);
+            }
+        }
+
+        template<class Func>
+        void forEachOptionInHelp(bool forSubCommand, Func && func) const {
+            auto first = this->m_parser.options().begin();
+            auto last = this->optionsEnd(forSubCommand);
+            for (auto it = first; it != last; ++it)
+                func(*it, size_t(it - first));
+        }
+
+        template<class Item>
+        auto cachedItemName(size_t idx) const -> const ItemName & {
+            if constexpr (std::is_same_v<Item, Positional>)
+                return this->m_itemNames->positionals[idx];
+            else
+                return this->m_itemNames->options[idx];
+        }
+
+        //Puts the item name preceded by helpLeadingGap spaces into dest and returns the name width
+        template<class Item>
+        auto loadItemName(StringType & dest, const Item & item, size_t idx, const Colorizer & colorizer) const -> unsigned {
+            constexpr auto space = CharConstants::space;
+
+            dest.assign(this->m_layout.helpLeadingGap, space);
+            if (this->m_itemNames) {
+                auto & cached = this->cachedItemName<Item>(idx);
+                dest.append(cached.name);
+                return cached.width;
+            }
+            return item.appendHelpName(dest, this->m_parser, colorizer);
+        }
+
     private:
         StringType m_progName;
         const BasicParser<Char> & m_parser;
         Layout m_layout;
+        const ItemNames * m_itemNames = nullptr;
     };
 
     ARGUM_DECLARE_FRIENDLY_NAMES(HelpFormatter)
@@ -3688,6 +7124,7 @@ namespace Argum {
         using CharConstants = Argum::CharConstants<CharType>;
         using Messages = Argum::Messages<CharType>;
         using Colorizer = BasicColorizer<CharType>;
+        using ColorScheme = BasicColorScheme<CharType>;
         using HandlerReturnType = ARGUM_EXPECTED(CharType, void);
 
         using NoArgHandler = std::function<HandlerReturnType ()>; 
@@ -3795,8 +7232,10 @@ namespace Argum {
                 ret += brop;
             auto & mainName = this->m_names.main();
             bool isLong = parser.isOptionNameLong(mainName);
-            StringType nameAndArg = isLong ? colorizer.longOptionInUsage(mainName) : colorizer.shortOptionInUsage(mainName);
-            nameAndArg.append(this->formatArgSyntax(isLong, true, colorizer));
+            StringType nameAndArg;
+            Impl::ColoredTextBuilder<CharType> builder(nameAndArg);
+            builder.append(colorizer.colored(isLong ? &ColorScheme::longOptionInUsage : &ColorScheme::shortOptionInUsage, mainName));
+            this->appendArgSyntax(builder, isLong, true, colorizer);
             ret.append(nameAndArg);
             unsigned idx = 1;
             for (; idx < this->m_occurs.min(); ++idx) {
@@ -3817,64 +7256,75 @@ namespace Argum {
         }
 
         auto formatArgSyntax(bool forLongName, bool forUsage, const Colorizer & colorizer = {}) const -> StringType {
+            StringType ret;
+            Impl::ColoredTextBuilder<CharType> builder(ret);
+            this->appendArgSyntax(builder, forLongName, forUsage, colorizer);
+            return ret;
+        }
+
+        auto formatHelpName(const BasicParser<CharType> & parser, 
+                            const Colorizer & colorizer = {}) const -> StringType {
+            StringType ret;
+            this->appendHelpName(ret, parser, colorizer);
+            return ret;
+        }
+
+        /**
+         Appends help name to dest and returns its display width
+         */
+        auto appendHelpName(StringType & dest,
+                            const BasicParser<CharType> & parser, 
+                            const Colorizer & colorizer = {}) const -> unsigned {
+
+            Impl::ColoredTextBuilder<CharType> builder(dest);
+            bool first = true;
+            for (auto & name: this->m_names.all()) {
+                if (!first)
+                    builder.append(StringViewType(Messages::listJoiner()));
+                first = false;
+                auto isLong = parser.isOptionNameLong(name);
+                builder.append(colorizer.colored(isLong ? &ColorScheme::longOption : &ColorScheme::shortOption, name));
+                this->appendArgSyntax(builder, isLong, false, colorizer);
+            }
+            return builder.width();
+        }
+
+        auto formatHelpDescription() const -> const StringType & {
+            return this->m_description;
+        }
+    private:
+        void appendArgSyntax(Impl::ColoredTextBuilder<CharType> & dest, 
+                             bool forLongName, bool forUsage, const Colorizer & colorizer) const {
             constexpr auto space = CharConstants::space;
             constexpr auto brop = CharConstants::squareBracketOpen;
             constexpr auto brcl = CharConstants::squareBracketClose;
             constexpr auto eq = CharConstants::assignment;
 
-            StringType ret;
             std::visit([&](const auto & handler) {
                 using HandlerType = std::remove_cvref_t<decltype(handler)>;
                 constexpr auto argumentKind = BasicOption::template argumentKindOf<HandlerType>();
-                auto colorArg = forUsage ? colorizer.optionArgInUsage(this->m_argName) : colorizer.optionArg(this->m_argName);
+                auto colorArg = colorizer.colored(forUsage ? &ColorScheme::optionArgInUsage : &ColorScheme::optionArg, this->m_argName);
                 if constexpr (argumentKind == ArgumentKind::Optional) {
                     if (this->m_requireAttachedArgument)
                         if (forLongName)
-                            ret.append({brop, eq});
+                            dest.append(brop).append(eq);
                         else
-                            ret.append({brop});
+                            dest.append(brop);
                     else
-                        ret.append({space, brop});
-                    ret.append(colorArg).append({brcl});
+                        dest.append(space).append(brop);
+                    dest.append(colorArg).append(brcl);
                 } else if constexpr (argumentKind == ArgumentKind::Required)  {
                     if (this->m_requireAttachedArgument) {
                         if (forLongName)
-                            ret.append({eq});
+                            dest.append(eq);
                     } else {
-                        ret.append({space});
+                        dest.append(space);
                     }
-                    ret.append(colorArg);
+                    dest.append(colorArg);
                 }
             }, this->m_handler);
-            return ret;
-        }
-
-        auto formatHelpName(const BasicParser<CharType> & parser, 
-                            const Colorizer & colorizer = {}) const -> StringType {
-
-            auto handleName = [&](const StringType & name) {
-                auto isLong = parser.isOptionNameLong(name);
-                StringType ret = isLong ? colorizer.longOption(name) : colorizer.shortOption(name);
-                ret += this->formatArgSyntax(isLong, false, colorizer);
-                return ret;
-            };
-
-            auto & all = this->m_names.all();
-            auto first = all.begin();
-            auto last = all.end();
-        
-            StringType ret = handleName(*first);
-            ++first;
-            std::for_each(first, last, [&](const auto & name) {
-                ret.append(Messages::listJoiner()).append(handleName(name));
-            });
-
-            return ret;
         }
 
-        auto formatHelpDescription() const -> const StringType & {
-            return this->m_description;
-        }
     private:
         OptionNames m_names;
         Handler m_handler = []() -> ARGUM_EXPECTED(CharType, void) { return ARGUM_VOID_SUCCESS; };
@@ -3900,6 +7350,7 @@ namespace Argum {
     private:
         using CharConstants = Argum::CharConstants<CharType>;
         using Colorizer = BasicColorizer<CharType>;
+        using ColorScheme = BasicColorScheme<CharType>;
         using HandlerReturnType = ARGUM_EXPECTED(CharType, void);
 
     public:
@@ -3944,7 +7395,7 @@ namespace Argum {
 
             StringType ret;
 
-            StringType colorizedName = colorizer.positionalInUsage(this->m_name);
+            StringType colorizedName = colorizer.colored(&ColorScheme::positionalInUsage, this->m_name).str();
 
             if (this->m_occurs.min() == 0)
                 ret += brop;
@@ -3959,7 +7410,8 @@ namespace Argum {
                     for (++idx; idx < this->m_occurs.max(); ++idx)
                         ret.append({space}).append(colorizedName);
                 } else {
-                    ret.append({space}).append(colorizer.positionalInUsage(ellipsis));
+                    ret.append({space});
+                    colorizer.colored(&ColorScheme::positionalInUsage, ellipsis).appendTo(ret);
                 }
                 ret += brcl;
             }
@@ -3971,7 +7423,18 @@ namespace Argum {
 
         auto formatHelpName(const BasicParser<CharType> & /*parser*/,
                           const Colorizer & colorizer = {}) const -> StringType {
-            return colorizer.positional(this->m_name);
+            return colorizer.colored(&ColorScheme::positional, this->m_name).str();
+        }
+
+        /**
+         Appends help name to dest and returns its display width
+         */
+        auto appendHelpName(StringType & dest,
+                            const BasicParser<CharType> & /*parser*/,
+                            const Colorizer & colorizer = {}) const -> unsigned {
+            Impl::ColoredTextBuilder<CharType> builder(dest);
+            builder.append(colorizer.colored(&ColorScheme::positional, this->m_name));
+            return builder.width();
         }
 
         auto formatHelpDescription() const -> const StringType & {
@@ -3995,12 +7458,14 @@ namespace Argum {
         using StringViewType = std::basic_string_view<Char>;
         using OptionNames = BasicOptionNames<Char>;
         using ParsingException = BasicParsingException<Char>;
+        using ParsingExceptionPtr = std::shared_ptr<ParsingException>;
         using Option = BasicOption<Char>;
         using Positional = BasicPositional<Char>;
         using Settings = typename BasicTokenizer<Char>::Settings;
         using HelpFormatter = BasicHelpFormatter<CharType>;
         using SubCommandMark = typename HelpFormatter::SubCommandMark;
         using Colorizer = BasicColorizer<Char>;
+        using OutputSink = BasicOutputSink<Char>;
 
     private:
         using CharConstants = Argum::CharConstants<CharType>;
@@ -4013,67 +7478,98 @@ namespace Argum {
     public:
         struct UnrecognizedOption : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(UnrecognizedOption, ParsingException, Error::UnrecognizedOption)
+            static constexpr bool IsCompact = true;
 
-            UnrecognizedOption(StringViewType option_): 
-                ParsingException(ErrorCode, format(Messages::unrecognizedOptionError(), option_)),
-                option(option_) {
+            UnrecognizedOption(StringViewType option_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                option(option_),
+                argumentIndex(argumentIndex_) {
             }
             StringType option;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::unrecognizedOptionError>(this->option);
+            }
         };
 
         struct AmbiguousOption : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(AmbiguousOption, ParsingException, Error::AmbiguousOption)
 
             AmbiguousOption(StringViewType option_, std::vector<StringType> possibilities_): 
-                ParsingException(ErrorCode, 
-                                 format(Messages::ambiguousOptionError(), option_, 
-                                        join(possibilities_.begin(), possibilities_.end(), Messages::listJoiner()))),
+                ParsingException(ErrorCode),
                 option(option_),
                 possibilities(std::move(possibilities_)) {
             }
             StringType option;
             std::vector<StringType> possibilities;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::ambiguousOptionError>(this->option, 
+                                join(this->possibilities.begin(), this->possibilities.end(), Messages::listJoiner()));
+            }
         };
 
         struct MissingOptionArgument : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(MissingOptionArgument, ParsingException, Error::MissingOptionArgument)
+            static constexpr bool IsCompact = true;
 
-            MissingOptionArgument(StringViewType option_): 
-                ParsingException(ErrorCode, format(Messages::missingOptionArgumentError(), option_)),
-                option(option_) {
+            MissingOptionArgument(StringViewType option_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                option(option_),
+                argumentIndex(argumentIndex_) {
             }
             StringType option;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::missingOptionArgumentError>(this->option);
+            }
         };
 
         struct ExtraOptionArgument : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(ExtraOptionArgument, ParsingException, Error::ExtraOptionArgument)
+            static constexpr bool IsCompact = true;
 
-            ExtraOptionArgument(StringViewType option_): 
-                ParsingException(ErrorCode, format(Messages::extraOptionArgumentError(), option_)),
-                option(option_) {
+            ExtraOptionArgument(StringViewType option_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                option(option_),
+                argumentIndex(argumentIndex_) {
             }
             StringType option;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::extraOptionArgumentError>(this->option);
+            }
         };
 
         struct ExtraPositional : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(ExtraPositional, ParsingException, Error::ExtraPositional)
+            static constexpr bool IsCompact = true;
 
-            ExtraPositional(StringViewType value_): 
-                ParsingException(ErrorCode, format(Messages::extraPositionalError(), value_)),
-                value(value_) {
+            ExtraPositional(StringViewType value_, int argumentIndex_ = -1): 
+                ParsingException(ErrorCode),
+                value(value_),
+                argumentIndex(argumentIndex_) {
             }
             StringType value;
+            int argumentIndex;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages::extraPositionalError>(this->value);
+            }
         };
         
         struct ValidationError : public ParsingException {
             ARGUM_IMPLEMENT_EXCEPTION(ValidationError, ParsingException, Error::ValidationError)
 
             ValidationError(StringViewType message):
-                ParsingException(ErrorCode, format(Messages::validationError(), message)) {
+                ParsingException(ErrorCode, format<Messages::validationError>(message)) {
             }
             template<DescribableParserValidator<CharType> Validator>
             ValidationError(Validator validator):
-                ParsingException(ErrorCode, format(Messages::validationError(), describe(validator))) {
+                ParsingException(ErrorCode, format<Messages::validationError>(describe(validator))) {
             }
         };
 
@@ -4118,39 +7614,165 @@ namespace Argum {
             m_validators.emplace_back(std::move(v), std::move(desc));
         }
 
-        auto parse(int argc, CharType ** argv) const -> ARGUM_EXPECTED(CharType, void) {
-            return this->parse(makeArgSpan<CharType>(argc, argv));
+        /**
+         Enables or disables caching of rendered usage and help. 
+         
+         When enabled, formatUsage() and formatHelp() remember their output for each combination of
+         program name, subcommand, layout and colorizer scheme and reuse it until the parser is modified.
+         Help names of all items are also cached so re-rendering for a different width is cheaper.
+         Note that with the cache enabled concurrent calls to these methods are not safe.
+         */
+        auto enableRenderCache(bool enable = true) -> void {
+            if (enable) {
+                if (!this->m_renderCache)
+                    this->m_renderCache.emplace();
+            } else {
+                this->m_renderCache.reset();
+            }
+        }
+
+        /**
+         Parses arguments invoking handlers of the options and positionals found.
+
+         All parse methods accept an optional ParseStats object to fill in with statistics of the parse.
+         Without it no statistics are gathered or timed.
+
+         In ARGUM_USE_EXPECTED mode common errors refer to the text of the arguments (see BasicParsingError)
+         and must not be inspected after the arguments are destroyed. Methods that take arguments by 
+         rvalue reference convert such errors into exception objects before returning.
+         */
+        auto parse(int argc, CharType ** argv, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
+            return this->parse(makeArgSpan<CharType>(argc, argv), stats);
+        }
+
+        template<ArgRange<CharType> Args>
+        auto parse(const Args & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
+            
+            return this->parse(std::begin(args), std::end(args), stats);
         }
 
         template<ArgRange<CharType> Args>
-        auto parse(const Args & args) const -> ARGUM_EXPECTED(CharType, void) {
+        requires(!std::is_lvalue_reference_v<Args> && !std::ranges::borrowed_range<Args>)
+        auto parse(Args && args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
             
-            return this->parse(std::begin(args), std::end(args));
+            return detached([&]() { return this->parse(std::as_const(args), stats); });
+        }
+
+        /**
+         Parses arguments produced by BasicResponseFileReader::expandLazily()
+
+         Errors reading response files are reported the same way as parsing errors.
+         */
+        auto parse(const BasicLazyExpandedArgs<CharType> & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = this->parse(args.begin(), args.end(), stats);
+            if (auto err = args.error())
+                return err;
+            return ret;
+        #else
+            return this->parse(args.begin(), args.end(), stats);
+        #endif
         }
 
         template<ArgIterator<CharType> It>
-        auto parse(It argFirst, It argLast) const -> ARGUM_EXPECTED(CharType, void) {
+        auto parse(It argFirst, It argLast, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, void) {
             
             using ReturnType = ARGUM_EXPECTED(CharType, void);
             ParsingState parsingState(*this);
+            parsingState.collectStats(stats);
 
             return ReturnType(parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/false));
         }
 
-        auto parseUntilUnknown(int argc, CharType ** argv) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
-            return this->parseUntilUnknown(makeArgSpan<CharType>(argc, argv));
+        static constexpr size_t defaultMaxErrors = 20;
+
+        /**
+         Parses all arguments reporting every error found rather than stopping at the first one.
+
+         Unrecognized and ambiguous options, extra positionals, missing or extra option arguments,
+         errors reported by handlers and failed validators are recorded and parsing continues with the
+         next argument. Once `maxErrors` errors are found parsing stops. Handlers of the arguments that
+         were parsed successfully are invoked as usual. 
+         
+         Returns the errors in the order they were found, or an empty vector on success. 
+         */
+        auto parseCollectingErrors(int argc, CharType ** argv, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
+            return this->parseCollectingErrors(makeArgSpan<CharType>(argc, argv), maxErrors, stats);
+        }
+
+        template<ArgRange<CharType> Args>
+        auto parseCollectingErrors(const Args & args, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
+            
+            return this->parseCollectingErrors(std::begin(args), std::end(args), maxErrors, stats);
+        }
+
+        auto parseCollectingErrors(const BasicLazyExpandedArgs<CharType> & args, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = this->parseCollectingErrors(args.begin(), args.end(), maxErrors, stats);
+            if (auto err = args.error())
+                ret.emplace_back(std::move(err));
+            return ret;
+        #else
+            return this->parseCollectingErrors(args.begin(), args.end(), maxErrors, stats);
+        #endif
+        }
+
+        template<ArgIterator<CharType> It>
+        auto parseCollectingErrors(It argFirst, It argLast, size_t maxErrors = defaultMaxErrors, ParseStats * stats = nullptr) const -> std::vector<ParsingExceptionPtr> {
+            
+            std::vector<ParsingExceptionPtr> ret;
+            ParsingState parsingState(*this);
+            parsingState.collectErrors(ret, maxErrors);
+            parsingState.collectStats(stats);
+
+            //the error that reaches the limit stops parsing
+        #ifdef ARGUM_USE_EXPECTED
+            auto res = parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/false);
+            if (!res)
+                ret.emplace_back(res.error());
+        #else
+            try {
+                parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/false);
+            } catch (ParsingException & ex) {
+                ret.emplace_back(ex.clone());
+            }
+        #endif
+            return ret;
+        }
+
+        auto parseUntilUnknown(int argc, CharType ** argv, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            return this->parseUntilUnknown(makeArgSpan<CharType>(argc, argv), stats);
+        }
+
+        template<ArgRange<CharType> Args>
+        auto parseUntilUnknown(const Args & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+            
+            return this->parseUntilUnknown(std::begin(args), std::end(args), stats);
         }
 
         template<ArgRange<CharType> Args>
-        auto parseUntilUnknown(const Args & args) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+        requires(!std::is_lvalue_reference_v<Args> && !std::ranges::borrowed_range<Args>)
+        auto parseUntilUnknown(Args && args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
             
-            return this->parseUntilUnknown(std::begin(args), std::end(args));
+            return detached([&]() { return this->parseUntilUnknown(std::as_const(args), stats); });
+        }
+
+        auto parseUntilUnknown(const BasicLazyExpandedArgs<CharType> & args, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = this->parseUntilUnknown(args.begin(), args.end(), stats);
+            if (auto err = args.error())
+                return err;
+            return ret;
+        #else
+            return this->parseUntilUnknown(args.begin(), args.end(), stats);
+        #endif
         }
 
         template<ArgIterator<CharType> It>
-        auto parseUntilUnknown(It argFirst, It argLast) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
+        auto parseUntilUnknown(It argFirst, It argLast, ParseStats * stats = nullptr) const -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
             
             ParsingState parsingState(*this);
+            parsingState.collectStats(stats);
 
             return parsingState.parse(argFirst, argLast, /*stopOnUnknown=*/true);
         }
@@ -4202,6 +7824,8 @@ namespace Argum {
         auto formatUsage(StringViewType progName, std::optional<StringType> subCommand,
                          unsigned width,
                          const Colorizer & colorizer) const -> StringType {
+            if (this->m_renderCache)
+                return this->cachedRender(RenderKind::usage, progName, subCommand, width, colorizer);
             typename HelpFormatter::Layout layout;
             layout.width = width;
             return HelpFormatter(*this, progName, layout).formatUsage(subCommand, colorizer);
@@ -4240,20 +7864,196 @@ namespace Argum {
         auto formatHelp(StringViewType progName, std::optional<StringType> subCommand,
                         unsigned width,
                         const Colorizer & colorizer) const -> StringType {
+            if (this->m_renderCache)
+                return this->cachedRender(RenderKind::help, progName, subCommand, width, colorizer);
+            StringType ret;
+            auto out = std::back_inserter(ret);
+            this->formatHelp(out, progName, subCommand, width, colorizer);
+            return ret;
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, 
+                         unsigned width = HelpFormatter::defaultLayout.width,
+                         const Colorizer & colorizer = {}) const {
+            this->formatUsage(out, progName, {}, width, colorizer);
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, const Colorizer & colorizer) const {
+            this->formatUsage(out, progName, {}, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                         const Colorizer & colorizer) const {
+            this->formatUsage(out, progName, subCommand, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        void formatUsage(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                         unsigned width = HelpFormatter::defaultLayout.width,
+                         const Colorizer & colorizer = {}) const {
+            if (this->m_renderCache) {
+                out.write(this->cachedRender(RenderKind::usage, progName, subCommand, width, colorizer));
+                return;
+            }
+            typename HelpFormatter::Layout layout;
+            layout.width = width;
+            HelpFormatter(*this, progName, layout).formatUsage(out, subCommand, colorizer);
+        }
+
+        void formatHelp(OutputSink out, StringViewType progName, 
+                        unsigned width = HelpFormatter::defaultLayout.width,
+                        const Colorizer & colorizer = {}) const {
+            this->formatHelp(out, progName, {}, width, colorizer);
+        }
+
+        void formatHelp(OutputSink out, StringViewType progName, const Colorizer & colorizer) const {
+            this->formatHelp(out, progName, {}, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        void formatHelp(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                        const Colorizer & colorizer) const {
+            this->formatHelp(out, progName, subCommand, HelpFormatter::defaultLayout.width, colorizer);
+        }
+
+        /**
+         Writes usage and help to the sink incrementally, without building the 
+         whole text in memory.
+         */
+        void formatHelp(OutputSink out, StringViewType progName, std::optional<StringType> subCommand,
+                        unsigned width = HelpFormatter::defaultLayout.width,
+                        const Colorizer & colorizer = {}) const {
+            if (this->m_renderCache) {
+                out.write(this->cachedRender(RenderKind::help, progName, subCommand, width, colorizer));
+                return;
+            }
             typename HelpFormatter::Layout layout;
             layout.width = width;           
             HelpFormatter formatter(*this, progName, layout);
-            StringType ret = formatter.formatUsage(subCommand, colorizer);
-            ret.append(2, CharConstants::endl);
-            ret.append(formatter.formatHelp(subCommand, colorizer));
+            formatter.formatUsage(out, subCommand, colorizer);
+            out.write(2, CharConstants::endl);
+            formatter.formatHelp(out, subCommand, colorizer);
+        }
+
+        auto isOptionNameLong(const StringViewType name) const -> bool {
+            return this->m_tokenizer.isOptionNameLong(name);
+        }
+
+    private:
+        enum class RenderKind {
+            usage,
+            help
+        };
+
+        using ColorScheme = BasicColorScheme<CharType>;
+        using ColorSchemeCopy = std::array<StringType, 12>;
+
+        static constexpr StringViewType ColorScheme::* colorSchemeFields[] = {
+            &ColorScheme::heading,
+            &ColorScheme::progName,
+            &ColorScheme::shortOptionInUsage,
+            &ColorScheme::longOptionInUsage,
+            &ColorScheme::optionArgInUsage,
+            &ColorScheme::positionalInUsage,
+            &ColorScheme::shortOption,
+            &ColorScheme::longOption,
+            &ColorScheme::optionArg,
+            &ColorScheme::positional,
+            &ColorScheme::error,
+            &ColorScheme::warning
+        };
+        static_assert(std::size(colorSchemeFields) == std::tuple_size_v<ColorSchemeCopy>);
+
+        //Schemes are compared by content since they are often temporaries or live on the stack
+        static auto copyColorScheme(const ColorScheme & scheme) -> ColorSchemeCopy {
+            ColorSchemeCopy ret;
+            for (size_t i = 0; i < ret.size(); ++i)
+                ret[i] = scheme.*colorSchemeFields[i];
+            return ret;
+        }
+
+        //Invokes a parse converting a compact error in its result into an exception object that does not 
+        //refer to the arguments
+        template<class Func>
+        static auto detached(Func && func) -> decltype(func()) {
+        #ifdef ARGUM_USE_EXPECTED
+            auto ret = func();
+            ret.detachError();
             return ret;
+        #else
+            return func();
+        #endif
         }
 
-        auto isOptionNameLong(const StringViewType name) const -> bool {
-            return this->m_tokenizer.isOptionNameLong(name);
+        static auto sameColorScheme(const ColorSchemeCopy & lhs, const ColorScheme & rhs) -> bool {
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (lhs[i] != rhs.*colorSchemeFields[i])
+                    return false;
+            }
+            return true;
+        }
+
+        struct RenderCacheEntry {
+            RenderKind kind;
+            StringType progName;
+            std::optional<StringType> subCommand;
+            typename HelpFormatter::Layout layout;
+            ColorSchemeCopy scheme;
+            StringType text;
+        };
+
+        struct RenderCache {
+            static constexpr size_t maxEntries = 8;
+
+            size_t updateCount = size_t(-1);
+            std::optional<ColorSchemeCopy> namesScheme;
+            typename HelpFormatter::ItemNames names;
+            std::vector<RenderCacheEntry> entries;
+        };
+
+        auto cachedRender(RenderKind kind, 
+                          StringViewType progName, 
+                          const std::optional<StringType> & subCommand,
+                          unsigned width,
+                          const Colorizer & colorizer) const -> const StringType & {
+            
+            auto & cache = *this->m_renderCache;
+            if (cache.updateCount != this->m_updateCount) {
+                cache.entries.clear();
+                cache.namesScheme.reset();
+                cache.updateCount = this->m_updateCount;
+            }
+
+            typename HelpFormatter::Layout layout;
+            layout.width = width;
+
+            auto & scheme = colorizer.scheme();
+            for (auto & entry: cache.entries) {
+                if (entry.kind == kind && entry.layout == layout && entry.progName == progName &&
+                    entry.subCommand == subCommand && sameColorScheme(entry.scheme, scheme))
+                    return entry.text;
+            }
+
+            HelpFormatter formatter(*this, progName, layout);
+            if (!cache.namesScheme || !sameColorScheme(*cache.namesScheme, scheme)) {
+                cache.names = formatter.calculateItemNames(colorizer);
+                cache.namesScheme = copyColorScheme(scheme);
+            }
+            formatter.useItemNames(cache.names);
+
+            if (cache.entries.size() == RenderCache::maxEntries)
+                cache.entries.erase(cache.entries.begin());
+            auto & entry = cache.entries.emplace_back(RenderCacheEntry{
+                kind, StringType(progName), subCommand, layout, copyColorScheme(scheme), {}
+            });
+
+            auto out = std::back_inserter(entry.text);
+            formatter.formatUsage(out, subCommand, colorizer);
+            if (kind == RenderKind::help) {
+                entry.text.append(2, CharConstants::endl);
+                formatter.formatHelp(out, subCommand, colorizer);
+            }
+            return entry.text;
         }
 
-    private:
         class ParsingState {
         public:
             ParsingState(const BasicParser & owner): 
@@ -4261,57 +8061,98 @@ namespace Argum {
                 m_updateCountAtLastRecalc(owner.m_updateCount - 1) {
             }
 
+            auto collectErrors(std::vector<ParsingExceptionPtr> & errors, size_t maxErrors) -> void {
+                m_errors = &errors;
+                m_maxErrors = maxErrors;
+            }
+
+            auto collectStats(ParseStats * stats) -> void {
+                m_stats = stats;
+            }
+
             template<ArgIterator<CharType> It>
             auto parse(It argFirst, It argLast, bool stopOnUnknown) -> ARGUM_EXPECTED(CharType, std::vector<StringType>) {
             
+                PhaseTimer totalTimer(m_stats, &ParseStats::totalTime);
+                AllocationCounter allocationCounter(m_stats);
+
+                //tracks the current argument without requiring random access to arguments
+                It current = argFirst;
+                unsigned currentIdx = 0;
+                //text at the start of an argument as a view into the command line for compact errors
+                auto inArgument = [&](StringViewType text, unsigned argIdx) -> std::optional<StringViewType> {
+                #ifdef ARGUM_USE_EXPECTED
+                    for ( ; currentIdx < argIdx; ++currentIdx)
+                        ++current;
+                    StringViewType arg = *current;
+                    if (arg.starts_with(text))
+                        return arg.substr(0, text.size());
+                #else
+                    (void)text; (void)argIdx;
+                #endif
+                    return std::nullopt;
+                };
                 ARGUM_CHECK_RESULT(auto ret, m_owner.m_tokenizer.tokenize(argFirst, argLast, [&](auto && token) -> ARGUM_EXPECTED(CharType, typename Tokenizer::TokenResult) {
 
                     using TokenType = std::remove_cvref_t<decltype(token)>;
 
                     if constexpr (std::is_same_v<TokenType, typename Tokenizer::OptionToken>) {
 
-                        ARGUM_PROPAGATE_ERROR(resetOption(token.idx, token.usedName, token.argument));
+                        Impl::countIn(m_stats, &ParseStats::optionTokens);
+                        ARGUM_PROPAGATE_ERROR(resetOption(token.idx, token.argIdx, token.usedName, inArgument(token.usedName, token.argIdx), 
+                                                          token.argument));
                         return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::OptionStopToken>) {
 
+                        Impl::countIn(m_stats, &ParseStats::optionStopTokens);
                         ARGUM_PROPAGATE_ERROR(completeOption());
                         return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::ArgumentToken>) {
 
-                        ARGUM_CHECK_RESULT(auto result, handlePositional(token.value, argFirst + token.argIdx, argLast));
+                        Impl::countIn(m_stats, &ParseStats::argumentTokens);
+                        for ( ; currentIdx < token.argIdx; ++currentIdx)
+                            ++current;
+                        ARGUM_CHECK_RESULT(auto result, handlePositional(token.value, current, argLast));
                         if (!result) {
                             if (stopOnUnknown)
                                 return Tokenizer::StopBefore;
-                            ARGUM_THROW(ExtraPositional, token.value);
+                            ARGUM_PROPAGATE_ERROR(failAt<ExtraPositional>(token.value, inArgument(token.value, token.argIdx), int(token.argIdx)));
                         }
                         return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::UnknownOptionToken>) {
 
+                        Impl::countIn(m_stats, &ParseStats::unknownOptionTokens);
                         ARGUM_PROPAGATE_ERROR(completeOption());
                         if (stopOnUnknown)
                             return Tokenizer::StopBefore;
-                        ARGUM_THROW(UnrecognizedOption, token.name);
+                        ARGUM_PROPAGATE_ERROR(failAt<UnrecognizedOption>(token.name, inArgument(token.name, token.argIdx), int(token.argIdx)));
+                        return Tokenizer::Continue;
 
                     } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::AmbiguousOptionToken>) {
 
+                        Impl::countIn(m_stats, &ParseStats::ambiguousOptionTokens);
                         ARGUM_PROPAGATE_ERROR(completeOption());
-                        ARGUM_THROW(AmbiguousOption, token.name, std::move(token.possibilities));
+                        ARGUM_PROPAGATE_ERROR(fail<AmbiguousOption>(token.name, std::move(token.possibilities)));
+                        return Tokenizer::Continue;
                     } 
-                }));
+                }, m_stats));
                 ARGUM_PROPAGATE_ERROR(completeOption());
                 ARGUM_PROPAGATE_ERROR(validate());
                 return ret;
             }
 
         private:
-            auto resetOption(unsigned index, StringViewType name, const std::optional<StringViewType> & argument) -> ARGUM_EXPECTED(CharType, void) {
+            auto resetOption(unsigned index, unsigned argIdx, StringViewType name, std::optional<StringViewType> nameInArgument, 
+                             const std::optional<StringViewType> & argument) -> ARGUM_EXPECTED(CharType, void) {
                 ARGUM_PROPAGATE_ERROR(completeOption());
                 m_optionName = std::move(name);
+                m_optionNameInArgument = nameInArgument;
                 m_optionArgument = argument;
                 m_optionIndex = int(index);
+                m_optionArgIdx = int(argIdx);
                 return ARGUM_VOID_SUCCESS;
             }
 
@@ -4326,14 +8167,14 @@ namespace Argum {
                     constexpr auto argumentKind = Option::template argumentKindOf<HandlerType>();
                     if constexpr (argumentKind == OptionArgumentKind::None) {
                         if (m_optionArgument)
-                            ARGUM_THROW(ExtraOptionArgument, m_optionName);
-                        ARGUM_PROPAGATE_ERROR(handler());
+                            return failAt<ExtraOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx);
+                        ARGUM_PROPAGATE_ERROR(callHandler(handler));
                     } else if constexpr (argumentKind == OptionArgumentKind::Optional) {
-                        ARGUM_PROPAGATE_ERROR(handler(m_optionArgument));
+                        ARGUM_PROPAGATE_ERROR(callHandler(handler, m_optionArgument));
                     } else {
                         if (!m_optionArgument)
-                            ARGUM_THROW(MissingOptionArgument, m_optionName);
-                        ARGUM_PROPAGATE_ERROR(handler(*m_optionArgument));
+                            return failAt<MissingOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx);
+                        ARGUM_PROPAGATE_ERROR(callHandler(handler, *m_optionArgument));
                     }
                     return ARGUM_VOID_SUCCESS;
                 }, option.m_handler));
@@ -4354,26 +8195,29 @@ namespace Argum {
                         using HandlerType = std::remove_cvref_t<decltype(handler)>;
                         constexpr auto argumentKind = Option::template argumentKindOf<HandlerType>();
                         if constexpr (argumentKind == OptionArgumentKind::None) {
-                            if (m_optionArgument)
-                                ARGUM_THROW(ExtraOptionArgument, m_optionName);
-                            ARGUM_PROPAGATE_ERROR(handler());
+                            if (m_optionArgument) {
+                                ARGUM_PROPAGATE_ERROR(failAt<ExtraOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx));
+                            } else {
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler));
+                            }
                             return false;
                         } else if constexpr (argumentKind == OptionArgumentKind::Optional) {
                             if (requireAttachedArgument || m_optionArgument) {
-                                ARGUM_PROPAGATE_ERROR(handler(m_optionArgument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, m_optionArgument));
                                 return false;
                             } else {
-                                ARGUM_PROPAGATE_ERROR(handler(argument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, argument));
                                 return true;
                             }
                         } else {
                             if (m_optionArgument) {
-                                ARGUM_PROPAGATE_ERROR(handler(*m_optionArgument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, *m_optionArgument));
                                 return false;
                             } else if (requireAttachedArgument) {
-                                ARGUM_THROW(MissingOptionArgument, m_optionName);
+                                ARGUM_PROPAGATE_ERROR(failAt<MissingOptionArgument>(m_optionName, m_optionNameInArgument, m_optionArgIdx));
+                                return false;
                             } else {
-                                ARGUM_PROPAGATE_ERROR(handler(argument));
+                                ARGUM_PROPAGATE_ERROR(callHandler(handler, argument));
                                 return true;
                             }
                         }
@@ -4386,10 +8230,10 @@ namespace Argum {
             auto validateOptionMax(const Option & option) -> ARGUM_EXPECTED(CharType, void) {
                 auto & name = option.m_names.main();
                 ++m_validationData.optionCount(name);
+                Impl::countIn(m_stats, &ParseStats::validatorEvaluations);
                 auto validator = optionOccursAtMost(name, option.m_occurs.max());
-                if (!validator(m_validationData)) {
-                    ARGUM_THROW(ValidationError, validator);
-                }
+                if (!validator(m_validationData))
+                    return fail<ValidationError>(validator);
                 return ARGUM_VOID_SUCCESS;
             }
 
@@ -4423,7 +8267,7 @@ namespace Argum {
                 }
                 
                 auto & count = m_validationData.positionalCount(positional->m_name);
-                ARGUM_PROPAGATE_ERROR(positional->m_handler(value));
+                ARGUM_PROPAGATE_ERROR(callHandler(positional->m_handler, value));
                 ++count;
                 return true;
             }
@@ -4433,25 +8277,43 @@ namespace Argum {
 
                 if (m_updateCountAtLastRecalc == m_owner.m_updateCount)
                     return;
+
+                Impl::countIn(m_stats, &ParseStats::positionalRecalculations);
+                PhaseTimer timer(m_stats, &ParseStats::positionalRecalculationTime);
                 
-                //1. Count remaining positional arguments
-                unsigned remainingPositionalCount = countRemainingPositionals(remainingArgFirst, argLast);
-                
-                //2. Build the partitioner for positional ranges
-                Partitioner<unsigned> partitioner;
-                
-                auto fillStartIndex = m_positionalIndex + 1;
+                auto fillStartIndex = unsigned(m_positionalIndex + 1);
+                unsigned alreadyProcessed = 0;
                 if (m_positionalIndex >= 0) {
                     auto & positional = m_owner.m_positionals[unsigned(m_positionalIndex)];
                     auto count = m_validationData.positionalCount(positional.m_name);
                     if (positional.m_occurs.max() > count) {
-                        remainingPositionalCount += count; //account for already processed
-                        partitioner.addRange(positional.m_occurs.min(), positional.m_occurs.max());
+                        alreadyProcessed = count;
                         --fillStartIndex;
                     }
                 }
-                std::for_each(m_owner.m_positionals.begin() + (m_positionalIndex + 1), m_owner.m_positionals.end(),
-                                [&] (const Positional & positional) {
+                auto first = m_owner.m_positionals.begin() + fillStartIndex;
+                auto last = m_owner.m_positionals.end();
+                m_positionalSizes.resize(m_owner.m_positionals.size());
+
+                //If only the last positional can take a variable number of arguments each one simply takes
+                //as many as it can. Counting the arguments would require tokenizing the rest of the command 
+                //line which, for lazily expanded arguments, means reading all remaining response files.
+                if (first == last || std::all_of(first, last - 1, [](const Positional & positional) {
+                        return positional.m_occurs.min() == positional.m_occurs.max(); 
+                    })) {
+                    std::transform(first, last, m_positionalSizes.begin() + fillStartIndex, [](const Positional & positional) {
+                        return positional.m_occurs.max();
+                    });
+                    this->m_updateCountAtLastRecalc = m_owner.m_updateCount;
+                    return;
+                }
+
+                //1. Count remaining positional arguments, accounting for already processed
+                unsigned remainingPositionalCount = countRemainingPositionals(remainingArgFirst, argLast) + alreadyProcessed;
+                
+                //2. Build the partitioner for positional ranges
+                Partitioner<unsigned> partitioner;
+                std::for_each(first, last, [&] (const Positional & positional) {
                     partitioner.addRange(positional.m_occurs.min(), positional.m_occurs.max());
                 });
 
@@ -4461,7 +8323,6 @@ namespace Argum {
                 ARGUM_ALWAYS_ASSERT(res); //this must be true by construction
 
                 //4. Fill in expected sizes based on regex matches
-                m_positionalSizes.resize(m_owner.m_positionals.size());
                 std::copy(res->begin(), res->end() - 1, m_positionalSizes.begin() + fillStartIndex);
 
                 this->m_updateCountAtLastRecalc = m_owner.m_updateCount;
@@ -4479,81 +8340,693 @@ namespace Argum {
 
                         auto & option = m_owner.m_options[token.idx];
                         if (option.canHaveArgument()) {
-                            currentOptionExpectsArgument = !token.argument;
+                            currentOptionExpectsArgument = !token.argument && !option.m_requireAttachedArgument;
                         } else {
                             currentOptionExpectsArgument = false;
                         }
 
-                    } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::OptionStopToken>) {
+                    } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::OptionStopToken>) {
+
+                        currentOptionExpectsArgument = false;
+
+                    } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::ArgumentToken>) {
+
+                        if (!currentOptionExpectsArgument)
+                            ++remainingPositionalCount;
+                        else
+                            currentOptionExpectsArgument = false;
+
+                    } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::UnknownOptionToken>) {
+
+                        currentOptionExpectsArgument = false;
+                    }
+                    return Tokenizer::Continue;
+                }, m_stats);
+                
+                return remainingPositionalCount;
+            }
+
+            auto validate() -> ARGUM_EXPECTED(CharType, void) {
+
+                PhaseTimer timer(m_stats, &ParseStats::validationTime);
+
+                //We could use normal validators for this but it is faster to do it manually
+                for(auto idx = (m_positionalIndex >= 0 ? unsigned(m_positionalIndex) : 0u); 
+                    idx != unsigned(m_owner.m_positionals.size());
+                    ++idx) {
+                    
+                    auto & positional = m_owner.m_positionals[unsigned(idx)];
+                    auto validator = positionalOccursAtLeast(positional.m_name, positional.m_occurs.min());
+                    Impl::countIn(m_stats, &ParseStats::validatorEvaluations);
+                    if (!validator(m_validationData)) {
+                        ARGUM_PROPAGATE_ERROR(fail<ValidationError>(validator));
+                    }
+                }
+                
+                for(auto & [validator, desc]: m_owner.m_validators) {
+                    Impl::countIn(m_stats, &ParseStats::validatorEvaluations);
+                    if (!validator(m_validationData)) {
+                        ARGUM_PROPAGATE_ERROR(fail<ValidationError>(desc));
+                    }
+                }
+
+                return ARGUM_VOID_SUCCESS;
+            }
+
+            //Whether the next error can be recorded and parsing continued
+            auto canRecover() const -> bool {
+                return m_errors && m_errors->size() + 1 < m_maxErrors;
+            }
+
+            //Reports an error: records it when collecting errors and there is room, fails otherwise
+            template<class Exception, class... Args>
+            auto fail(Args && ...args) -> ARGUM_EXPECTED(CharType, void) {
+                if (canRecover()) {
+                    m_errors->emplace_back(std::make_shared<Exception>(std::forward<Args>(args)...));
+                    return ARGUM_VOID_SUCCESS;
+                }
+                ARGUM_THROW(Exception, std::forward<Args>(args)...);
+            }
+
+            //Reports an error about text of an argument. Unless the error is recorded, in ARGUM_USE_EXPECTED 
+            //mode it refers to the text in the command line, if found there, rather than copying it
+            template<class Exception>
+            auto failAt(StringViewType subject, std::optional<StringViewType> inCommandLine, int argIdx) -> ARGUM_EXPECTED(CharType, void) {
+            #ifdef ARGUM_USE_EXPECTED
+                if (inCommandLine && !canRecover()) {
+                    if (auto compact = BasicParsingError<CharType>::template make<Exception>(*inCommandLine, argIdx))
+                        return *compact;
+                }
+            #else
+                (void)inCommandLine;
+            #endif
+                return fail<Exception>(subject, argIdx);
+            }
+
+            //Invokes a user handler recording its error when collecting errors
+            template<class Handler, class... Args>
+            auto callHandler(const Handler & handler, Args && ...args) -> ARGUM_EXPECTED(CharType, void) {
+                Impl::countIn(m_stats, &ParseStats::handlerInvocations);
+                PhaseTimer timer(m_stats, &ParseStats::handlersTime);
+            #ifdef ARGUM_USE_EXPECTED
+                auto res = handler(std::forward<Args>(args)...);
+                if (!res && canRecover()) {
+                    m_errors->emplace_back(res.error());
+                    return {};
+                }
+                return res;
+            #else
+                if (!m_errors)
+                    return handler(std::forward<Args>(args)...);
+                try {
+                    handler(std::forward<Args>(args)...);
+                } catch (ParsingException & ex) {
+                    if (!canRecover())
+                        throw;
+                    m_errors->emplace_back(ex.clone());
+                }
+            #endif
+            }
+
+            //Adds the time until its destruction to a phase of stats if they are being collected
+            class PhaseTimer {
+            public:
+                PhaseTimer(ParseStats * stats, ParseStats::Duration ParseStats::*phase):
+                    m_stats(stats),
+                    m_phase(phase) {
+                    if (m_stats)
+                        m_start = ParseStats::Clock::now();
+                }
+                ~PhaseTimer() {
+                    if (m_stats)
+                        m_stats->*m_phase += ParseStats::Clock::now() - m_start;
+                }
+                PhaseTimer(const PhaseTimer &) = delete;
+                PhaseTimer & operator=(const PhaseTimer &) = delete;
+            private:
+                ParseStats * m_stats;
+                ParseStats::Duration ParseStats::*m_phase;
+                ParseStats::Clock::time_point m_start;
+            };
+
+            //Adds the allocations made until its destruction to stats if they are being collected
+            class AllocationCounter {
+            public:
+                AllocationCounter(ParseStats * stats):
+                    m_stats(stats && stats->allocationCounter ? stats : nullptr) {
+                    if (m_stats)
+                        m_start = m_stats->allocationCounter();
+                }
+                ~AllocationCounter() {
+                    if (m_stats)
+                        m_stats->allocations += m_stats->allocationCounter() - m_start;
+                }
+                AllocationCounter(const AllocationCounter &) = delete;
+                AllocationCounter & operator=(const AllocationCounter &) = delete;
+            private:
+                ParseStats * m_stats;
+                size_t m_start = 0;
+            };
+
+        private:
+            const BasicParser & m_owner;
+            size_t m_updateCountAtLastRecalc;
+
+            int m_optionIndex = -1;
+            int m_optionArgIdx = -1;
+            StringType m_optionName;
+            std::optional<StringViewType> m_optionNameInArgument;
+            std::optional<StringType> m_optionArgument;
+
+            int m_positionalIndex = -1;
+            std::vector<unsigned> m_positionalSizes;
+            
+            ValidationData m_validationData;
+
+            std::vector<ParsingExceptionPtr> * m_errors = nullptr;
+            size_t m_maxErrors = 0;
+
+            ParseStats * m_stats = nullptr;
+        };
+
+    private:
+        std::vector<Option> m_options;
+        std::vector<Positional> m_positionals;
+        Tokenizer m_tokenizer;
+        std::vector<std::pair<ValidatorFunction, StringType>> m_validators;
+        size_t m_updateCount = 0;
+        SubCommandMark m_subCommandMark;
+        mutable std::optional<RenderCache> m_renderCache;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(Parser)
+
+}
+
+#endif 
+#ifndef HEADER_ARGUM_RESPONSE_FILE_WRITER_H_INCLUDED
+#define HEADER_ARGUM_RESPONSE_FILE_WRITER_H_INCLUDED
+
+
+
+
+#if !defined(_WIN32) && __has_include(<unistd.h>)
+    #define ARGUM_HAS_UNISTD_H
+#endif
+
+namespace Argum {
+
+    /**
+     Writes response files that BasicResponseFileReader with its default splitter reads back
+     into the same arguments.
+
+     The default splitter has no quoting: each line is one argument with surrounding whitespace
+     trimmed and empty lines skipped. Arguments that cannot survive this - empty ones, ones
+     containing a newline or starting or ending with whitespace - are only representable in the
+     binary format (see BinaryResponseFile). With `Format::automatic` the text format is used
+     when possible and the binary one otherwise.
+
+     Note that the reader expands arguments starting with its prefix in either format.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicResponseFileWriter {
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+
+        enum class Format {
+            automatic,
+            lines,
+            binary
+        };
+
+        struct Exception : public BasicParsingException<CharType> {
+            ARGUM_IMPLEMENT_EXCEPTION(Exception, BasicParsingException<CharType>, Error::ResponseFileWriteError)
+
+            Exception(const std::filesystem::path & filename_, std::error_code error_):
+                BasicParsingException<CharType>(ErrorCode),
+                filename(filename_),
+                error(error_) {
+            }
+            std::filesystem::path filename;
+            std::error_code error;
+        protected:
+            auto formatMessage() const -> StringType override {
+                return format<Messages<CharType>::errorWritingResponseFile>(this->filename.native(), this->error.message());
+            }
+        };
+
+    public:
+        BasicResponseFileWriter(Format format = Format::automatic): m_format(format) {
+        }
+
+        auto outputFormat() const -> Format {
+            return this->m_format;
+        }
+
+        //Whether the argument is read back unchanged from a line of a text response file
+        static auto representableAsLine(StringViewType arg) -> bool {
+            return !arg.empty() &&
+                   !CharConstants<CharType>::isSpace(arg.front()) &&
+                   !CharConstants<CharType>::isSpace(arg.back()) &&
+                   arg.find(CharConstants<CharType>::endl) == StringViewType::npos;
+        }
+
+        //The format that will be used for the given arguments. In automatic format `wchar_t` arguments 
+        //that the current locale cannot encode are written in binary even if this returns lines.
+        template<ArgRange<CharType> Args>
+        auto formatFor(const Args & args) const -> Format {
+            if (this->m_format != Format::automatic)
+                return this->m_format;
+            for (StringViewType arg: args) {
+                if (!representableAsLine(arg))
+                    return Format::binary;
+            }
+            return Format::lines;
+        }
+
+        /**
+         Writes the arguments to a file with a single write call.
+         */
+        template<ArgRange<CharType> Args>
+        auto write(const std::filesystem::path & path, const Args & args) const -> ARGUM_EXPECTED(CharType, void) {
+            std::string buffer;
+            std::error_code error = this->serialize(args, buffer);
+            if (!error) {
+                SimpleFile file(path, "wb", error);
+                if (file)
+                    file.write(buffer.data(), buffer.size(), error);
+            }
+            if (error)
+                ARGUM_THROW(Exception, path, error);
+            return ARGUM_VOID_SUCCESS;
+        }
+
+        /**
+         Appends the file image for the arguments to dest.
+
+         The image size is computed upfront so that dest is allocated once. For `wchar_t`
+         in text format the arguments are encoded according to the current locale and the
+         size is only an estimate. In automatic format arguments that the locale cannot
+         encode are written in binary format instead.
+         */
+        template<ArgRange<CharType> Args>
+        auto serialize(const Args & args, std::string & dest) const -> std::error_code {
+            auto format = this->formatFor(args);
+            if (format == Format::lines) {
+                auto originalSize = dest.size();
+                auto error = serializeLines(args, dest);
+                if (!error || this->m_format != Format::automatic)
+                    return error;
+                dest.resize(originalSize);
+            }
+            serializeBinary(args, dest);
+            return {};
+        }
+
+        /**
+         Maximum size of a command line that can be passed to a new process.
+
+         On Windows this is the `CreateProcess` limit in characters. Elsewhere it is `ARG_MAX` in
+         bytes less 2048 bytes of headroom as recommended by POSIX for `xargs`. The environment
+         passed to the process counts against the same limit on most systems and is not
+         accounted for.
+         */
+        static auto commandLineLimit() -> size_t {
+        #if defined(_WIN32)
+            return 32767;
+        #else
+            long argMax = -1;
+            #ifdef ARGUM_HAS_UNISTD_H
+                argMax = sysconf(_SC_ARG_MAX);
+            #endif
+            if (argMax <= 0)
+                argMax = 4096; //_POSIX_ARG_MAX
+            return size_t(argMax) > 2 * headroom ? size_t(argMax) - headroom : size_t(argMax) / 2;
+        #endif
+        }
+
+        /**
+         Projected size of the command line made of the arguments in the units of commandLineLimit().
+
+         On Windows this includes the separators and the quoting a process launcher needs to add.
+         Elsewhere it includes the terminating null and pointer of each argument in the
+         argument array. For `wchar_t` each non-ASCII character is assumed to take `MB_CUR_MAX`
+         bytes.
+         */
+        template<ArgRange<CharType> Args>
+        static auto commandLineSize(const Args & args) -> size_t {
+            size_t ret = 0;
+            for (StringViewType arg: args)
+                ret += argumentSize(arg);
+            return ret;
+        }
+
+        /**
+         Whether the arguments should be passed via a response file rather than directly.
+
+         Besides the total size, on Linux each single argument must not exceed `MAX_ARG_STRLEN`.
+         */
+        template<ArgRange<CharType> Args>
+        static auto needsResponseFile(const Args & args, size_t limit = commandLineLimit()) -> bool {
+            size_t total = 0;
+            for (StringViewType arg: args) {
+                size_t size = argumentSize(arg);
+            #ifdef __linux__
+                if (size > maxArgumentSize)
+                    return true;
+            #endif
+                total += size;
+                if (total > limit)
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        static constexpr size_t headroom = 2048;
+    #ifdef __linux__
+        //MAX_ARG_STRLEN is 32 pages
+        static constexpr size_t maxArgumentSize = 32 * 4096;
+    #endif
+
+        static auto argumentSize(StringViewType arg) -> size_t {
+        #ifdef _WIN32
+            //separator and the quoting rules of CommandLineToArgvW
+            size_t ret = arg.size() + 1;
+            if (!arg.empty() && arg.find_first_of(CharConstants<CharType>::windowsQuotedChars) == StringViewType::npos)
+                return ret;
+            ret += 2;
+            size_t backslashes = 0;
+            for (auto c: arg) {
+                if (c == CharConstants<CharType>::backslash) {
+                    ++backslashes;
+                    continue;
+                }
+                if (c == CharConstants<CharType>::doubleQuote)
+                    ret += backslashes + 1;
+                backslashes = 0;
+            }
+            return ret + backslashes;
+        #else
+            size_t ret = arg.size() + 1 + sizeof(char *);
+            if constexpr (!std::is_same_v<CharType, char>) {
+                for (auto c: arg) {
+                    if (uint32_t(c) >= 0x80)
+                        ret += MB_CUR_MAX - 1;
+                }
+            }
+            return ret;
+        #endif
+        }
+
+        template<ArgRange<CharType> Args>
+        static auto serializeLines(const Args & args, std::string & dest) -> std::error_code {
+            size_t size = 0;
+            for (StringViewType arg: args)
+                size += arg.size() + 1;
+            dest.reserve(dest.size() + size);
+            for (StringViewType arg: args) {
+                if constexpr (std::is_same_v<CharType, char>) {
+                    dest.append(arg);
+                } else {
+                    mbstate_t state = mbstate_t();
+                    for (auto c: arg) {
+                        //ASCII in initial shift state is the same in all supported encodings
+                        if (uint32_t(c) < 0x80 && mbsinit(&state)) {
+                            dest += char(c);
+                            continue;
+                        }
+                        char encoded[MB_LEN_MAX];
+                        size_t res = wcrtomb(encoded, c, &state);
+                        if (res == size_t(-1))
+                            return std::make_error_code(std::errc::illegal_byte_sequence);
+                        dest.append(encoded, res);
+                    }
+                    char encoded[MB_LEN_MAX];
+                    size_t res = wcrtomb(encoded, L'\0', &state);
+                    if (res == size_t(-1))
+                        return std::make_error_code(std::errc::illegal_byte_sequence);
+                    //the returned size includes the terminating null which is not needed
+                    dest.append(encoded, res - 1);
+                }
+                dest += '\n';
+            }
+            return {};
+        }
+
+        template<ArgRange<CharType> Args>
+        static auto serializeBinary(const Args & args, std::string & dest) -> void {
+            uint64_t count = 0;
+            size_t size = BinaryResponseFile::headerSize;
+            for (StringViewType arg: args) {
+                size += sizeof(uint64_t) + BinaryResponseFile::paddedSize(arg.size() * sizeof(CharType));
+                ++count;
+            }
+            dest.reserve(dest.size() + size);
+            dest.append(BinaryResponseFile::magic, sizeof(BinaryResponseFile::magic));
+            append(dest, uint32_t(sizeof(CharType)));
+            append(dest, uint32_t(0));
+            append(dest, count);
+            for (StringViewType arg: args) {
+                size_t byteSize = arg.size() * sizeof(CharType);
+                append(dest, uint64_t(arg.size()));
+                dest.append(reinterpret_cast<const char *>(arg.data()), byteSize);
+                dest.append(BinaryResponseFile::paddedSize(byteSize) - byteSize, '\0');
+            }
+        }
+
+        template<class T>
+        static auto append(std::string & dest, const T & val) -> void {
+            dest.append(reinterpret_cast<const char *>(&val), sizeof(T));
+        }
+
+    private:
+        Format m_format;
+    };
+
+    ARGUM_DECLARE_FRIENDLY_NAMES(ResponseFileWriter)
+}
+
+#endif
+#ifndef HEADER_ARGUM_QUOTING_SPLITTER_H_INCLUDED
+#define HEADER_ARGUM_QUOTING_SPLITTER_H_INCLUDED
+
+
+
+
+namespace Argum {
+
+    /**
+     Response file splitter that allows multiple, quoted arguments on each line.
+
+     With `Syntax::posixShell` the rules follow POSIX shell word splitting without any expansions:
+     - arguments are separated by whitespace
+     - outside of quotes a backslash escapes the next character
+     - inside single quotes all characters are literal
+     - inside double quotes a backslash only escapes `$`, `` ` ``, `"` and `\`
+     - a `#` at the start of an argument starts a comment that extends to the end of the line
+
+     With `Syntax::gcc` the rules are the ones of GCC `@file` arguments: arguments are separated by
+     whitespace, single and double quotes group characters, and a backslash escapes the next
+     character everywhere, including inside quotes.
+
+     Lines are split independently: a quote that is not closed on its line is closed at its end and
+     a backslash at the end of the line is ignored.
+
+     Each line is scanned once. Arguments that need no unescaping are produced as views into the
+     line (or, when splitting owned lines, by moving the line if it is a single argument). Others
+     are unescaped directly into their final storage.
+     */
+    ARGUM_MOD_EXPORTED
+    template<class Char>
+    class BasicQuotingSplitter {
+    public:
+        using CharType = Char;
+        using StringType = std::basic_string<Char>;
+        using StringViewType = std::basic_string_view<Char>;
+
+        enum class Syntax {
+            posixShell,
+            gcc
+        };
+
+    public:
+        BasicQuotingSplitter(Syntax syntax = Syntax::posixShell): m_syntax(syntax) {
+        }
 
-                        currentOptionExpectsArgument = false;
+        auto syntax() const -> Syntax {
+            return this->m_syntax;
+        }
 
-                    } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::ArgumentToken>) {
+        //Splitter for BasicResponseFileReader::expand() and expandConcurrently()
+        template<class OutIt>
+        void operator()(StringType && line, OutIt dest) const {
+            OwningEmitter<OutIt> emitter{line, dest, {}};
+            this->split(StringViewType(line), emitter);
+        }
 
-                        if (!currentOptionExpectsArgument)
-                            ++remainingPositionalCount;
-                        else
-                            currentOptionExpectsArgument = false;
+        //Splitter for BasicResponseFileReader::expandMapped() and expandLazily()
+        template<class OutIt>
+        void operator()(StringViewType line, OutIt dest, BasicArgumentStore<CharType> & store) const {
+            ViewEmitter<OutIt> emitter{store, dest, 0};
+            this->split(line, emitter);
+        }
 
-                    } else if constexpr (std::is_same_v<TokenType, typename Tokenizer::UnknownOptionToken>) {
+    private:
+        using Constants = CharConstants<CharType>;
+
+        template<class OutIt>
+        struct OwningEmitter {
+            StringType & line;
+            OutIt & dest;
+            //scratch space for unescaping, allocated once per line
+            StringType buffer;
+
+            void view(StringViewType arg) {
+                if (arg.data() == line.data() && arg.size() == line.size())
+                    *dest = std::move(line);
+                else
+                    *dest = StringType(arg);
+            }
+            auto begin(size_t maxSize) -> CharType * {
+                if (this->buffer.size() < maxSize)
+                    this->buffer.resize(maxSize);
+                return this->buffer.data();
+            }
+            void finish(CharType * data, size_t size) {
+                *dest = StringType(data, size);
+            }
+        };
 
-                        currentOptionExpectsArgument = false;
-                    }
-                    return Tokenizer::Continue;
-                });
-                
-                return remainingPositionalCount;
+        template<class OutIt>
+        struct ViewEmitter {
+            BasicArgumentStore<CharType> & store;
+            OutIt & dest;
+            size_t allocated = 0;
+
+            void view(StringViewType arg) {
+                *dest = arg;
+            }
+            auto begin(size_t maxSize) -> CharType * {
+                this->allocated = maxSize;
+                return this->store.allocate(maxSize);
             }
+            void finish(CharType * data, size_t size) {
+                this->store.shrink(data, this->allocated, size);
+                *dest = StringViewType(data, size);
+            }
+        };
 
-            auto validate() -> ARGUM_EXPECTED(CharType, void) {
+        template<class Emitter>
+        void split(StringViewType line, Emitter & emitter) const {
+            if (this->m_syntax == Syntax::gcc)
+                splitLine<Syntax::gcc>(line, emitter);
+            else
+                splitLine<Syntax::posixShell>(line, emitter);
+        }
 
-                //We could use normal validators for this but it is faster to do it manually
-                for(auto idx = (m_positionalIndex >= 0 ? unsigned(m_positionalIndex) : 0u); 
-                    idx != unsigned(m_owner.m_positionals.size());
-                    ++idx) {
-                    
-                    auto & positional = m_owner.m_positionals[unsigned(idx)];
-                    auto validator = positionalOccursAtLeast(positional.m_name, positional.m_occurs.min());
-                    if (!validator(m_validationData))
-                        ARGUM_THROW(ValidationError, validator);
-                }
-                
-                for(auto & [validator, desc]: m_owner.m_validators) {
-                    if (!validator(m_validationData))
-                        ARGUM_THROW(ValidationError, desc);
-                }
+        template<Syntax syntax, class Emitter>
+        static void splitLine(StringViewType line, Emitter & emitter) {
+            enum class State { unquoted, singleQuoted, doubleQuoted };
 
-                return ARGUM_VOID_SUCCESS;
-            }
+            const CharType * current = line.data();
+            const CharType * const last = current + line.size();
+            for ( ; ; ) {
+                while (current != last && isSpace(*current))
+                    ++current;
+                if (current == last)
+                    break;
+                if constexpr (syntax == Syntax::posixShell) {
+                    if (*current == Constants::hash)
+                        break;
+                }
 
-        private:
-            const BasicParser & m_owner;
-            size_t m_updateCountAtLastRecalc;
+                const CharType * const start = current;
+                //set once the argument differs from its source text
+                CharType * outStart = nullptr;
+                CharType * out = nullptr;
+                auto startCopy = [&]() {
+                    outStart = emitter.begin(size_t(last - start));
+                    out = std::copy(start, current, outStart);
+                };
 
-            int m_optionIndex = -1;
-            StringType m_optionName;
-            std::optional<StringType> m_optionArgument;
+                State state = State::unquoted;
+                for ( ; current != last; ++current) {
+                    CharType c = *current;
+                    if (state == State::unquoted) {
+                        if (isSpace(c))
+                            break;
+                        if (c == Constants::singleQuote || c == Constants::doubleQuote) {
+                            if (!out)
+                                startCopy();
+                            state = (c == Constants::singleQuote ? State::singleQuoted : State::doubleQuoted);
+                            continue;
+                        }
+                        if (c == Constants::backslash) {
+                            if (!out)
+                                startCopy();
+                            if (current + 1 != last)
+                                *out++ = *++current;
+                            continue;
+                        }
+                    } else if (state == State::singleQuoted) {
+                        if (c == Constants::singleQuote) {
+                            state = State::unquoted;
+                            continue;
+                        }
+                        if constexpr (syntax == Syntax::gcc) {
+                            if (c == Constants::backslash) {
+                                if (current + 1 != last)
+                                    *out++ = *++current;
+                                continue;
+                            }
+                        }
+                    } else {
+                        if (c == Constants::doubleQuote) {
+                            state = State::unquoted;
+                            continue;
+                        }
+                        if (c == Constants::backslash) {
+                            if (current + 1 == last)
+                                continue;
+                            if (syntax == Syntax::gcc || isShellEscapableInDoubleQuotes(current[1])) {
+                                *out++ = *++current;
+                                continue;
+                            }
+                        }
+                    }
+                    if (out)
+                        *out++ = c;
+                }
+                if (out)
+                    emitter.finish(outStart, size_t(out - outStart));
+                else
+                    emitter.view(StringViewType(start, size_t(current - start)));
+            }
+        }
 
-            int m_positionalIndex = -1;
-            std::vector<unsigned> m_positionalSizes;
-            
-            ValidationData m_validationData;
-        };
+        static auto isSpace(CharType c) -> bool {
+            //avoid the locale lookup for ASCII
+            if (std::make_unsigned_t<CharType>(c) < 0x80)
+                return c == Constants::space || (c >= Constants::tab && c <= Constants::carriageReturn);
+            return Constants::isSpace(c);
+        }
 
+        static auto isShellEscapableInDoubleQuotes(CharType c) -> bool {
+            return c == Constants::dollar || c == Constants::backtick ||
+                   c == Constants::doubleQuote || c == Constants::backslash;
+        }
     private:
-        std::vector<Option> m_options;
-        std::vector<Positional> m_positionals;
-        Tokenizer m_tokenizer;
-        std::vector<std::pair<ValidatorFunction, StringType>> m_validators;
-        size_t m_updateCount = 0;
-        SubCommandMark m_subCommandMark;
+        Syntax m_syntax;
     };
 
-    ARGUM_DECLARE_FRIENDLY_NAMES(Parser)
-
+    ARGUM_DECLARE_FRIENDLY_NAMES(QuotingSplitter)
 }
 
-#endif 
+#endif
 #ifndef HEADER_ARGUM_TYPE_PARSERS_H_INCLUDED
 #define HEADER_ARGUM_TYPE_PARSERS_H_INCLUDED
 
@@ -4574,7 +9047,7 @@ namespace Argum {
         std::basic_string<Char> value(std::forward<S>(str));
 
         if (value.empty())
-            ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+            ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
 
         T ret;
         Char * endPtr;
@@ -4586,14 +9059,14 @@ namespace Argum {
                 auto res = CharConstants::toLong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res < (decltype(res))std::numeric_limits<T>::min() || res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             } else  {
                 auto res = CharConstants::toLongLong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res < (decltype(res))std::numeric_limits<T>::min() || res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             }
@@ -4604,23 +9077,23 @@ namespace Argum {
                 auto res = CharConstants::toULong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             } else  {
                 auto res = CharConstants::toULongLong(value.data(), &endPtr, base);
                 if constexpr (sizeof(T) < sizeof(res)) {
                     if (res > (decltype(res))std::numeric_limits<T>::max())
-                        ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+                        ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
                 }
                 ret = T(res);
             }
         }
         if (errno == ERANGE)
-            ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+            ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
         for ( ; endPtr != value.data() + value.size(); ++endPtr) {
             if (!CharConstants::isSpace(*endPtr))
-                ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+                ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
         }
         
         return ret;
@@ -4639,7 +9112,7 @@ namespace Argum {
         std::basic_string<Char> value(std::forward<S>(str));
 
         if (value.empty())
-            ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+            ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
 
         T ret;
         Char * endPtr;
@@ -4654,10 +9127,10 @@ namespace Argum {
         }
 
         if (errno == ERANGE)
-            ARGUM_THROW(ValidationError, format(Messages::outOfRange(), value));
+            ARGUM_THROW(ValidationError, format<Messages::outOfRange>(value));
         for ( ; endPtr != value.data() + value.size(); ++endPtr) {
             if (!CharConstants::isSpace(*endPtr))
-                ARGUM_THROW(ValidationError, format(Messages::notANumber(), value));
+                ARGUM_THROW(ValidationError, format<Messages::notANumber>(value));
         }
         
         return ret;
@@ -4716,7 +9189,7 @@ namespace Argum {
             });
             if (it == this->m_choices.end()) {
                 if (!m_allowElse)
-                    ARGUM_THROW(ValidationError, format(Messages::notAValidChoice(), value, this->m_description));
+                    ARGUM_THROW(ValidationError, format<Messages::notAValidChoice>(value, this->m_description));
                 return this->m_choices.size();
             }
             return it - this->m_choices.begin();
@@ -4830,7 +9303,7 @@ namespace Argum {
         required    
     };
 
-    // Detect ColorStatus from the environment
+    // Detects ColorStatus from the environment, without caching
     // Logic taken from combination of:
     // https://no-color.org
     // https://force-color.org
@@ -4839,7 +9312,7 @@ namespace Argum {
     // https://gist.github.com/scop/4d5902b98f0503abec3fcbb00b38aec3
     // https://andrey-zherikov.github.io/argparse/ansi-coloring-and-styling.html#heuristic
     ARGUM_MOD_EXPORTED
-    inline auto environmentColorStatus() -> ColorStatus {
+    inline auto probeEnvironmentColorStatus() -> ColorStatus {
         using namespace std;
         using namespace std::literals;
 
@@ -4897,63 +9370,22 @@ namespace Argum {
         return ColorStatus::unknown;
     }
 
+    //Whether the file is a terminal, without caching
     ARGUM_MOD_EXPORTED
-    inline bool shouldUseColor(ColorStatus envColorStatus, FILE * fp) {
-        if (envColorStatus == ColorStatus::required)
-            return true;
-        if (envColorStatus == ColorStatus::forbidden)
-            return false;
-
+    inline auto probeIsTerminal(FILE * fp) -> bool {
 #if defined(ARGUM_HAS_UNISTD_H)
-        if (envColorStatus == ColorStatus::unknown)
-            return false;
-
         return isatty(fileno(fp));
-
 #elif defined(_WIN32)
         int desc = _fileno(fp);
-        if (desc < 0)
-            return false;
-
-        if (!_isatty(desc))
-            return false;
-
-        if (envColorStatus == ColorStatus::unknown) {
-        
-            HANDLE h = HANDLE(_get_osfhandle(_fileno(fp)));
-            if (h == INVALID_HANDLE_VALUE)
-                return false;
-
-            DWORD dwMode = 0;
-            if (!GetConsoleMode(h, &dwMode))
-                return false;
-
-            if (!(dwMode & ENABLE_VIRTUAL_TERMINAL_PROCESSING))
-                return false;
-        }
-
-        return true;
+        return desc >= 0 && _isatty(desc);
 #else
         return false;
 #endif
     }
 
+    //Width of the terminal the file refers to, without caching
     ARGUM_MOD_EXPORTED
-    inline auto colorizerForFile(ColorStatus envColorStatus, FILE * fp) -> Colorizer {
-        if (shouldUseColor(envColorStatus, fp))
-            return defaultColorizer();
-        return {};
-    }
-
-    ARGUM_MOD_EXPORTED
-    inline auto wideColorizerForFile(ColorStatus envColorStatus, FILE * fp) -> WColorizer {
-        if (shouldUseColor(envColorStatus, fp))
-            return defaultWColorizer();
-        return {};
-    }
-
-    ARGUM_MOD_EXPORTED
-    inline unsigned terminalWidth(FILE * fp) {
+    inline auto probeTerminalWidth(FILE * fp) -> unsigned {
         unsigned fallback = std::numeric_limits<unsigned>::max();
 
 #if defined(ARGUM_HAS_UNISTD_H) && defined(ARGUM_HAS_TIOCGWINSZ) 
@@ -5003,6 +9435,290 @@ namespace Argum {
 #endif
     }
 
+    /**
+     Snapshot of the environment color status and of the terminal properties of the standard streams.
+
+     Each value is probed on first use and cached. Values can also be injected with the `set...` 
+     methods. Injected values are kept until reset(). Probed ones are forgotten by invalidate() and, 
+     for terminal widths, when the terminal is resized if watchResize() was called. After redirecting
+     a standard stream to another file, for example with `dup2()` or `freopen()`, call 
+     invalidate(FILE *) for it. Files other than `stdin`, `stdout` and `stderr` are probed on every call.
+
+     The free functions environmentColorStatus(), shouldUseColor() and terminalWidth() use the
+     shared current() snapshot. All methods are safe to call concurrently.
+     */
+    ARGUM_MOD_EXPORTED
+    class TerminalInfo {
+    public:
+        TerminalInfo() = default;
+        TerminalInfo(const TerminalInfo &) = delete;
+        TerminalInfo & operator=(const TerminalInfo &) = delete;
+
+        static auto current() -> TerminalInfo & {
+            static TerminalInfo instance;
+            return instance;
+        }
+
+        auto colorStatus() -> ColorStatus {
+            unsigned ret;
+            uint64_t seen;
+            if (!this->m_colorStatus.get(ret, seen)) {
+                ret = unsigned(probeEnvironmentColorStatus());
+                this->m_colorStatus.storeProbed(seen, ret);
+            }
+            return ColorStatus(ret);
+        }
+
+        auto isTerminal(FILE * fp) -> bool {
+            auto slot = TerminalInfo::slotFor(this->m_isTerminal, fp);
+            if (!slot)
+                return probeIsTerminal(fp);
+            unsigned ret;
+            uint64_t seen;
+            if (!slot->get(ret, seen)) {
+                ret = probeIsTerminal(fp);
+                slot->storeProbed(seen, ret);
+            }
+            return ret;
+        }
+
+        auto width(FILE * fp) -> unsigned {
+            auto slot = TerminalInfo::slotFor(this->m_width, fp);
+            if (!slot)
+                return probeTerminalWidth(fp);
+            unsigned generation = s_resizeGeneration.load(std::memory_order_relaxed);
+            unsigned ret;
+            uint64_t seen;
+            if (!slot->get(ret, seen, generation)) {
+                ret = probeTerminalWidth(fp);
+                slot->storeProbed(seen, ret, generation);
+            }
+            return ret;
+        }
+
+        auto setColorStatus(ColorStatus status) -> void {
+            this->m_colorStatus.inject(unsigned(status));
+        }
+        auto setIsTerminal(FILE * fp, bool value) -> void {
+            if (auto slot = TerminalInfo::slotFor(this->m_isTerminal, fp))
+                slot->inject(value);
+        }
+        auto setWidth(FILE * fp, unsigned value) -> void {
+            if (auto slot = TerminalInfo::slotFor(this->m_width, fp))
+                slot->inject(value);
+        }
+
+        //Forgets probed values so that they are probed again on next use
+        auto invalidate() -> void {
+            this->forEachSlot([](Slot & slot) { slot.invalidate(false); });
+        }
+        //Forgets probed values for a file, for example after it has been redirected
+        auto invalidate(FILE * fp) -> void {
+            if (auto slot = TerminalInfo::slotFor(this->m_isTerminal, fp))
+                slot->invalidate(false);
+            if (auto slot = TerminalInfo::slotFor(this->m_width, fp))
+                slot->invalidate(false);
+        }
+        //Forgets both probed and injected values
+        auto reset() -> void {
+            this->forEachSlot([](Slot & slot) { slot.invalidate(true); });
+        }
+
+        /**
+         Installs a `SIGWINCH` handler that makes all snapshots re-probe terminal widths after a resize.
+
+         A previously installed handler is still invoked. Returns false if the platform has no 
+         `SIGWINCH` or the handler could not be installed.
+         */
+        static auto watchResize() -> bool {
+        #if defined(ARGUM_HAS_UNISTD_H) && defined(SIGWINCH)
+            static const bool installed = []() {
+                struct sigaction action{};
+                action.sa_sigaction = TerminalInfo::onResize;
+                sigemptyset(&action.sa_mask);
+                action.sa_flags = SA_RESTART | SA_SIGINFO;
+                return sigaction(SIGWINCH, &action, &previousResizeAction()) == 0;
+            }();
+            return installed;
+        #else
+            return false;
+        #endif
+        }
+
+        //Makes all snapshots re-probe terminal widths. Safe to call from a signal handler.
+        static auto notifyResize() -> void {
+            s_resizeGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    private:
+        /*
+         The value, its state and the resize generation it was probed at are packed into a single word
+         so that a probed value is only stored if the slot has not changed, and in particular has not 
+         had a value injected, since it was read.
+         */
+        class Slot {
+        public:
+            enum State : uint64_t { empty, probed, injected };
+
+            //Returns false if the value needs to be probed. `seen` receives the word to pass to storeProbed()
+            auto get(unsigned & value, uint64_t & seen, unsigned generation = 0) const -> bool {
+                seen = this->m_word.load(std::memory_order_acquire);
+                auto state = Slot::stateOf(seen);
+                if (state == empty)
+                    return false;
+                if (state == probed && Slot::generationOf(seen) != (generation & generationMask))
+                    return false;
+                value = Slot::valueOf(seen);
+                return true;
+            }
+            auto storeProbed(uint64_t seen, unsigned value, unsigned generation = 0) -> void {
+                this->m_word.compare_exchange_strong(seen, Slot::pack(value, probed, generation), 
+                                                     std::memory_order_release, std::memory_order_relaxed);
+            }
+            auto inject(unsigned value) -> void {
+                this->m_word.store(Slot::pack(value, injected, 0), std::memory_order_release);
+            }
+            auto invalidate(bool injectedToo) -> void {
+                auto word = this->m_word.load(std::memory_order_relaxed);
+                while (Slot::stateOf(word) == probed || (injectedToo && Slot::stateOf(word) == injected)) {
+                    //advance the generation so that the emptied word differs from the one a concurrent prober saw
+                    auto emptied = Slot::pack(0, empty, Slot::generationOf(word) + 1);
+                    if (this->m_word.compare_exchange_weak(word, emptied))
+                        break;
+                }
+            }
+        private:
+            static constexpr uint64_t generationMask = (uint64_t(1) << 30) - 1;
+
+            static auto pack(unsigned value, State state, uint64_t generation) -> uint64_t {
+                return uint64_t(value) | ((generation & generationMask) << 32) | (uint64_t(state) << 62);
+            }
+            static auto valueOf(uint64_t word) -> unsigned {
+                return unsigned(word & 0xFFFFFFFF);
+            }
+            static auto generationOf(uint64_t word) -> uint64_t {
+                return (word >> 32) & generationMask;
+            }
+            static auto stateOf(uint64_t word) -> State {
+                return State(word >> 62);
+            }
+        private:
+            std::atomic<uint64_t> m_word{0};
+        };
+
+        static constexpr int cachedDescriptors = 3;
+
+        static auto slotFor(Slot (&slots)[cachedDescriptors], FILE * fp) -> Slot * {
+        #if defined(_WIN32)
+            int desc = _fileno(fp);
+        #elif defined(ARGUM_HAS_UNISTD_H)
+            int desc = fileno(fp);
+        #else
+            int desc = (fp == stdin ? 0 : fp == stdout ? 1 : fp == stderr ? 2 : -1);
+        #endif
+            if (desc < 0 || desc >= cachedDescriptors)
+                return nullptr;
+            return &slots[desc];
+        }
+
+        template<class Func>
+        auto forEachSlot(Func func) -> void {
+            func(this->m_colorStatus);
+            for (auto & slot: this->m_isTerminal)
+                func(slot);
+            for (auto & slot: this->m_width)
+                func(slot);
+        }
+
+    #if defined(ARGUM_HAS_UNISTD_H) && defined(SIGWINCH)
+        static auto previousResizeAction() -> struct sigaction & {
+            static struct sigaction action{};
+            return action;
+        }
+
+        static void onResize(int sig, siginfo_t * info, void * context) {
+            TerminalInfo::notifyResize();
+            auto & previous = previousResizeAction();
+            if (previous.sa_flags & SA_SIGINFO) {
+                if (previous.sa_sigaction)
+                    previous.sa_sigaction(sig, info, context);
+            } else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+                previous.sa_handler(sig);
+            }
+        }
+    #endif
+
+    private:
+        static inline std::atomic<unsigned> s_resizeGeneration{0};
+
+        Slot m_colorStatus;
+        Slot m_isTerminal[cachedDescriptors];
+        Slot m_width[cachedDescriptors];
+    };
+
+    // Detect ColorStatus from the environment. The result is cached in TerminalInfo::current()
+    ARGUM_MOD_EXPORTED
+    inline auto environmentColorStatus() -> ColorStatus {
+        return TerminalInfo::current().colorStatus();
+    }
+
+    ARGUM_MOD_EXPORTED
+    inline bool shouldUseColor(ColorStatus envColorStatus, FILE * fp) {
+        if (envColorStatus == ColorStatus::required)
+            return true;
+        if (envColorStatus == ColorStatus::forbidden)
+            return false;
+
+#if defined(ARGUM_HAS_UNISTD_H)
+        if (envColorStatus == ColorStatus::unknown)
+            return false;
+
+        return TerminalInfo::current().isTerminal(fp);
+
+#elif defined(_WIN32)
+        if (!TerminalInfo::current().isTerminal(fp))
+            return false;
+
+        if (envColorStatus == ColorStatus::unknown) {
+        
+            HANDLE h = HANDLE(_get_osfhandle(_fileno(fp)));
+            if (h == INVALID_HANDLE_VALUE)
+                return false;
+
+            DWORD dwMode = 0;
+            if (!GetConsoleMode(h, &dwMode))
+                return false;
+
+            if (!(dwMode & ENABLE_VIRTUAL_TERMINAL_PROCESSING))
+                return false;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    ARGUM_MOD_EXPORTED
+    inline auto colorizerForFile(ColorStatus envColorStatus, FILE * fp) -> Colorizer {
+        if (shouldUseColor(envColorStatus, fp))
+            return defaultColorizer();
+        return {};
+    }
+
+    ARGUM_MOD_EXPORTED
+    inline auto wideColorizerForFile(ColorStatus envColorStatus, FILE * fp) -> WColorizer {
+        if (shouldUseColor(envColorStatus, fp))
+            return defaultWColorizer();
+        return {};
+    }
+
+    //Width of the terminal the file refers to. The result is cached in TerminalInfo::current()
+    ARGUM_MOD_EXPORTED
+    inline unsigned terminalWidth(FILE * fp) {
+        return TerminalInfo::current().width(fp);
+    }
+
 }
 
 #endif
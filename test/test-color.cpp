@@ -151,4 +151,54 @@ TEST_CASE( "Custom wide color" ) {
 
 }
 
+TEST_CASE( "Colored text segments" ) {
+
+    Colorizer plain;
+    auto text = plain.colored(&ColorScheme::shortOption, "-x");
+    CHECK(text.prefix.empty());
+    CHECK(text.text == "-x");
+    CHECK(text.suffix.empty());
+    CHECK(text.str() == plain.shortOption("-x"));
+
+    auto colorizer = defaultColorizer();
+    text = colorizer.colored(&ColorScheme::shortOption, "-x");
+    CHECK(text.prefix == defaultColorScheme().shortOption);
+    CHECK(text.text == "-x");
+    CHECK(text.suffix == makeColor<Color::normal>());
+    CHECK(text.size() == text.str().size());
+    CHECK(text.str() == colorizer.shortOption("-x"));
+    string str = "a";
+    CHECK(text.appendTo(str) == "a" + colorizer.shortOption("-x"));
+
+    auto wtext = defaultWColorizer().colored(&WColorScheme::error, L"oops");
+    CHECK(wtext.str() == defaultWColorizer().error(L"oops"));
+}
+
+TEST_CASE( "Help name width ignores colors" ) {
+
+    map<string, vector<Value>> results;
+    Parser parser;
+    parser.add(OPTION_REQ_ARG("-y", "--yy").argName("Y"));
+    parser.add(OPTION_OPT_ARG("--\u754C").argName("\u00E9"));
+    parser.add(POSITIONAL("foo"));
+
+    for (auto & colorizer: {Colorizer{}, defaultColorizer()}) {
+        string name;
+        auto width = parser.options()[0].appendHelpName(name, parser, colorizer);
+        CHECK(name == parser.options()[0].formatHelpName(parser, colorizer));
+        CHECK(width == stringWidth(name));
+        CHECK(width == 12);
+
+        name.clear();
+        width = parser.options()[1].appendHelpName(name, parser, colorizer);
+        CHECK(width == stringWidth(name));
+        CHECK(width == 8);
+
+        name = "xyz";
+        width = parser.positionals()[0].appendHelpName(name, parser, colorizer);
+        CHECK(name == "xyz" + parser.positionals()[0].formatHelpName(parser, colorizer));
+        CHECK(width == 3);
+    }
+}
+
 }
\ No newline at end of file
@@ -1,9 +1,24 @@
 #include "test-common.h"
 
 #include <argum/command-line.h>
+#include <argum/formatting.h>
+#include <argum/parser.h>
+#include <argum/response-file-writer.h>
+#include <argum/quoting-splitter.h>
 
 #include <doctest/doctest.h>
 
+#include <fstream>
+#include <map>
+#include <random>
+#include <thread>
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
 using namespace Argum;
 using namespace std;
 
@@ -88,10 +103,807 @@ TEST_CASE( "Wide response file" ) {
     CHECK(expanded == vector<wstring>{L"first", L"foo", L"bar", L"hello", L"world", L"baz", L"last"});
 }
 
+//Creates a new, uniquely named, directory for the files of a test
+static auto makeTempDir(const string & name) -> filesystem::path {
+    random_device random;
+    for ( ; ; ) {
+        auto dir = filesystem::temp_directory_path() / ("argum-" + name + "-" + to_string(random()));
+        if (filesystem::create_directories(dir))
+            return dir;
+    }
+}
+
+//Replaces the content of the file. An existing file is rewritten in place keeping its inode.
+static auto writeFile(const filesystem::path & path, const string & content) -> void {
+    FILE * fp = fopen(path.string().c_str(), "r+b");
+    if (!fp)
+        fp = fopen(path.string().c_str(), "wb");
+    REQUIRE(fp);
+    fwrite(content.data(), 1, content.size(), fp);
+    fclose(fp);
+    filesystem::resize_file(path, content.size());
+}
+
+template<class Char>
+static auto makeBinaryResponseFile(const vector<basic_string<Char>> & args) -> string {
+    string ret(BinaryResponseFile::magic, sizeof(BinaryResponseFile::magic));
+    auto append = [&](const auto & val) {
+        ret.append(reinterpret_cast<const char *>(&val), sizeof(val));
+    };
+    append(uint32_t(sizeof(Char)));
+    append(uint32_t(0));
+    append(uint64_t(args.size()));
+    for (auto & arg: args) {
+        append(uint64_t(arg.size()));
+        ret.append(reinterpret_cast<const char *>(arg.data()), arg.size() * sizeof(Char));
+        ret.append(BinaryResponseFile::paddedSize(arg.size() * sizeof(Char)) - arg.size() * sizeof(Char), '\0');
+    }
+    return ret;
+}
+
+TEST_CASE( "Simple file reads lines" ) {
+
+    auto dir = makeTempDir("simple-file");
+    auto path = dir / "lines.txt";
+    
+    //lines long enough to span internal buffers with a multibyte character across a buffer boundary
+    vector<string> lines = {
+        "first",
+        "",
+        string(65533, 'a') + "\u00E9\u754C" + "b",
+        string(200000, 'c'),
+        "",
+        "last without newline"
+    };
+    {
+        FILE * fp = fopen(path.string().c_str(), "wb");
+        REQUIRE(fp);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            fwrite(lines[i].data(), 1, lines[i].size(), fp);
+            if (i != lines.size() - 1)
+                fputc('\n', fp);
+        }
+        fclose(fp);
+    }
+
+    auto readAll = [&](auto charTag) {
+        using Char = decltype(charTag);
+        std::error_code ec;
+        SimpleFile file(path, "r", ec);
+        REQUIRE(file);
+        vector<basic_string<Char>> ret;
+        do {
+            ret.push_back(file.readLine<Char>(ec));
+            REQUIRE(!ec);
+        } while(!file.eof());
+        return ret;
+    };
+
+    CHECK(readAll(char()) == lines);
+    
+    vector<wstring> wlines;
+    for (auto & line: lines)
+        wlines.push_back(toString<wchar_t>(line));
+    CHECK(readAll(wchar_t()) == wlines);
+
+    writeFile(path, "a\nb\n");
+    CHECK(readAll(char()) == vector<string>{"a", "b", ""});
+    CHECK(readAll(wchar_t()) == vector<wstring>{L"a", L"b", L""});
+
+    writeFile(path, "a\n\xFF\xFE\n");
+    {
+        std::error_code ec;
+        SimpleFile file(path, "r", ec);
+        REQUIRE(file);
+        CHECK(file.readLine<wchar_t>(ec) == L"a");
+        CHECK(!ec);
+        file.readLine<wchar_t>(ec);
+        CHECK(ec == std::errc::illegal_byte_sequence);
+    }
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Mapped response file" ) {
+
+    auto dir = makeTempDir("mapped");
+    auto outerPath = dir / "outer.txt";
+    auto innerPath = dir / "inner.txt";
+    auto emptyPath = dir / "empty.txt";
+    writeFile(outerPath, "foo\n\n  bar  \n@" + innerPath.string() + "\r\n@" + emptyPath.string() + "\n  baz");
+    writeFile(innerPath, "hello\nw\u00F6rld\n");
+    writeFile(emptyPath, "");
+
+    auto outerArg = "@" + outerPath.string();
+    const char * argv[] = {"prog", "first", outerArg.c_str(), "last"};
+    const auto args = makeArgSpan(int(std::size(argv)), (char**)argv);
+    
+    auto expanded = ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandMapped(args));
+    CHECK(vector<string>(expanded.begin(), expanded.end()) == 
+          vector<string>{"first", "foo", "bar", "hello", "w\u00F6rld", "baz", "last"});
+    
+    vector<string> parsed;
+    Parser parser;
+    parser.add(Positional("p").occurs(zeroOrMoreTimes).handler([&](string_view val) {
+        parsed.emplace_back(val);
+    }));
+    ARGUM_EXPECTED_VALUE(parser.parse(expanded));
+    CHECK(parsed == vector<string>(expanded.begin(), expanded.end()));
+
+    auto split = ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandMapped(args, [](string_view line, auto dest) {
+        line = trim(line);
+        for (size_t pos = line.find_first_not_of(' '); pos != line.npos; ) {
+            auto end = line.find(' ', pos);
+            *dest = line.substr(pos, end - pos);
+            pos = line.find_first_not_of(' ', end);
+        }
+    }));
+    CHECK(vector<string>(split.begin(), split.end()) == 
+          vector<string>{"first", "foo", "bar", "hello", "w\u00F6rld", "baz", "last"});
+
+    auto wouterArg = L"@" + outerPath.wstring();
+    const wchar_t * wargv[] = {L"prog", L"first", wouterArg.c_str(), L"last"};
+    const auto wargs = makeArgSpan(int(std::size(wargv)), (wchar_t**)wargv);
+
+    auto wexpanded = ARGUM_EXPECTED_VALUE(WResponseFileReader(L'@').expandMapped(wargs));
+    CHECK(vector<wstring>(wexpanded.begin(), wexpanded.end()) == 
+          vector<wstring>{L"first", L"foo", L"bar", L"hello", L"w\u00F6rld", L"baz", L"last"});
+
+    auto missingArg = "@" + (dir / "missing.txt").string();
+    const char * missingArgv[] = {"prog", missingArg.c_str()};
+    const auto missingArgs = makeArgSpan(int(std::size(missingArgv)), (char**)missingArgv);
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandMapped(missingArgs)), ResponseFileReader::Exception);
+    #else
+        auto err = ResponseFileReader('@').expandMapped(missingArgs).error();
+        CHECK(err);
+        if (!err) abort();
+        CHECK(err->code() == Error::ResponseFileError);
+    #endif
+
+    writeFile(innerPath, "a\n\xFF\xFE\n");
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(WResponseFileReader(L'@').expandMapped(wargs)), WResponseFileReader::Exception);
+    #else
+        auto werr = WResponseFileReader(L'@').expandMapped(wargs).error();
+        CHECK(werr);
+        if (!werr) abort();
+        CHECK(werr->code() == Error::ResponseFileError);
+    #endif
+
+#ifndef _WIN32
+    //FIFOs report zero size and must be read rather than mapped
+    auto fifoPath = dir / "fifo";
+    REQUIRE(mkfifo(fifoPath.c_str(), 0600) == 0);
+    jthread writer([&]() {
+        for (auto deadline = chrono::steady_clock::now() + 10s; chrono::steady_clock::now() < deadline; this_thread::sleep_for(1ms)) {
+            int fd = open(fifoPath.c_str(), O_WRONLY | O_NONBLOCK);
+            if (fd >= 0) {
+                [[maybe_unused]] auto written = write(fd, "x\ny\n", 4);
+                close(fd);
+                break;
+            }
+        }
+    });
+    auto fifoArg = "@" + fifoPath.string();
+    const char * fifoArgv[] = {fifoArg.c_str(), "z"};
+    auto fromFifo = ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandMapped(std::span(fifoArgv)));
+    CHECK(vector<string>(fromFifo.begin(), fromFifo.end()) == vector<string>{"x", "y", "z"});
+#endif
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Lazy response file expansion" ) {
+
+    auto dir = makeTempDir("lazy");
+    auto outerPath = dir / "outer.txt";
+    auto innerPath = dir / "inner.txt";
+    writeFile(outerPath, "foo\n\n  bar  \n@" + innerPath.string() + "\n@" + innerPath.string() + "\n  baz");
+    writeFile(innerPath, "hello\nworld\n");
+
+    auto outerArg = "@" + outerPath.string();
+    const char * argv[] = {"prog", "first", outerArg.c_str(), "last"};
+    const auto args = makeArgSpan(int(std::size(argv)), (char**)argv);
+    
+    const vector<string> expected = {"first", "foo", "bar", "hello", "world", "hello", "world", "baz", "last"};
+
+    auto lazy = ResponseFileReader('@').expandLazily(args);
+    CHECK(vector<string>(lazy.begin(), lazy.end()) == expected);
+
+    //multi-pass
+    auto it = lazy.begin();
+    ++it;
+    auto copy = it;
+    CHECK(*it++ == "foo");
+    CHECK(*it == "bar");
+    CHECK(*copy == "foo");
+    CHECK(copy != it);
+    ++copy;
+    CHECK(copy == it);
+    CHECK(std::distance(lazy.begin(), lazy.end()) == ptrdiff_t(expected.size()));
+    
+    vector<string> parsed;
+    Parser parser;
+    parser.add(Option("--opt"));
+    parser.add(Positional("p").occurs(zeroOrMoreTimes).handler([&](string_view val) {
+        parsed.emplace_back(val);
+    }));
+    ARGUM_EXPECTED_VALUE(parser.parse(lazy));
+    CHECK(parsed == expected);
+
+    //iterating again splits the lines again rather than remembering every argument
+    int splitCalls = 0;
+    auto counted = ResponseFileReader('@').expandLazily(args, [&](string_view line, auto dest) {
+        ++splitCalls;
+        line = trim(line);
+        if (!line.empty())
+            *dest = line;
+    });
+    CHECK(std::distance(counted.begin(), counted.end()) == ptrdiff_t(expected.size()));
+    auto firstPassSplitCalls = splitCalls;
+    CHECK(firstPassSplitCalls > 0);
+    CHECK(std::distance(counted.begin(), counted.end()) == ptrdiff_t(expected.size()));
+    CHECK(splitCalls == 2 * firstPassSplitCalls);
+
+    //with a single variable positional the parser does not read ahead so files are read as parsing reaches them
+    filesystem::remove(innerPath);
+    parsed.clear();
+    Parser creating;
+    creating.add(Positional("p").occurs(zeroOrMoreTimes).handler([&](string_view val) {
+        if (parsed.empty())
+            writeFile(innerPath, "hello\nworld\n");
+        parsed.emplace_back(val);
+    }));
+    ARGUM_EXPECTED_VALUE(creating.parse(ResponseFileReader('@').expandLazily(args)));
+    CHECK(parsed == expected);
+
+    const wchar_t * wargv[] = {L"first", L"@nonexistent-response-file.txt", L"last"};
+    auto wlazy = WResponseFileReader(L'@').expandLazily(std::span(wargv));
+    #ifndef ARGUM_USE_EXPECTED
+        CHECK_THROWS_AS(vector<wstring>(wlazy.begin(), wlazy.end()), WResponseFileReader::Exception);
+    #else
+        CHECK(vector<wstring>(wlazy.begin(), wlazy.end()) == vector<wstring>{L"first"});
+        CHECK(wlazy.error());
+    #endif
+
+    const char * badArgv[] = {"first", "@nonexistent-response-file.txt", "--opt"};
+    auto badLazy = ResponseFileReader('@').expandLazily(std::span(badArgv));
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(parser.parse(badLazy)), ResponseFileReader::Exception);
+    #else
+        auto err = parser.parse(badLazy).error();
+        CHECK(err);
+        if (!err) abort();
+        CHECK(err->code() == Error::ResponseFileError);
+    #endif
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Concurrent response file expansion" ) {
+
+    auto dir = makeTempDir("concurrent");
+
+    vector<string> argv = {"first"};
+    for (int i = 0; i < 20; ++i) {
+        auto name = dir / ("file" + std::to_string(i) + ".txt");
+        auto nestedName = dir / ("nested" + std::to_string(i) + ".txt");
+        writeFile(name, "a" + std::to_string(i) + "\n @" + nestedName.string() + "\nb" + std::to_string(i));
+        writeFile(nestedName, "n" + std::to_string(i) + "\n\n");
+        argv.push_back("@" + name.string());
+        argv.push_back("arg" + std::to_string(i));
+    }
+    argv.push_back("last");
+
+    auto sequential = ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expand(argv));
+    CHECK(sequential.size() == 2 + 20 * 4);
+    CHECK(sequential[1] == "a0");
+    CHECK(sequential[2] == "n0");
+    CHECK(sequential[3] == "b0");
+    CHECK(sequential[4] == "arg0");
+    
+    CHECK(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandConcurrently(argv)) == sequential);
+    CHECK(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandConcurrently(argv, 1)) == sequential);
+    CHECK(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandConcurrently(argv, 4)) == sequential);
+
+    auto upper = [](string && line, auto dest) {
+        trimInPlace(line);
+        if (line.empty())
+            return;
+        if (line[0] != '@')
+            std::transform(line.begin(), line.end(), line.begin(), [](char c) { return char(toupper(c)); });
+        *dest = std::move(line);
+    };
+    CHECK(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandConcurrently(argv, 3, upper)) == 
+          ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expand(argv, upper)));
+
+    //the first error in command line order is reported
+    filesystem::remove(dir / "nested3.txt");
+    filesystem::remove(dir / "file7.txt");
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_WITH(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandConcurrently(argv, 4)), 
+                          ("error reading response file \"" + (dir / "nested3.txt").string() + "\": " + 
+                            std::make_error_code(errc::no_such_file_or_directory).message()).c_str());
+
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(ResponseFileReader('@').expandConcurrently(argv, 4, [](string &&, auto) {
+            throw std::runtime_error("splitter failed");
+        })), std::runtime_error);
+    #else
+        auto err = ResponseFileReader('@').expandConcurrently(argv, 4).error();
+        CHECK(err);
+        if (!err) abort();
+        CHECK(err->message() == 
+              "error reading response file \"" + (dir / "nested3.txt").string() + "\": " + 
+              std::make_error_code(errc::no_such_file_or_directory).message());
+    #endif
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Response file cache" ) {
+
+    auto dir = makeTempDir("cache");
+    auto cacheDir = dir / "cache";
+    auto cacheEntries = [&]() {
+        size_t count = 0;
+        std::error_code ec;
+        for (auto & entry: filesystem::directory_iterator(cacheDir, ec))
+            count += (entry.path().extension() == ResponseFileCache::extension);
+        return count;
+    };
+
+    auto respPath = dir / "resp.txt";
+    auto nestedPath = dir / "nested.txt";
+    writeFile(respPath, " foo \n@" + nestedPath.string() + "\nbar\n");
+    writeFile(nestedPath, "hello\nworld");
+    auto respArg = "@" + respPath.string();
+    const char * argv[] = {"first", respArg.c_str(), "last"};
+
+    ResponseFileReader reader('@');
+    reader.enableCache(cacheDir);
+    
+    const vector<string> expected = {"first", "foo", "hello", "world", "bar", "last"};
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == expected);
+    CHECK(cacheEntries() == 2);
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == expected);
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expandConcurrently(std::span(argv), 2)) == expected);
+    CHECK(cacheEntries() == 2);
+
+    //same size, inode and modification time: cached content is used
+    auto mtime = filesystem::last_write_time(nestedPath);
+    writeFile(nestedPath, "HELLO\nWORLD");
+    filesystem::last_write_time(nestedPath, mtime);
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == expected);
+    
+    //changed size invalidates the entry
+    writeFile(nestedPath, "HELLO\nWORLD\nagain");
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == 
+          vector<string>{"first", "foo", "HELLO", "WORLD", "again", "bar", "last"});
+    CHECK(cacheEntries() == 2);
+
+    //custom splitters are only cached when identified
+    auto upper = [](string && line, auto dest) {
+        trimInPlace(line);
+        if (line.empty())
+            return;
+        if (line[0] != '@')
+            std::transform(line.begin(), line.end(), line.begin(), [](char c) { return char(toupper(c)); });
+        *dest = std::move(line);
+    };
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv), upper)) == 
+          vector<string>{"first", "FOO", "HELLO", "WORLD", "AGAIN", "BAR", "last"});
+    CHECK(cacheEntries() == 2);
+    reader.enableCache(cacheDir, ResponseFileCache::defaultMaxSize, "upper");
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv), upper)) == 
+          vector<string>{"first", "FOO", "HELLO", "WORLD", "AGAIN", "BAR", "last"});
+    CHECK(cacheEntries() == 4);
+
+    //errors are not cached
+    filesystem::remove(nestedPath);
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))), ResponseFileReader::Exception);
+    #else
+        CHECK(reader.expand(std::span(argv)).error());
+    #endif
+    CHECK(cacheEntries() == 4);
+
+    ResponseFileCache(cacheDir).clear();
+    CHECK(cacheEntries() == 0);
+
+    //temporaries left behind by writers that did not finish are removed once stale
+    auto makeTemporary = [&](const string & name, size_t size, filesystem::file_time_type::duration age) {
+        auto path = cacheDir / ("0123456789abcdef" + string(ResponseFileCache::extension) + "." + name + ".tmp");
+        writeFile(path, string(size, 'x'));
+        filesystem::last_write_time(path, filesystem::file_time_type::clock::now() - age);
+        return path;
+    };
+    auto staleTemp = makeTemporary("1", 1000, 2min);
+    auto freshTemp = makeTemporary("2", 10, 0s);
+
+    //eviction keeps the total size under the limit
+    reader.enableCache(cacheDir, 200);
+    for (int i = 0; i < 10; ++i) {
+        auto path = dir / ("file" + std::to_string(i) + ".txt");
+        writeFile(path, "argument" + std::to_string(i));
+        auto arg = "@" + path.string();
+        const char * args[] = {arg.c_str()};
+        CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(args))) == vector<string>{"argument" + std::to_string(i)});
+        CHECK(cacheEntries() > 0);
+    }
+    uintmax_t total = 0;
+    for (auto & entry: filesystem::directory_iterator(cacheDir))
+        total += entry.file_size();
+    CHECK(total <= 200 + filesystem::file_size(freshTemp));
+    CHECK(cacheEntries() < 10);
+    CHECK(!filesystem::exists(staleTemp));
+    CHECK(filesystem::exists(freshTemp));
+
+    staleTemp = makeTemporary("3", 1000, 2min);
+    ResponseFileCache(cacheDir).clear();
+    CHECK(!filesystem::exists(staleTemp));
+    CHECK(filesystem::exists(freshTemp));
+    filesystem::remove(freshTemp);
+
+    //wide arguments are cached per locale they were decoded with
+    ResponseFileCache(cacheDir).clear();
+    auto wrespArg = L"@" + nestedPath.wstring();
+    writeFile(nestedPath, "hello\nworld");
+    const wchar_t * wargv[] = {wrespArg.c_str()};
+    WResponseFileReader wreader(L'@');
+    wreader.enableCache(cacheDir);
+    string savedLocale = setlocale(LC_CTYPE, nullptr);
+    setlocale(LC_CTYPE, "C");
+    CHECK(ARGUM_EXPECTED_VALUE(wreader.expand(std::span(wargv))) == vector<wstring>{L"hello", L"world"});
+    CHECK(cacheEntries() == 1);
+    setlocale(LC_CTYPE, savedLocale.c_str());
+    CHECK(ARGUM_EXPECTED_VALUE(wreader.expand(std::span(wargv))) == vector<wstring>{L"hello", L"world"});
+    CHECK(cacheEntries() == (savedLocale == "C" ? 1 : 2));
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Binary response file" ) {
+
+    auto dir = makeTempDir("binary");
+
+    auto binPath = dir / "args.bin";
+    auto textPath = dir / "args.txt";
+    writeFile(textPath, " text \n");
+    const vector<string> binArgs = {"  spaced  ", "", "multi\nline", "@" + textPath.string(), "w\u00F6rld", "x"};
+    writeFile(binPath, makeBinaryResponseFile(binArgs));
+
+    auto binArg = "@" + binPath.string();
+    const char * argv[] = {"first", binArg.c_str(), "last"};
+    const vector<string> expected = {"first", "  spaced  ", "", "multi\nline", "text", "w\u00F6rld", "x", "last"};
+
+    ResponseFileReader reader('@');
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == expected);
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expandConcurrently(std::span(argv), 2)) == expected);
+    auto mapped = ARGUM_EXPECTED_VALUE(reader.expandMapped(std::span(argv)));
+    CHECK(vector<string>(mapped.begin(), mapped.end()) == expected);
+    auto lazy = reader.expandLazily(std::span(argv));
+    CHECK(vector<string>(lazy.begin(), lazy.end()) == expected);
+
+    //splitter is not used for binary files
+    auto splitCalls = 0;
+    auto counted = ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv), [&](string && line, auto dest) {
+        ++splitCalls;
+        trimInPlace(line);
+        *dest = std::move(line);
+    }));
+    CHECK(counted == expected);
+    CHECK(splitCalls == 1);
+
+    const vector<wstring> wexpected = {L"first", L"  spaced  ", L"", L"multi\nline", L"text", L"w\u00F6rld", L"x", L"last"};
+    auto wbinArg = L"@" + binPath.wstring();
+    const wchar_t * wargv[] = {L"first", wbinArg.c_str(), L"last"};
+    WResponseFileReader wreader(L'@');
+    CHECK(ARGUM_EXPECTED_VALUE(wreader.expand(std::span(wargv))) == wexpected);
+    auto wmapped = ARGUM_EXPECTED_VALUE(wreader.expandMapped(std::span(wargv)));
+    CHECK(vector<wstring>(wmapped.begin(), wmapped.end()) == wexpected);
+
+    writeFile(binPath, makeBinaryResponseFile(vector<wstring>{L"  spaced  ", L"", L"multi\nline", L"@" + textPath.wstring(), L"w\u00F6rld", L"x"}));
+    CHECK(ARGUM_EXPECTED_VALUE(wreader.expand(std::span(wargv))) == wexpected);
+    auto wlazy = wreader.expandLazily(std::span(wargv));
+    CHECK(vector<wstring>(wlazy.begin(), wlazy.end()) == wexpected);
+
+    //wrong character size or truncated data
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))), ResponseFileReader::Exception);
+    #else
+        CHECK(reader.expand(std::span(argv)).error());
+    #endif
+    auto truncated = makeBinaryResponseFile(binArgs);
+    truncated.resize(truncated.size() - 10);
+    writeFile(binPath, truncated);
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(reader.expandMapped(std::span(argv))), ResponseFileReader::Exception);
+    #else
+        CHECK(reader.expandMapped(std::span(argv)).error());
+    #endif
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Response file writer" ) {
+
+    auto dir = makeTempDir("writer");
+    auto path = dir / "args.rsp";
+    auto readAll = [](const filesystem::path & p) {
+        ifstream stream(p, ios::binary);
+        return string(istreambuf_iterator<char>(stream), istreambuf_iterator<char>());
+    };
+
+    ResponseFileReader reader('@');
+    auto arg = "@" + path.string();
+    const char * argv[] = {"first", arg.c_str(), "last"};
+
+    const vector<string> simple = {"-a", "b c", "w\u00F6rld"};
+    ResponseFileWriter writer;
+    CHECK(writer.formatFor(simple) == ResponseFileWriter::Format::lines);
+    ARGUM_EXPECTED_VALUE(writer.write(path, simple));
+    CHECK(readAll(path) == "-a\nb c\nw\u00F6rld\n");
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == vector<string>{"first", "-a", "b c", "w\u00F6rld", "last"});
+
+    const vector<string> tricky = {" spaced ", "", "multi\nline"};
+    CHECK(writer.formatFor(tricky) == ResponseFileWriter::Format::binary);
+    ARGUM_EXPECTED_VALUE(writer.write(path, tricky));
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv))) == vector<string>{"first", " spaced ", "", "multi\nline", "last"});
+
+    ResponseFileWriter binaryWriter(ResponseFileWriter::Format::binary);
+    string image;
+    CHECK(!binaryWriter.serialize(simple, image));
+    CHECK(image == makeBinaryResponseFile(simple));
+
+    const vector<wstring> wsimple = {L"-a", L"b c", L"w\u00F6rld"};
+    WResponseFileWriter wwriter(WResponseFileWriter::Format::lines);
+    ARGUM_EXPECTED_VALUE(wwriter.write(path, wsimple));
+    CHECK(readAll(path) == "-a\nb c\nw\u00F6rld\n");
+    auto warg = L"@" + path.wstring();
+    const wchar_t * wargv[] = {warg.c_str()};
+    WResponseFileReader wreader(L'@');
+    CHECK(ARGUM_EXPECTED_VALUE(wreader.expand(std::span(wargv))) == wsimple);
+
+    //characters the locale cannot encode are written in binary in automatic format only
+    const vector<wstring> wunencodable = {L"-a", L"\u4E16"};
+    string savedLocale = setlocale(LC_CTYPE, nullptr);
+    setlocale(LC_CTYPE, "C");
+    string wimage;
+    CHECK(wwriter.serialize(wunencodable, wimage) == std::errc::illegal_byte_sequence);
+    wimage.clear();
+    CHECK(!WResponseFileWriter().serialize(wunencodable, wimage));
+    CHECK(wimage == makeBinaryResponseFile(wunencodable));
+    setlocale(LC_CTYPE, savedLocale.c_str());
+
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(writer.write(dir / "missing" / "args.rsp", simple)), ResponseFileWriter::Exception);
+    #else
+        auto err = writer.write(dir / "missing" / "args.rsp", simple).error();
+        CHECK(err);
+        if (!err) abort();
+        CHECK(err->code() == Error::ResponseFileWriteError);
+        CHECK(!err->as<ResponseFileReader::Exception>());
+    #endif
+
+    const vector<string> small(10, "argument");
+    CHECK(!ResponseFileWriter::needsResponseFile(small));
+    CHECK(ResponseFileWriter::needsResponseFile(small, ResponseFileWriter::commandLineSize(small) - 1));
+    CHECK(!ResponseFileWriter::needsResponseFile(small, ResponseFileWriter::commandLineSize(small)));
+    const vector<string> huge(1, string(ResponseFileWriter::commandLineLimit(), 'x'));
+    CHECK(ResponseFileWriter::needsResponseFile(huge));
+
+    filesystem::remove_all(dir);
+}
+
+template<class Char>
+static auto splitOwned(const BasicQuotingSplitter<Char> & splitter, const Char * line) -> vector<basic_string<Char>> {
+    vector<basic_string<Char>> ret;
+    splitter(basic_string<Char>(line), back_inserter(ret));
+    return ret;
+}
+
+template<class Char>
+static auto splitViews(const BasicQuotingSplitter<Char> & splitter, const Char * line) -> vector<basic_string<Char>> {
+    BasicArgumentStore<Char> store;
+    vector<basic_string_view<Char>> views;
+    splitter(basic_string_view<Char>(line), back_inserter(views), store);
+    return vector<basic_string<Char>>(views.begin(), views.end());
+}
+
+TEST_CASE( "Quoting splitter" ) {
+
+    QuotingSplitter shell;
+    QuotingSplitter gcc(QuotingSplitter::Syntax::gcc);
+
+    auto check = [](const QuotingSplitter & splitter, const char * line, const vector<string> & expected) {
+        CHECK(splitOwned(splitter, line) == expected);
+        CHECK(splitViews(splitter, line) == expected);
+    };
+
+    check(shell, "", {});
+    check(shell, "  \t ", {});
+    check(shell, "single", {"single"});
+    check(shell, "  -a  b\tc \r", {"-a", "b", "c"});
+    check(shell, R"(a\ b 'c d' "e f" g"h"'i')", {"a b", "c d", "e f", "ghi"});
+    check(shell, R"('' "" x)", {"", "", "x"});
+    check(shell, R"('a\b' "a\b" "\$\`\"\\" a\\b)", {R"(a\b)", R"(a\b)", R"($`"\)", R"(a\b)"});
+    check(shell, R"(x # comment "here)", {"x"});
+    check(shell, R"(#comment)", {});
+    check(shell, R"(a#b)", {"a#b"});
+    check(shell, R"("unterminated arg)", {"unterminated arg"});
+    check(shell, R"(trailing\)", {"trailing"});
+    check(shell, "\xE9t\xE9 \xA0\xFF", {"\xE9t\xE9", "\xA0\xFF"});
+
+    check(gcc, R"(a\ b 'c d' "e f" g"h"'i')", {"a b", "c d", "e f", "ghi"});
+    check(gcc, R"('a\'b' "a\"b" "a\b" a\\b)", {"a'b", R"(a"b)", "ab", R"(a\b)"});
+    check(gcc, R"(x #notcomment)", {"x", "#notcomment"});
+
+    CHECK(splitOwned(WQuotingSplitter(), LR"(w 'x y' "wörld")") == vector<wstring>{L"w", L"x y", L"wörld"});
+    CHECK(splitViews(WQuotingSplitter(), LR"(w 'x y' "wörld")") == vector<wstring>{L"w", L"x y", L"wörld"});
+
+    //arguments that need no unescaping point into the line
+    {
+        BasicArgumentStore<char> store;
+        vector<string_view> views;
+        string_view line = R"(plain "quoted")";
+        shell(line, back_inserter(views), store);
+        REQUIRE(views.size() == 2);
+        CHECK(views[0].data() == line.data());
+        CHECK(views[1] == "quoted");
+        CHECK((views[1].data() < line.data() || views[1].data() >= line.data() + line.size()));
+    }
+
+    auto dir = makeTempDir("quoting");
+    auto path = dir / "args.rsp";
+    auto nestedPath = dir / "nested.rsp";
+    {
+        ofstream nested(nestedPath, ios::binary);
+        nested << "'nested arg' plain\n";
+        ofstream main(path, ios::binary);
+        main << "# options\n-o 'out file'\n\"@" << nestedPath.string() << "\" last\\ one\n";
+    }
+    auto arg = "@" + path.string();
+    const char * argv[] = {"first", arg.c_str()};
+    const vector<string> expected = {"first", "-o", "out file", "nested arg", "plain", "last one"};
+
+    ResponseFileReader reader('@');
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv), shell)) == expected);
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expandConcurrently(std::span(argv), 2, shell)) == expected);
+    auto mapped = ARGUM_EXPECTED_VALUE(reader.expandMapped(std::span(argv), shell));
+    CHECK(vector<string>(mapped.begin(), mapped.end()) == expected);
+    auto lazy = reader.expandLazily(std::span(argv), shell);
+    CHECK(vector<string>(lazy.begin(), lazy.end()) == expected);
+    CHECK(vector<string>(lazy.begin(), lazy.end()) == expected);
+
+    filesystem::remove_all(dir);
+}
+
+TEST_CASE( "Response file memoization and cycles" ) {
+
+    auto dir = makeTempDir("cycle");
+    auto shared = dir / "shared.rsp";
+    auto main = dir / "main.rsp";
+    writeFile(shared, "-shared\n");
+    //the same file by different names
+    writeFile(main, "@" + shared.string() + "\n@" + (dir / "." / "shared.rsp").string() + "\n-main\n");
+
+    auto sharedArg = "@" + shared.string();
+    auto mainArg = "@" + main.string();
+    const char * argv[] = {sharedArg.c_str(), mainArg.c_str(), sharedArg.c_str()};
+    const vector<string> expected = {"-shared", "-shared", "-shared", "-main", "-shared"};
+
+    ResponseFileReader reader('@');
+    map<string, int> splits;
+    auto countingSplitter = [&](string && line, auto dest) {
+        ++splits[line];
+        *dest = std::move(line);
+    };
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expand(std::span(argv), countingSplitter)) == expected);
+    CHECK(splits["-shared"] == 1);
+    splits.clear();
+    CHECK(ARGUM_EXPECTED_VALUE(reader.expandConcurrently(std::span(argv), 3, countingSplitter)) == expected);
+    CHECK(splits["-shared"] == 1);
+
+    map<string_view, int> viewSplits;
+    auto mapped = ARGUM_EXPECTED_VALUE(reader.expandMapped(std::span(argv), [&](string_view line, auto dest) {
+        ++viewSplits[line];
+        *dest = line;
+    }));
+    CHECK(vector<string>(mapped.begin(), mapped.end()) == expected);
+    CHECK(viewSplits["-shared"] == 1);
+    auto lazy = reader.expandLazily(std::span(argv));
+    CHECK(vector<string>(lazy.begin(), lazy.end()) == expected);
+
+    auto first = dir / "first.rsp";
+    auto second = dir / "second.rsp";
+    writeFile(first, "-a\n@" + second.string() + "\n");
+    writeFile(second, "-b\n@" + sharedArg.substr(1) + "\n@" + first.string() + "\n");
+    auto firstArg = "@" + first.string();
+    const char * cycleArgv[] = {"x", firstArg.c_str()};
+
+    auto checkCycle = [&](auto && expand) {
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(expand()), ResponseFileReader::CycleException);
+    #endif
+    #ifdef ARGUM_USE_EXPECTED
+        auto err = expand().error();
+        REQUIRE(err);
+        CHECK(err->code() == Error::ResponseFileCycle);
+        CHECK(err->template as<ResponseFileReader::CycleException>());
+        CHECK(err->message() == "response file \"" + first.string() + "\" references itself");
+    #endif
+    };
+    checkCycle([&]() { return reader.expand(std::span(cycleArgv)); });
+    checkCycle([&]() { return reader.expandConcurrently(std::span(cycleArgv), 2); });
+    checkCycle([&]() { return reader.expandMapped(std::span(cycleArgv)); });
+    #ifndef ARGUM_USE_EXPECTED
+        auto cyclic = reader.expandLazily(std::span(cycleArgv));
+        CHECK_THROWS_AS(vector<string>(cyclic.begin(), cyclic.end()), ResponseFileReader::CycleException);
+    #else
+        auto cyclic = reader.expandLazily(std::span(cycleArgv));
+        CHECK(vector<string>(cyclic.begin(), cyclic.end()) == vector<string>{"x", "-a", "-b", "-shared"});
+        REQUIRE(cyclic.error());
+        CHECK(cyclic.error()->message() == "response file \"" + first.string() + "\" references itself");
+    #endif
+
+    writeFile(first, "@" + first.string() + "\n");
+    checkCycle([&]() { return reader.expand(std::span(cycleArgv)); });
+
+    //other errors are not cycles
+    auto missingArg = "@" + (dir / "missing.rsp").string();
+    const char * missingArgv[] = {missingArg.c_str()};
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS(ARGUM_EXPECTED_VALUE(reader.expand(std::span(missingArgv))), ResponseFileReader::Exception);
+    #endif
+    #ifdef ARGUM_USE_EXPECTED
+        auto missingErr = reader.expand(std::span(missingArgv)).error();
+        REQUIRE(missingErr);
+        CHECK(missingErr->code() == Error::ResponseFileError);
+        CHECK(!missingErr->as<ResponseFileReader::CycleException>());
+    #endif
+
+#ifndef _WIN32
+    //names without a canonical path, like the /dev/fd ones of shell process substitution, are used as is
+    if (filesystem::exists("/dev/fd")) {
+        auto expandPipe = [&](auto && expand) -> vector<string> {
+            int fds[2];
+            REQUIRE(pipe(fds) == 0);
+            REQUIRE(write(fds[1], "x\ny\n", 4) == 4);
+            close(fds[1]);
+            auto pipeArg = "@/dev/fd/" + to_string(fds[0]);
+            const char * pipeArgv[] = {pipeArg.c_str(), pipeArg.c_str(), "b"};
+            auto ret = expand(std::span(pipeArgv));
+            close(fds[0]);
+            return ret;
+        };
+        const vector<string> pipeExpected = {"x", "y", "x", "y", "b"};
+        CHECK(expandPipe([&](auto args) { 
+            return ARGUM_EXPECTED_VALUE(reader.expand(args)); 
+        }) == pipeExpected);
+        CHECK(expandPipe([&](auto args) { 
+            return ARGUM_EXPECTED_VALUE(reader.expandConcurrently(args, 3)); 
+        }) == pipeExpected);
+        CHECK(expandPipe([&](auto args) { 
+            auto res = ARGUM_EXPECTED_VALUE(reader.expandMapped(args)); 
+            return vector<string>(res.begin(), res.end()); 
+        }) == pipeExpected);
+        CHECK(expandPipe([&](auto args) { 
+            auto res = reader.expandLazily(args); 
+            return vector<string>(res.begin(), res.end()); 
+        }) == pipeExpected);
+    }
+#endif
+
+    filesystem::remove_all(dir);
+}
+
 TEST_CASE( "Trim in place" ) {
 
     std::string str = "help help";
     CHECK(trimInPlace(str) == "help help");
+    CHECK(trim(" \t help help \n"sv) == "help help");
+    CHECK(trim("   "sv) == "");
 }
 
 }
@@ -0,0 +1,93 @@
+#include "test-common.h"
+
+#include <argum/detect-system.h>
+
+#include <doctest/doctest.h>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+using namespace Argum;
+using namespace std;
+
+TEST_SUITE("detect-system") {
+
+TEST_CASE( "Terminal info injection" ) {
+    TerminalInfo info;
+
+    info.setColorStatus(ColorStatus::required);
+    CHECK(info.colorStatus() == ColorStatus::required);
+    info.setColorStatus(ColorStatus::forbidden);
+    CHECK(info.colorStatus() == ColorStatus::forbidden);
+
+    info.setWidth(stdout, 42);
+    info.setIsTerminal(stdout, true);
+    CHECK(info.width(stdout) == 42);
+    CHECK(info.isTerminal(stdout));
+
+    //injected values survive invalidation and resizes
+    info.invalidate();
+    TerminalInfo::notifyResize();
+    CHECK(info.colorStatus() == ColorStatus::forbidden);
+    CHECK(info.width(stdout) == 42);
+    CHECK(info.isTerminal(stdout));
+
+    info.reset();
+    CHECK(info.colorStatus() == probeEnvironmentColorStatus());
+    CHECK(info.width(stdout) == probeTerminalWidth(stdout));
+    CHECK(info.isTerminal(stdout) == probeIsTerminal(stdout));
+}
+
+TEST_CASE( "Terminal info caching" ) {
+    TerminalInfo info;
+
+#ifndef _WIN32
+
+    setenv("COLUMNS", "77", 1);
+    auto width = info.width(stdout);
+    CHECK(width == probeTerminalWidth(stdout));
+
+    setenv("COLUMNS", "78", 1);
+    CHECK(info.width(stdout) == width);
+
+    auto probedAfterChange = probeTerminalWidth(stdout);
+    TerminalInfo::notifyResize();
+    CHECK(info.width(stdout) == probedAfterChange);
+
+    setenv("COLUMNS", "79", 1);
+    info.invalidate();
+    CHECK(info.width(stdout) == probeTerminalWidth(stdout));
+
+    //redirected streams are re-probed once invalidated
+    auto stderrWidth = info.width(stderr);
+    info.isTerminal(stderr);
+    setenv("COLUMNS", "80", 1);
+    CHECK(info.width(stderr) == stderrWidth);
+    fflush(stderr);
+    int savedStderr = dup(fileno(stderr));
+    FILE * redirect = tmpfile();
+    REQUIRE(redirect);
+    dup2(fileno(redirect), fileno(stderr));
+    CHECK(info.width(stderr) == stderrWidth);
+    info.invalidate(stderr);
+    CHECK(info.width(stderr) == 80);
+    CHECK(!info.isTerminal(stderr));
+    dup2(savedStderr, fileno(stderr));
+    close(savedStderr);
+    fclose(redirect);
+    info.invalidate(stderr);
+    unsetenv("COLUMNS");
+#endif
+
+    auto & current = TerminalInfo::current();
+    current.setWidth(stderr, 33);
+    CHECK(terminalWidth(stderr) == 33);
+    current.setColorStatus(ColorStatus::allowed);
+    CHECK(environmentColorStatus() == ColorStatus::allowed);
+    current.setIsTerminal(stderr, false);
+    CHECK(!shouldUseColor(ColorStatus::allowed, stderr));
+    current.reset();
+}
+
+}
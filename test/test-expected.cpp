@@ -34,6 +34,57 @@ namespace {
         Exc(string s): ParsingException(ErrorCode, s) {
         }
     };
+
+    struct CompactExc : public ParsingException {
+        ARGUM_IMPLEMENT_EXCEPTION(CompactExc, ParsingException, Error::UnrecognizedOption)
+        static constexpr bool IsCompact = true;
+
+        CompactExc(string_view option_, int argumentIndex_ = -1):
+            ParsingException(ErrorCode, "unrecognized option: " + string(option_)),
+            option(option_),
+            argumentIndex(argumentIndex_) {
+        }
+        string option;
+        int argumentIndex;
+    };
+
+    struct LazyExc : public WParsingException {
+        ARGUM_IMPLEMENT_EXCEPTION(LazyExc, WParsingException, Error::UserError)
+
+        LazyExc(int & counter_): WParsingException(ErrorCode), counter(&counter_) {
+        }
+        int * counter;
+    protected:
+        auto formatMessage() const -> wstring override {
+            ++*this->counter;
+            return L"lazy";
+        }
+    };
+
+    #ifndef ARGUM_NO_THROW
+        //Fails to format its message while failures is not negative
+        struct FailingExc : public WParsingException {
+            ARGUM_IMPLEMENT_EXCEPTION(FailingExc, WParsingException, Error::UserError)
+
+            FailingExc(int & failures_): WParsingException(ErrorCode), failures(&failures_) {
+            }
+            int * failures;
+        protected:
+            auto formatMessage() const -> wstring override {
+                if (*this->failures < 0)
+                    return L"recovered";
+                ++*this->failures;
+                throw std::bad_alloc();
+            }
+        };
+    #endif
+
+    #ifdef ARGUM_USE_EXPECTED
+        auto propagate(Expected<int> src) -> Expected<string> {
+            ARGUM_PROPAGATE_ERROR(src);
+            return "ok";
+        }
+    #endif
 }
 
 TEST_SUITE("expected") {
@@ -199,6 +250,133 @@ TEST_CASE( "converting expecteds" ) {
     CHECK(Expected<void>(Expected<int>(5)));
 }
 
+TEST_CASE( "compact errors" ) {
+    static_assert(is_trivially_copyable_v<ParsingError>);
+    static_assert(is_trivially_copyable_v<WParsingError>);
+    //compact errors do not make expected values larger than with exception objects alone
+    static_assert(sizeof(Expected<void>) == sizeof(variant<monostate, shared_ptr<ParsingException>>));
+    static_assert(sizeof(WExpected<void>) == sizeof(variant<monostate, shared_ptr<WParsingException>>));
+
+    {
+        string commandLine = "--bar";
+        Expected<foo> exp(*ParsingError::make<CompactExc>(commandLine, 3));
+        XREQUIRE(!exp);
+        XREQUIRE(exp.compactError());
+        CHECK(exp.compactError()->code() == Error::UnrecognizedOption);
+        CHECK(exp.compactError()->subject() == "--bar");
+        CHECK(exp.compactError()->subject().data() == commandLine.data());
+        CHECK(exp.compactError()->argumentIndex() == 3);
+        CHECK(exp.errorCode() == Error::UnrecognizedOption);
+        CHECK(exp.errorMessage() == "unrecognized option: --bar");
+
+        Expected<void> converted(exp);
+        XREQUIRE(converted.compactError());
+        CHECK(converted.compactError()->subject() == "--bar");
+
+        //error() does not modify the result
+        auto temporary = exp.error();
+        XREQUIRE(temporary);
+        CHECK(temporary->message() == "unrecognized option: --bar");
+        CHECK(exp.compactError());
+
+        //detaching replaces the compact error with an exception object that owns the subject
+        exp.detachError();
+        CHECK(!exp.compactError());
+        auto err = exp.error();
+        XREQUIRE(err);
+        CHECK(exp.error() == err);
+        CHECK(exp.errorCode() == Error::UnrecognizedOption);
+        commandLine = "xxxxx";
+        auto specific = err->as<CompactExc>();
+        XREQUIRE(specific);
+        CHECK(specific->option == "--bar");
+        CHECK(specific->argumentIndex == 3);
+        CHECK(err->message() == "unrecognized option: --bar");
+        CHECK(exp.errorMessage() == "unrecognized option: --bar");
+
+    #ifndef ARGUM_NO_THROW
+        CHECK_THROWS_AS((void)exp.value(), CompactExc);
+        CHECK_THROWS_AS((void)converted.value(), CompactExc);
+    #endif
+    }
+
+    {
+        string longSubject(ParsingError::maxSubjectSize + 1, 'a');
+        CHECK(!ParsingError::make<CompactExc>(longSubject));
+        CHECK(ParsingError::make<CompactExc>(string_view(longSubject).substr(1)));
+
+        Expected<void> exp(Failure<CompactExc>, "--bar");
+        XREQUIRE(!exp);
+        CHECK(!exp.compactError());
+        CHECK(exp.errorCode() == Error::UnrecognizedOption);
+    }
+
+    {
+        Expected<void> exp(Failure<Exc>, "a");
+        CHECK(!exp.compactError());
+        CHECK(exp.errorCode() == Error::UserError);
+        CHECK(exp.errorMessage() == "a");
+
+        Expected<void> success;
+        CHECK(!success.compactError());
+        CHECK(!success.errorCode());
+        CHECK(success.errorMessage().empty());
+    }
+
+#ifdef ARGUM_USE_EXPECTED
+    {
+        auto propagated = propagate(Expected<int>(*ParsingError::make<CompactExc>("-x", 1)));
+        XREQUIRE(propagated.compactError());
+        CHECK(propagated.compactError()->subject() == "-x");
+
+        auto ex = make_shared<Exc>();
+        propagated = propagate(Expected<int>(ex));
+        CHECK(propagated.error() == ex);
+
+        CHECK(propagate(Expected<int>(1)).value() == "ok");
+    }
+#endif
+}
+
+TEST_CASE( "lazy exception message" ) {
+    int counter = 0;
+    LazyExc ex(counter);
+    CHECK(ex.code() == Error::UserError);
+    CHECK(ex.as<LazyExc>());
+    CHECK(counter == 0);
+
+    CHECK(ex.what() == "lazy"s);
+    CHECK(ex.message() == L"lazy");
+    CHECK(counter == 1);
+
+    auto copy = ex.clone();
+    CHECK(counter == 1);
+    CHECK(copy->message() == L"lazy");
+    CHECK(counter == 2);
+
+    int otherCounter = 0;
+    LazyExc assigned(otherCounter);
+    CHECK(assigned.message() == L"lazy");
+    CHECK(otherCounter == 1);
+    assigned = ex;
+    CHECK(assigned.what() == "lazy"s);
+    CHECK(counter == 3);
+    CHECK(otherCounter == 1);
 }
 
+#ifndef ARGUM_NO_THROW
+TEST_CASE( "failing exception message" ) {
+    int failures = 0;
+    FailingExc ex(failures);
+    CHECK(ex.message() == L"error message unavailable");
+    CHECK(ex.what() == "error message unavailable"s);
+    CHECK(failures == 2);
 
+    failures = -1;
+    CHECK(ex.message() == L"recovered");
+    CHECK(ex.what() == "recovered"s);
+    CHECK(failures == -1);
+}
+#endif
+
+}
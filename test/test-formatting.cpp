@@ -1,6 +1,7 @@
 #include "test-common.h"
 
 #include <argum/formatting.h>
+#include <argum/messages.h>
 
 #include <doctest/doctest.h>
 
@@ -96,6 +97,67 @@ TEST_CASE( "wide formatting" ) {
     CHECK(format(L"{1}", 1.2) == to_wstring(1.2));
 }
 
+template<class Char, size_t N>
+struct FormatLiteral {
+    using CharType = Char;
+    constexpr FormatLiteral(const Char (&str)[N]) { std::copy(str, str + N, value); }
+    Char value[N];
+};
+
+template<FormatLiteral Lit> 
+constexpr auto formatLiteral() -> const typename decltype(Lit)::CharType * { return Lit.value; }
+
+#define CHECK_COMPILED_FORMAT(str, ...) \
+    static_assert(Impl::ConstantFormat<formatLiteral<str>>); \
+    CHECK(format<formatLiteral<str>>(__VA_ARGS__) == format(str __VA_OPT__(,) __VA_ARGS__))
+
+static auto runtimeFormat() { return "{1}-{2}"; }
+
+TEST_CASE( "compiled formatting" ) {
+
+    static_assert(Impl::countFormatSegments("abc"sv) == 1);
+    static_assert(Impl::countFormatSegments("{{1}"sv) == 2);
+    static_assert(Impl::countFormatSegments("a{1}b{2}"sv) == 4);
+
+    CHECK_COMPILED_FORMAT("");
+    CHECK_COMPILED_FORMAT("abc");
+    CHECK_COMPILED_FORMAT("{{1}");
+    CHECK_COMPILED_FORMAT("{1}");
+    CHECK_COMPILED_FORMAT("{12345678901234567890}");
+    CHECK_COMPILED_FORMAT("", 42);
+    CHECK_COMPILED_FORMAT("{", 42);
+    CHECK_COMPILED_FORMAT("{1", 42);
+    CHECK_COMPILED_FORMAT("a{1", 42);
+    CHECK_COMPILED_FORMAT("{{", 42);
+    CHECK_COMPILED_FORMAT("{{1", 42);
+    CHECK_COMPILED_FORMAT("{{1}", 42);
+    CHECK_COMPILED_FORMAT("{1}", 42);
+    CHECK_COMPILED_FORMAT("{1a}", 42);
+    CHECK_COMPILED_FORMAT("{+1}", 42);
+    CHECK_COMPILED_FORMAT("{1.}", 42);
+    CHECK_COMPILED_FORMAT("{2}", 42);
+    CHECK_COMPILED_FORMAT("{0}", 42);
+    CHECK_COMPILED_FORMAT("{12345678901234567890}", 42);
+    CHECK_COMPILED_FORMAT("{{{1}}", 42);
+    CHECK_COMPILED_FORMAT("{a{1}", 42);
+    CHECK_COMPILED_FORMAT("x{2}y{1}z{2}{3}", "abc"sv, L"def"s);
+    CHECK_COMPILED_FORMAT("{1}", true);
+    CHECK_COMPILED_FORMAT("{1}", 1.2);
+
+    CHECK_COMPILED_FORMAT(L"", 42);
+    CHECK_COMPILED_FORMAT(L"{{1}", 42);
+    CHECK_COMPILED_FORMAT(L"{1}", 42);
+    CHECK_COMPILED_FORMAT(L"{2}", 42);
+    CHECK_COMPILED_FORMAT(L"{1a}", 42);
+    CHECK_COMPILED_FORMAT(L"x{2}y{1}z{2}{3}", "abc"sv, L"def"s);
+
+    CHECK(format<Messages<char>::notAValidChoice>("x", "a, b") == "value \"x\" is not one of the valid choices {a, b}");
+    CHECK(format<Messages<wchar_t>::outOfRange>(L"7") == L"value \"7\" is out of range");
+
+    static_assert(!Impl::ConstantFormat<runtimeFormat>);
+    CHECK(format<runtimeFormat>("a", 1) == "a-1");
+}
+
 TEST_CASE( "string width" ) {
 
     CHECK(stringWidth("") == 0);
@@ -111,6 +173,29 @@ TEST_CASE( "string width" ) {
     CHECK((emoji == 2 || emoji == 1));
 }
 
+TEST_CASE( "wcwidth" ) {
+
+    CHECK(Wcwidth::mk_wcwidth(0) == 0);
+    CHECK(Wcwidth::mk_wcwidth(0x1B) == -1);
+    CHECK(Wcwidth::mk_wcwidth(0x9F) == -1);
+    CHECK(Wcwidth::mk_wcwidth(U'a') == 1);
+    CHECK(Wcwidth::mk_wcwidth(0x00AD) == 1);
+    CHECK(Wcwidth::mk_wcwidth(0x0301) == 0);
+    CHECK(Wcwidth::mk_wcwidth(0x1160) == 0);
+    CHECK(Wcwidth::mk_wcwidth(0x200B) == 0);
+    CHECK(Wcwidth::mk_wcwidth(0xE0100) == 0);
+    CHECK(Wcwidth::mk_wcwidth(0x303F) == 1);
+    CHECK(Wcwidth::mk_wcwidth(0x754C) == 2);
+    CHECK(Wcwidth::mk_wcwidth(0xFF21) == 2);
+    CHECK(Wcwidth::mk_wcwidth(0x1F921) == 2);
+    CHECK(Wcwidth::mk_wcwidth(0x2FFFD) == 2);
+    CHECK(Wcwidth::mk_wcwidth(0x10FFFF) == 1);
+    CHECK(Wcwidth::mk_wcwidth(0x110000) == 1);
+
+    CHECK(Wcwidth::wcswidth(L"a\u0301\u754C", 3) == 3);
+    CHECK(Wcwidth::wcswidth(L"a\x1b", 2) == -1);
+}
+
 TEST_CASE( "word wrap" ) {
 
     CHECK(wordWrap("", 0) == "");
@@ -137,6 +222,12 @@ TEST_CASE( "word wrap" ) {
 
     CHECK(wordWrap("ab cd", 2, 1) == "ab\n cd");
     CHECK(wordWrap("ab cd ef", 2, 1) == "ab\n cd\n ef");
+    CHECK(wordWrap("aaa bb c dddd", 6, 2) == "aaa bb\n  c\n  dddd");
+    CHECK(wordWrap("ab \x1b[1mcd\x1b[0m ef", 5) == "ab \x1b[1mcd\x1b[0m\nef");
+    CHECK(wordWrap(L"ab \u754C\u754C ef", 5) == L"ab\n\u754C\u754C\nef");
+
+    string dest = "x: ";
+    CHECK(appendWordWrapped(dest, "ab cd"sv, 4, 1, 3) == "x: ab\n cd");
 }
 
 }
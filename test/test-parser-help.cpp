@@ -1,5 +1,8 @@
 #include "parser-common.h"
 
+#include <sstream>
+#include <span>
+
 TEST_SUITE("parser-help") {
 
 TEST_CASE( "Argument help aligns when options are longer" ) {
@@ -54,6 +57,26 @@ TEST_CASE( "help wraps properly" ) {
 )__");
 }
 
+TEST_CASE( "help name wrapped without leading gap" ) {
+    map<string, vector<Value>> results;
+    Parser parser;
+
+    parser.add(OPTION_NO_ARG("--alpha", "-b").help("desc"));
+
+    HelpFormatter formatter(parser, "PROG", {
+        .width = 10,
+        .helpLeadingGap = 0,
+        .helpNameMaxWidth = 6,
+        .helpDescriptionGap = 0
+    });
+
+    CHECK(formatter.formatHelp() == R"__(options:
+--alpha,
+-b    desc
+
+)__");
+}
+
 TEST_CASE( "extremely small number of columns" ) {
 
     map<string, vector<Value>> results;
@@ -220,4 +243,161 @@ options:
     }
 }
 
+TEST_CASE( "help can be written to output sinks" ) {
+
+    map<string, vector<Value>> results;
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-h", "--help").help("show this help message and exit"));
+    parser.add(OPTION_REQ_ARG("--y").argName("Y").help("Y HELP"));
+    parser.add(POSITIONAL("foo").help("FOO HELP"));
+    parser.addSubCommand(POSITIONAL("command").help("COMMAND HELP"));
+    parser.add(OPTION_NO_ARG("-z").help("Z HELP"));
+    parser.add(POSITIONAL("bar").help("BAR HELP"));
+
+    const auto expectedHelp = parser.formatHelp("PROG", 30);
+    const auto expectedSubHelp = parser.formatHelp("PROG", "cmd", 30);
+    CHECK(expectedHelp == R"__(Usage: PROG [-h] [--y Y] foo
+  command
+
+positional arguments:
+  foo         FOO HELP
+  command     COMMAND HELP
+
+options:
+  -h, --help  show this help
+              message and exit
+  --y Y       Y HELP
+
+)__");
+
+    SUBCASE("output iterator") {
+        string str;
+        auto it = back_inserter(str);
+        parser.formatHelp(it, "PROG", 30);
+        CHECK(str == expectedHelp);
+
+        str.clear();
+        parser.formatHelp(it, "PROG", "cmd", 30);
+        CHECK(str == expectedSubHelp);
+
+        str.clear();
+        parser.formatUsage(it, "PROG", "cmd");
+        CHECK(str == parser.formatUsage("PROG", "cmd"));
+    }
+
+    SUBCASE("stream") {
+        ostringstream str;
+        parser.formatHelp(str, "PROG", 30);
+        CHECK(str.str() == expectedHelp);
+    }
+
+    SUBCASE("FILE") {
+        FILE * fp = tmpfile();
+        REQUIRE(fp);
+        parser.formatHelp(fp, "PROG", 30);
+        rewind(fp);
+        string str;
+        for (int c; (c = fgetc(fp)) != EOF; )
+            str += char(c);
+        fclose(fp);
+        CHECK(str == expectedHelp);
+    }
+
+    SUBCASE("fixed buffer") {
+        char buffer[20];
+        span<char> remaining(buffer);
+        parser.formatHelp(remaining, "PROG", 30);
+        CHECK(remaining.empty());
+        CHECK(string_view(buffer, size(buffer)) == string_view(expectedHelp).substr(0, size(buffer)));
+
+        char bigBuffer[1024];
+        remaining = bigBuffer;
+        parser.formatUsage(remaining, "PROG");
+        CHECK(string_view(bigBuffer, size(bigBuffer) - remaining.size()) == parser.formatUsage("PROG"));
+    }
+
+    SUBCASE("formatter") {
+        HelpFormatter formatter(parser, "PROG", {.width = 30});
+        string str;
+        auto it = back_inserter(str);
+        formatter.formatHelp(it, "cmd");
+        CHECK(str == formatter.formatHelp("cmd"));
+        CHECK(formatter.formatItemHelp("--name", "some description", 8) == "  --name    some description");
+    }
+}
+
+TEST_CASE( "wide help can be written to output sinks" ) {
+
+    map<wstring, vector<WValue>> results;
+    WParser parser;
+    parser.add(WOPTION_NO_ARG(L"-h", L"--help").help(L"show this help message and exit"));
+    parser.add(WPOSITIONAL(L"foo").help(L"FOO HELP"));
+
+    wostringstream str;
+    parser.formatHelp(str, L"PROG");
+    CHECK(str.str() == parser.formatHelp(L"PROG"));
+}
+
+TEST_CASE( "render cache" ) {
+
+    map<string, vector<Value>> results;
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-h", "--help").help("show this help message and exit"));
+    parser.add(POSITIONAL("foo").help("FOO HELP"));
+    parser.addSubCommand(POSITIONAL("command").help("COMMAND HELP"));
+    parser.add(OPTION_NO_ARG("-z").help("Z HELP"));
+
+    const auto help = parser.formatHelp("PROG", 30);
+    const auto subHelp = parser.formatHelp("PROG", "cmd");
+    const auto coloredHelp = parser.formatHelp("PROG", 40, defaultColorizer());
+    const auto usage = parser.formatUsage("PROG", 20);
+
+    parser.enableRenderCache();
+    for (int i = 0; i < 2; ++i) {
+        CHECK(parser.formatHelp("PROG", 30) == help);
+        CHECK(parser.formatHelp("PROG", "cmd") == subHelp);
+        CHECK(parser.formatHelp("PROG", 40, defaultColorizer()) == coloredHelp);
+        CHECK(parser.formatUsage("PROG", 20) == usage);
+        CHECK(parser.formatUsage("PROG", 20) != parser.formatHelp("PROG", 20));
+        CHECK(parser.formatUsage("BOB", 20) == "Usage: BOB [-h] foo\n  command");
+
+        ostringstream str;
+        parser.formatHelp(str, "PROG", 40, defaultColorizer());
+        CHECK(str.str() == coloredHelp);
+    }
+
+    //the cache is invalidated by changes
+    parser.add(OPTION_NO_ARG("--extra").help("EXTRA HELP"));
+    const auto newHelp = parser.formatHelp("PROG", "cmd");
+    CHECK(newHelp != subHelp);
+    CHECK(newHelp.find("EXTRA HELP") != newHelp.npos);
+
+    //schemes are compared by value
+    ColorScheme scheme = defaultColorScheme();
+    auto schemeHelp = parser.formatHelp("PROG", 40, Colorizer{scheme});
+    scheme.heading = makeColor<Color::red>();
+    CHECK(parser.formatHelp("PROG", 40, Colorizer{scheme}) != schemeHelp);
+
+    parser.enableRenderCache(false);
+    CHECK(parser.formatHelp("PROG", "cmd") == newHelp);
+}
+
+TEST_CASE( "precomputed item names" ) {
+
+    map<string, vector<Value>> results;
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-h", "--help").help("show this help message and exit"));
+    parser.add(OPTION_REQ_ARG("--y").argName("Y").help("Y HELP"));
+    parser.add(POSITIONAL("foo").help("FOO HELP"));
+
+    HelpFormatter formatter(parser, "PROG", {.width = 25});
+    auto expected = formatter.formatHelp(defaultColorizer());
+    auto names = formatter.calculateItemNames(defaultColorizer());
+    REQUIRE(names.positionals.size() == 1);
+    REQUIRE(names.options.size() == 2);
+    CHECK(names.options[1].width == 5);
+    formatter.useItemNames(names);
+    CHECK(formatter.formatHelp(defaultColorizer()) == expected);
+}
+
 }
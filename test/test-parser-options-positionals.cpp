@@ -189,6 +189,83 @@ TEST_CASE( "options with required attached arguments" ) {
     EXPECT_SUCCESS(ARGS("--goo=a"), RESULTS({"-g", {"a"}}))
     EXPECT_SUCCESS(ARGS("-ga", "b"), RESULTS({"-g", {"a"}}, {"z", {"b"}}))
     EXPECT_SUCCESS(ARGS("--goo=a", "b"), RESULTS({"-g", {"a"}}, {"z", {"b"}}))
+    EXPECT_SUCCESS(ARGS("a", "-g", "b"), RESULTS({"-g", {nullopt}}, {"z", {"a", "b"}}))
+    EXPECT_SUCCESS(ARGS("a", "--goo", "b"), RESULTS({"-g", {nullopt}}, {"z", {"a", "b"}}))
+}
+
+TEST_CASE( "Parse statistics" ) {
+
+    map<string, vector<Value>> results;
+
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-n", "--no-arg"));
+    parser.add(OPTION_OPT_ARG("-o", "--opt-arg"));
+    parser.add(OPTION_NO_ARG("--opt-other"));
+    parser.add(OPTION_REQ_ARG("-r", "--req-arg"));
+    parser.add(POSITIONAL("p").occurs(zeroOrMoreTimes));
+    parser.add(POSITIONAL("f"));
+    parser.addValidator(!optionPresent("-n") || optionPresent("-o"), "-n requires -o");
+
+    ParseStats stats;
+    stats.allocationCounter = []() -> size_t {
+        static size_t count = 0;
+        return count += 5;
+    };
+
+    auto parseWithStats = [&](initializer_list<const char *> args) {
+        results.clear();
+    #ifndef ARGUM_USE_EXPECTED
+        REQUIRE_NOTHROW(parser.parse(args, &stats));
+    #else
+        REQUIRE(parser.parse(args, &stats));
+    #endif
+    };
+
+    //The positionals are recalculated once, on the first one, which tokenizes the whole command line again
+    parseWithStats(ARGS("a", "-no", "--req-a=x", "b", "--", "c"));
+    CHECK(results == RESULTS({"-n", {"+"}}, {"-o", {nullopt}}, {"-r", {"x"}}, {"p", {"a", "b"}}, {"f", {"c"}}));
+    CHECK(stats.optionTokens == 3);
+    CHECK(stats.argumentTokens == 3);
+    CHECK(stats.optionStopTokens == 1);
+    CHECK(stats.unknownOptionTokens == 0);
+    CHECK(stats.ambiguousOptionTokens == 0);
+    CHECK(stats.tokens() == 7);
+    CHECK(stats.prefixLookups == 10);
+    CHECK(stats.optionLookups == 6);
+    CHECK(stats.abbreviationResolutions == 2);
+    CHECK(stats.positionalRecalculations == 1);
+    CHECK(stats.handlerInvocations == 6);
+    CHECK(stats.validatorEvaluations == 5);
+    CHECK(stats.allocations == 5);
+    CHECK(stats.totalTime > ParseStats::Duration::zero());
+    CHECK(stats.totalTime >= stats.handlersTime + stats.positionalRecalculationTime + stats.validationTime);
+    CHECK(stats.tokenizingTime() >= ParseStats::Duration::zero());
+
+    //Counters accumulate over parses
+    parseWithStats(ARGS("c"));
+    CHECK(stats.argumentTokens == 4);
+    CHECK(stats.positionalRecalculations == 2);
+    CHECK(stats.handlerInvocations == 7);
+    CHECK(stats.allocations == 10);
+
+    stats.reset();
+    CHECK(stats.tokens() == 0);
+    CHECK(stats.allocations == 0);
+    CHECK(stats.totalTime == ParseStats::Duration::zero());
+    CHECK(stats.allocationCounter);
+
+    auto errors = parser.parseCollectingErrors(ARGS("--bogus", "--opt", "c"), Parser::defaultMaxErrors, &stats);
+    CHECK(errors.size() == 2);
+    CHECK(stats.unknownOptionTokens == 1);
+    CHECK(stats.ambiguousOptionTokens == 1);
+    CHECK(stats.argumentTokens == 1);
+    CHECK(stats.handlerInvocations == 1);
+
+    stats.reset();
+    CHECK(ARGUM_EXPECTED_VALUE(parser.parseUntilUnknown(ARGS("c", "--bogus"), &stats)) == vector<string>{"--bogus"});
+    CHECK(stats.argumentTokens == 1);
+    CHECK(stats.unknownOptionTokens == 1);
+    CHECK(stats.handlerInvocations == 1);
 }
 
 }
@@ -540,5 +540,50 @@ TEST_CASE( "Repeat 2-or-3 option" ) {
     EXPECT_SUCCESS(ARGS("--work=42", "-w", "-w34"), RESULTS({"-w", {"42", nullopt, "34"}}))
 }
 
+TEST_CASE( "Error argument index" ) {
+    map<string, vector<Value>> results;
+
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-a"));
+    parser.add(OPTION_REQ_ARG("-b", "--bee"));
+
+    EXPECT_FAILURE(ARGS("-a", "-c"), HANDLE_FAILURE(UnrecognizedOption, { CHECK(ex.option == "-c"); CHECK(ex.argumentIndex == 1); }))
+    EXPECT_FAILURE(ARGS("-a", "x"), HANDLE_FAILURE(ExtraPositional, { CHECK(ex.value == "x"); CHECK(ex.argumentIndex == 1); }))
+    EXPECT_FAILURE(ARGS("-a", "-a=x"), HANDLE_FAILURE(ExtraOptionArgument, { CHECK(ex.option == "-a"); CHECK(ex.argumentIndex == 1); }))
+    EXPECT_FAILURE(ARGS("-a", "-a", "--bee"), HANDLE_FAILURE(MissingOptionArgument, { CHECK(ex.option == "--bee"); CHECK(ex.argumentIndex == 2); }))
+
+    //names longer than the compact representation allows
+    auto longName = "--" + string(ParsingError::maxSubjectSize, 'x');
+    EXPECT_FAILURE(ARGS("-a", longName.c_str()), HANDLE_FAILURE(UnrecognizedOption, { CHECK(ex.option.size() == ParsingError::maxSubjectSize + 2); CHECK(ex.argumentIndex == 1); }))
+
+#ifdef ARGUM_USE_EXPECTED
+    //compact errors refer to the text of the arguments
+    vector<string> args = {"-a", "-c"};
+    auto res = parser.parse(args);
+    REQUIRE(res.compactError());
+    CHECK(res.compactError()->subject() == "-c");
+    CHECK(res.compactError()->subject().data() == args[1].data());
+    CHECK(res.errorMessage() == "unrecognized option: -c");
+
+    args = {"-a=x"};
+    res = parser.parse(args);
+    REQUIRE(res.compactError());
+    CHECK(res.compactError()->subject().data() == args[0].data());
+    CHECK(res.errorMessage() == "extraneous argument for option: -a");
+
+    args = {"-b"};
+    res = parser.parse(args);
+    REQUIRE(res.compactError());
+    CHECK(res.compactError()->code() == Error::MissingOptionArgument);
+    CHECK(res.compactError()->subject().data() == args[0].data());
+
+    //errors about temporary arguments are converted to exception objects
+    res = parser.parse(vector<string>{"-c"});
+    CHECK(!res.compactError());
+    CHECK(res.errorMessage() == "unrecognized option: -c");
+    CHECK(parser.parseUntilUnknown(vector<string>{"-b"}).errorCode() == Error::MissingOptionArgument);
+    CHECK(!parser.parseUntilUnknown(vector<string>{"-b"}).compactError());
+#endif
 }
 
+}
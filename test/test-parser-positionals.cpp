@@ -388,4 +388,77 @@ TEST_CASE( "Two positionals with repeats: ?, +" ) {
     EXPECT_SUCCESS(ARGS("a", "b", "c"), RESULTS({"foo", {"a"}}, {"bar", {"b", "c"}}))
 }
 
+
+TEST_CASE( "Fixed positionals followed by one with unlimited" ) {
+    map<string, vector<Value>> results;
+
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-o"));
+    parser.add(POSITIONAL("foo"));
+    parser.add(POSITIONAL("bar").occurs(2));
+    parser.add(POSITIONAL("baz").occurs(zeroOrMoreTimes));
+
+    EXPECT_FAILURE(ARGS(), VALIDATION_ERROR("invalid arguments: positional argument foo must be present"))
+    EXPECT_FAILURE(ARGS("a"), VALIDATION_ERROR("invalid arguments: positional argument bar must occur at least 2 times"))
+    EXPECT_FAILURE(ARGS("a", "b"), VALIDATION_ERROR("invalid arguments: positional argument bar must occur at least 2 times"))
+    EXPECT_FAILURE(ARGS("a", "-o", "b"), VALIDATION_ERROR("invalid arguments: positional argument bar must occur at least 2 times"))
+
+    EXPECT_SUCCESS(ARGS("a", "b", "c"), RESULTS({"foo", {"a"}}, {"bar", {"b", "c"}}))
+    EXPECT_SUCCESS(ARGS("a", "b", "c", "d", "e"), RESULTS({"foo", {"a"}}, {"bar", {"b", "c"}}, {"baz", {"d", "e"}}))
+    EXPECT_SUCCESS(ARGS("a", "-o", "b", "c", "-o", "d"), RESULTS({"-o", {"+", "+"}}, {"foo", {"a"}}, {"bar", {"b", "c"}}, {"baz", {"d"}}))
+    EXPECT_SUCCESS(ARGS("a", "b", "--", "-c", "-d"), RESULTS({"foo", {"a"}}, {"bar", {"b", "-c"}}, {"baz", {"-d"}}))
+}
+
+TEST_CASE( "Fixed positionals followed by one with one or more" ) {
+    map<string, vector<Value>> results;
+
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-o"));
+    parser.add(POSITIONAL("foo").occurs(2));
+    parser.add(POSITIONAL("bar"));
+    parser.add(POSITIONAL("baz").occurs(oneOrMoreTimes));
+
+    EXPECT_FAILURE(ARGS("a"), VALIDATION_ERROR("invalid arguments: positional argument foo must occur at least 2 times"))
+    EXPECT_FAILURE(ARGS("a", "b"), VALIDATION_ERROR("invalid arguments: positional argument bar must be present"))
+    EXPECT_FAILURE(ARGS("a", "b", "c"), VALIDATION_ERROR("invalid arguments: positional argument baz must be present"))
+    EXPECT_FAILURE(ARGS("a", "-o", "b", "c", "-o"), VALIDATION_ERROR("invalid arguments: positional argument baz must be present"))
+
+    EXPECT_SUCCESS(ARGS("a", "b", "c", "d"), RESULTS({"foo", {"a", "b"}}, {"bar", {"c"}}, {"baz", {"d"}}))
+    EXPECT_SUCCESS(ARGS("a", "-o", "b", "c", "d", "-o", "e"), RESULTS({"-o", {"+", "+"}}, {"foo", {"a", "b"}}, {"bar", {"c"}}, {"baz", {"d", "e"}}))
+}
+
+TEST_CASE( "Fixed positionals followed by one with an optional" ) {
+    map<string, vector<Value>> results;
+
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-o"));
+    parser.add(POSITIONAL("foo"));
+    parser.add(POSITIONAL("bar"));
+    parser.add(POSITIONAL("baz").occurs(neverOrOnce));
+
+    EXPECT_FAILURE(ARGS("a"), VALIDATION_ERROR("invalid arguments: positional argument bar must be present"))
+    EXPECT_FAILURE(ARGS("a", "b", "c", "d"), EXTRA_POSITIONAL("d"))
+    EXPECT_FAILURE(ARGS("a", "-o", "b", "c", "-o", "d", "e"), EXTRA_POSITIONAL("d"))
+
+    EXPECT_SUCCESS(ARGS("a", "b"), RESULTS({"foo", {"a"}}, {"bar", {"b"}}))
+    EXPECT_SUCCESS(ARGS("a", "-o", "b", "c"), RESULTS({"-o", {"+"}}, {"foo", {"a"}}, {"bar", {"b"}}, {"baz", {"c"}}))
+}
+
+TEST_CASE( "Fixed positionals only" ) {
+    map<string, vector<Value>> results;
+
+    Parser parser;
+    parser.add(OPTION_NO_ARG("-o"));
+    parser.add(POSITIONAL("foo").occurs(2));
+    parser.add(POSITIONAL("bar"));
+
+    EXPECT_FAILURE(ARGS("a"), VALIDATION_ERROR("invalid arguments: positional argument foo must occur at least 2 times"))
+    EXPECT_FAILURE(ARGS("a", "-o", "b"), VALIDATION_ERROR("invalid arguments: positional argument bar must be present"))
+    EXPECT_FAILURE(ARGS("a", "b", "c", "d"), EXTRA_POSITIONAL("d"))
+    EXPECT_FAILURE(ARGS("a", "b", "-o", "c", "d", "e"), EXTRA_POSITIONAL("d"))
+
+    EXPECT_SUCCESS(ARGS("a", "b", "c"), RESULTS({"foo", {"a", "b"}}, {"bar", {"c"}}))
+    EXPECT_SUCCESS(ARGS("-o", "a", "b", "-o", "c"), RESULTS({"-o", {"+", "+"}}, {"foo", {"a", "b"}}, {"bar", {"c"}}))
+}
+
 }
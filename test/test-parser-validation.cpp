@@ -63,4 +63,65 @@ TEST_CASE( "If one then other" ) {
     EXPECT_SUCCESS(ARGS("-a2", "-b1", "-b2"), RESULTS({"-a2", {"+"}}, {"-b1", {"+"}}, {"-b2", {"+"}}))
 }
 
+TEST_CASE( "Collecting errors" ) {
+
+    vector<string> seen;
+
+    Parser parser;
+    parser.add(Option("-a").handler([&]() { seen.push_back("-a"); }));
+    parser.add(Option("--num").handler([&](string_view value) -> ARGUM_EXPECTED(char, void) {
+        if (value != "1")
+            ARGUM_THROW(ValidationError, "bad number "s + string(value));
+        seen.push_back("--num");
+        return ARGUM_VOID_SUCCESS;
+    }));
+    parser.add(Option("--req").occurs(Quantifier(1,1)).handler([&](string_view) { seen.push_back("--req"); }));
+    parser.add(Positional("pos").occurs(Quantifier(1,1)).handler([&](string_view value) { seen.push_back(string(value)); }));
+
+    auto codes = [](const vector<shared_ptr<ParsingException>> & errors) {
+        vector<Error> ret;
+        for (auto & err: errors)
+            ret.push_back(err->code());
+        return ret;
+    };
+
+    {
+        auto args = ARGS("-x", "--num", "2", "-a=3", "p", "q", "--num", "1", "--req");
+        auto errors = parser.parseCollectingErrors(args);
+        CHECK(codes(errors) == vector{Error::UnrecognizedOption, Error::ValidationError, Error::ExtraOptionArgument, 
+                                      Error::ExtraPositional, Error::MissingOptionArgument});
+        REQUIRE(errors.size() == 5);
+        CHECK(errors[0]->as<UnrecognizedOption>()->option == "-x");
+        CHECK(errors[1]->message() == "invalid arguments: bad number 2");
+        CHECK(errors[3]->as<ExtraPositional>()->value == "q");
+        CHECK(errors[4]->as<MissingOptionArgument>()->option == "--req");
+        CHECK(seen == vector<string>{"p", "--num"});
+    }
+
+    {
+        seen.clear();
+        auto args = ARGS("-x", "--num", "2", "-a=3", "p", "q", "--num", "1", "--req");
+        auto errors = parser.parseCollectingErrors(args, 2);
+        CHECK(codes(errors) == vector{Error::UnrecognizedOption, Error::ValidationError});
+        CHECK(seen.empty());
+    }
+
+    {
+        seen.clear();
+        auto args = ARGS("--num", "2");
+        auto errors = parser.parseCollectingErrors(args);
+        CHECK(codes(errors) == vector{Error::ValidationError, Error::ValidationError, Error::ValidationError});
+        REQUIRE(errors.size() == 3);
+        CHECK(errors[1]->message() == "invalid arguments: positional argument pos must be present");
+        CHECK(errors[2]->message() == "invalid arguments: option --req must be present");
+    }
+
+    {
+        seen.clear();
+        auto args = ARGS("-a", "p", "--req", "r");
+        CHECK(parser.parseCollectingErrors(args).empty());
+        CHECK(seen == vector<string>{"-a", "p", "--req"});
+    }
+}
+
 }
@@ -81,6 +81,7 @@ function(configure_test name)
             test/test-parser-validation.cpp
             test/test-type-parsers.cpp
             test/test-color.cpp
+            test/test-detect-system.cpp
 
             test/response.txt
             test/response1.txt